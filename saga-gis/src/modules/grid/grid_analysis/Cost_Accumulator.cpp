@@ -0,0 +1,479 @@
+/**********************************************************
+ * Version $Id$
+ *********************************************************/
+
+///////////////////////////////////////////////////////////
+//                                                       //
+//                         SAGA                          //
+//                                                       //
+//      System for Automated Geoscientific Analyses      //
+//                                                       //
+//                    Module Library:                    //
+//                     grid_analysis                     //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//                  Cost_Accumulator.cpp                 //
+//                                                       //
+//                 Copyright (C) 2015 by                 //
+//                      Olaf Conrad                      //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+// This file is part of 'SAGA - System for Automated     //
+// Geoscientific Analyses'. SAGA is free software; you   //
+// can redistribute it and/or modify it under the terms  //
+// of the GNU General Public License as published by the //
+// Free Software Foundation; version 2 of the License.   //
+//                                                       //
+// SAGA is distributed in the hope that it will be       //
+// useful, but WITHOUT ANY WARRANTY; without even the    //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A  //
+// PARTICULAR PURPOSE. See the GNU General Public        //
+// License for more details.                             //
+//                                                       //
+// You should have received a copy of the GNU General    //
+// Public License along with this program; if not,       //
+// write to the Free Software Foundation, Inc.,          //
+// 51 Franklin Street, 5th Floor, Boston, MA 02110-1301, //
+// USA.                                                  //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//    e-mail:     oconrad@saga-gis.org                   //
+//                                                       //
+//    contact:    Olaf Conrad                            //
+//                Institute of Geography                 //
+//                University of Goettingen               //
+//                Goldschmidtstr. 5                      //
+//                37077 Goettingen                       //
+//                Germany                                //
+//                                                       //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+
+//---------------------------------------------------------
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+#include "Cost_Accumulator.h"
+
+#include <algorithm>
+#include <float.h>
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+CCost_Accumulator::CCost_Accumulator(void)
+{
+	m_pCost	= m_pAccumulated = m_pAllocation = m_pBacklink = m_pDirection = NULL;
+
+	m_NX	= m_NY	= 0;
+
+	m_Threshold	= 0.0;
+	m_Max_Cost	= 0.0;
+	m_k			= 1.0;
+}
+
+//---------------------------------------------------------
+CCost_Accumulator::~CCost_Accumulator(void)
+{
+	Destroy();
+}
+
+//---------------------------------------------------------
+void CCost_Accumulator::Destroy(void)
+{
+	m_Acc    .clear();
+	m_bDone  .clear();
+	m_bSource.clear();
+	m_Heap   .clear();
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CCost_Accumulator::Create(CSG_Grid *pCost, CSG_Grid *pAccumulated, CSG_Grid *pAllocation, CSG_Grid *pBacklink)
+{
+	Destroy();
+
+	if( !pCost || !pAccumulated || !pAccumulated->is_Compatible(pCost)
+	||  (pAllocation && !pAllocation->is_Compatible(pCost))
+	||  (pBacklink   && !pBacklink  ->is_Compatible(pCost)) )
+	{
+		return( false );
+	}
+
+	m_pCost			= pCost;
+	m_pAccumulated	= pAccumulated;
+	m_pAllocation	= pAllocation;
+	m_pBacklink		= pBacklink;
+	m_pDirection	= NULL;
+
+	m_NX			= pCost->Get_NX();
+	m_NY			= pCost->Get_NY();
+
+	m_Acc    .assign((size_t)m_NX * m_NY, DBL_MAX);
+	m_bDone  .assign((size_t)m_NX * m_NY, false);
+	m_bSource.assign((size_t)m_NX * m_NY, false);
+
+	m_pAccumulated->Assign_NoData();
+
+	if( m_pAllocation )	{	m_pAllocation->Assign_NoData();	}
+	if( m_pBacklink   )	{	m_pBacklink  ->Assign_NoData();	}
+
+	return( true );
+}
+
+//---------------------------------------------------------
+bool CCost_Accumulator::Add_Source(int x, int y, int ID)
+{
+	if( m_Acc.size() == 0 || !is_Passable(x, y) )
+	{
+		return( false );
+	}
+
+	sLong	n	= (sLong)y * m_NX + x;
+
+	m_Acc    [n]	= 0.0;
+	m_bSource[n]	= true;
+
+	if( m_pAllocation )
+	{
+		m_pAllocation->Set_Value(x, y, ID);
+	}
+
+	Push(n, 0.0);
+
+	return( true );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+void CCost_Accumulator::Push(sLong n, double Cost)
+{
+	TNode	Node;	Node.n	= n;	Node.Cost	= Cost;
+
+	m_Heap.push_back(Node);
+
+	std::push_heap(m_Heap.begin(), m_Heap.end(), SNode_Greater());
+}
+
+//---------------------------------------------------------
+CCost_Accumulator::TNode CCost_Accumulator::Pop(void)
+{
+	std::pop_heap(m_Heap.begin(), m_Heap.end(), SNode_Greater());
+
+	TNode	Node	= m_Heap.back();	m_Heap.pop_back();
+
+	return( Node );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// Cost of the step from cell x/y to its neighbour in the
+// given direction, measured in cell units.
+
+double CCost_Accumulator::Get_Cost(int x, int y, int Direction)
+{
+	int	ix	= CSG_Grid_System::Get_xTo(Direction, x);
+	int	iy	= CSG_Grid_System::Get_yTo(Direction, y);
+
+	if( !m_pDirection )	// isotropic, mean cost of both cells
+	{
+		return( CSG_Grid_System::Get_UnitLength(Direction) * (m_pCost->asDouble(x, y) + m_pCost->asDouble(ix, iy)) / 2.0 );
+	}
+
+	//-----------------------------------------------------
+	// anisotropic, the friction depends on the difference
+	// between the moving direction and the direction of
+	// maximum cost of both cells
+
+	static const double	Angles[3][3]	= { { 315, 0, 45 }, { 270, 0, 90 }, { 225, 180, 135 } };
+
+	double	Angle	= Angles[iy - y + 1][ix - x + 1];
+
+	double	Cost	= pow(cos(fabs(m_pDirection->asDouble( x,  y) - Angle) * M_DEG_TO_RAD), m_k) / 2.0
+					+ pow(cos(fabs(m_pDirection->asDouble(ix, iy) - Angle) * M_DEG_TO_RAD), m_k) / 2.0;
+
+	return( CSG_Grid_System::Get_UnitLength(Direction) * Cost );
+}
+
+//---------------------------------------------------------
+// First order upwind solution of |grad T| = cost, using the
+// settled neighbours along both axes.
+
+double CCost_Accumulator::Get_Eikonal(int x, int y)
+{
+	double	F	= m_pCost->asDouble(x, y);
+
+	if( !(F >= 0.0) )
+	{
+		return( DBL_MAX );
+	}
+
+	double	T[2];
+
+	for(int Axis=0; Axis<2; Axis++)
+	{
+		T[Axis]	= DBL_MAX;
+
+		for(int Direction=Axis*2; Direction<8; Direction+=4)	// 0/4 = north/south, 2/6 = east/west
+		{
+			int	ix	= CSG_Grid_System::Get_xTo(Direction, x);
+			int	iy	= CSG_Grid_System::Get_yTo(Direction, y);
+
+			if( ix >= 0 && ix < m_NX && iy >= 0 && iy < m_NY )
+			{
+				sLong	i	= (sLong)iy * m_NX + ix;
+
+				if( m_bDone[i] && m_Acc[i] < T[Axis] )
+				{
+					T[Axis]	= m_Acc[i];
+				}
+			}
+		}
+	}
+
+	double	a	= M_GET_MIN(T[0], T[1]), b = M_GET_MAX(T[0], T[1]);
+
+	if( a >= DBL_MAX )
+	{
+		return( DBL_MAX );
+	}
+
+	if( b >= DBL_MAX || b - a >= F )
+	{
+		return( a + F );
+	}
+
+	return( (a + b + sqrt(2.0 * F*F - (b - a)*(b - a))) / 2.0 );
+}
+
+//---------------------------------------------------------
+void CCost_Accumulator::Set_Link(int x, int y, int Direction)
+{
+	if( m_pBacklink )
+	{
+		m_pBacklink->Set_Value(x, y, Direction);
+	}
+
+	if( m_pAllocation )
+	{
+		m_pAllocation->Set_Value(x, y, m_pAllocation->asInt(CSG_Grid_System::Get_xTo(Direction, x), CSG_Grid_System::Get_yTo(Direction, y)));
+	}
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CCost_Accumulator::Run(bool bFastMarching)
+{
+	if( m_Acc.size() == 0 )
+	{
+		return( false );
+	}
+
+	bool	bResult	= bFastMarching && !m_pDirection ? Run_Fast_Marching() : Run_Dijkstra();
+
+	//-----------------------------------------------------
+	for(int y=0; y<m_NY; y++)
+	{
+		for(int x=0; x<m_NX; x++)
+		{
+			sLong	n	= (sLong)y * m_NX + x;
+
+			if( m_bDone[n] )
+			{
+				m_pAccumulated->Set_Value(x, y, m_Acc[n]);
+			}
+			else
+			{
+				if( m_pAllocation )	{	m_pAllocation->Set_NoData(x, y);	}
+				if( m_pBacklink   )	{	m_pBacklink  ->Set_NoData(x, y);	}
+			}
+		}
+	}
+
+	m_Heap.clear();
+
+	return( bResult );
+}
+
+//---------------------------------------------------------
+bool CCost_Accumulator::Run_Dijkstra(void)
+{
+	sLong	nDone	= 0, nCells	= (sLong)m_NX * m_NY;
+
+	while( m_Heap.size() > 0 )
+	{
+		TNode	Node	= Pop();
+
+		if( m_bDone[Node.n] || Node.Cost > m_Acc[Node.n] )	// outdated entry
+		{
+			continue;
+		}
+
+		if( m_Max_Cost > 0.0 && Node.Cost > m_Max_Cost )
+		{
+			break;
+		}
+
+		m_bDone[Node.n]	= true;
+
+		if( (++nDone % m_NX) == 0 && !SG_UI_Process_Set_Progress((double)nDone, (double)nCells) )
+		{
+			return( false );
+		}
+
+		//-------------------------------------------------
+		int	x	= (int)(Node.n % m_NX);
+		int	y	= (int)(Node.n / m_NX);
+
+		for(int i=0; i<8; i++)
+		{
+			int	ix	= CSG_Grid_System::Get_xTo(i, x);
+			int	iy	= CSG_Grid_System::Get_yTo(i, y);
+
+			if( is_Passable(ix, iy) )
+			{
+				sLong	j	= (sLong)iy * m_NX + ix;
+
+				double	Cost;
+
+				if( !m_bDone[j] && (Cost = Get_Cost(x, y, i)) >= 0.0 )
+				{
+					Cost	+= Node.Cost;
+
+					if( m_Acc[j] >= DBL_MAX || m_Acc[j] > Cost + m_Threshold )
+					{
+						m_Acc[j]	= Cost;
+
+						Set_Link(ix, iy, (i + 4) % 8);
+
+						Push(j, Cost);
+					}
+				}
+			}
+		}
+	}
+
+	return( true );
+}
+
+//---------------------------------------------------------
+bool CCost_Accumulator::Run_Fast_Marching(void)
+{
+	sLong	nDone	= 0, nCells	= (sLong)m_NX * m_NY;
+
+	while( m_Heap.size() > 0 )
+	{
+		TNode	Node	= Pop();
+
+		if( m_bDone[Node.n] || Node.Cost > m_Acc[Node.n] )	// outdated entry
+		{
+			continue;
+		}
+
+		if( m_Max_Cost > 0.0 && Node.Cost > m_Max_Cost )
+		{
+			break;
+		}
+
+		m_bDone[Node.n]	= true;
+
+		if( (++nDone % m_NX) == 0 && !SG_UI_Process_Set_Progress((double)nDone, (double)nCells) )
+		{
+			return( false );
+		}
+
+		//-------------------------------------------------
+		int	x	= (int)(Node.n % m_NX);
+		int	y	= (int)(Node.n / m_NX);
+
+		if( !m_bSource[Node.n] )	// link to the settled neighbour the cheapest step comes from
+		{
+			int		Link	= -1;
+			double	Min		= DBL_MAX;
+
+			for(int i=0; i<8; i++)
+			{
+				int	ix	= CSG_Grid_System::Get_xTo(i, x);
+				int	iy	= CSG_Grid_System::Get_yTo(i, y);
+
+				if( is_Passable(ix, iy) && m_bDone[(sLong)iy * m_NX + ix] )
+				{
+					double	Cost	= m_Acc[(sLong)iy * m_NX + ix] + Get_Cost(x, y, i);
+
+					if( Link < 0 || Cost < Min )
+					{
+						Link	= i;	Min	= Cost;
+					}
+				}
+			}
+
+			if( Link >= 0 )
+			{
+				Set_Link(x, y, Link);
+			}
+		}
+
+		//-------------------------------------------------
+		for(int i=0; i<8; i+=2)
+		{
+			int	ix	= CSG_Grid_System::Get_xTo(i, x);
+			int	iy	= CSG_Grid_System::Get_yTo(i, y);
+
+			if( is_Passable(ix, iy) )
+			{
+				sLong	j	= (sLong)iy * m_NX + ix;
+
+				double	Cost;
+
+				if( !m_bDone[j] && (Cost = Get_Eikonal(ix, iy)) < m_Acc[j] )
+				{
+					m_Acc[j]	= Cost;
+
+					Push(j, Cost);
+				}
+			}
+		}
+	}
+
+	return( true );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
@@ -0,0 +1,159 @@
+/**********************************************************
+ * Version $Id$
+ *********************************************************/
+
+///////////////////////////////////////////////////////////
+//                                                       //
+//                         SAGA                          //
+//                                                       //
+//      System for Automated Geoscientific Analyses      //
+//                                                       //
+//                    Module Library:                    //
+//                     grid_analysis                     //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//                   Cost_Accumulator.h                  //
+//                                                       //
+//                 Copyright (C) 2015 by                 //
+//                      Olaf Conrad                      //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+// This file is part of 'SAGA - System for Automated     //
+// Geoscientific Analyses'. SAGA is free software; you   //
+// can redistribute it and/or modify it under the terms  //
+// of the GNU General Public License as published by the //
+// Free Software Foundation; version 2 of the License.   //
+//                                                       //
+// SAGA is distributed in the hope that it will be       //
+// useful, but WITHOUT ANY WARRANTY; without even the    //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A  //
+// PARTICULAR PURPOSE. See the GNU General Public        //
+// License for more details.                             //
+//                                                       //
+// You should have received a copy of the GNU General    //
+// Public License along with this program; if not,       //
+// write to the Free Software Foundation, Inc.,          //
+// 51 Franklin Street, 5th Floor, Boston, MA 02110-1301, //
+// USA.                                                  //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//    e-mail:     oconrad@saga-gis.org                   //
+//                                                       //
+//    contact:    Olaf Conrad                            //
+//                Institute of Geography                 //
+//                University of Goettingen               //
+//                Goldschmidtstr. 5                      //
+//                37077 Goettingen                       //
+//                Germany                                //
+//                                                       //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+
+//---------------------------------------------------------
+#ifndef HEADER_INCLUDED__Cost_Accumulator_H
+#define HEADER_INCLUDED__Cost_Accumulator_H
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+#include "MLB_Interface.h"
+
+#include <vector>
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// Accumulated cost engine shared by the cost analysis
+// modules. Cells are settled in order of increasing
+// accumulated cost with a binary heap (Dijkstra), so each
+// cell is finalised exactly once. Optionally the isotropic
+// case is solved as eikonal equation by fast marching.
+// Back links store the direction (0-7, see Get_xTo())
+// from each cell to its predecessor on the least cost path.
+
+//---------------------------------------------------------
+class CCost_Accumulator
+{
+public:
+	CCost_Accumulator(void);
+	virtual ~CCost_Accumulator(void);
+
+	bool						Create				(CSG_Grid *pCost, CSG_Grid *pAccumulated, CSG_Grid *pAllocation = NULL, CSG_Grid *pBacklink = NULL);
+	void						Destroy				(void);
+
+	void						Set_Anisotropy		(CSG_Grid *pDirection, double k)	{	m_pDirection = pDirection; m_k = k;	}
+	void						Set_Threshold		(double Threshold)					{	m_Threshold	= Threshold;	}
+	void						Set_Max_Cost		(double Max_Cost)					{	m_Max_Cost	= Max_Cost;		}
+
+	bool						Add_Source			(int x, int y, int ID = 1);
+
+	bool						Run					(bool bFastMarching = false);
+
+
+private:
+
+	typedef struct SNode
+	{
+		double					Cost;
+
+		sLong					n;
+	}
+	TNode;
+
+	struct SNode_Greater
+	{
+		bool operator ()	(const TNode &a, const TNode &b) const	{	return( a.Cost > b.Cost );	}
+	};
+
+
+	int							m_NX, m_NY;
+
+	double						m_Threshold, m_Max_Cost, m_k;
+
+	std::vector<double>			m_Acc;
+
+	std::vector<bool>			m_bDone, m_bSource;
+
+	std::vector<TNode>			m_Heap;
+
+	CSG_Grid					*m_pCost, *m_pAccumulated, *m_pAllocation, *m_pBacklink, *m_pDirection;
+
+
+	void						Push				(sLong n, double Cost);
+	TNode						Pop					(void);
+
+	bool						is_Passable			(int x, int y)	const	{	return( x >= 0 && x < m_NX && y >= 0 && y < m_NY && !m_pCost->is_NoData(x, y) );	}
+
+	double						Get_Cost			(int x, int y, int Direction);
+	double						Get_Eikonal			(int x, int y);
+
+	void						Set_Link			(int x, int y, int Direction);
+
+	bool						Run_Dijkstra		(void);
+	bool						Run_Fast_Marching	(void);
+
+};
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+#endif // #ifndef HEADER_INCLUDED__Cost_Accumulator_H
@@ -66,6 +66,14 @@ CCost_Anisotropic::CCost_Anisotropic(void)
 						PARAMETER_TYPE_Double, 
 						2);
 
+	Parameters.Add_Grid(NULL, 
+						"BACKLINK", 
+						_TL("Back Links"), 
+						_TL("Direction to the next cell on the least cost path towards the destination points (0 = north, clockwise in steps of 45 degrees)."), 
+						PARAMETER_OUTPUT_OPTIONAL, 
+						true, 
+						SG_DATATYPE_Char);
+
 	Parameters.Add_Value(NULL,
 						"THRESHOLD",
 						_TL("Threshold for different route"),
@@ -73,6 +81,13 @@ CCost_Anisotropic::CCost_Anisotropic(void)
 						PARAMETER_TYPE_Double,
 						0.);
 
+	Parameters.Add_Value(NULL,
+						"MAXCOST",
+						_TL("Maximum Cost"),
+						_TL("Cells with a higher accumulated cost are not processed. Ignored if zero."),
+						PARAMETER_TYPE_Double,
+						0., 0., true);
+
 }
 
 CCost_Anisotropic::~CCost_Anisotropic(void)
@@ -86,106 +101,33 @@ bool CCost_Anisotropic::On_Execute(void)
 	m_pCostGrid = Parameters("COST")->asGrid(); 
 	m_pPointsGrid = Parameters("POINTS")->asGrid(); 
 	m_pDirectionGrid = Parameters("DIRECTION")->asGrid();
-	m_dK = Parameters("K")->asDouble();
-	m_dThreshold = Parameters("THRESHOLD")->asDouble();
-	
-	m_pAccCostGrid->Assign(NO_DATA);
-
-	m_CentralPoints.Clear();
-	m_AdjPoints.Clear();				
-	
-	m_CentralPoints.Clear();
 
-	for(int y=0; y<Get_NY(); y++){		
-		for(int x=0; x<Get_NX(); x++){
-			if (!m_pPointsGrid->is_NoData(x,y)){
-				m_CentralPoints.Add(x,y);
-				m_pAccCostGrid->Set_Value(x,y,0.0);
-			}//if
-		}//for
-	}//for
-	
-	CalculateCost();
+	CSG_Grid *pBacklink = Parameters("BACKLINK")->asGrid();
 
 	m_pAccCostGrid->Set_NoData_Value(NO_DATA);
 
-	return true;
+	if (pBacklink){
+		pBacklink->Set_NoData_Value(NO_DATA);
+	}//if
 
-}//method
+	CCost_Accumulator Accumulator;
 
-void CCost_Anisotropic::CalculateCost(){
-    
-    double dCost=0;;
-	int iX,iY;
-	int iUsedCells=0;
-	int iTotalCells=Get_NX()*Get_NY();
-	
-	while (m_CentralPoints.Get_Count()!=0){
-        
-		for (int iPt=0; iPt<m_CentralPoints.Get_Count();iPt++){	        
-	    
-			iX=m_CentralPoints.Get_X(iPt);
-			iY=m_CentralPoints.Get_Y(iPt);
-			
-			for (int i = -1; i < 2; i++) {        
-				for (int j = -1; j < 2; j++) { 
-					if (m_pCostGrid->is_InGrid(iX+i,iY+j)){							     			            		
-						if (m_pCostGrid->is_NoData(iX,iY) || m_pCostGrid->is_NoData(iX+i,iY+j)){				            							            			
-						}//if
-						else{
-							double dPartialCost=CalculateCostInDirection(iX,iY,i,j);
-							dCost = m_pAccCostGrid->asDouble(iX,iY) + dPartialCost* M_GET_LENGTH(i, j);
-							if (m_pAccCostGrid->asDouble(iX+i,iY+j)==NO_DATA){
-								iUsedCells++;
-								m_pAccCostGrid->Set_Value(iX+i,iY+j,dCost);
-								m_AdjPoints.Add(iX+i,iY+j);									
-							}//if
-							else if (m_pAccCostGrid->asDouble(iX+i,iY+j)> dCost + m_dThreshold){
-								m_pAccCostGrid->Set_Value(iX+i,iY+j,dCost);
-								m_AdjPoints.Add(iX+i,iY+j);		            			
-							}//if
-						}//else			            	       		
-					}//if           	                
-				}// for
-			}// for
-		}//for
+	if (!Accumulator.Create(m_pCostGrid, m_pAccCostGrid, NULL, pBacklink)){
+		return false;
+	}//if
 
+	Accumulator.Set_Anisotropy(m_pDirectionGrid, Parameters("K")->asDouble());
+	Accumulator.Set_Threshold(Parameters("THRESHOLD")->asDouble());
+	Accumulator.Set_Max_Cost(Parameters("MAXCOST")->asDouble());
 
-		m_CentralPoints.Clear();
-		for (int i=0; i<m_AdjPoints.Get_Count(); i++){
-			iX = m_AdjPoints.Get_X(i);
-			iY = m_AdjPoints.Get_Y(i);
-			m_CentralPoints.Add(iX,iY);
+	for(int y=0; y<Get_NY(); y++){		
+		for(int x=0; x<Get_NX(); x++){
+			if (!m_pPointsGrid->is_NoData(x,y)){
+				Accumulator.Add_Source(x,y);
+			}//if
 		}//for
-		m_AdjPoints.Clear();
-		DataObject_Update(m_pAccCostGrid, true);
-
-		Set_Progress((double)iUsedCells,(double)iTotalCells);
-
-	}//while
-
-}//method
-
-
-double CCost_Anisotropic::CalculateCostInDirection(int iX,
-											  int iY,
-											  int iH,
-											  int iV){
-
-	double dAngles[3][3] = {{315,0,45},{270,0,90},{225,180,135}};
-	double PI=3.14159;
-	
-	double dAngle = dAngles[iV+1][iH+1];
-
-	double dDifAngle1 = fabs(m_pDirectionGrid->asDouble(iX,iY)-dAngle);
-	double dDifAngle2 = fabs(m_pDirectionGrid->asDouble(iX+iH,iY+iV)-dAngle);
-
-	dDifAngle1 = dDifAngle1/360.0 * 2.0 * PI;
-	dDifAngle2 = dDifAngle2/360.0 * 2.0 * PI;
+	}//for
 	
-	double dCost1 = pow(cos(dDifAngle1),m_dK)/2;
-	double dCost2 = pow(cos(dDifAngle2),m_dK)/2;
-
-	return dCost1+dCost2;
+	return Accumulator.Run();
 
 }//method
@@ -22,7 +22,7 @@
 #ifndef HEADER_INCLUDED__Cost_Anisotropic_H
 #define HEADER_INCLUDED__Cost_Anisotropic_H
 
-#include "MLB_Interface.h"
+#include "Cost_Accumulator.h"
 
 class CCost_Anisotropic : public CSG_Module_Grid
 {
@@ -41,20 +41,11 @@ protected:
 
 private:
 
-	double					m_dK;
-	double					m_dThreshold;
-
-	CSG_Points_Int			m_CentralPoints;
-	CSG_Points_Int			m_AdjPoints;
-
 	CSG_Grid					*m_pCostGrid;
 	CSG_Grid					*m_pDirectionGrid;
 	CSG_Grid					*m_pPointsGrid;	
 	CSG_Grid					*m_pAccCostGrid;
 
-	void					CalculateCost				(void);
-	double					CalculateCostInDirection	(int,int,int,int);
-
 };
 
 #endif // #ifndef HEADER_INCLUDED__Cost_Anisotropic_H
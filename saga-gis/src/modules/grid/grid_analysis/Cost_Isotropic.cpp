@@ -60,12 +60,36 @@ CCost_Isotropic::CCost_Isotropic(void)
 						true, 
 						SG_DATATYPE_Int);
 
+	Parameters.Add_Grid(NULL, 
+						"BACKLINK", 
+						_TL("Back Links"), 
+						_TL("Direction to the next cell on the least cost path towards the closest point (0 = north, clockwise in steps of 45 degrees)."), 
+						PARAMETER_OUTPUT_OPTIONAL, 
+						true, 
+						SG_DATATYPE_Char);
+
+	Parameters.Add_Choice(NULL,
+						"METHOD",
+						_TL("Method"),
+						_TL("Dijkstra's algorithm accumulates the cost along the eight neighbour connections. Fast marching solves the eikonal equation, which gives smoother, direction independent cost distances."),
+						CSG_String::Format("%s|%s|",
+							_TL("Dijkstra"),
+							_TL("Fast Marching")
+						), 0);
+
 	Parameters.Add_Value(NULL,
 						"THRESHOLD",
 						_TL("Threshold for different route"),
 						_TL(""),
 						PARAMETER_TYPE_Double,
 						0.);
+
+	Parameters.Add_Value(NULL,
+						"MAXCOST",
+						_TL("Maximum Cost"),
+						_TL("Cells with a higher accumulated cost are not processed. Ignored if zero."),
+						PARAMETER_TYPE_Double,
+						0., 0., true);
 }
 
 CCost_Isotropic::~CCost_Isotropic(void)
@@ -77,95 +101,38 @@ bool CCost_Isotropic::On_Execute(void)
 	
 	int iPoint = 1;
 
-	m_dThreshold = Parameters("THRESHOLD")->asDouble();
-
 	m_pAccCostGrid = Parameters("ACCCOST")->asGrid(); 
 	m_pCostGrid = Parameters("COST")->asGrid(); 
 	m_pClosestPtGrid = Parameters("CLOSESTPT")->asGrid(); 
 	m_pPointsGrid = Parameters("POINTS")->asGrid(); 
-	
-	m_pAccCostGrid->Assign(NO_DATA);
-	m_pClosestPtGrid->Assign(NO_DATA);
+
+	CSG_Grid *pBacklink = Parameters("BACKLINK")->asGrid();
 
 	m_pAccCostGrid->Set_NoData_Value(NO_DATA);
 	m_pClosestPtGrid->Set_NoData_Value(NO_DATA);
 
-	m_CentralPoints.Clear();
-	m_AdjPoints.Clear();
+	if (pBacklink){
+		pBacklink->Set_NoData_Value(NO_DATA);
+	}//if
+
+	CCost_Accumulator Accumulator;
 
-	m_CentralPoints.Clear();				
+	if (!Accumulator.Create(m_pCostGrid, m_pAccCostGrid, m_pClosestPtGrid, pBacklink)){
+		return false;
+	}//if
+
+	Accumulator.Set_Threshold(Parameters("THRESHOLD")->asDouble());
+	Accumulator.Set_Max_Cost(Parameters("MAXCOST")->asDouble());
 
 	for(int y=0; y<Get_NY(); y++){		
 		for(int x=0; x<Get_NX(); x++){
 			if (!m_pPointsGrid->is_NoData(x,y)){				
-				m_CentralPoints.Add(x,y,iPoint);
-				m_pAccCostGrid->Set_Value(x,y,0.0);
-				m_pClosestPtGrid->Set_Value(x,y,iPoint);
+				Accumulator.Add_Source(x,y,iPoint);
 				iPoint++;
 			}//if
 		}//for
 	}//for
 
-	CalculateCost();
-
-	return true;
+	return Accumulator.Run(Parameters("METHOD")->asInt() == 1);
 
 }//method
-
-void CCost_Isotropic::CalculateCost(){
-    
-    double dCost=0;
-	int iPoint;
-	int iX,iY;
-	int iUsedCells=0;
-	int iTotalCells=Get_NX()*Get_NY();
-	
-	while (m_CentralPoints.Get_Count()!=0){
-        
-		for (int iPt=0; iPt<m_CentralPoints.Get_Count();iPt++){	        
-	    
-			iX=m_CentralPoints.Get_X(iPt);
-			iY=m_CentralPoints.Get_Y(iPt);
-			iPoint = m_CentralPoints.Get_ClosestPoint(iPt);
-
-			for (int i = -1; i < 2; i++) {        
-				for (int j = -1; j < 2; j++) { 
-					if (m_pCostGrid->is_InGrid(iX+i,iY+j)){							     			            		
-						if (m_pCostGrid->is_NoData(iX,iY) || m_pCostGrid->is_NoData(iX+i,iY+j)){				            							            			
-						}//if
-						else{
-							double dPartialCost=(m_pCostGrid->asDouble(iX,iY)+m_pCostGrid->asDouble(iX+i,iY+j))/2.0;
-							dCost = m_pAccCostGrid->asDouble(iX,iY) + dPartialCost * M_GET_LENGTH(i, j);					
-							if (m_pAccCostGrid->asDouble(iX+i,iY+j)==NO_DATA || 
-									m_pAccCostGrid->asDouble(iX+i,iY+j)>dCost + m_dThreshold){								
-								m_pAccCostGrid->Set_Value(iX+i,iY+j,dCost);
-								m_pClosestPtGrid->Set_Value(iX+i,iY+j,iPoint);
-								m_AdjPoints.Add(iX+i,iY+j,iPoint);	
-								iUsedCells++;								
-							}//if							
-						}//else			            	       		
-					}//if 
-				}// for
-			}// for
-		}//for
-
-		m_CentralPoints.Clear();
-		for (int i=0; i<m_AdjPoints.Get_Count(); i++){
-			iX = m_AdjPoints.Get_X(i);
-			iY = m_AdjPoints.Get_Y(i);
-			iPoint = m_AdjPoints.Get_ClosestPoint(i);
-			m_CentralPoints.Add(iX,iY, iPoint);
-		}//for
-		m_AdjPoints.Clear();
-		
-		//DataObject_Update(m_pAccCostGrid, true); 
-
-		Set_Progress((double)iUsedCells,(double)iTotalCells);
-
-	}//while
-
-
-	
-}//method
-
-
@@ -23,7 +23,7 @@
 #define HEADER_INCLUDED__Cost_Isotropic_H
 
 #include "MLB_Interface.h"
-#include "PointsEx.h"
+#include "Cost_Accumulator.h"
 
 class CCost_Isotropic : public CSG_Module_Grid
 {
@@ -42,19 +42,11 @@ protected:
 
 private:
 
-	double					m_dThreshold;
-
-	CPointsEx				m_CentralPoints;
-	CPointsEx				m_AdjPoints;
-
 	CSG_Grid					*m_pCostGrid;
 	CSG_Grid					*m_pPointsGrid;	
 	CSG_Grid					*m_pAccCostGrid;
 	CSG_Grid					*m_pClosestPtGrid;
 
-
-	void					CalculateCost	(void);
-	
 };
 
 #endif // #ifndef HEADER_INCLUDED__Cost_Isotropic_H
@@ -95,6 +95,13 @@ CLeastCostPathProfile::CLeastCostPathProfile(void)
 		PARAMETER_INPUT
 	);
 
+	Parameters.Add_Grid(
+		NULL, "BACKLINK"	, 
+		_TL("Back Links"),
+		_TL("If the back links of the accumulated cost calculation are supplied, the path follows these instead of the steepest descent of the accumulated cost."),
+		PARAMETER_INPUT_OPTIONAL
+	);
+
 	Parameters.Add_Grid_List(
 		NULL, 
 		"VALUES", 
@@ -136,6 +143,7 @@ CLeastCostPathProfile::~CLeastCostPathProfile(void)
 bool CLeastCostPathProfile::On_Execute(void)
 {
 	m_pDEM		= Parameters("DEM")		->asGrid();
+	m_pBacklink	= Parameters("BACKLINK")->asGrid();
 	m_pValues	= Parameters("VALUES")	->asGridList();
 	m_pPoints	= Parameters("POINTS")	->asShapes();
 	m_pLine		= Parameters("LINE")	->asShapes();
@@ -238,6 +246,16 @@ void CLeastCostPathProfile::getNextCell(CSG_Grid *g,
     float fMaxSlope;
     float fSlope;
 
+	if( m_pBacklink )	// follow the back links of the accumulated cost calculation
+	{
+		int	i	= m_pBacklink->is_InGrid(iX, iY) ? m_pBacklink->asInt(iX, iY) : -1;
+
+		iNextX	= i < 0 ? iX : Get_xTo(i, iX);
+		iNextY	= i < 0 ? iY : Get_yTo(i, iY);
+
+		return;
+	}
+
     fMaxSlope = 0;
     fSlope = 0;
 
@@ -93,7 +93,7 @@ private:
 
 	CSG_Shapes						*m_pPoints, *m_pLine;
 
-	CSG_Grid						*m_pDEM;
+	CSG_Grid						*m_pDEM, *m_pBacklink;
 
 	CSG_Parameter_Grid_List		*m_pValues;
 
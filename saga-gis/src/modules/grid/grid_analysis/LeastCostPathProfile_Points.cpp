@@ -111,6 +111,13 @@ CLeastCostPathProfile_Points::CLeastCostPathProfile_Points(void)
 		PARAMETER_INPUT
 	);
 
+	Parameters.Add_Grid(
+		NULL, "BACKLINK"	, 
+		_TL("Back Links"),
+		_TL("If the back links of the accumulated cost calculation are supplied, the paths follow these instead of the steepest descent of the accumulated cost."),
+		PARAMETER_INPUT_OPTIONAL
+	);
+
 	Parameters.Add_Grid_List(
 		NULL, 
 		"VALUES", 
@@ -158,6 +165,7 @@ bool CLeastCostPathProfile_Points::On_Execute(void)
 
 	pSources		= Parameters("SOURCE")	->asShapes();
 	m_pDEM			= Parameters("DEM")		->asGrid();
+	m_pBacklink		= Parameters("BACKLINK")->asGrid();
 	m_pValues		= Parameters("VALUES")	->asGridList();
 	pShapesPoints	= Parameters("POINTS")	->asShapesList();
 	pShapesLine		= Parameters("LINE")	->asShapesList();
@@ -243,6 +251,16 @@ void CLeastCostPathProfile_Points::getNextCell(CSG_Grid *g,	int iX,	int iY,	int
     float	fMaxSlope	= 0;
     float	fSlope		= 0;
 
+	if( m_pBacklink )	// follow the back links of the accumulated cost calculation
+	{
+		int	i	= m_pBacklink->is_InGrid(iX, iY) ? m_pBacklink->asInt(iX, iY) : -1;
+
+		iNextX	= i < 0 ? iX : Get_xTo(i, iX);
+		iNextY	= i < 0 ? iY : Get_yTo(i, iY);
+
+		return;
+	}
+
     if( iX<1 || iX>=g->Get_NX()-1 || iY<1 || iY>=g->Get_NY()-1 || g->is_NoData(iX,iY) )
 	{
         iNextX = iX;
@@ -89,7 +89,7 @@ protected:
 
 private:
 
-	CSG_Grid					*m_pDEM;
+	CSG_Grid					*m_pDEM, *m_pBacklink;
 
 	CSG_Parameter_Grid_List		*m_pValues;
 
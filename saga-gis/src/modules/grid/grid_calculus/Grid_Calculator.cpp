@@ -59,26 +59,9 @@
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-#include <float.h>
-
 #include "Grid_Calculator.h"
 
 
-///////////////////////////////////////////////////////////
-//														 //
-//                                                       //
-//														 //
-///////////////////////////////////////////////////////////
-
-//---------------------------------------------------------
-#if defined(_SAGA_LINUX)
-bool _finite(double val)
-{
-	return( true );
-}
-#endif
-
-
 ///////////////////////////////////////////////////////////
 //														 //
 //                                                       //
@@ -277,52 +260,83 @@ bool CGrid_Calculator::On_Execute(void)
 		+ (bPosition[3] ? 1 : 0);
 
 	//-----------------------------------------------------
+	// input grids are read row by row, each row is then
+	// evaluated in chunks by the vectorized formula...
+
+	int	nGrids	= pGrids->Get_Count(), nXGrids = pXGrids->Get_Count();
+
+	CSG_Matrix	Rows(Get_NX(), nValues > 0 ? nValues : 1);
+	CSG_Vector	Results(Get_NX());
+
+	bool	*bNoData	= (bool *)SG_Malloc((nGrids + 1) * Get_NX() * sizeof(bool));
+	bool	*bResult	= bNoData + nGrids * Get_NX();
+
+	int	iCol = -1, iRow = -1, iXPos = -1, iYPos = -1, n = nGrids + nXGrids;
+
+	if( bPosition[0] )	iCol	= n++;
+	if( bPosition[1] )	iRow	= n++;
+	if( bPosition[2] )	iXPos	= n++;
+	if( bPosition[3] )	iYPos	= n++;
+
+	for(int x=0; x<Get_NX(); x++)
+	{
+		if( iCol  >= 0 )	Rows[iCol ][x]	= x;							// col()
+		if( iXPos >= 0 )	Rows[iXPos][x]	= Get_XMin() + x * Get_Cellsize();	// xpos()
+	}
+
+	const int	Chunk	= 1024;
+
 	for(int y=0; y<Get_NY() && Set_Progress(y); y++)
 	{
 		double	py	= Get_YMin() + y * Get_Cellsize();
 
+		for(int i=0; i<nGrids; i++)
+		{
+			pGrids->asGrid(i)->Get_Row(y, Rows[i], true, bNoData + i * Get_NX());
+		}
+
 		#pragma omp parallel for
 		for(int x=0; x<Get_NX(); x++)
 		{
-			bool		bOkay	= true;
-			int			i, n	= 0;
-			double		Result, px	= Get_XMin() + x * Get_Cellsize();
-			CSG_Vector	Values(nValues);
+			if( iRow  >= 0 )	Rows[iRow ][x]	=  y;	// row()
+			if( iYPos >= 0 )	Rows[iYPos][x]	= py;	// ypos()
 
-			for(i=0; bOkay && i<pGrids->Get_Count() ; i++, n++)
+			bool	bOkay	= true;
+			int		i;
+			double	px	= Get_XMin() + x * Get_Cellsize();
+
+			for(i=0; bOkay && i<nGrids; i++)
 			{
-				if( (bOkay = bUseNoData || !pGrids->asGrid(i)->is_NoData(x, y)) == true )
-				{
-					Values[n]	= pGrids->asGrid(i)->asDouble(x, y);
-				}
+				bOkay	= bUseNoData || !bNoData[i * Get_NX() + x];
 			}
 
-			for(i=0; bOkay && i<pXGrids->Get_Count(); i++, n++)
+			for(i=0; bOkay && i<nXGrids; i++)
 			{
-				bOkay	= pXGrids->asGrid(i)->Get_Value(px, py, Values[n], Interpol);
+				bOkay	= pXGrids->asGrid(i)->Get_Value(px, py, Rows[nGrids + i][x], Interpol);
 			}
 
-			if( bOkay )
-			{
-				if( bPosition[0] )	Values[n++]	=  x;	// col()
-				if( bPosition[1] )	Values[n++]	=  y;	// row()
-				if( bPosition[2] )	Values[n++]	= px;	// xpos()
-				if( bPosition[3] )	Values[n++]	= py;	// ypos()
+			bResult[x]	= !bOkay;
+		}
 
-				bOkay	= _finite(Result = Formula.Get_Value(Values)) != 0;
-			}
+		#pragma omp parallel for
+		for(int x=0; x<Get_NX(); x+=Chunk)
+		{
+			int				nInputs		= M_GET_MIN(nValues, 26);	// formula variables 'a' to 'z'
+			const double	*Inputs[26];
 
-			if( bOkay )
+			for(int i=0; i<nInputs; i++)
 			{
-				pResult->Set_Value(x, y, Result);
-			}
-			else
-			{
-				pResult->Set_NoData(x, y);
+				Inputs[i]	= Rows[i] + x;
 			}
+
+			Formula.Get_Values(Inputs, nInputs, Results.Get_Data() + x, M_GET_MIN(Chunk, Get_NX() - x), bResult + x);
 		}
+
+		pResult->Set_Row(y, Results.Get_Data(), true, bResult);
 	}
 
+	SG_Free(bNoData);
+
 	//-----------------------------------------------------
 	return( true );
 }
@@ -165,82 +165,51 @@ bool CFilter::On_Execute(void)
 	//-----------------------------------------------------
 	int	Method	= Parameters("METHOD")->asInt();
 
-	m_Kernel.Set_Radius(Parameters("RADIUS")->asInt(), Parameters("MODE")->asInt() == 0);
+	CSG_Grid	Mean, *pMean	= Method == 0 ? pResult : &Mean;
 
-	for(int y=0; y<Get_NY() && Set_Progress(y); y++)
+	if( pMean == &Mean && !Mean.Create(*Get_System(), SG_DATATYPE_Double) )	// full precision for the difference to the input
 	{
-		#pragma omp parallel for
-		for(int x=0; x<Get_NX(); x++)
-		{
-			double	Mean;
+		Error_Set(_TL("failed to allocate memory"));
+
+		return( false );
+	}
+
+	if( !SG_Grid_Filter_Mean(m_pInput, pMean, Parameters("RADIUS")->asInt(), Parameters("MODE")->asInt() == 0) )
+	{
+		return( false );
+	}
 
-			if( Get_Mean(x, y, Mean) )
+	//-----------------------------------------------------
+	if( Method != 0 )
+	{
+		for(int y=0; y<Get_NY() && Set_Progress(y); y++)
+		{
+			#pragma omp parallel for
+			for(int x=0; x<Get_NX(); x++)
 			{
-				switch( Method )
+				if( Mean.is_NoData(x, y) )
+				{
+					pResult->Set_NoData(x, y);
+				}
+				else switch( Method )
 				{
-				default:	// Smooth...
-					pResult->Set_Value(x, y, Mean);
-					break;
-
 				case  1:	// Sharpen...
-					pResult->Set_Value(x, y, m_pInput->asDouble(x, y) + (m_pInput->asDouble(x, y) - Mean));
+					pResult->Set_Value(x, y, m_pInput->asDouble(x, y) + (m_pInput->asDouble(x, y) - Mean.asDouble(x, y)));
 					break;
 
-				case  2:	// Edge...
-					pResult->Set_Value(x, y, m_pInput->asDouble(x, y) - Mean);
+				default:	// Edge...
+					pResult->Set_Value(x, y, m_pInput->asDouble(x, y) - Mean.asDouble(x, y));
 					break;
 				}
 			}
-			else
-			{
-				pResult->Set_NoData(x, y);
-			}
 		}
 	}
 
-	m_Kernel.Destroy();
-
 	//-----------------------------------------------------
 	return( true );
 }
 
 
-///////////////////////////////////////////////////////////
-//														 //
-//														 //
-//														 //
-///////////////////////////////////////////////////////////
-
-//---------------------------------------------------------
-bool CFilter::Get_Mean(int x, int y, double &Value)
-{
-	CSG_Simple_Statistics	s;
-
-	if( m_pInput->is_InGrid(x, y) )
-	{
-		for(int i=0; i<m_Kernel.Get_Count(); i++)
-		{
-			int	ix	= m_Kernel.Get_X(i, x);
-			int	iy	= m_Kernel.Get_Y(i, y);
-
-			if( m_pInput->is_InGrid(ix, iy) )
-			{
-				s	+= m_pInput->asDouble(ix, iy);
-			}
-		}
-	}
-
-	if( s.Get_Count() > 0 )
-	{
-		Value	= s.Get_Mean();
-
-		return( true );
-	}
-
-	return( false );
-}
-
-
 ///////////////////////////////////////////////////////////
 //														 //
 //														 //
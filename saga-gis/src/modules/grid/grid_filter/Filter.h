@@ -96,13 +96,8 @@ protected:
 
 private:
 
-	CSG_Grid_Cell_Addressor	m_Kernel;
-
 	CSG_Grid				*m_pInput;
 
-
-	bool					Get_Mean		(int x, int y, double &Value);
-
 };
 
 
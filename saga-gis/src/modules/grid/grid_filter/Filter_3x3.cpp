@@ -193,40 +193,60 @@ bool CFilter_3x3::On_Execute(void)
 	}
 
 	//-----------------------------------------------------
+	// row-wise access, input rows y - dy ... y + dy are kept
+	// in Values with their no-data flags in bNoData...
+
+	CSG_Matrix	Values(Get_NX(), Filter.Get_NY());
+	CSG_Vector	Result(Get_NX());
+
+	bool	*bNoData	= (bool *)SG_Malloc((Filter.Get_NY() + 1) * Get_NX() * sizeof(bool));
+	bool	*bResult	= bNoData + Filter.Get_NY() * Get_NX();
+
 	for(int y=0; y<Get_NY() && Set_Progress(y); y++)
 	{
+		for(int iy=0, jy=y-dy; iy<Filter.Get_NY(); iy++, jy++)
+		{
+			if( !pInput->Get_Row(jy, Values[iy], true, bNoData + iy * Get_NX()) )
+			{
+				memset(bNoData + iy * Get_NX(), true, Get_NX() * sizeof(bool));
+			}
+		}
+
 		#pragma omp parallel for
 		for(int x=0; x<Get_NX(); x++)
 		{
 			double	s	= 0.0;
 			double	n	= 0.0;
 
-			if( pInput->is_InGrid(x, y) )
+			if( !bNoData[dy * Get_NX() + x] )
 			{
-				for(int iy=0, jy=y-dy; iy<Filter.Get_NY(); iy++, jy++)
+				for(int iy=0; iy<Filter.Get_NY(); iy++)
 				{
+					double	*pValues	= Values[iy];
+					bool	*pNoData	= bNoData + iy * Get_NX();
+
 					for(int ix=0, jx=x-dx; ix<Filter.Get_NX(); ix++, jx++)
 					{
-						if( pInput->is_InGrid(jx, jy) )
+						if( jx >= 0 && jx < Get_NX() && !pNoData[jx] )
 						{
-							s	+= Filter[iy][ix] * pInput->asDouble(jx, jy);
+							s	+= Filter[iy][ix] * pValues[jx];
 							n	+= fabs(Filter[iy][ix]);
 						}
 					}
 				}
 			}
 
-			if( n > 0.0 )
-			{
-				pResult->Set_Value(x, y, bAbsolute ? s : s / n);
-			}
-			else
+			if( (bResult[x] = n <= 0.0) == false )
 			{
-				pResult->Set_NoData(x, y);
+				Result[x]	= bAbsolute ? s : s / n;
 			}
 		}
+
+		pResult->Set_Row(y, Result.Get_Data(), true, bResult);
 	}
 
+	SG_Free(bNoData);
+
 	//-----------------------------------------------------
 	if( !Parameters("RESULT")->asGrid() || Parameters("RESULT")->asGrid() == pInput )
 	{
@@ -85,6 +85,13 @@ CFilter_Gauss::CFilter_Gauss(void)
 		"and remove detail and noise.\n"
 		"The degree of smoothing is determined by the standard deviation.\n"
 		"For higher standard deviations you need a greater Radius\n"
+		"The recursive mode approximates the Gaussian with an infinite impulse response "
+		"filter, which does not need a search radius and runs at constant speed for any "
+		"standard deviation.\n"
+		"\n"
+		"References:\n"
+		"Young, I.T. & van Vliet, L.J. (1995): Recursive implementation of the Gaussian filter. "
+		"Signal Processing, 44: 139-151.\n"
 	));
 
 
@@ -112,9 +119,10 @@ CFilter_Gauss::CFilter_Gauss(void)
 	Parameters.Add_Choice(
 		NULL, "MODE"		, _TL("Search Mode"),
 		_TL(""),
-		CSG_String::Format(SG_T("%s|%s|"),
+		CSG_String::Format(SG_T("%s|%s|%s|"),
 			_TL("Square"),
-			_TL("Circle")
+			_TL("Circle"),
+			_TL("Recursive")
 		), 1
 	);
 
@@ -151,7 +159,7 @@ bool CFilter_Gauss::On_Execute(void)
 	Sigma		= Parameters("SIGMA")	->asDouble();
 
 	//-----------------------------------------------------
-	if( Initialise(Radius, Sigma, Mode) )
+	if( Mode == 2 || Initialise(Radius, Sigma, Mode) )
 	{
 		if( !pResult || pResult == m_pInput )
 		{
@@ -165,20 +173,50 @@ bool CFilter_Gauss::On_Execute(void)
 		}
 
 		//-------------------------------------------------
-		for(int y=0; y<Get_NY() && Set_Progress(y); y++)
+		bool	bResult	= true;
+
+		switch( Mode )
 		{
-			#pragma omp parallel for
-			for(int x=0; x<Get_NX(); x++)
+		case 0:	// square kernels are separable
+			bResult	= SG_Grid_Filter_Gaussian(m_pInput, pResult, Sigma, Radius);
+			break;
+
+		case 1:
+			for(int y=0; y<Get_NY() && Set_Progress(y); y++)
 			{
-				if( m_pInput->is_InGrid(x, y) )
-				{
-					pResult->Set_Value(x, y, Get_Mean(x, y));
-				}
-				else
+				#pragma omp parallel for
+				for(int x=0; x<Get_NX(); x++)
 				{
-					pResult->Set_NoData(x, y);
+					if( m_pInput->is_InGrid(x, y) )
+					{
+						pResult->Set_Value(x, y, Get_Mean(x, y));
+					}
+					else
+					{
+						pResult->Set_NoData(x, y);
+					}
 				}
 			}
+			break;
+
+		case 2:
+			bResult	= SG_Grid_Filter_Gaussian_Recursive(m_pInput, pResult, Sigma);
+			break;
+		}
+
+		//-------------------------------------------------
+		if( !bResult )
+		{
+			if( pResult != Parameters("RESULT")->asGrid() )
+			{
+				delete(pResult);
+			}
+
+			m_Weights.Destroy();
+
+			Error_Set(_TL("Gaussian filter failed"));
+
+			return( false );
 		}
 
 		//-------------------------------------------------
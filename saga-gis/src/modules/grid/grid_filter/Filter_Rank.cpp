@@ -61,6 +61,9 @@
 //---------------------------------------------------------
 #include "Filter_Rank.h"
 
+#include <algorithm>
+#include <vector>
+
 
 ///////////////////////////////////////////////////////////
 //														 //
@@ -152,7 +155,18 @@ bool CFilter_Rank::On_Execute(void)
 	}
 
 	//-----------------------------------------------------
-	for(int y=0; y<Get_NY() && Set_Progress(y); y++)
+	if( Parameters("MODE")->asInt() == 0 && (Rank <= 0.0 || Rank >= 1.0) )	// minimum or maximum
+	{
+		if( !SG_Grid_Filter_Extreme(m_pInput, pResult, Parameters("RADIUS")->asInt(), Rank >= 1.0) )
+		{
+			m_Kernel.Destroy();
+
+			Error_Set(_TL("rank filter failed"));
+
+			return( false );
+		}
+	}
+	else for(int y=0; y<Get_NY() && Set_Progress(y); y++)
 	{
 		#pragma omp parallel for
 		for(int x=0; x<Get_NX(); x++)
@@ -193,9 +207,9 @@ bool CFilter_Rank::Get_Value(int x, int y, double Rank, double &Value)
 {
 	if( m_pInput->is_InGrid(x, y) )
 	{
-		CSG_Table	Values;
+		std::vector<double>	Values;
 
-		Values.Add_Field(SG_T("Z"), SG_DATATYPE_Double);
+		Values.reserve(m_Kernel.Get_Count());
 
 		for(int i=0; i<m_Kernel.Get_Count(); i++)
 		{
@@ -204,36 +218,38 @@ bool CFilter_Rank::Get_Value(int x, int y, double Rank, double &Value)
 
 			if( m_pInput->is_InGrid(ix, iy) )
 			{
-				Values.Add_Record()->Set_Value(0, m_pInput->asDouble(ix, iy));
+				Values.push_back(m_pInput->asDouble(ix, iy));
 			}
 		}
 
-		switch( Values.Get_Count() )
+		int	n	= (int)Values.size();
+
+		switch( n )
 		{
 		case 0:
 			return( false );
 
 		case 1:
-			Value	= Values[0].asDouble(0);
+			Value	= Values[0];
 			return( true );
 
 		case 2:
-			Value	= (Values[0].asDouble(0) + Values[1].asDouble(0)) / 2.0;
+			Value	= (Values[0] + Values[1]) / 2.0;
 			return( true );
 
 		default:
 			{
-				Values.Set_Index(0, TABLE_INDEX_Ascending);
-
-				Rank	= Rank * (Values.Get_Count() - 1.0);
+				Rank	= Rank * (n - 1.0);
 
 				int	i	= (int)Rank;
 
-				Value	= Values.Get_Record_byIndex(i)->asDouble(0);
+				std::nth_element(Values.begin(), Values.begin() + i, Values.end());	// no need to sort it all
+
+				Value	= Values[i];
 
-				if( Rank - i > 0.0 && i < Values.Get_Count() - 1 )
+				if( Rank - i > 0.0 && i < n - 1 )
 				{
-					Value	= (Value + Values.Get_Record_byIndex(i + 1)->asDouble(0)) / 2.0;
+					Value	= (Value + *std::min_element(Values.begin() + i + 1, Values.end())) / 2.0;
 				}
 			}
 
@@ -61,6 +61,10 @@
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "Interpolation.h"
 
 
@@ -71,8 +75,16 @@
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-CInterpolation::CInterpolation(void)
+/**
+  * If bParallel is true, Get_Value() is expected to be thread-safe
+  * and is called in parallel for the cells of each row. Each thread
+  * passes its own search selection buffer, which is created once
+  * before the row loop and reused for all cells.
+*/
+CInterpolation::CInterpolation(bool bParallel)
 {
+	m_bParallel	= bParallel;
+
 	CSG_Parameter	*pNode	= Parameters.Add_Shapes(
 		NULL	, "SHAPES"		, _TL("Points"),
 		_TL(""),
@@ -158,14 +170,28 @@ bool CInterpolation::Interpolate(void)
 {
 	if( On_Initialize() )
 	{
-		int		ix, iy;
-		double	x, y, z;
+		#ifdef _OPENMP
+		CSG_Array	*Selection	= new CSG_Array[m_bParallel ? omp_get_max_threads() : 1];
+		#else
+		CSG_Array	*Selection	= new CSG_Array[1];
+		#endif
 
-		for(iy=0, y=m_pGrid->Get_YMin(); iy<m_pGrid->Get_NY() && Set_Progress(iy, m_pGrid->Get_NY()); iy++, y+=m_pGrid->Get_Cellsize())
+		for(int iy=0; iy<m_pGrid->Get_NY() && Set_Progress(iy, m_pGrid->Get_NY()); iy++)
 		{
-			for(ix=0, x=m_pGrid->Get_XMin(); ix<m_pGrid->Get_NX(); ix++, x+=m_pGrid->Get_Cellsize())
+			double	y	= m_pGrid->Get_YMin() + iy * m_pGrid->Get_Cellsize();
+
+			#pragma omp parallel for if(m_bParallel)
+			for(int ix=0; ix<m_pGrid->Get_NX(); ix++)
 			{
-				if( Get_Value(x, y, z) )
+				#ifdef _OPENMP
+				CSG_Array	&Buffer	= Selection[m_bParallel ? omp_get_thread_num() : 0];
+				#else
+				CSG_Array	&Buffer	= Selection[0];
+				#endif
+
+				double	z, x	= m_pGrid->Get_XMin() + ix * m_pGrid->Get_Cellsize();
+
+				if( Get_Value(x, y, z, Buffer) )
 				{
 					m_pGrid->Set_Value(ix, iy, z);
 				}
@@ -176,6 +202,8 @@ bool CInterpolation::Interpolate(void)
 			}
 		}
 
+		delete[](Selection);
+
 		On_Finalize();
 
 		return( true );
@@ -85,7 +85,7 @@
 class grid_gridding_EXPORT CInterpolation : public CSG_Module
 {
 public:
-	CInterpolation(void);
+	CInterpolation(bool bParallel = false);
 
 	virtual CSG_String			Get_MenuPath			(void)	{	return( _TL("R:Interpolation from Points") );	}
 
@@ -111,12 +111,15 @@ protected:
 	virtual bool				On_Finalize				(void)							{	return( true );	}
 
 	virtual bool				Get_Value				(double x, double y, double &z)	{	return( true );	}
+	virtual bool				Get_Value				(double x, double y, double &z, CSG_Array &Selection)	{	return( Get_Value(x, y, z) );	}
 
 	CSG_Shapes *				Get_Points				(bool bOnlyNonPoints = false);
 
 
 private:
 
+	bool						m_bParallel;
+
 	CSG_Parameters_Grid_Target	m_Grid_Target;
 
 };
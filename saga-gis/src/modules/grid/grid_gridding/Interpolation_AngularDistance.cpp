@@ -72,6 +72,7 @@
 
 //---------------------------------------------------------
 CInterpolation_AngularDistance::CInterpolation_AngularDistance(void)
+	: CInterpolation(true)
 {
 	//-----------------------------------------------------
 	Set_Name		(_TL("Angular Distance Weighted"));
@@ -159,10 +160,18 @@ bool CInterpolation_AngularDistance::On_Finalize(void)
 
 //---------------------------------------------------------
 bool CInterpolation_AngularDistance::Get_Value(double x, double y, double &z)
+{
+	CSG_Array	Selection;
+
+	return( Get_Value(x, y, z, Selection) );
+}
+
+//---------------------------------------------------------
+bool CInterpolation_AngularDistance::Get_Value(double x, double y, double &z, CSG_Array &Selection)
 {
 	int		i, j, n;
 
-	if( (n = m_Search.Set_Location(x, y)) <= 0 )
+	if( (n = m_Search.Set_Location(x, y, Selection)) <= 0 )
 	{
 		return( false );
 	}
@@ -172,7 +181,7 @@ bool CInterpolation_AngularDistance::Get_Value(double x, double y, double &z)
 
 	for(i=0; i<n; i++)
 	{
-		m_Search.Get_Point(i, X[i], Y[i], Z[i]);
+		m_Search.Get_Point(Selection, i, X[i], Y[i], Z[i]);
 
 		D[i]	= SG_Get_Distance(x, y, X[i], Y[i]);
 		W[i]	= m_Weighting.Get_Weight(D[i]);
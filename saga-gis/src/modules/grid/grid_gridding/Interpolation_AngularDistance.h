@@ -97,6 +97,7 @@ protected:
 	virtual bool			On_Finalize				(void);
 
 	virtual bool			Get_Value				(double x, double y, double &z);
+	virtual bool			Get_Value				(double x, double y, double &z, CSG_Array &Selection);
 
 
 private:
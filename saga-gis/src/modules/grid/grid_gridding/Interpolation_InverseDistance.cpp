@@ -72,6 +72,7 @@
 
 //---------------------------------------------------------
 CInterpolation_InverseDistance::CInterpolation_InverseDistance(void)
+	: CInterpolation(true)
 {
 	//-----------------------------------------------------
 	Set_Name		(_TL("Inverse Distance Weighted"));
@@ -155,7 +156,15 @@ bool CInterpolation_InverseDistance::On_Finalize(void)
 //---------------------------------------------------------
 bool CInterpolation_InverseDistance::Get_Value(double x, double y, double &z)
 {
-	int		n	= m_Search.Set_Location(x, y);
+	CSG_Array	Selection;
+
+	return( Get_Value(x, y, z, Selection) );
+}
+
+//---------------------------------------------------------
+bool CInterpolation_InverseDistance::Get_Value(double x, double y, double &z, CSG_Array &Selection)
+{
+	int		n	= m_Search.Set_Location(x, y, Selection);
 
 	if( n <= 0 )
 	{
@@ -169,7 +178,7 @@ bool CInterpolation_InverseDistance::Get_Value(double x, double y, double &z)
 
 	for(int i=0; i<n; i++)
 	{
-		if( m_Search.Get_Point(i, ix, iy, z) )
+		if( m_Search.Get_Point(Selection, i, ix, iy, z) )
 		{
 			if( (w = m_Weighting.Get_Weight(SG_Get_Distance(x, y, ix, iy))) < 0.0 )
 			{
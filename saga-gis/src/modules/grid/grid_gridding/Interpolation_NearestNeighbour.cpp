@@ -72,6 +72,7 @@
 
 //---------------------------------------------------------
 CInterpolation_NearestNeighbour::CInterpolation_NearestNeighbour(void)
+	: CInterpolation(true)
 {
 	Set_Name		(_TL("Nearest Neighbour"));
 
@@ -74,6 +74,15 @@
 #define X_WORLD_TO_GRID(X)	(((X) - m_pGrid->Get_XMin()) / m_pGrid->Get_Cellsize())
 #define Y_WORLD_TO_GRID(Y)	(((Y) - m_pGrid->Get_YMin()) / m_pGrid->Get_Cellsize())
 
+//---------------------------------------------------------
+typedef struct
+{
+	int		Index;
+
+	double	Value;
+}
+TS2G_Shape;
+
 
 ///////////////////////////////////////////////////////////
 //														 //
@@ -92,7 +101,9 @@ CShapes2Grid::CShapes2Grid(void)
 	Set_Author		(SG_T("O.Conrad (c) 2003"));
 
 	Set_Description	(_TW(
-		"Gridding of a shapes layer. If some shapes are selected, only these will be gridded."
+		"Gridding of a shapes layer. If some shapes are selected, only these will be gridded. "
+		"Polygons are rasterized with a scanline algorithm, optionally reporting the percentage "
+		"of each cell's area that is covered by polygons."
 	));
 
 
@@ -165,6 +176,7 @@ CShapes2Grid::CShapes2Grid(void)
 
 	m_Grid_Target.Add_Grid("GRID" , _TL("Grid")            , false);
 	m_Grid_Target.Add_Grid("COUNT", _TL("Number of Values"), true);
+	m_Grid_Target.Add_Grid("COVERAGE", _TL("Coverage"), true);
 }
 
 
@@ -192,6 +204,7 @@ int CShapes2Grid::On_Parameters_Enable(CSG_Parameters *pParameters, CSG_Paramete
 	{
 		pParameters->Set_Enabled("LINE_TYPE", pParameter->asShapes() && pParameter->asShapes()->Get_Type() == SHAPE_TYPE_Line);
 		pParameters->Set_Enabled("POLY_TYPE", pParameter->asShapes() && pParameter->asShapes()->Get_Type() == SHAPE_TYPE_Polygon);
+		pParameters->Set_Enabled("COVERAGE_CREATE", pParameter->asShapes() && pParameter->asShapes()->Get_Type() == SHAPE_TYPE_Polygon);
 	}
 
 	if(	!SG_STR_CMP(pParameter->Get_Identifier(), SG_T("OUTPUT")) )
@@ -294,8 +307,21 @@ bool CShapes2Grid::On_Execute(void)
 	m_pCount->Set_NoData_Value(0.0);
 	m_pCount->Assign(0.0);
 
+	//-------------------------------------------------
+	m_pCoverage	= m_pShapes->Get_Type() == SHAPE_TYPE_Polygon ? m_Grid_Target.Get_Grid("COVERAGE", SG_DATATYPE_Float) : NULL;
+
+	if( m_pCoverage )
+	{
+		m_pCoverage->Set_Name(CSG_String::Format("%s [%s]", m_pShapes->Get_Name(), _TL("Coverage")));
+		m_pCoverage->Set_Unit(SG_T("%"));
+		m_pCoverage->Set_NoData_Value(0.0);
+		m_pCoverage->Assign(0.0);
+	}
+
 	//-----------------------------------------------------
-	for(int iShape=0; iShape<m_pShapes->Get_Count() && Set_Progress(iShape, m_pShapes->Get_Count()); iShape++)
+	CSG_Array	Shapes(sizeof(TS2G_Shape), 0, SG_ARRAY_GROWTH_1);
+
+	for(int iShape=0; iShape<m_pShapes->Get_Count(); iShape++)
 	{
 		CSG_Shape	*pShape	= m_pShapes->Get_Shape(iShape);
 
@@ -303,45 +329,65 @@ bool CShapes2Grid::On_Execute(void)
 		{
 			if( iField < 0 || !pShape->is_NoData(iField) )
 			{
-				m_Value	= iField >= 0 ? pShape->asDouble(iField) : iField == -2 ? iShape + 1 : 1;
-
-				if( pShape->Intersects(m_pGrid->Get_Extent()) )
+				if( pShape->Intersects(m_pGrid->Get_Extent()) && Shapes.Inc_Array() )
 				{
-					switch( m_pShapes->Get_Type() )
-					{
-					case SHAPE_TYPE_Point:	case SHAPE_TYPE_Points:
-						Set_Points	(pShape);
-						break;
-
-					case SHAPE_TYPE_Line:
-						Set_Line	(pShape);
-						break;
-
-					case SHAPE_TYPE_Polygon:
-						Set_Polygon	(pShape);
-
-						if( m_Method_Polygon == 1 )	// all cells intersected have to be marked
-						{
-							Set_Line(pShape);	// thick, each cell crossed by polygon boundary will be marked additionally
-						}
-						break;
-					}
+					TS2G_Shape	&Shape	= ((TS2G_Shape *)Shapes.Get_Array())[Shapes.Get_Size() - 1];
+
+					Shape.Index	= iShape;
+					Shape.Value	= iField >= 0 ? pShape->asDouble(iField) : iField == -2 ? iShape + 1 : 1;
 				}
 			}
 		}
 	}
 
 	//-----------------------------------------------------
-	if( m_Method_Multi == 4 )	// mean
+	if( m_pShapes->Get_Type() == SHAPE_TYPE_Polygon )
+	{
+		Set_Polygons(Shapes);
+	}
+	else
+	{
+		TBand	Band;
+
+		Band.yMin	= 0;
+		Band.yMax	= m_pGrid->Get_NY() - 1;
+
+		for(int i=0; i<(int)Shapes.Get_Size() && Set_Progress(i, (int)Shapes.Get_Size()); i++)
+		{
+			TS2G_Shape	&Shape	= ((TS2G_Shape *)Shapes.Get_Array())[i];
+
+			Band.Value	= Shape.Value;
+
+			switch( m_pShapes->Get_Type() )
+			{
+			default:
+				Set_Points	(m_pShapes->Get_Shape(Shape.Index), Band);
+				break;
+
+			case SHAPE_TYPE_Line:
+				Set_Line	(m_pShapes->Get_Shape(Shape.Index), Band);
+				break;
+			}
+		}
+	}
+
+	//-----------------------------------------------------
+	if( m_Method_Multi == 4 || m_pCoverage )	// mean, coverage of overlapping polygons
 	{
 		for(int y=0; y<m_pGrid->Get_NY() && Set_Progress(y, m_pGrid->Get_NY()); y++)
 		{
+			#pragma omp parallel for
 			for(int x=0; x<m_pGrid->Get_NX(); x++)
 			{
-				if( m_pCount->asInt(x, y) > 1 )
+				if( m_Method_Multi == 4 && m_pCount->asInt(x, y) > 1 )
 				{
 					m_pGrid->Mul_Value(x, y, 1.0 / m_pCount->asDouble(x, y));
 				}
+
+				if( m_pCoverage && m_pCoverage->asDouble(x, y) > 100.0 )
+				{
+					m_pCoverage->Set_Value(x, y, 100.0);
+				}
 			}
 		}
 	}
@@ -360,13 +406,13 @@ bool CShapes2Grid::On_Execute(void)
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-inline void CShapes2Grid::Set_Value(int x, int y)
+inline void CShapes2Grid::Set_Value(int x, int y, const TBand &Band)
 {
-	if( m_pGrid->is_InGrid(x, y, false) )
+	if( y >= Band.yMin && y <= Band.yMax && m_pGrid->is_InGrid(x, y, false) )
 	{
 		if( m_pCount->asInt(x, y) == 0 )
 		{
-			m_pGrid->Set_Value(x, y, m_Value);
+			m_pGrid->Set_Value(x, y, Band.Value);
 		}
 		else switch( m_Method_Multi )
 		{
@@ -374,25 +420,25 @@ inline void CShapes2Grid::Set_Value(int x, int y)
 			break;
 
 		case 1:	// last
-			m_pGrid->Set_Value(x, y, m_Value);
+			m_pGrid->Set_Value(x, y, Band.Value);
 			break;
 
 		case 2:	// minimum
-			if( m_pGrid->asDouble(x, y) > m_Value )
+			if( m_pGrid->asDouble(x, y) > Band.Value )
 			{
-				m_pGrid->Set_Value(x, y, m_Value);
+				m_pGrid->Set_Value(x, y, Band.Value);
 			}
 			break;
 
 		case 3:	// maximum
-			if( m_pGrid->asDouble(x, y) < m_Value )
+			if( m_pGrid->asDouble(x, y) < Band.Value )
 			{
-				m_pGrid->Set_Value(x, y, m_Value);
+				m_pGrid->Set_Value(x, y, Band.Value);
 			}
 			break;
 
 		case 4:	// mean
-			m_pGrid->Add_Value(x, y, m_Value);
+			m_pGrid->Add_Value(x, y, Band.Value);
 			break;
 		}
 
@@ -408,7 +454,7 @@ inline void CShapes2Grid::Set_Value(int x, int y)
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-void CShapes2Grid::Set_Points(CSG_Shape *pShape)
+void CShapes2Grid::Set_Points(CSG_Shape *pShape, const TBand &Band)
 {
 	for(int iPart=0; iPart<pShape->Get_Part_Count(); iPart++)
 	{
@@ -418,7 +464,8 @@ void CShapes2Grid::Set_Points(CSG_Shape *pShape)
 
 			Set_Value(
 				(int)(0.5 + X_WORLD_TO_GRID(p.x)),
-				(int)(0.5 + Y_WORLD_TO_GRID(p.y))
+				(int)(0.5 + Y_WORLD_TO_GRID(p.y)),
+				Band
 			);
 		}
 	}
@@ -432,7 +479,7 @@ void CShapes2Grid::Set_Points(CSG_Shape *pShape)
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-void CShapes2Grid::Set_Line(CSG_Shape *pShape)
+void CShapes2Grid::Set_Line(CSG_Shape *pShape, const TBand &Band)
 {
 	TSG_Point	a, b;
 
@@ -451,15 +498,15 @@ void CShapes2Grid::Set_Line(CSG_Shape *pShape)
 
 			switch( m_Method_Lines )
 			{
-			case 0:	Set_Line_A(a, b);	break;
-			case 1:	Set_Line_B(a, b);	break;
+			case 0:	Set_Line_A(a, b, Band);	break;
+			case 1:	Set_Line_B(a, b, Band);	break;
 			}
 		}
 	}
 }
 
 //---------------------------------------------------------
-void CShapes2Grid::Set_Line_A(TSG_Point a, TSG_Point b)
+void CShapes2Grid::Set_Line_A(TSG_Point a, TSG_Point b, const TBand &Band)
 {
 	double			ix, iy, sig;
 	double			dx, dy;
@@ -484,7 +531,7 @@ void CShapes2Grid::Set_Line_A(TSG_Point a, TSG_Point b)
 
 			for(ix=0; ix<=dx; ix++, a.x+=sig, a.y+=dy)
 			{
-				Set_Value((int)a.x, (int)a.y);
+				Set_Value((int)a.x, (int)a.y, Band);
 			}
 		}
 		else if( fabs(dy) >= fabs(dx) && dy != 0 )
@@ -495,18 +542,18 @@ void CShapes2Grid::Set_Line_A(TSG_Point a, TSG_Point b)
 
 			for(iy=0; iy<=dy; iy++, a.x+=dx, a.y+=sig)
 			{
-				Set_Value((int)a.x, (int)a.y);
+				Set_Value((int)a.x, (int)a.y, Band);
 			}
 		}
 	}
 	else
 	{
-		Set_Value(A.x, A.y);
+		Set_Value(A.x, A.y, Band);
 	}
 }
 
 /*/---------------------------------------------------------
-void CShapes2Grid::Set_Line_A(TSG_Point a, TSG_Point b)
+void CShapes2Grid::Set_Line_A(TSG_Point a, TSG_Point b, const TBand &Band)
 {
 	TSG_Point_Int	A, B;
 
@@ -531,7 +578,7 @@ void CShapes2Grid::Set_Line_A(TSG_Point a, TSG_Point b)
 
 			for(t=A.y; A.x!=B.x; A.x+=d, t+=m)
 			{
-				Set_Value(A.x, (int)t);
+				Set_Value(A.x, (int)t, Band);
 			}
 		}
 		else // if( fabs(dy) >= fabs(dx) )
@@ -541,18 +588,18 @@ void CShapes2Grid::Set_Line_A(TSG_Point a, TSG_Point b)
 
 			for(t=A.x; A.y!=B.y; A.y+=d, t+=m)
 			{
-				Set_Value((int)t, A.y);
+				Set_Value((int)t, A.y, Band);
 			}
 		}
 	}
 	else
 	{
-		Set_Value(A.x, A.y);
+		Set_Value(A.x, A.y, Band);
 	}
 }/**/
 
 //---------------------------------------------------------
-void CShapes2Grid::Set_Line_B(TSG_Point a, TSG_Point b)
+void CShapes2Grid::Set_Line_B(TSG_Point a, TSG_Point b, const TBand &Band)
 {
 	int				ix, iy;
 	double			e, d, dx, dy;
@@ -563,7 +610,7 @@ void CShapes2Grid::Set_Line_B(TSG_Point a, TSG_Point b)
 	B.x	= (int)(b.x	+= 0.5);
 	B.y	= (int)(b.y	+= 0.5);
 
-	Set_Value(A.x, A.y);
+	Set_Value(A.x, A.y, Band);
 
 	//-----------------------------------------------------
 	if( A.x != B.x || A.y != B.y )
@@ -588,14 +635,14 @@ void CShapes2Grid::Set_Line_B(TSG_Point a, TSG_Point b)
 			{
 				e	-= 1.0;
 				A.y	+= iy;
-				Set_Value(A.x, A.y);
+				Set_Value(A.x, A.y, Band);
 			}
 
 			while( A.x != B.x )
 			{
 				A.x	+= ix;
 				e	+= d;
-				Set_Value(A.x, A.y);
+				Set_Value(A.x, A.y, Band);
 
 				if( A.x != B.x )
 				{
@@ -603,7 +650,7 @@ void CShapes2Grid::Set_Line_B(TSG_Point a, TSG_Point b)
 					{
 						e	-= 1.0;
 						A.y	+= iy;
-						Set_Value(A.x, A.y);
+						Set_Value(A.x, A.y, Band);
 					}
 				}
 			}
@@ -615,7 +662,7 @@ void CShapes2Grid::Set_Line_B(TSG_Point a, TSG_Point b)
 				while( A.y != B.y )
 				{
 					A.y	+= iy;
-					Set_Value(A.x, A.y);
+					Set_Value(A.x, A.y, Band);
 				}
 			}
 		}
@@ -634,14 +681,14 @@ void CShapes2Grid::Set_Line_B(TSG_Point a, TSG_Point b)
 			{
 				e	-= 1.0;
 				A.x	+= ix;
-				Set_Value(A.x, A.y);
+				Set_Value(A.x, A.y, Band);
 			}
 
 			while( A.y != B.y )
 			{
 				A.y	+= iy;
 				e	+= d;
-				Set_Value(A.x, A.y);
+				Set_Value(A.x, A.y, Band);
 
 				if( A.y != B.y )
 				{
@@ -649,7 +696,7 @@ void CShapes2Grid::Set_Line_B(TSG_Point a, TSG_Point b)
 					{
 						e	-= 1.0;
 						A.x	+= ix;
-						Set_Value(A.x, A.y);
+						Set_Value(A.x, A.y, Band);
 					}
 				}
 			}
@@ -661,7 +708,7 @@ void CShapes2Grid::Set_Line_B(TSG_Point a, TSG_Point b)
 				while( A.x != B.x )
 				{
 					A.x	+= ix;
-					Set_Value(A.x, A.y);
+					Set_Value(A.x, A.y, Band);
 				}
 			}
 		}
@@ -676,126 +723,374 @@ void CShapes2Grid::Set_Line_B(TSG_Point a, TSG_Point b)
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-void CShapes2Grid::Set_Polygon(CSG_Shape *pShape)
+typedef struct
 {
-	Set_Polygon_Node((CSG_Shape_Polygon *)pShape);
+	double	xa, ya, yb, dxdy;	// lower end point and upper y in grid coordinates
+
+	double	Sign;				// winding direction, lakes inverted
+
+	int		yFirst;				// first row band touched
 }
+TS2G_Edge;
 
 //---------------------------------------------------------
-void CShapes2Grid::Set_Polygon_Node(CSG_Shape_Polygon *pPolygon)
+static int S2G_Compare_Edges(const void *a, const void *b)
 {
-	bool		bFill, *bCrossing;
-	int			x, y, xStart, xStop;
-	TSG_Point	A, B, a, b, c;
-	CSG_Rect	Extent;
+	return( ((const TS2G_Edge *)a)->yFirst - ((const TS2G_Edge *)b)->yFirst );
+}
 
-	//-----------------------------------------------------
-	bCrossing	= (bool *)SG_Malloc(m_pGrid->Get_NX() * sizeof(bool));
+//---------------------------------------------------------
+/**
+  * Accumulates the signed area that an edge section within a
+  * single row leaves to its right. Cells span [x, x + 1), the
+  * running sum along the row then gives the cells' coverage.
+  * Parts of the section beyond the west or east border of the
+  * grid are added as vertical segments on the border, so that
+  * the slope of the remaining part is kept.
+*/
+static void S2G_Add_Coverage(double *Coverage, int nx, double xa, double xb, double d)
+{
+	if( xa < 0.0 || xb < 0.0 || xa > nx || xb > nx )
+	{
+		double	dx	= xb - xa, t0 = 0.0, t1 = 1.0;	// section within the grid in terms of the edge parameter t
 
-	Extent		= pPolygon->Get_Extent();
+		if( dx != 0.0 )
+		{
+			double	tw	= (0.0 - xa) / dx, te = (nx - xa) / dx;
 
-	xStart		= (int)((Extent.m_rect.xMin - m_pGrid->Get_XMin()) / m_pGrid->Get_Cellsize()) - 1;
-	if( xStart < 0 )
-		xStart	= 0;
+			t0	= M_GET_MAX(0.0, M_GET_MIN(tw, te));
+			t1	= M_GET_MIN(1.0, M_GET_MAX(tw, te));
+		}
+		else
+		{
+			t1	= 0.0;	// vertical, completely outside
+		}
 
-	xStop		= (int)((Extent.m_rect.xMax - m_pGrid->Get_XMin()) / m_pGrid->Get_Cellsize()) + 1;
-	if( xStop >= m_pGrid->Get_NX() )
-		xStop	= m_pGrid->Get_NX() - 1;
+		if( t0 >= t1 )	// no part within the grid
+		{
+			Coverage[xa + 0.5 * dx < 0.0 ? 0 : nx]	+= d;
 
-	A.x			= m_pGrid->Get_XMin() - 1.0;
-	B.x			= m_pGrid->Get_XMax() + 1.0;
+			return;
+		}
+
+		if( t0 > 0.0 )	// leading part outside
+		{
+			Coverage[xa + 0.5 * t0 * dx < 0.0 ? 0 : nx]	+= d * t0;
+		}
+
+		if( t1 < 1.0 )	// trailing part outside
+		{
+			Coverage[xa + 0.5 * (1.0 + t1) * dx < 0.0 ? 0 : nx]	+= d * (1.0 - t1);
+		}
+
+		xb	= xa + t1 * dx;
+		xa	= xa + t0 * dx;
+		d	= d * (t1 - t0);
+	}
+
+	xa	= xa < 0.0 ? 0.0 : xa > nx ? nx : xa;	// rounding
+	xb	= xb < 0.0 ? 0.0 : xb > nx ? nx : xb;
+
+	double	x0	= xa < xb ? xa : xb;
+	double	x1	= xa < xb ? xb : xa;
+
+	int		x0i	= (int)floor(x0);
+	int		x1i	= (int)ceil (x1);
+
+	if( x1i <= x0i + 1 )	// within one cell
+	{
+		double	xm	= 0.5 * (xa + xb) - x0i;
+
+		Coverage[x0i    ]	+= d - d * xm;
+		Coverage[x0i + 1]	+=     d * xm;
+	}
+	else
+	{
+		double	s	= 1.0 / (x1 - x0);
+		double	x0f	= x0 - x0i;
+		double	x1f	= x1 - x1i + 1.0;
+		double	a0	= 0.5 * s * (1.0 - x0f) * (1.0 - x0f);
+		double	am	= 0.5 * s * x1f * x1f;
+
+		Coverage[x0i]	+= d * a0;
+
+		if( x1i == x0i + 2 )
+		{
+			Coverage[x0i + 1]	+= d * (1.0 - a0 - am);
+		}
+		else
+		{
+			double	a1	= s * (1.5 - x0f);
+
+			Coverage[x0i + 1]	+= d * (a1 - a0);
+
+			for(int x=x0i+2; x<x1i-1; x++)
+			{
+				Coverage[x]	+= d * s;
+			}
+
+			Coverage[x1i - 1]	+= d * (1.0 - (a1 + (x1i - x0i - 3) * s) - am);
+		}
+
+		Coverage[x1i]	+= d * am;
+	}
+}
+
+//---------------------------------------------------------
+/**
+  * The grid rows are split into bands, each of which is owned
+  * by one thread and receives the shapes in their original
+  * order, so the multiple value methods give the same results
+  * as a sequential run.
+*/
+void CShapes2Grid::Set_Polygons(const CSG_Array &Shapes)
+{
+	int	nShapes	= (int)Shapes.Get_Size();
+	int	nBands	= M_GET_MIN(m_pGrid->Get_NY(), 4 * SG_Get_Max_Num_Threads_Omp());
+	int	nChunk	= M_GET_MAX(1, nShapes / 100);
+
+	TS2G_Shape	*pShapes	= (TS2G_Shape *)Shapes.Get_Array();
 
 	//-----------------------------------------------------
-	for(y=0, A.y=m_pGrid->Get_YMin(); y<m_pGrid->Get_NY(); y++, A.y+=m_pGrid->Get_Cellsize())
+	for(int iFirst=0; iFirst<nShapes && Set_Progress(iFirst, nShapes); iFirst+=nChunk)
 	{
-		if( A.y >= Extent.m_rect.yMin && A.y <= Extent.m_rect.yMax )
+		int	iLast	= M_GET_MIN(nShapes, iFirst + nChunk);
+
+		for(int i=iFirst; i<iLast; i++)	// update cached extents and ring properties before going parallel
 		{
-			B.y	= A.y;
+			CSG_Shape_Polygon	*pPolygon	= (CSG_Shape_Polygon *)m_pShapes->Get_Shape(pShapes[i].Index);
 
-			memset(bCrossing, 0, m_pGrid->Get_NX() * sizeof(bool));
+			pPolygon->Get_Extent();
 
 			for(int iPart=0; iPart<pPolygon->Get_Part_Count(); iPart++)
 			{
-				if( pPolygon->Get_Part(iPart)->Get_Extent().Intersects(m_pGrid->Get_Extent(true)) )
+				pPolygon->Get_Part(iPart)->Get_Extent();
+
+				if( m_pCoverage )
+				{
+					pPolygon->is_Lake(iPart);
+					pPolygon->is_Clockwise(iPart);
+				}
+			}
+		}
+
+		//-------------------------------------------------
+		#pragma omp parallel for schedule(dynamic)
+		for(int iBand=0; iBand<nBands; iBand++)
+		{
+			TBand	Band;
+
+			Band.yMin	= (int)(((sLong)m_pGrid->Get_NY() * (iBand    )) / nBands);
+			Band.yMax	= (int)(((sLong)m_pGrid->Get_NY() * (iBand + 1)) / nBands) - 1;
+
+			double	yMin	= m_pGrid->Get_YMin() + (Band.yMin - 0.5) * m_pGrid->Get_Cellsize();
+			double	yMax	= m_pGrid->Get_YMin() + (Band.yMax + 0.5) * m_pGrid->Get_Cellsize();
+
+			CSG_Array	Edges    (sizeof(TS2G_Edge), 0, SG_ARRAY_GROWTH_1);
+			CSG_Array	Active   (sizeof(int      ), 0, SG_ARRAY_GROWTH_1);
+			CSG_Array	Crossings(sizeof(double   ), 0, SG_ARRAY_GROWTH_1);
+
+			double	*Coverage	= m_pCoverage ? (double *)SG_Malloc((m_pGrid->Get_NX() + 2) * sizeof(double)) : NULL;
+
+			for(int i=iFirst; i<iLast; i++)
+			{
+				CSG_Shape_Polygon	*pPolygon	= (CSG_Shape_Polygon *)m_pShapes->Get_Shape(pShapes[i].Index);
+
+				if( pPolygon->Get_Extent().Get_YMax() >= yMin && pPolygon->Get_Extent().Get_YMin() <= yMax )
 				{
-					b	= pPolygon->Get_Point(pPolygon->Get_Point_Count(iPart) - 1, iPart);
+					Band.Value	= pShapes[i].Value;
+
+					Set_Polygon(pPolygon, Band, Edges, Active, Crossings, Coverage);
 
-					for(int iPoint=0; iPoint<pPolygon->Get_Point_Count(iPart); iPoint++)
+					if( m_Method_Polygon == 1 )	// all cells intersected have to be marked
 					{
-						a	= b;
-						b	= pPolygon->Get_Point(iPoint, iPart);
-
-						if(	((a.y <= A.y && A.y  < b.y)
-						||	 (a.y  > A.y && A.y >= b.y)) )
-						{
-							SG_Get_Crossing(c, a, b, A, B, false);
-
-							x	= (int)(1.0 + X_WORLD_TO_GRID(c.x));
-
-							if( x < 0 )
-							{
-								x	= 0;
-							}
-							else if( x >= m_pGrid->Get_NX() )
-							{
-								continue;
-							}
-
-							bCrossing[x]	= !bCrossing[x];
-						}
+						Set_Line(pPolygon, Band);	// thick, each cell crossed by polygon boundary will be marked additionally
 					}
 				}
 			}
 
-			//---------------------------------------------
-			for(x=xStart, bFill=false; x<=xStop; x++)
+			SG_FREE_SAFE(Coverage);
+		}
+	}
+}
+
+//---------------------------------------------------------
+/**
+  * Scanline rasterization with an edge table sorted by the
+  * first row and a list of active edges. Cells are filled by
+  * the even-odd rule for their centres, the coverage is taken
+  * from the edges' signed area within each row.
+*/
+void CShapes2Grid::Set_Polygon(CSG_Shape_Polygon *pPolygon, const TBand &Band, CSG_Array &Edges, CSG_Array &Active, CSG_Array &Crossings, double *Coverage)
+{
+	const CSG_Rect	&Extent	= pPolygon->Get_Extent();
+
+	int	yA	= (int)floor(Y_WORLD_TO_GRID(Extent.Get_YMin()) + 0.5)    ;	if( yA < Band.yMin )	yA	= Band.yMin;
+	int	yB	= (int)ceil (Y_WORLD_TO_GRID(Extent.Get_YMax()) + 0.5) - 1;	if( yB > Band.yMax )	yB	= Band.yMax;
+	int	xA	= (int)floor(X_WORLD_TO_GRID(Extent.Get_XMin()) + 0.5)    ;	if( xA < 0                  )	xA	= 0;
+	int	xB	= (int)ceil (X_WORLD_TO_GRID(Extent.Get_XMax()) + 0.5) - 1;	if( xB >= m_pGrid->Get_NX() )	xB	= m_pGrid->Get_NX() - 1;
+
+	if( yA > yB || xA > xB )
+	{
+		return;
+	}
+
+	//-----------------------------------------------------
+	Edges.Set_Array(0, false);
+
+	for(int iPart=0; iPart<pPolygon->Get_Part_Count(); iPart++)
+	{
+		CSG_Shape_Part	*pPart	= pPolygon->Get_Part(iPart);
+
+		if( pPart->Get_Count() < 3
+		||	Y_WORLD_TO_GRID(pPart->Get_Extent().Get_YMax()) <= yA - 0.5
+		||	Y_WORLD_TO_GRID(pPart->Get_Extent().Get_YMin()) >= yB + 0.5 )
+		{
+			continue;
+		}
+
+		double	Sign	= !Coverage ? 1.0 : (pPolygon->is_Clockwise(iPart) ? 1.0 : -1.0) * (pPolygon->is_Lake(iPart) ? -1.0 : 1.0);
+
+		TSG_Point	a, b	= pPart->Get_Point(pPart->Get_Count() - 1);
+
+		b.x	= X_WORLD_TO_GRID(b.x);
+		b.y	= Y_WORLD_TO_GRID(b.y);
+
+		for(int iPoint=0; iPoint<pPart->Get_Count(); iPoint++)
+		{
+			a	= b;
+			b	= pPart->Get_Point(iPoint);
+			b.x	= X_WORLD_TO_GRID(b.x);
+			b.y	= Y_WORLD_TO_GRID(b.y);
+
+			if( a.y != b.y )
 			{
-				if( bCrossing[x] )
+				TS2G_Edge	e;
+
+				if( a.y < b.y )
+				{
+					e.xa	= a.x;	e.ya	= a.y;	e.yb	= b.y;	e.Sign	=  Sign;
+				}
+				else
 				{
-					bFill	= !bFill;
+					e.xa	= b.x;	e.ya	= b.y;	e.yb	= a.y;	e.Sign	= -Sign;
 				}
 
-				if( bFill )
+				if( e.yb > yA - 0.5 && e.ya < yB + 0.5 && Edges.Inc_Array() )
 				{
-					Set_Value(x, y);
+					e.dxdy		= (b.x - a.x) / (b.y - a.y);
+					e.yFirst	= M_GET_MAX(yA, (int)floor(e.ya + 0.5));
+
+					((TS2G_Edge *)Edges.Get_Array())[Edges.Get_Size() - 1]	= e;
 				}
 			}
 		}
 	}
 
-	//-----------------------------------------------------
-	SG_Free(bCrossing);
-}
+	int	nEdges	= (int)Edges.Get_Size();
 
-//---------------------------------------------------------
-void CShapes2Grid::Set_Polygon_Cell(CSG_Shape_Polygon *pPolygon)
-{
-	//-----------------------------------------------------
-	CSG_Grid_System	s(m_pGrid->Get_System());
+	if( nEdges < 2 )
+	{
+		return;
+	}
 
-	int	xA	= s.Get_xWorld_to_Grid(pPolygon->Get_Extent().Get_XMin());	if( xA <  0          )	xA	= 0;
-	int	xB	= s.Get_xWorld_to_Grid(pPolygon->Get_Extent().Get_XMax());	if( xB >= s.Get_NX() )	xB	= s.Get_NX() - 1;
-	int	yA	= s.Get_yWorld_to_Grid(pPolygon->Get_Extent().Get_YMin());	if( yA <  0          )	yA	= 0;
-	int	yB	= s.Get_yWorld_to_Grid(pPolygon->Get_Extent().Get_YMax());	if( yB >= s.Get_NY() )	yB	= s.Get_NY() - 1;
+	TS2G_Edge	*pEdges	= (TS2G_Edge *)Edges.Get_Array();
 
-	//-----------------------------------------------------
-	TSG_Rect	r;
+	qsort(pEdges, nEdges, sizeof(TS2G_Edge), S2G_Compare_Edges);
 
-	r.yMax	= s.Get_yGrid_to_World(yA) - 0.5 * s.Get_Cellsize();
+	//-----------------------------------------------------
+	Active.Set_Array(0, false);
 
-	for(int y=yA; y<=yB; y++)
+	for(int y=yA, iEdge=0; y<=yB; y++)
 	{
-		r.yMin	= r.yMax;	r.yMax	+= s.Get_Cellsize();
+		int	i, n, *pActive	= (int *)Active.Get_Array();
+
+		for(i=0, n=0; i<(int)Active.Get_Size(); i++)	// drop edges ending below the row
+		{
+			if( pEdges[pActive[i]].yb > y - 0.5 )
+			{
+				pActive[n++]	= pActive[i];
+			}
+		}
 
-		r.xMax	= s.Get_xGrid_to_World(xA) - 0.5 * s.Get_Cellsize();
+		Active.Set_Array(n, false);
 
-		for(int x=xA; x<=xB; x++)
+		for( ; iEdge<nEdges && pEdges[iEdge].yFirst<=y; iEdge++)
 		{
-			r.xMin	= r.xMax;	r.xMax	+= s.Get_Cellsize();
+			if( Active.Inc_Array() )
+			{
+				((int *)Active.Get_Array())[Active.Get_Size() - 1]	= iEdge;
+			}
+		}
+
+		pActive	= (int *)Active.Get_Array();
+		n		= (int)Active.Get_Size();
 
-			if( pPolygon->Intersects(r) )
+		//-------------------------------------------------
+		Crossings.Set_Array(0, false);
+
+		for(i=0; i<n; i++)
+		{
+			TS2G_Edge	&e	= pEdges[pActive[i]];
+
+			if( e.ya <= y && y < e.yb && Crossings.Inc_Array() )
 			{
-				Set_Value(x, y);
+				double	*c	= (double *)Crossings.Get_Array(), x	= e.xa + (y - e.ya) * e.dxdy;
+				int		j	= (int)Crossings.Get_Size() - 1;
+
+				for( ; j>0 && c[j - 1]>x; j--)	// insertion sort, crossings keep their order from row to row
+				{
+					c[j]	= c[j - 1];
+				}
+
+				c[j]	= x;
+			}
+		}
+
+		double	*c	= (double *)Crossings.Get_Array();
+
+		for(i=1; i<(int)Crossings.Get_Size(); i+=2)
+		{
+			int	x	= (int)floor(c[i - 1]) + 1;	if( x < xA )	x	= xA;
+			int	xb	= (int)floor(c[i    ])    ;	if( xb > xB )	xb	= xB;
+
+			for( ; x<=xb; x++)
+			{
+				Set_Value(x, y, Band);
+			}
+		}
+
+		//-------------------------------------------------
+		if( Coverage )
+		{
+			memset(Coverage + xA, 0, (xB - xA + 2) * sizeof(double));
+
+			for(i=0; i<n; i++)
+			{
+				TS2G_Edge	&e	= pEdges[pActive[i]];
+
+				double	ya	= M_GET_MAX(e.ya, y - 0.5);
+				double	yb	= M_GET_MIN(e.yb, y + 0.5);
+
+				if( ya < yb )
+				{
+					S2G_Add_Coverage(Coverage, m_pGrid->Get_NX(),
+						0.5 + e.xa + (ya - e.ya) * e.dxdy,
+						0.5 + e.xa + (yb - e.ya) * e.dxdy, e.Sign * (yb - ya)
+					);
+				}
+			}
+
+			double	Sum	= 0.0;
+
+			for(int x=xA; x<=xB; x++)
+			{
+				double	Cover	= fabs(Sum += Coverage[x]);
+
+				if( Cover > 0.0 )
+				{
+					m_pCoverage->Add_Value(x, y, 100.0 * (Cover < 1.0 ? Cover : 1.0));
+				}
 			}
 		}
 	}
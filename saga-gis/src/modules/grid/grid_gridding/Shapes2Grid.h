@@ -98,30 +98,36 @@ protected:
 
 private:
 
-	int							m_Method_Multi, m_Method_Lines, m_Method_Polygon;
+	typedef struct
+	{
+		int						yMin, yMax;		// rows owned by the band
+
+		double					Value;
+	}
+	TBand;
 
-	double						m_Value;
+
+	int							m_Method_Multi, m_Method_Lines, m_Method_Polygon;
 
 	CSG_Parameters_Grid_Target	m_Grid_Target;
 
-	CSG_Grid					*m_pGrid, *m_pCount, m_Count;
+	CSG_Grid					*m_pGrid, *m_pCount, m_Count, *m_pCoverage;
 
 	CSG_Shapes					*m_pShapes;
 
 
 	TSG_Data_Type				Get_Grid_Type			(int iType);
 
-	void						Set_Value				(int x, int y);
+	void						Set_Value				(int x, int y, const TBand &Band);
 
-	void						Set_Points				(CSG_Shape *pShape);
+	void						Set_Points				(CSG_Shape *pShape, const TBand &Band);
 
-	void						Set_Line				(CSG_Shape *pShape);
-	void						Set_Line_A				(TSG_Point a, TSG_Point b);
-	void						Set_Line_B				(TSG_Point a, TSG_Point b);
+	void						Set_Line				(CSG_Shape *pShape, const TBand &Band);
+	void						Set_Line_A				(TSG_Point a, TSG_Point b, const TBand &Band);
+	void						Set_Line_B				(TSG_Point a, TSG_Point b, const TBand &Band);
 
-	void						Set_Polygon				(CSG_Shape *pShape);
-	void						Set_Polygon_Node		(CSG_Shape_Polygon *pPolygon);
-	void						Set_Polygon_Cell		(CSG_Shape_Polygon *pPolygon);
+	void						Set_Polygons			(const CSG_Array &Shapes);
+	void						Set_Polygon				(CSG_Shape_Polygon *pPolygon, const TBand &Band, CSG_Array &Edges, CSG_Array &Active, CSG_Array &Crossings, double *Coverage);
 
 };
 
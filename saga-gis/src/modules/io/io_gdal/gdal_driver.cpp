@@ -57,6 +57,10 @@
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "gdal_driver.h"
 
 #include <gdal_priv.h>
@@ -267,6 +271,9 @@ bool CSG_GDAL_DataSet::Open_Read(const CSG_String &File_Name)
 	m_NX		= m_pDataSet->GetRasterXSize();
 	m_NY		= m_pDataSet->GetRasterYSize();
 
+	m_xOff		= 0;
+	m_yOff		= 0;
+
 	if( m_pDataSet->GetGeoTransform(Transform) != CE_None )
 	{
 		m_bTransform	= false;
@@ -370,6 +377,9 @@ bool CSG_GDAL_DataSet::Open_Write(const CSG_String &File_Name, const CSG_String
 	m_NX			= m_pDataSet->GetRasterXSize();
 	m_NY			= m_pDataSet->GetRasterYSize();
 
+	m_xOff			= 0;
+	m_yOff			= 0;
+
 	m_bTransform	= false;
 	m_Cellsize		= 1.0;
 	m_xMin			= 0.5;
@@ -664,15 +674,32 @@ bool CSG_GDAL_DataSet::Get_MetaData_Item(int i, const char *pszName, CSG_String
 }
 
 //---------------------------------------------------------
-CSG_Grid * CSG_GDAL_DataSet::Read(int i)
+// Raster data is read and written in tiles, that are aligned to
+// the natural block size of the data set and hold about this
+// number of cells (per band).
+//---------------------------------------------------------
+#define GDAL_TILE_CELLS	(1024 * 1024)
+
+//---------------------------------------------------------
+static inline double	SG_GDAL_Get_Value	(const char *pData, int x, TSG_Data_Type Type)
 {
-	//-------------------------------------------------
-	if( !is_Reading() )
+	switch( Type )
 	{
-		return( NULL );
+	case SG_DATATYPE_Byte  :	return( ((BYTE   *)pData)[x] );
+	case SG_DATATYPE_Char  :	return( ((char   *)pData)[x] );
+	case SG_DATATYPE_Word  :	return( ((WORD   *)pData)[x] );
+	case SG_DATATYPE_Short :	return( ((short  *)pData)[x] );
+	case SG_DATATYPE_DWord :	return( ((DWORD  *)pData)[x] );
+	case SG_DATATYPE_Int   :	return( ((int    *)pData)[x] );
+	case SG_DATATYPE_Float :	return( ((float  *)pData)[x] );
+	case SG_DATATYPE_Double:	return( ((double *)pData)[x] );
+	default:					return( 0.0 );
 	}
+}
 
-	//-------------------------------------------------
+//---------------------------------------------------------
+CSG_Grid * CSG_GDAL_DataSet::_Read_Create(int i)
+{
 	GDALRasterBand	*pBand	= m_pDataSet->GetRasterBand(i + 1);
 
 	if( !pBand )
@@ -683,6 +710,11 @@ CSG_Grid * CSG_GDAL_DataSet::Read(int i)
 	//-------------------------------------------------
 	TSG_Data_Type	Type	= gSG_GDAL_Drivers.Get_SAGA_Type(pBand->GetRasterDataType());
 
+	if( Type == SG_DATATYPE_Undefined )	// complex data types, read the real part
+	{
+		Type	= SG_DATATYPE_Double;
+	}
+
 	CSG_Grid	*pGrid	= SG_Create_Grid(Type, Get_NX(), Get_NY(), Get_Cellsize(), Get_xMin(), Get_yMin());
 
 	if( !pGrid )
@@ -712,26 +744,251 @@ CSG_Grid * CSG_GDAL_DataSet::Read(int i)
 
 	Get_MetaData(i, pGrid->Get_MetaData());
 
-	//-------------------------------------------------
-	double	*zLine	= (double *)SG_Malloc(Get_NX() * sizeof(double));
+	return( pGrid );
+}
+
+//---------------------------------------------------------
+/**
+  * Reads the tile with the given offset and size (in data set
+  * pixel coordinates) of all requested bands in their native
+  * data types and copies it to the grids.
+*/
+bool CSG_GDAL_DataSet::_Read_Tile(GDALDataset *pDataSet, int nBands, const int *Bands, CSG_Grid **ppGrids, int xOff, int yOff, int nx, int ny, CSG_Array &Buffer)
+{
+	int		i, y;
+	bool	bSameType	= true;
+	size_t	nBytes		= 0;
 
-	for(int y=0; y<Get_NY() && SG_UI_Process_Set_Progress(y, Get_NY()); y++)
+	for(i=0; i<nBands; i++)
 	{
-		int	yy	= m_bTransform ? y : Get_NY() - 1 - y;
+		nBytes	+= (size_t)nx * ny * SG_Data_Type_Get_Size(ppGrids[i]->Get_Type());
 
-		if( pBand->RasterIO(GF_Read, 0, y, Get_NX(), 1, zLine, Get_NX(), 1, GDT_Float64, 0, 0) == CE_None )
+		if( ppGrids[i]->Get_Type() != ppGrids[0]->Get_Type() )
 		{
-			for(int x=0; x<Get_NX(); x++)
+			bSameType	= false;
+		}
+	}
+
+	if( Buffer.Get_Size() < nBytes && !Buffer.Set_Array(nBytes) )
+	{
+		return( false );
+	}
+
+	char	*pBuffer	= (char *)Buffer.Get_Array();
+
+	//-----------------------------------------------------
+	if( bSameType && nBands > 1 )	// one request for all bands, decodes pixel interleaved blocks only once
+	{
+		int	*BandMap	= new int[nBands];
+
+		for(i=0; i<nBands; i++)
+		{
+			BandMap[i]	= Bands[i] + 1;
+		}
+
+		CPLErr	Error	= pDataSet->RasterIO(GF_Read, xOff, yOff, nx, ny, pBuffer, nx, ny,
+			(GDALDataType)gSG_GDAL_Drivers.Get_GDAL_Type(ppGrids[0]->Get_Type()), nBands, BandMap, 0, 0, 0
+		);
+
+		delete[](BandMap);
+
+		if( Error != CE_None )
+		{
+			return( false );
+		}
+	}
+	else
+	{
+		for(i=0, nBytes=0; i<nBands; i++)
+		{
+			GDALRasterBand	*pBand	= pDataSet->GetRasterBand(Bands[i] + 1);
+
+			if( !pBand || pBand->RasterIO(GF_Read, xOff, yOff, nx, ny, pBuffer + nBytes, nx, ny,
+				(GDALDataType)gSG_GDAL_Drivers.Get_GDAL_Type(ppGrids[i]->Get_Type()), 0, 0) != CE_None )
 			{
-			//	double	NaN	= 0.0;	NaN	= -1.0 / NaN;	if( NaN == zLine[x] )	pGrid->Set_NoData(x, yy); else
-				pGrid->Set_Value(x, yy, zLine[x], false);
+				return( false );
 			}
+
+			nBytes	+= (size_t)nx * ny * SG_Data_Type_Get_Size(ppGrids[i]->Get_Type());
 		}
 	}
 
-	SG_Free(zLine);
+	//-----------------------------------------------------
+	for(i=0, nBytes=0; i<nBands; i++)
+	{
+		CSG_Grid	*pGrid	= ppGrids[i];
+
+		int	Size	= (int)SG_Data_Type_Get_Size(pGrid->Get_Type());
 
-	return( pGrid );
+		for(y=0; y<ny; y++)
+		{
+			int	yy	= yOff - m_yOff + y;	if( !m_bTransform )	yy	= Get_NY() - 1 - yy;
+
+			char	*pLine	= pBuffer + nBytes + (size_t)y * nx * Size;
+			char	*pRow	= (char *)pGrid->Get_Row_Data(yy);
+
+			if( pRow )
+			{
+				memcpy(pRow + (size_t)(xOff - m_xOff) * Size, pLine, (size_t)nx * Size);
+			}
+			else for(int x=0; x<nx; x++)
+			{
+				pGrid->Set_Value(xOff - m_xOff + x, yy, SG_GDAL_Get_Value(pLine, x, pGrid->Get_Type()), false);
+			}
+		}
+
+		nBytes	+= (size_t)nx * ny * Size;
+	}
+
+	return( true );
+}
+
+//---------------------------------------------------------
+CSG_Grid * CSG_GDAL_DataSet::Read(int i)
+{
+	CSG_Grid	*pGrid;
+
+	return( Read(1, &i, &pGrid) ? pGrid : NULL );
+}
+
+//---------------------------------------------------------
+/**
+  * Reads the bands with the given (zero based) indices into new
+  * grids, which are stored in ppGrids. Reading follows the block
+  * layout of the data set and uses the native data types. Tiles
+  * are decoded concurrently, each thread using its own data set
+  * handle, as long as the grids are held in memory. If any tile
+  * cannot be read, the grids are deleted and false is returned.
+*/
+bool CSG_GDAL_DataSet::Read(int nBands, const int *Bands, CSG_Grid **ppGrids)
+{
+	if( !is_Reading() || nBands < 1 )
+	{
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	int		i;
+	bool	bParallel	= true;
+
+	for(i=0; i<nBands; i++)
+	{
+		if( (ppGrids[i] = _Read_Create(Bands[i])) == NULL )
+		{
+			while( --i >= 0 )
+			{
+				delete(ppGrids[i]);
+			}
+
+			return( false );
+		}
+
+		if( !ppGrids[i]->Get_Row_Data(0) )	// not an array, cell-wise access is not thread-safe
+		{
+			bParallel	= false;
+		}
+	}
+
+	//-----------------------------------------------------
+	int		bx, by;
+
+	m_pDataSet->GetRasterBand(Bands[0] + 1)->GetBlockSize(&bx, &by);
+
+	if( bx < 1 || bx > m_pDataSet->GetRasterXSize() )	bx	= m_pDataSet->GetRasterXSize();
+	if( by < 1 || by > m_pDataSet->GetRasterYSize() )	by	= m_pDataSet->GetRasterYSize();
+
+	int		tx	= bx * M_GET_MAX(1, 1024 / bx);
+	int		ty	= by * (int)M_GET_MAX(1, GDAL_TILE_CELLS / ((sLong)tx * by));
+
+	int		ntx	= (m_xOff + Get_NX() - 1) / tx - m_xOff / tx + 1;
+	int		nty	= (m_yOff + Get_NY() - 1) / ty - m_yOff / ty + 1;
+
+	int		nTiles	= ntx * nty;
+
+	//-----------------------------------------------------
+	int		nThreads	= 1;
+
+	#ifdef _OPENMP
+	if( bParallel )
+	{
+		nThreads	= M_GET_MIN(omp_get_max_threads(), nTiles);
+	}
+	#endif
+
+	GDALDataset	**pDataSets	= new GDALDataset *[nThreads];
+
+	pDataSets[0]	= m_pDataSet;
+
+	for(i=1; i<nThreads; i++)
+	{
+		if( (pDataSets[i] = (GDALDataset *)GDALOpen(m_File_Name, GA_ReadOnly)) == NULL )
+		{
+			nThreads	= i;
+		}
+	}
+
+	CSG_Array	*Buffers	= new CSG_Array[nThreads];
+
+	for(i=0; i<nThreads; i++)
+	{
+		Buffers[i].Create(sizeof(char));
+	}
+
+	//-----------------------------------------------------
+	bool	bOkay	= true;
+
+	for(int iTile=0; iTile<nTiles && bOkay && SG_UI_Process_Set_Progress(iTile, nTiles); iTile+=nThreads)
+	{
+		#pragma omp parallel for num_threads(nThreads)
+		for(int iThread=0; iThread<nThreads; iThread++)
+		{
+			if( iTile + iThread < nTiles )
+			{
+				int	x0	= ((iTile + iThread) % ntx + m_xOff / tx) * tx, x1 = x0 + tx;
+				int	y0	= ((iTile + iThread) / ntx + m_yOff / ty) * ty, y1 = y0 + ty;
+
+				if( x0 < m_xOff            )	x0	= m_xOff;
+				if( x1 > m_xOff + Get_NX() )	x1	= m_xOff + Get_NX();
+				if( y0 < m_yOff            )	y0	= m_yOff;
+				if( y1 > m_yOff + Get_NY() )	y1	= m_yOff + Get_NY();
+
+				if( !_Read_Tile(pDataSets[iThread], nBands, Bands, ppGrids, x0, y0, x1 - x0, y1 - y0, Buffers[iThread]) )
+				{
+					bOkay	= false;
+				}
+			}
+		}
+	}
+
+	//-----------------------------------------------------
+	for(i=1; i<nThreads; i++)
+	{
+		GDALClose(pDataSets[i]);
+	}
+
+	delete[](pDataSets);
+	delete[](Buffers);
+
+	if( !bOkay )
+	{
+		SG_UI_Msg_Add_Error(_TL("Reading dataset failed."));
+
+		for(i=0; i<nBands; i++)
+		{
+			delete(ppGrids[i]);
+
+			ppGrids[i]	= NULL;
+		}
+
+		return( false );
+	}
+
+	for(i=0; i<nBands; i++)
+	{
+		ppGrids[i]->Set_Modified();
+	}
+
+	return( true );
 }
 
 //---------------------------------------------------------
@@ -745,21 +1002,71 @@ bool CSG_GDAL_DataSet::Write(int i, CSG_Grid *pGrid, double noDataValue)
 	GDALRasterBand	*pBand	= m_pDataSet->GetRasterBand(i + 1);
 
 	//-----------------------------------------------------
-	CPLErr	Error	= CE_None;
+	// write strips of the natural block height in the band's
+	// data type, integer grids with matching type are copied
+	// without conversion
+
+	GDALDataType	Type	= pBand->GetRasterDataType();
+
+	int		Size	= GDALGetDataTypeSize(Type) / 8;
 
-	double	*zLine	= (double *)SG_Malloc(Get_NX() * sizeof(double));
+	bool	bRaw	= pGrid->Get_Row_Data(0) && !pGrid->is_Scaled() && gSG_GDAL_Drivers.Get_SAGA_Type(Type) == pGrid->Get_Type()
+		&& pGrid->Get_Type() != SG_DATATYPE_Float && pGrid->Get_Type() != SG_DATATYPE_Double
+		&& pGrid->Get_NoData_Value() == noDataValue && pGrid->Get_NoData_hiValue() == noDataValue;
 
-	for(int y=0, yy=Get_NY()-1; Error==CE_None && y<Get_NY() && SG_UI_Process_Set_Progress(y, Get_NY()); y++, yy--)
+	int		bx, by;
+
+	pBand->GetBlockSize(&bx, &by);
+
+	if( by < 1 || by > Get_NY() )	by	= Get_NY();
+
+	int		ny	= by * (int)M_GET_MAX(1, GDAL_TILE_CELLS / ((sLong)Get_NX() * by));
+
+	char	*pStrip	= (char *)SG_Malloc((size_t)Get_NX() * ny * Size);
+
+	//-----------------------------------------------------
+	CPLErr	Error	= CE_None;
+
+	for(int y0=0; Error==CE_None && y0<Get_NY() && SG_UI_Process_Set_Progress(y0, Get_NY()); y0+=ny)
 	{
-		for(int x=0; x<Get_NX(); x++)
+		int	nRows	= M_GET_MIN(ny, Get_NY() - y0);
+
+		#pragma omp parallel for if(pGrid->Get_Row_Data(0) != NULL)
+		for(int y=0; y<nRows; y++)
 		{
-			zLine[x]	= pGrid->is_NoData(x, yy) ? noDataValue : pGrid->asDouble(x, yy);
+			int		yy		= Get_NY() - 1 - (y0 + y);
+			char	*pLine	= pStrip + (size_t)y * Get_NX() * Size;
+
+			if( bRaw )
+			{
+				memcpy(pLine, pGrid->Get_Row_Data(yy), (size_t)Get_NX() * Size);
+			}
+			else
+			{
+				double	*zLine	= (double *)SG_Malloc(Get_NX() * sizeof(double));
+				bool	*bLine	= (bool   *)SG_Malloc(Get_NX() * sizeof(bool  ));
+
+				pGrid->Get_Row(yy, zLine, true, bLine);
+
+				for(int x=0; x<Get_NX(); x++)
+				{
+					if( bLine[x] )
+					{
+						zLine[x]	= noDataValue;
+					}
+				}
+
+				GDALCopyWords(zLine, GDT_Float64, sizeof(double), pLine, Type, Size, Get_NX());
+
+				SG_Free(zLine);
+				SG_Free(bLine);
+			}
 		}
 
-		Error	= pBand->RasterIO(GF_Write, 0, y, Get_NX(), 1, zLine, Get_NX(), 1, GDT_Float64, 0, 0);
+		Error	= pBand->RasterIO(GF_Write, 0, y0, Get_NX(), nRows, pStrip, Get_NX(), nRows, Type, 0, 0);
 	}
 
-	SG_Free(zLine);
+	SG_Free(pStrip);
 
 	//-----------------------------------------------------
 	if( Error != CE_None )
@@ -816,6 +1123,47 @@ CSG_Grid_System CSG_GDAL_DataSet::Get_System(void)	const
 	return( System );
 }
 
+//---------------------------------------------------------
+/**
+  * Restricts all following read operations to those cells,
+  * whose centers are located within the given extent. Not
+  * supported for data sets that need to be transformed.
+*/
+bool CSG_GDAL_DataSet::Set_Window(const CSG_Rect &Extent)
+{
+	if( !is_Reading() || Needs_Transformation() )
+	{
+		return( false );
+	}
+
+	int	x0	= (int)ceil ((Extent.Get_XMin() - Get_xMin()) / Get_Cellsize());	if( x0 < 0            )	x0	= 0;
+	int	x1	= (int)floor((Extent.Get_XMax() - Get_xMin()) / Get_Cellsize());	if( x1 > Get_NX() - 1 )	x1	= Get_NX() - 1;
+	int	y0	= (int)ceil ((Extent.Get_YMin() - Get_yMin()) / Get_Cellsize());	if( y0 < 0            )	y0	= 0;
+	int	y1	= (int)floor((Extent.Get_YMax() - Get_yMin()) / Get_Cellsize());	if( y1 > Get_NY() - 1 )	y1	= Get_NY() - 1;
+
+	if( x0 > x1 || y0 > y1 )
+	{
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	int	dx	= x0, dy	= Get_NY() - 1 - y1;	// offset in pixel coordinates (top-down)
+
+	m_TF_A[0]	+= dx * m_TF_B[0][0] + dy * m_TF_B[0][1];
+	m_TF_A[1]	+= dx * m_TF_B[1][0] + dy * m_TF_B[1][1];
+
+	m_xOff		+= dx;
+	m_yOff		+= dy;
+
+	m_xMin		+= x0 * Get_Cellsize();
+	m_yMin		+= y0 * Get_Cellsize();
+
+	m_NX		 = 1 + x1 - x0;
+	m_NY		 = 1 + y1 - y0;
+
+	return( true );
+}
+
 
 ///////////////////////////////////////////////////////////
 //														 //
@@ -142,6 +142,8 @@ public:
 	CSG_Rect					Get_Extent			(bool bTransform = true)	const;
 	CSG_Grid_System				Get_System			(void)	const;
 
+	bool						Set_Window			(const CSG_Rect &Extent);
+
 	bool						Needs_Transformation(void)	const	{	return( m_bTransform );	}
 	void						Get_Transformation	(CSG_Vector &A, CSG_Matrix &B)				const	{	A	= m_TF_A;	B	= m_TF_B;	}
 	bool						Get_Transformation	(CSG_Grid_System &System, bool bVerbose)	const;
@@ -167,6 +169,7 @@ public:
 	const char *				Get_MetaData_Item	(int i, const char *pszName)	const;
 	bool						Get_MetaData_Item	(int i, const char *pszName, CSG_String &MetaData)	const;
 	CSG_Grid *					Read				(int i);
+	bool						Read				(int nBands, const int *Bands, CSG_Grid **ppGrids);
 	bool						Write				(int i, CSG_Grid *pGrid, double NoDataValue);
 	bool						Write				(int i, CSG_Grid *pGrid);
 
@@ -175,7 +178,7 @@ private:
 
 	bool						m_bTransform;
 
-	int							m_Access, m_NX, m_NY;
+	int							m_Access, m_NX, m_NY, m_xOff, m_yOff;
 
 	double						m_xMin, m_yMin, m_Cellsize;
 
@@ -188,6 +191,10 @@ private:
 	class GDALDataset			*m_pDataSet;
 
 
+	CSG_Grid *					_Read_Create		(int i);
+	bool						_Read_Tile			(class GDALDataset *pDataSet, int nBands, const int *Bands, CSG_Grid **ppGrids, int xOff, int yOff, int nx, int ny, CSG_Array &Buffer);
+
+
 public:
 
 	bool						to_World			(double x, double y, double &xWorld, double &yWorld)
@@ -144,6 +144,23 @@ CGDAL_Import::CGDAL_Import(void)
 		), 4
 	);
 
+	//-----------------------------------------------------
+	pNode	= Parameters.Add_Value(
+		NULL	, "WINDOW"		, _TL("Window"),
+		_TL("import only those cells that are located within the given extent, not available for rasters that need to be transformed"),
+		PARAMETER_TYPE_Bool, false
+	);
+
+	Parameters.Add_Range(
+		pNode	, "WINDOW_X"	, _TL("West-East"),
+		_TL("")
+	);
+
+	Parameters.Add_Range(
+		pNode	, "WINDOW_Y"	, _TL("South-North"),
+		_TL("")
+	);
+
 	//-----------------------------------------------------
 	Add_Parameters("SELECTION", _TL("Select from Multiple Bands"), _TL(""));
 }
@@ -163,6 +180,12 @@ int CGDAL_Import::On_Parameters_Enable(CSG_Parameters *pParameters, CSG_Paramete
 		pParameters->Get_Parameter("INTERPOL")->Set_Enabled(pParameter->asBool());
 	}
 
+	if(	!SG_STR_CMP(pParameter->Get_Identifier(), "WINDOW") )
+	{
+		pParameters->Get_Parameter("WINDOW_X")->Set_Enabled(pParameter->asBool());
+		pParameters->Get_Parameter("WINDOW_Y")->Set_Enabled(pParameter->asBool());
+	}
+
 	if( !SG_STR_CMP(pParameters->Get_Identifier(), "SELECTION")
 	&&  !SG_STR_CMP(pParameter ->Get_Identifier(), "ALL") && pParameters->Get_Parameter("BANDS") )
 	{
@@ -283,6 +306,22 @@ bool CGDAL_Import::Load(CSG_GDAL_DataSet &DataSet, const CSG_String &Name)
 		return( Load_Sub(DataSet) );
 	}
 
+	//-----------------------------------------------------
+	if( Parameters("WINDOW") && Parameters("WINDOW")->asBool() )
+	{
+		CSG_Rect	Window(
+			Parameters("WINDOW_X")->asRange()->Get_LoVal(), Parameters("WINDOW_Y")->asRange()->Get_LoVal(),
+			Parameters("WINDOW_X")->asRange()->Get_HiVal(), Parameters("WINDOW_Y")->asRange()->Get_HiVal()
+		);
+
+		if( !DataSet.Set_Window(Window) )
+		{
+			Message_Add(_TL("failed: window does not overlap the raster or the raster needs to be transformed"));
+
+			return( false );
+		}
+	}
+
 	//-----------------------------------------------------
 	CSG_Vector	A;
 	CSG_Matrix	B;
@@ -301,7 +340,7 @@ bool CGDAL_Import::Load(CSG_GDAL_DataSet &DataSet, const CSG_String &Name)
 	Message_Add("\n", false);
 
 	//-----------------------------------------------------
-	int			i, n;
+	int			i;
 	CSG_Table	Bands;
 
 	Bands.Add_Field("NAME", SG_DATATYPE_String);
@@ -362,50 +401,59 @@ bool CGDAL_Import::Load(CSG_GDAL_DataSet &DataSet, const CSG_String &Name)
 	bool	bTransform	= Parameters("TRANSFORM")->asBool() && DataSet.Needs_Transformation();
 
 	//-----------------------------------------------------
-	for(i=0, n=0; i<DataSet.Get_Count() && Process_Get_Okay(); i++)
+	int			nBands;
+	CSG_Array	Band_Index(sizeof(int), DataSet.Get_Count()), Band_Grid(sizeof(CSG_Grid *), DataSet.Get_Count());
+
+	for(i=0, nBands=0; i<DataSet.Get_Count(); i++)
 	{
 		CSG_Table_Record	*pBand	= Bands.Get_Record_byIndex(i);
 
 		if( !Bands.Get_Selection_Count() || pBand->is_Selected() )
 		{
-			Process_Set_Text(CSG_String::Format("%s [%d/%d]", _TL("loading band"), i + 1, DataSet.Get_Count()));
+			((int *)Band_Index.Get_Array())[nBands++]	= pBand->Get_Index();
+		}
+	}
 
-			CSG_Grid	*pGrid	= DataSet.Read(pBand->Get_Index());
+	Process_Set_Text(CSG_String::Format("%s [%d]", _TL("loading bands"), nBands));
 
-			if( pGrid != NULL )
-			{
-				n++;
+	if( !DataSet.Read(nBands, (int *)Band_Index.Get_Array(), (CSG_Grid **)Band_Grid.Get_Array()) )	// all bands in one pass
+	{
+		return( false );
+	}
 
-				if( bTransform )
-				{
-					Process_Set_Text(CSG_String::Format("%s [%d/%d]", _TL("band transformation"), i + 1, DataSet.Get_Count()));
+	//-----------------------------------------------------
+	for(i=0; i<nBands; i++)
+	{
+		CSG_Grid	*pGrid	= ((CSG_Grid **)Band_Grid.Get_Array())[i];
 
-					DataSet.Get_Transformation(&pGrid, Interpolation, true);
-				}
+		if( bTransform && Process_Get_Okay() )
+		{
+			Process_Set_Text(CSG_String::Format("%s [%d/%d]", _TL("band transformation"), i + 1, nBands));
 
-				pGrid->Set_Name(DataSet.Get_Count() > 1
-					? CSG_String::Format("%s [%s]", Name.c_str(), pGrid->Get_Name()).c_str()
-					: Name.c_str()
-				);
+			DataSet.Get_Transformation(&pGrid, Interpolation, true);
+		}
 
-				pGrid->Set_File_Name(DataSet.Get_File_Name());
+		pGrid->Set_Name(DataSet.Get_Count() > 1
+			? CSG_String::Format("%s [%s]", Name.c_str(), pGrid->Get_Name()).c_str()
+			: Name.c_str()
+		);
 
-				m_pGrids->Add_Item(pGrid);
+		pGrid->Set_File_Name(DataSet.Get_File_Name());
 
-				DataObject_Add			(pGrid);
-				DataObject_Set_Colors	(pGrid, CSG_Colors(11, SG_COLORS_BLACK_WHITE, false));
+		m_pGrids->Add_Item(pGrid);
 
-				if( DataSet.Get_Count() == 1 )
-				{
-					pGrid->Set_File_Name(DataSet.Get_File_Name());
-					pGrid->Get_MetaData().Add_Child("GDAL_DRIVER", DataSet.Get_DriverID());
-				}
-			}
+		DataObject_Add			(pGrid);
+		DataObject_Set_Colors	(pGrid, CSG_Colors(11, SG_COLORS_BLACK_WHITE, false));
+
+		if( DataSet.Get_Count() == 1 )
+		{
+			pGrid->Set_File_Name(DataSet.Get_File_Name());
+			pGrid->Get_MetaData().Add_Child("GDAL_DRIVER", DataSet.Get_DriverID());
 		}
-    }
+	}
 
 	//-----------------------------------------------------
-	return( n > 0 );
+	return( nBands > 0 );
 }
 
 
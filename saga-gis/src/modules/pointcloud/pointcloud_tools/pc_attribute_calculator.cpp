@@ -249,39 +249,63 @@ bool CPC_Attribute_Calculator::On_Execute(void)
 
 
 	//---------------------------------------------------------
-	CSG_Vector	Values(nFields);
+	// points are evaluated in chunks by the vectorized formula...
 
-	for( int i=0; i<pInput->Get_Point_Count() && Set_Progress(i, pInput->Get_Point_Count()); i++ )
+	const int	Chunk	= 1024;
+
+	CSG_Matrix	Values(Chunk, nFields);
+	CSG_Vector	Results(Chunk);
+
+	bool			bNoData[Chunk];
+	const double	**Inputs	= new const double *[nFields];
+
+	for( int iField=0; iField<nFields; iField++ )
+		Inputs[iField]	= Values[iField];
+
+	for( int iFirst=0; iFirst<pInput->Get_Point_Count() && Set_Progress(iFirst, pInput->Get_Point_Count()); iFirst+=Chunk )
 	{
-		bool	bOkay	= true;
+		int		n	= M_GET_MIN(Chunk, pInput->Get_Point_Count() - iFirst);
 
-		pResult->Add_Point(pInput->Get_X(i), pInput->Get_Y(i), pInput->Get_Z(i));
+		for( int j=0; j<n; j++ )
+		{
+			int		i	= iFirst + j;
 
-		for( int iField=2; iField<pInput->Get_Field_Count(); iField++ )
-			pResult->Set_Value(i, iField, pInput->Get_Value(i, iField));
+			pResult->Add_Point(pInput->Get_X(i), pInput->Get_Y(i), pInput->Get_Z(i));
 
-		for( int iField=0; iField<nFields && bOkay; iField++ )
+			for( int iField=2; iField<pInput->Get_Field_Count(); iField++ )
+				pResult->Set_Value(i, iField, pInput->Get_Value(i, iField));
+
+			bNoData[j]	= false;
+
+			for( int iField=0; iField<nFields && !bNoData[j]; iField++ )
+			{
+				if( !pInput->is_NoData(i, pFields[iField]) || bUseNoData )
+				{
+					Values[iField][j]	= pInput->Get_Value(i, pFields[iField]);
+				}
+				else
+				{
+					bNoData[j]	= true;
+				}
+			}
+		}
+
+		Formula.Get_Values(Inputs, nFields, Results.Get_Data(), n, bNoData);
+
+		for( int j=0; j<n; j++ )
 		{
-			if( !pInput->is_NoData(i, pFields[iField]) || bUseNoData )
+			if( !bNoData[j] )
 			{
-				Values[iField]	= pInput->Get_Value(i, pFields[iField]);
+				pResult->Set_Value(iFirst + j, pInput->Get_Field_Count(), Results[j]);
 			}
 			else
 			{
-				bOkay = false;
+				pResult->Set_NoData(iFirst + j, pInput->Get_Field_Count());
 			}
 		}
-
-		if( bOkay )
-		{
-			pResult->Set_Value(i, pInput->Get_Field_Count(), Formula.Get_Value(Values.Get_Data(), nFields));
-		}
-		else
-		{
-			pResult->Set_NoData(i, pInput->Get_Field_Count());
-		}
 	}
 
+	delete[](Inputs);
 
 	delete[](pFields);
 
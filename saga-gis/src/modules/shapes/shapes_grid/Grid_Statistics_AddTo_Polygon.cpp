@@ -136,6 +136,10 @@ CGrid_Statistics_AddTo_Polygon::CGrid_Statistics_AddTo_Polygon(void)
 		_TL("Calculate distribution quantiles. Value specifies interval (median=50, quartiles=25, deciles=10, ...). Set to zero to omit quantile calculation."),
 		PARAMETER_TYPE_Int, 0, 0, true, 50, true
 	);
+	Parameters.Add_Value(pNode, "QUANTILE_CLASSES", _TL("Quantile Classes"), 
+		_TL("If greater than zero, quantiles are approximated with a histogram of the given number of classes, which needs much less memory than the exact calculation."),
+		PARAMETER_TYPE_Int, 0, 0, true
+	);
 }
 
 
@@ -180,6 +184,7 @@ bool CGrid_Statistics_AddTo_Polygon::On_Execute(void)
 
 	//-----------------------------------------------------
 	int	Quantile	= Parameters("QUANTILE")->asInt();
+	int	nClasses	= Parameters("QUANTILE_CLASSES")->asInt();
 	int	nFields		= 0;
 
 	int	fCOUNT		= Parameters("COUNT"   )->asBool() ? nFields++ : -1;
@@ -220,13 +225,32 @@ bool CGrid_Statistics_AddTo_Polygon::On_Execute(void)
 
 	CSG_Simple_Statistics	*Statistics	= new CSG_Simple_Statistics[pPolygons->Get_Count()];
 
+	CSG_Zonal_Statistics	Zonal;	// standard method, all grids in one pass
+
+	if( Method == 0 )
+	{
+		Zonal.Add_Key(&m_Index, false);
+
+		for(int iGrid=0; iGrid<pGrids->Get_Count(); iGrid++)
+		{
+			Zonal.Add_Value(pGrids->asGrid(iGrid), Quantile > 0, nClasses);
+		}
+
+		if( !Zonal.Execute() )
+		{
+			delete[](Statistics);
+
+			return( false );
+		}
+	}
+
 	//-----------------------------------------------------
 	for(int iGrid=0; iGrid<pGrids->Get_Count() && Process_Get_Okay(); iGrid++)
 	{
 		Process_Set_Text(CSG_String::Format("[%d/%d] %s", 1 + iGrid, pGrids->Get_Count(), pGrids->asGrid(iGrid)->Get_Name()));
 
-		if( (Method == 0 && Get_Statistics    (pGrids->asGrid(iGrid), pPolygons, Statistics, Quantile > 0))
-		||  (Method == 1 && Get_Statistics_Alt(pGrids->asGrid(iGrid), pPolygons, Statistics, Quantile > 0)) )
+		if( (Method == 0 && Get_Statistics    (Zonal, iGrid, pPolygons, Statistics))
+		||  (Method == 1 && Get_Statistics_Alt(pGrids->asGrid(iGrid), pPolygons, Statistics, Quantile > 0, nClasses)) )
 		{
 			nFields	= pPolygons->Get_Field_Count();
 
@@ -307,23 +331,20 @@ bool CGrid_Statistics_AddTo_Polygon::On_Execute(void)
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-bool CGrid_Statistics_AddTo_Polygon::Get_Statistics(CSG_Grid *pGrid, CSG_Shapes *pPolygons, CSG_Simple_Statistics *Statistics, bool bQuantiles)
+bool CGrid_Statistics_AddTo_Polygon::Get_Statistics(CSG_Zonal_Statistics &Zonal, int iGrid, CSG_Shapes *pPolygons, CSG_Simple_Statistics *Statistics)
 {
 	int		i;
 
 	for(i=0; i<pPolygons->Get_Count(); i++)
 	{
-		Statistics[i].Create(bQuantiles);
+		Statistics[i].Create();
 	}
 
-	for(int y=0; y<Get_NY() && Set_Progress(y); y++)
+	for(sLong iZone=0; iZone<Zonal.Get_Count(); iZone++)
 	{
-		for(int x=0; x<Get_NX(); x++)
+		if( (i = Zonal.Get_Key(iZone, 0)) >= 0 && i < pPolygons->Get_Count() )
 		{
-			if( (i = m_Index.asInt(x, y)) >= 0 && i < pPolygons->Get_Count() )
-			{
-				Statistics[i]	+= pGrid->asDouble(x, y);
-			}
+			Statistics[i]	= Zonal.Get_Statistics(iZone, iGrid);
 		}
 	}
 
@@ -331,11 +352,16 @@ bool CGrid_Statistics_AddTo_Polygon::Get_Statistics(CSG_Grid *pGrid, CSG_Shapes
 }
 
 //---------------------------------------------------------
-bool CGrid_Statistics_AddTo_Polygon::Get_Statistics_Alt(CSG_Grid *pGrid, CSG_Shapes *pPolygons, CSG_Simple_Statistics *Statistics, bool bQuantiles)
+bool CGrid_Statistics_AddTo_Polygon::Get_Statistics_Alt(CSG_Grid *pGrid, CSG_Shapes *pPolygons, CSG_Simple_Statistics *Statistics, bool bQuantiles, int nClasses)
 {
 	for(int i=0; i<pPolygons->Get_Count() && Set_Progress(i, pPolygons->Get_Count()); i++)
 	{
-		Statistics[i].Create(bQuantiles);
+		Statistics[i].Create(bQuantiles && nClasses <= 0);
+
+		if( bQuantiles && nClasses > 0 )
+		{
+			Statistics[i].Set_Histogram(nClasses, pGrid->Get_ZMin(), pGrid->Get_ZMax());
+		}
 
 		CSG_Shape_Polygon	*pPolygon	= (CSG_Shape_Polygon *)pPolygons->Get_Shape(i);
 
@@ -382,6 +408,7 @@ bool CGrid_Statistics_AddTo_Polygon::Get_Index(CSG_Shapes *pPolygons)
 
 	//-----------------------------------------------------
 	m_Index.Create(*Get_System(), pPolygons->Get_Count() < 32767 ? SG_DATATYPE_Short : SG_DATATYPE_Int);
+	m_Index.Set_NoData_Value(-1.0);
 	m_Index.Assign(-1.0);
 
 	bCrossing	= (bool *)SG_Malloc(Get_NX() * sizeof(bool));
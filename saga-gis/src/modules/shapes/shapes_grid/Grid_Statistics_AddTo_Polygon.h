@@ -100,8 +100,8 @@ private:
 	CSG_Grid				m_Index;
 
 
-	bool					Get_Statistics		(CSG_Grid *pGrid, CSG_Shapes *pPolygons, CSG_Simple_Statistics *Statistics, bool bQuantiles);
-	bool					Get_Statistics_Alt	(CSG_Grid *pGrid, CSG_Shapes *pPolygons, CSG_Simple_Statistics *Statistics, bool bQuantiles);
+	bool					Get_Statistics		(CSG_Zonal_Statistics &Zonal, int iGrid, CSG_Shapes *pPolygons, CSG_Simple_Statistics *Statistics);
+	bool					Get_Statistics_Alt	(CSG_Grid *pGrid, CSG_Shapes *pPolygons, CSG_Simple_Statistics *Statistics, bool bQuantiles, int nClasses);
 
 	bool					Get_Index			(CSG_Shapes *pPolygons);
 
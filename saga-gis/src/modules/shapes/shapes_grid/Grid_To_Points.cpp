@@ -217,9 +217,13 @@ inline bool CGrid_To_Points::is_Contained(double x, double y, CSG_Shapes *pPolyg
 {
 	if( pPolygons && pPolygons->Get_Type() == SHAPE_TYPE_Polygon )
 	{
-		for(int iPolygon=0; iPolygon<pPolygons->Get_Count(); iPolygon++)
+		const CSG_Shapes_RTree	*pIndex	= pPolygons->Get_Spatial_Index();
+
+		int	nPolygons	= pIndex ? pIndex->Get_Candidates(CSG_Point(x, y), m_Candidates) : pPolygons->Get_Count();
+
+		for(int iPolygon=0; iPolygon<nPolygons; iPolygon++)
 		{
-			CSG_Shape_Polygon *pPolygon	= (CSG_Shape_Polygon *)pPolygons->Get_Shape(iPolygon);
+			CSG_Shape_Polygon *pPolygon	= (CSG_Shape_Polygon *)pPolygons->Get_Shape(pIndex ? CSG_Shapes_RTree::Get_Index(m_Candidates, iPolygon) : iPolygon);
 
 			if( pPolygon->Contains(x, y) )
 			{
@@ -98,6 +98,9 @@ protected:
 
 private:
 
+	CSG_Array				m_Candidates;
+
+
 	bool					is_Contained	(double x, double y, CSG_Shapes *pPolygons);
 
 };
@@ -173,6 +173,10 @@ bool CPolygonStatisticsFromPoints::On_Execute(void)
 	//-----------------------------------------------------
 	CSG_Simple_Statistics	*Statistics	= new CSG_Simple_Statistics[pFields->Get_Count()];
 
+	CSG_Array	Candidates;
+
+	const CSG_Shapes_RTree	*pIndex	= pPoints->Get_Spatial_Index();
+
 	for(int iPolygon=0; iPolygon<pPolygons->Get_Count() && Set_Progress(iPolygon, pPolygons->Get_Count()); iPolygon++)
 	{
 		CSG_Shape_Polygon	*pPolygon	= (CSG_Shape_Polygon *)pPolygons->Get_Shape(iPolygon);
@@ -184,9 +188,11 @@ bool CPolygonStatisticsFromPoints::On_Execute(void)
 		}
 
 		//-------------------------------------------------
-		for(int iPoint=0; iPoint<pPoints->Get_Count() && Process_Get_Okay(); iPoint++)
+		int	nPoints	= pIndex ? pIndex->Get_Intersection(pPolygon->Get_Extent(), Candidates) : pPoints->Get_Count();
+
+		for(int iPoint=0; iPoint<nPoints && Process_Get_Okay(); iPoint++)
 		{
-			CSG_Shape	*pPoint	= pPoints->Get_Shape(iPoint);
+			CSG_Shape	*pPoint	= pPoints->Get_Shape(pIndex ? CSG_Shapes_RTree::Get_Index(Candidates, iPoint) : iPoint);
 
 			if( pPolygon->Contains(pPoint->Get_Point(0)) )
 			{
@@ -204,14 +204,20 @@ bool CAdd_Point_Attributes::On_Execute(void)
 
 
 	//-----------------------------------------------------
+	CSG_Array	Candidates;
+
+	const CSG_Shapes_RTree	*pIndex	= pPoints->Get_Spatial_Index();
+
 	for(int iPolygon=0; iPolygon<pOutput->Get_Count() && Set_Progress(iPolygon, pOutput->Get_Count()); iPolygon++)
 	{
 		CSG_Shape_Polygon	*pPolygon	= (CSG_Shape_Polygon *)pOutput->Get_Shape(iPolygon);
 
 		//-------------------------------------------------
-		for(int iPoint=0; iPoint<pPoints->Get_Count() && Process_Get_Okay(); iPoint++)
+		int	nPoints	= pIndex ? pIndex->Get_Intersection(pPolygon->Get_Extent(), Candidates) : pPoints->Get_Count();
+
+		for(int iPoint=0; iPoint<nPoints && Process_Get_Okay(); iPoint++)
 		{
-			CSG_Shape	*pPoint	= pPoints->Get_Shape(iPoint);
+			CSG_Shape	*pPoint	= pPoints->Get_Shape(pIndex ? CSG_Shapes_RTree::Get_Index(Candidates, iPoint) : iPoint);
 
 			if( pPolygon->Contains(pPoint->Get_Point(0)) )
 			{
@@ -157,15 +157,13 @@ CGSGrid_Zonal_Statistics::~CGSGrid_Zonal_Statistics(void)
 bool CGSGrid_Zonal_Statistics::On_Execute(void)
 {
 	bool					bShortNames;
-	int						x, y, nCatGrids, nStatGrids, iGrid, zoneID, catID, NDcount, catLevel, NDcountStat;
-	double					statID;
+	int						nCatGrids, nStatGrids, iGrid, catLevel;
+	sLong					NDcountStat;
 
-	CSG_Grid				*pZones, *pGrid, *pAspect;
+	CSG_Grid				*pZones, *pAspect;
 	CSG_Parameter_Grid_List	*pCatList;
 	CSG_Parameter_Grid_List	*pStatList;
 
-	CList_Conti				*newZone, *startList, *runList, *newSub, *parent, *runSub, *subList;
-	CList_Stat				*runStats;
 	CSG_Table				*pOutTab;
 	CSG_Table_Record		*pRecord;
 	CSG_String				fieldName, tmpName;
@@ -181,7 +179,6 @@ bool CGSGrid_Zonal_Statistics::On_Execute(void)
 	nCatGrids	= pCatList	->Get_Count();
 	nStatGrids	= pStatList	->Get_Count();
 
-	NDcount		= 0;						// NoData Counter (ZoneGrid)
 	NDcountStat	= 0;						// NoData Counter (StatGrids)
 
 	CSG_String	sTabName = Parameters("OUTTAB")->asString();
@@ -191,210 +188,24 @@ bool CGSGrid_Zonal_Statistics::On_Execute(void)
 		pOutTab->Set_Name(sTabName);
 	}
 
-	newZone		= new CList_Conti();								// create first list entry (dummy)
-	startList	= newZone;
+	// Unique condition units are the combinations of zone and category values,
+	// NoData cells of zone and categorical grids form units of their own
+	CSG_Zonal_Statistics	Zonal;
 
-	for(y=0; y<Get_NY() && Set_Progress(y); y++)
-	{
-		for(x=0; x<Get_NX(); x++)
-		{
-			runList		= startList;
-			zoneID		= pZones->asInt(x, y);								// get zone ID
-
-			while( runList->next != NULL && runList->cat < zoneID )			// search for last entry in list or insert point
-			{
-				runList = runList->next;
-			}
-
-			if( runList->dummy == true )
-			{
-				runList->cat = zoneID;										// first list entry, write and
-				runList->dummy = false;										// setup
-			}
-			else if( runList->cat == zoneID )
-				runList = runList;											// zoneID found
-			else if( runList->next == NULL && runList->cat < zoneID )		// append zoneID
-			{
-				newZone = new CList_Conti();
-				newZone->previous	= runList;
-				runList->next		= newZone;
-
-				newZone->cat	= zoneID;									// ... and write info
-				newZone->dummy	= false;
-				runList			= newZone;
-			}
-			else															// insert new entry
-			{
-				newZone = new CList_Conti();
-
-				newZone->next = runList;
-				if( runList->previous != NULL )
-				{
-					newZone->previous = runList->previous;
-					runList->previous->next = newZone;
-				}
-				runList->previous = newZone;
-
-				if( runList == startList )
-					startList = newZone;									// if new entry is first element, update startList pointer
-
-				newZone->cat	= zoneID;									// ... and write info
-				newZone->dummy	= false;
-				runList			= newZone;
-			}
-
-
-			for(iGrid=0; iGrid<nCatGrids; iGrid++)							// collect categories
-			{
-				parent  = runList;
-				if( runList->sub == NULL )									// no sub class found
-				{
-					newSub = new CList_Conti();
-					runList->sub = newSub;
-				}
-
-				runList = runList->sub;
-
-				pGrid	= pCatList->asGrid(iGrid);
-				if( !pGrid->is_NoData(x, y) )
-					catID	= pGrid->asInt(x, y);
-				else
-					catID	= (int)pGrid->Get_NoData_Value();
-
-
-				while( runList->next != NULL && runList->cat < catID )		// search for last entry in list or insert point
-				{
-					runList = runList->next;
-				}
-
-				if( runList->dummy == true )
-				{
-					runList->cat	= catID;								// first list entry, write and
-					runList->dummy	= false;								// setup
-					runList->parent	= parent;
-				}
-				else if( runList->cat == catID )
-					runList = runList;										// zoneID found, all infos already written
-				else if( runList->next == NULL && runList->cat < catID)		// append zoneID
-				{
-					newSub = new CList_Conti();
-					newSub->cat			= catID;							// ... and write info
-					newSub->previous	= runList;
-					newSub->parent		= parent;
-					newSub->dummy		= false;
-					runList->next		= newSub;
-					runList				= newSub;
-				}
-				else														// insert new entry
-				{
-					newSub = new CList_Conti();
-					newSub->cat		= catID;								// ... and write info
-					newSub->next	= runList;
-					newSub->parent	= parent;
-					newSub->dummy	= false;
-					if( runList->previous != NULL )
-					{
-						newSub->previous = runList->previous;
-						runList->previous->next = newSub;
-					}
-					else
-						parent->sub	 = newSub;
-
-					runList->previous = newSub;
-					runList	= newSub;
-				}
-			}
+	Zonal.Add_Key(pZones);
 
+	for(iGrid=0; iGrid<nCatGrids; iGrid++)
+		Zonal.Add_Key(pCatList->asGrid(iGrid));
 
-			for(iGrid=0; iGrid<nStatGrids; iGrid++)							// collect statistics for StatGrids
-			{
-				if( iGrid == 0 )
-				{
-					if( runList->stats == NULL )
-						runList->stats = new CList_Stat();
-
-					runStats = runList->stats;
-				}
-				else
-				{
-					if( runStats->next == NULL )
-						runStats->next = new CList_Stat();
-
-					runStats = runStats->next;
-				}
-				if( !pStatList->asGrid(iGrid)->is_NoData(x, y) )
-				{
-					statID		= pStatList->asGrid(iGrid)->asDouble(x, y);
-
-					if( runStats->dummy == true )
-					{
-						runStats->min = statID;
-						runStats->max = statID;
-						runStats->dummy = false;
-					}
-					if( runStats->min > statID )
-						runStats->min = statID;
-					if( runStats->max < statID )
-						runStats->max = statID;
-
-					runStats->n	  += 1;
-					runStats->sum += statID;
-					runStats->dev += pow(statID, 2);
-				}
-				else
-					NDcountStat += 1;
-			}
+	for(iGrid=0; iGrid<nStatGrids; iGrid++)
+		Zonal.Add_Value(pStatList->asGrid(iGrid));
 
-			if( pAspect != NULL )
-			{
-				for( int i=0; i<2; i++ )
-				{
-					if( nStatGrids == 0 && i == 0 )
-					{
-						if( runList->stats == NULL )
-							runList->stats = new CList_Stat();
-
-						runStats = runList->stats;
-					}
-					else
-					{
-						if( runStats->next == NULL )
-							runStats->next = new CList_Stat();
-
-						runStats = runStats->next;
-					}
-					if( !pAspect->is_NoData(x, y) )
-					{
-						statID	= pAspect->asDouble(x, y);
-
-						if( i == 0 )
-						{
-							if( runStats->dummy == true )
-							{
-								runStats->min = statID;
-								runStats->max = statID;
-								runStats->dummy = false;
-							}
-							if( runStats->min > statID )
-								runStats->min = statID;
-							if( runStats->max < statID )
-								runStats->max = statID;
-
-							statID	= sin(statID);
-						}
-						else
-							statID	= cos(statID);
-
-						runStats->n	  += 1;
-						runStats->sum += statID;
-					}
-					else
-						NDcountStat += 1;
-				}
-			}
+	if( pAspect != NULL )
+		Zonal.Add_Value(pAspect, false, 0, true);
 
-			runList->count += 1;											// sum up unique condition area
-		}
+	if( !Zonal.Execute() )
+	{
+		return( false );
 	}
 
 
@@ -461,111 +272,67 @@ bool CGSGrid_Zonal_Statistics::On_Execute(void)
 
 	int	iStatFields = 6;	// number of table fields: n, min, max, mean, stddev, sum
 
-	while( startList != NULL )												// scan zone layer list and write cat values in table
+	for(sLong iZone=0; iZone<Zonal.Get_Count() && Set_Progress((double)iZone, (double)Zonal.Get_Count()); iZone++)
 	{
-		runList = startList;
-		while( runList->sub != NULL )										// fall down to lowest layer
-			runList = runList->sub;
+		catLevel = nCatGrids;
+		pRecord	= pOutTab->Add_Record();									// create new record in table
 
-		subList = runList;													// use pointer to scan horizontal
+		for(iGrid=0; iGrid<=nCatGrids; iGrid++)								// write zone and categories
+			pRecord->Set_Value(iGrid, Zonal.Get_Key(iZone, iGrid));
 
-		while( subList != NULL )											// move forward and read all categories of this layer (including the parent layers)
+		pRecord->Set_Value((catLevel+1), (double)Zonal.Get_Cells(iZone));	// write field count
+
+		for(iGrid=0; iGrid<nStatGrids; iGrid++)								// write statistics
 		{
-			runSub = subList;
-			catLevel = nCatGrids;
-			pRecord	= pOutTab->Add_Record();								// create new record in table
-			pRecord->Set_Value((catLevel+1), runSub->count);				// read/write field count
+			CSG_Simple_Statistics	&s	= Zonal.Get_Statistics(iZone, iGrid);
 
-			for(iGrid=0; iGrid<nStatGrids; iGrid++)							// read/write statistics
-			{
-				if( iGrid == 0 )
-					runStats = runSub->stats;
-				else
-					runStats = runStats->next;
-
-				pRecord->Set_Value(catLevel+2+iGrid*iStatFields, runStats->n);
-				pRecord->Set_Value(catLevel+3+iGrid*iStatFields, runStats->min);
-				pRecord->Set_Value(catLevel+4+iGrid*iStatFields, runStats->max);
-				pRecord->Set_Value(catLevel+5+iGrid*iStatFields, runStats->sum/runStats->n);
-				pRecord->Set_Value(catLevel+6+iGrid*iStatFields, sqrt((runStats->dev - runStats->n*pow(runStats->sum/runStats->n, 2)) / (runStats->n - 1))); // sample
-				//pRecord->Set_Value(catLevel+6+iGrid*iStatFields, sqrt((runStats->dev - pow(runStats->sum/runStats->n, 2)) / runStats->n)); // population
-				pRecord->Set_Value(catLevel+7+iGrid*iStatFields, runStats->sum);
-			}
+			NDcountStat	+= Zonal.Get_Cells(iZone) - s.Get_Count();
 
-			if( pAspect != NULL )
+			pRecord->Set_Value(catLevel+2+iGrid*iStatFields, (double)s.Get_Count());
+
+			if( s.Get_Count() > 0 )
 			{
-				iGrid		= nStatGrids * iStatFields;
-
-				int			n;
-				double		min, max, sumYcomp, sumXcomp, val, valYcomp, valXcomp;
-
-				if( nStatGrids == 0 )
-					runStats	= runSub->stats;
-				else
-					runStats	= runStats->next;
-				n			= runStats->n;
-				min			= runStats->min;
-				max			= runStats->max;
-				sumXcomp	= runStats->sum;
-
-				runStats	= runStats->next;
-				sumYcomp	= runStats->sum;
-
-				pRecord		->Set_Value(catLevel+2+iGrid, n);
-				pRecord		->Set_Value(catLevel+3+iGrid, min*M_RAD_TO_DEG);
-				pRecord		->Set_Value(catLevel+4+iGrid, max*M_RAD_TO_DEG);
-				valXcomp	= sumXcomp / n;
-				valYcomp	= sumYcomp / n;
-				val			= valXcomp ? fmod(M_PI_270 + atan2(valYcomp, valXcomp), M_PI_360) : (valYcomp > 0 ? M_PI_270 : (valYcomp < 0 ? M_PI_090 : -1));
-				val			= fmod(M_PI_360 - val, M_PI_360);
-				pRecord		->Set_Value(catLevel+5+iGrid, val*M_RAD_TO_DEG);
+				pRecord->Set_Value(catLevel+3+iGrid*iStatFields, s.Get_Minimum());
+				pRecord->Set_Value(catLevel+4+iGrid*iStatFields, s.Get_Maximum());
+				pRecord->Set_Value(catLevel+5+iGrid*iStatFields, s.Get_Mean());
+				pRecord->Set_Value(catLevel+6+iGrid*iStatFields, s.Get_Count() > 1 ? sqrt(s.Get_Variance() * s.Get_Count() / (s.Get_Count() - 1.0)) : 0.0); // sample
+				pRecord->Set_Value(catLevel+7+iGrid*iStatFields, s.Get_Sum());
 			}
-
-			while( runSub != NULL )											// read/write categories
+			else
 			{
-				pRecord->Set_Value(catLevel, runSub->cat);
-				runSub = runSub->parent;
-				catLevel -= 1;
+				for(int iField=3; iField<=7; iField++)
+					pRecord->Set_NoData(catLevel+iField+iGrid*iStatFields);
 			}
-			subList = subList->next;
 		}
 
-		while( runList->parent != NULL && runList->parent->next == NULL )	// move up to next 'Caterory with -> next'
-			runList = runList->parent;
-
-		if( runList->parent != NULL )										// if not upper layer (zones)
+		if( pAspect != NULL )
 		{
-			runList = runList->parent;										// move to parent of next 'Caterory with -> next'
-			if( runList->next != NULL && runList->parent != NULL )
-				runList->parent->sub = runList->next;						// redirect pointer to category which is next 'Categora with -> next' next
-			else if (runList->parent == NULL && runList->next != NULL )
-				startList = runList->next;									// when upper layer (zones) is reached, move to next zone
-			else
-				startList = NULL;											// reading finished
+			CSG_Simple_Statistics	&s	= Zonal.Get_Statistics(iZone, nStatGrids);
 
-			if( runList->parent == NULL )
-				startList = runList->next;									// ?? when upper layer is reached, move to next zone
-			else
-				runList->sub = runList->sub->next;							// on sub layers redirect pointer to ->next
-		}
-		else
-		{
-			if( nCatGrids == 0 )
-				startList = NULL;
-			else
-				startList = runList->next;									// ?? upper layer is reached, move to next zone
-		}
+			NDcountStat	+= 2 * (Zonal.Get_Cells(iZone) - s.Get_Count());
 
+			iGrid		= nStatGrids * iStatFields;
 
-		runList->next = NULL;
-		delete (runList);													// delete disconneted part of the list
+			pRecord		->Set_Value(catLevel+2+iGrid, (double)s.Get_Count());
 
+			if( s.Get_Count() > 0 )
+			{
+				pRecord		->Set_Value(catLevel+3+iGrid, s.Get_Minimum()*M_RAD_TO_DEG);
+				pRecord		->Set_Value(catLevel+4+iGrid, s.Get_Maximum()*M_RAD_TO_DEG);
+				pRecord		->Set_Value(catLevel+5+iGrid, Zonal.Get_Direction(iZone, nStatGrids)*M_RAD_TO_DEG);
+			}
+			else
+			{
+				for(int iField=3; iField<=5; iField++)
+					pRecord->Set_NoData(catLevel+iField+iGrid);
+			}
+		}
 	}
 
 
 	if( NDcountStat > 0 )
 	{
-		Message_Add(CSG_String::Format(SG_T("\n\n\n%s: %d %s\n\n\n"), _TL("WARNING"), NDcountStat, _TL("NoData value(s) in statistic grid(s)!")));
+		Message_Add(CSG_String::Format(SG_T("\n\n\n%s: %.0f %s\n\n\n"), _TL("WARNING"), (double)NDcountStat, _TL("NoData value(s) in statistic grid(s)!")));
 	}
 
 	return (true);
@@ -82,74 +82,6 @@
 //														 //
 ///////////////////////////////////////////////////////////
 
-//---------------------------------------------------------
-class CList_Stat
-{
-public:
-	CList_Stat(void)
-	{
-		n		= 0;
-		min		= max	= 0.0;
-		sum		= dev	= 0.0;
-		next	= NULL;
-		dummy	= true;
-	};
-
-	~CList_Stat(void)
-	{
-		if( next != NULL )
-			delete(next);
-		next	= NULL;
-	};
-
-	int					n;
-	double				min, max, sum, dev;
-	bool				dummy;
-
-	CList_Stat			*next;
-
-};
-
-//---------------------------------------------------------
-class CList_Conti
-{
-public:
-	CList_Conti(void)
-	{
-		cat			= 0;
-		count		= 0;
-		next		= NULL;
-		previous	= NULL;
-		parent		= NULL;
-		sub			= NULL;
-		stats		= NULL;
-		dummy		= true;
-	};
-
-	~CList_Conti(void)
-	{
-		if( stats != NULL )
-			delete(stats);
-
-		if( sub != NULL )
-			delete(sub);
-		sub		= NULL;
-
-		if( next != NULL )
-			delete(next);
-		next	 = NULL;					
-	};
-
-
-	int					cat, count;
-	bool				dummy;
-
-	CList_Conti			*next, *previous, *parent, *sub;
-
-	CList_Stat			*stats;
-
-};
-
 //---------------------------------------------------------
 class CGSGrid_Zonal_Statistics : public CSG_Module_Grid
 {
@@ -61,11 +61,61 @@
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "variogram_dialog.h"
 
 #include "kriging_base.h"
 
 
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// Neighbouring cells very often select the same set of points,
+// i.e. the same kriging system. Each thread keeps a small
+// direct mapped cache of inverted kriging matrices, that is
+// keyed by the point set, so that a matrix is only built and
+// inverted once for each distinct neighbourhood.
+//---------------------------------------------------------
+#define KRIGING_CACHE_SIZE	256
+
+//---------------------------------------------------------
+class CKriging_Cache
+{
+public:
+	CKriging_Cache(void)
+	{
+		m_nHits	= m_nMisses	= 0;
+
+		for(int i=0; i<KRIGING_CACHE_SIZE; i++)
+		{
+			m_System[i].Key	= 0;
+		}
+	}
+
+	sLong				m_nHits, m_nMisses;
+
+	CSG_Points_Z		m_Search;
+
+	struct
+	{
+		uLong			Key;
+
+		CSG_Points_Z	Points;
+
+		CSG_Matrix		W;
+	}
+	m_System[KRIGING_CACHE_SIZE];
+
+};
+
+
 ///////////////////////////////////////////////////////////
 //														 //
 //														 //
@@ -163,6 +213,8 @@ CKriging_Base::CKriging_Base(void)
 
 	//-----------------------------------------------------
 	m_Search.Create(&Parameters, Parameters.Add_Node(NULL, "NODE_SEARCH", _TL("Search Options"), _TL("")), 16);
+
+	m_pCache	= NULL;
 }
 
 ///////////////////////////////////////////////////////////
@@ -271,6 +323,15 @@ bool CKriging_Base::On_Execute(void)
 	{
 		Message_Add(CSG_String::Format(SG_T("%s: %s"), _TL("variogram model"), m_Model.Get_Formula(SG_TREND_STRING_Formula_Parameters).c_str()), false);
 
+		if( !m_Search.Do_Use_All() )	// local
+		{
+			#ifdef _OPENMP
+			m_pCache	= new CKriging_Cache[omp_get_max_threads()];
+			#else
+			m_pCache	= new CKriging_Cache[1];
+			#endif
+		}
+
 		for(int y=0; y<m_pGrid->Get_NY() && Set_Progress(y, m_pGrid->Get_NY()); y++)
 		{
 			#pragma omp parallel for
@@ -291,6 +352,30 @@ bool CKriging_Base::On_Execute(void)
 	}
 
 	//-----------------------------------------------------
+	if( m_pCache )
+	{
+		sLong	nHits	= 0, nMisses	= 0;
+
+		#ifdef _OPENMP
+		for(int i=0; i<omp_get_max_threads(); i++)
+		#else
+		for(int i=0; i<1; i++)
+		#endif
+		{
+			nHits	+= m_pCache[i].m_nHits;
+			nMisses	+= m_pCache[i].m_nMisses;
+		}
+
+		if( nHits + nMisses > 0 )
+		{
+			Message_Add(CSG_String::Format(SG_T("%s: %d (%.1f%% %s)"), _TL("kriging systems"), (int)nMisses, 100.0 * nHits / (double)(nHits + nMisses), _TL("reused")), false);
+		}
+
+		delete[](m_pCache);
+
+		m_pCache	= NULL;
+	}
+
 	m_Model .Clr_Data();
 	m_Search.Finalize();
 	m_Data  .Clear();
@@ -373,6 +458,106 @@ bool CKriging_Base::On_Initialize(void)
 }
 
 
+///////////////////////////////////////////////////////////
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+/**
+  * Supplies the data points and the inverted kriging matrix to
+  * be used for the prediction at location p. For local kriging
+  * the selected points are brought into a canonical order (by
+  * coordinates), so that identical neighbourhoods result in the
+  * same kriging system, which is then taken from the cache.
+*/
+bool CKriging_Base::Get_Neighbourhood(const TSG_Point &p, CSG_Points_Z *&pData, double **&W)
+{
+	if( m_Search.Do_Use_All() )	// global
+	{
+		pData	= &m_Data;
+		W		= m_W.Get_Data();
+
+		return( true );
+	}
+
+	//-----------------------------------------------------
+	#ifdef _OPENMP
+	CKriging_Cache	&Cache	= m_pCache[omp_get_thread_num()];
+	#else
+	CKriging_Cache	&Cache	= m_pCache[0];
+	#endif
+
+	CSG_Points_Z	&Points	= Cache.m_Search;
+
+	if( !m_Search.Get_Points(p, Points) )
+	{
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	int		i, j, n	= Points.Get_Count();
+
+	for(i=1; i<n; i++)	// insertion sort, there are usually only a few points
+	{
+		TSG_Point_Z	a	= Points[i];
+
+		for(j=i; j>0 && (Points[j - 1].x > a.x || (Points[j - 1].x == a.x && Points[j - 1].y > a.y)); j--)
+		{
+			Points[j]	= Points[j - 1];
+		}
+
+		Points[j]	= a;
+	}
+
+	uLong	Key	= n;	// FNV-1a hash of the coordinates
+
+	for(i=0; i<n; i++)
+	{
+		const BYTE	*b	= (const BYTE *)&Points[i];
+
+		for(j=0; j<(int)(2 * sizeof(double)); j++)
+		{
+			Key	= (Key ^ b[j]) * 1099511628211;
+		}
+	}
+
+	//-----------------------------------------------------
+	CSG_Points_Z	&Cached	= Cache.m_System[Key % KRIGING_CACHE_SIZE].Points;
+
+	bool	bCached	= Cache.m_System[Key % KRIGING_CACHE_SIZE].Key == Key && Cached.Get_Count() == n;
+
+	for(i=0; bCached && i<n; i++)
+	{
+		bCached	= Cached[i].x == Points[i].x && Cached[i].y == Points[i].y;
+	}
+
+	if( bCached )
+	{
+		Cache.m_nHits++;
+	}
+	else
+	{
+		Cache.m_nMisses++;
+
+		Cached	= Points;
+
+		if( !Get_Weights(Cached, Cache.m_System[Key % KRIGING_CACHE_SIZE].W) )
+		{
+			Cached.Clear();
+
+			return( false );
+		}
+
+		Cache.m_System[Key % KRIGING_CACHE_SIZE].Key	= Key;
+	}
+
+	pData	= &Cached;
+	W		= Cache.m_System[Key % KRIGING_CACHE_SIZE].W.Get_Data();
+
+	return( true );
+}
+
+
 ///////////////////////////////////////////////////////////
 //														 //
 //														 //
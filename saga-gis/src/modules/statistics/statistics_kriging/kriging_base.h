@@ -115,6 +115,8 @@ protected:
 
 	virtual bool					Get_Value				(const TSG_Point &p, double &z, double &v)	= 0;
 
+	bool							Get_Neighbourhood		(const TSG_Point &p, CSG_Points_Z *&pData, double **&W);
+
 	double							Get_Weight				(double d)											{	return( m_Model.Get_Value(d) );	}
 	double							Get_Weight				(double dx, double dy)								{	return( Get_Weight(sqrt(dx*dx + dy*dy)) );	}
 	double							Get_Weight				(const TSG_Point_Z &a, const TSG_Point_Z &b)		{	return( Get_Weight(a.x - b.x, a.y - b.y) );	}
@@ -161,6 +163,8 @@ private:
 
 	class CVariogram_Dialog			*m_pVariogram;
 
+	class CKriging_Cache			*m_pCache;
+
 
 	bool							_Initialise_Grids		(void);
 
@@ -129,20 +129,9 @@ bool CKriging_Ordinary::Get_Value(const TSG_Point &p, double &z, double &v)
 	//-----------------------------------------------------
 	int				i, n;
 	double			**W;
-	CSG_Matrix		_W;
-	CSG_Points_Z	_Data, *pData;
+	CSG_Points_Z	*pData;
 
-	if( m_Search.Do_Use_All() )	// global
-	{
-		pData	= &m_Data;
-		W		= m_W.Get_Data();
-	}
-	else if( m_Search.Get_Points(p, _Data) && Get_Weights(_Data, _W) )	// local
-	{
-		pData	= &_Data;
-		W		= _W.Get_Data();
-	}
-	else
+	if( !Get_Neighbourhood(p, pData, W) )
 	{
 		return( false );
 	}
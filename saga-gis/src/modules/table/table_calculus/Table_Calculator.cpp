@@ -124,36 +124,63 @@ bool CTable_Calculator_Base::On_Execute(void)
 	}
 
 	//-----------------------------------------------------
-	CSG_Vector	Values(nFields);
+	// records are evaluated in chunks by the vectorized formula...
 
-	for(int iRecord=0; iRecord<pTable->Get_Count() && Set_Progress(iRecord, pTable->Get_Count()); iRecord++)
+	const int	Chunk	= 1024;
+
+	CSG_Matrix	Values(Chunk, nFields);
+	CSG_Vector	Results(Chunk);
+
+	bool			bNoData[Chunk];
+	const double	**Inputs	= new const double *[nFields];
+
+	for(int iField=0; iField<nFields; iField++)
 	{
-		CSG_Table_Record	*pRecord	= pTable->Get_Record(iRecord);
+		Inputs[iField]	= Values[iField];
+	}
 
-		bool	bOkay	= true;
+	for(int iFirst=0; iFirst<pTable->Get_Count() && Set_Progress(iFirst, pTable->Get_Count()); iFirst+=Chunk)
+	{
+		int	iRecord, n	= M_GET_MIN(Chunk, pTable->Get_Count() - iFirst);
 
-		for(int iField=0; iField<nFields && bOkay; iField++)
+		for(iRecord=0; iRecord<n; iRecord++)
 		{
-			if( !pRecord->is_NoData(iField) )
-			{
-				Values[iField]	= pRecord->asDouble(Fields[iField]);
-			}
-			else
+			CSG_Table_Record	*pRecord	= pTable->Get_Record(iFirst + iRecord);
+
+			bNoData[iRecord]	= false;
+
+			for(int iField=0; iField<nFields && !bNoData[iRecord]; iField++)
 			{
-				bOkay	= false;
+				if( pRecord->is_NoData(Fields[iField]) )
+				{
+					bNoData[iRecord]	= true;
+				}
+				else
+				{
+					Values[iField][iRecord]	= pRecord->asDouble(Fields[iField]);
+				}
 			}
 		}
 
-		if( bOkay )
-		{
-			pRecord->Set_Value(fResult, Formula.Get_Value(Values.Get_Data(), nFields));
-		}
-		else
+		Formula.Get_Values(Inputs, nFields, Results.Get_Data(), n, bNoData);
+
+		for(iRecord=0; iRecord<n; iRecord++)
 		{
-			pRecord->Set_NoData(fResult);
+			CSG_Table_Record	*pRecord	= pTable->Get_Record(iFirst + iRecord);
+
+			if( !bNoData[iRecord] )
+			{
+				pRecord->Set_Value(fResult, Results[iRecord]);
+			}
+			else
+			{
+				pRecord->Set_NoData(fResult);
+			}
 		}
 	}
 
+	delete[](Inputs);
+
 	//-----------------------------------------------------
 	delete[](Fields);
 
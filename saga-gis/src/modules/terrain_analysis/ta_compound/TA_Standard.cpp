@@ -129,50 +129,12 @@ bool CTA_Standard::On_Execute(void)
 	)
 
 	Parameters("SINKS")->asGrid()->Set_NoData_Value(0.0);
-//	Parameters("SINKS")->asGrid()->Assign(&(TMP2 = DEMP - *Parameters("ELEVATION")->asGrid()));
-
-	SG_RUN_MODULE_ExitOnError("grid_calculus"      , 1,	// grid calculator
-			SG_MODULE_PARAMETER_SET("RESULT"       , Parameters("SINKS"))
-		&&	SG_MODULE_PARAMETER_SET("FORMULA"      , SG_T("g1 - g2"))
-		&&	SG_MODULE_PARAMETER_SET("NAME"         , _TL("Closed Depressions"))
-		&&	SG_MODULE_PARAMLIST_ADD("GRIDS"        , &DEMP)
-		&&	SG_MODULE_PARAMLIST_ADD("GRIDS"        , Parameters("ELEVATION")->asGrid())
-	)
 
 	//-----------------------------------------------------
-	SG_RUN_MODULE_ExitOnError("ta_lighting"        , 0,
-			SG_MODULE_PARAMETER_SET("ELEVATION"    , &DEMP)
-		&&	SG_MODULE_PARAMETER_SET("SHADE"        , Parameters("SHADE"))
-	)
-
-	//-----------------------------------------------------
-	SG_RUN_MODULE_ExitOnError("ta_morphometry"     , 0,
-			SG_MODULE_PARAMETER_SET("ELEVATION"    , &DEMP)
-		&&	SG_MODULE_PARAMETER_SET("SLOPE"        , Parameters("SLOPE"))
-		&&	SG_MODULE_PARAMETER_SET("ASPECT"       , Parameters("ASPECT"))
-		&&	SG_MODULE_PARAMETER_SET("C_CROS"       , (CSG_Grid *)NULL)
-		&&	SG_MODULE_PARAMETER_SET("C_LONG"       , (CSG_Grid *)NULL)
-	)
-
-	SG_RUN_MODULE_ExitOnError("grid_filter"        , 0,
-			SG_MODULE_PARAMETER_SET("INPUT"        , &DEMP)
-		&&	SG_MODULE_PARAMETER_SET("RESULT"       , &TMP1)
-		&&	SG_MODULE_PARAMETER_SET("RADIUS"       , 3)
-	)
-
-	SG_RUN_MODULE_ExitOnError("ta_morphometry"     , 0,
-			SG_MODULE_PARAMETER_SET("ELEVATION"    , &TMP1)
-		&&	SG_MODULE_PARAMETER_SET("SLOPE"        , &TMP2)
-		&&	SG_MODULE_PARAMETER_SET("ASPECT"       , &TMP2)
-		&&	SG_MODULE_PARAMETER_SET("C_CROS"       , Parameters("HCURV"))
-		&&	SG_MODULE_PARAMETER_SET("C_LONG"       , Parameters("VCURV"))
-	)
-
-	//-----------------------------------------------------
-	SG_RUN_MODULE_ExitOnError("ta_morphometry"     , 1,
-			SG_MODULE_PARAMETER_SET("ELEVATION"    , &TMP1)
-		&&	SG_MODULE_PARAMETER_SET("RESULT"       , Parameters("CONVERGENCE"))
-	)
+	if( !Get_Local_Parameters(Parameters("ELEVATION")->asGrid(), &DEMP) )	// closed depressions, hillshading, slope, aspect, curvatures, convergence
+	{
+		return( false );
+	}
 
 	//-----------------------------------------------------
 	SG_RUN_MODULE_ExitOnError("ta_hydrology"       , 0,
@@ -258,6 +220,285 @@ bool CTA_Standard::On_Execute(void)
 }
 
 
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// The purely local parameters are derived in one pass over
+// bands of rows instead of running the hillshading, the
+// morphometry (twice), the filter and the convergence tools
+// one after the other. The curvatures and the convergence
+// index need the smoothed elevation, which is kept only for
+// the rows of the current band plus a halo of one row on
+// each side. The smoothing and the parameterizations
+// follow the standard settings of the single tools:
+// - Analytical Hillshading: standard method, azimuth 315,
+//   declination 45 degree, exaggeration 4.
+// - Slope, Aspect, Curvatures: 9 parameter 2nd order
+//   polynom (Zevenbergen & Thorne 1987).
+// - Smoothing: simple filter, circle with radius 3.
+// - Convergence Index: aspect, 2 x 2 gradients.
+//---------------------------------------------------------
+#define BAND_SIZE	64
+
+//---------------------------------------------------------
+bool CTA_Standard::Get_Local_Parameters(CSG_Grid *pDEM, CSG_Grid *pDEMP)
+{
+	CSG_Grid	*pSinks			= Parameters("SINKS"      )->asGrid();
+	CSG_Grid	*pShade			= Parameters("SHADE"      )->asGrid();
+	CSG_Grid	*pSlope			= Parameters("SLOPE"      )->asGrid();
+	CSG_Grid	*pAspect		= Parameters("ASPECT"     )->asGrid();
+	CSG_Grid	*pHCurv			= Parameters("HCURV"      )->asGrid();
+	CSG_Grid	*pVCurv			= Parameters("VCURV"      )->asGrid();
+	CSG_Grid	*pConvergence	= Parameters("CONVERGENCE")->asGrid();
+
+	pSinks		->Set_Name(_TL("Closed Depressions"));
+	pShade		->Set_Unit(_TL("radians"));
+	pSlope		->Set_Unit(_TL("Radians"));
+	pAspect		->Set_Unit(_TL("Radians"));
+
+	DataObject_Set_Colors(pShade      , 100, SG_COLORS_BLACK_WHITE  , true );
+	DataObject_Set_Colors(pSlope      ,  11, SG_COLORS_YELLOW_RED   , false);
+	DataObject_Set_Colors(pAspect     ,  11, SG_COLORS_ASPECT_3     , false);
+	DataObject_Set_Colors(pHCurv      ,  11, SG_COLORS_RED_GREY_BLUE, true );
+	DataObject_Set_Colors(pVCurv      ,  11, SG_COLORS_RED_GREY_BLUE, true );
+	DataObject_Set_Colors(pConvergence, 100, SG_COLORS_RED_GREY_BLUE, true );
+
+	//-----------------------------------------------------
+	CSG_Grid_Cell_Addressor	Kernel;	Kernel.Set_Radius(3, false);
+
+	int	i, nKernel	= Kernel.Get_Count();
+
+	int	*xKernel	= new int[2 * nKernel], *yKernel = xKernel + nKernel;
+
+	for(i=0; i<nKernel; i++)
+	{
+		xKernel[i]	= Kernel.Get_X(i);
+		yKernel[i]	= Kernel.Get_Y(i);
+	}
+
+	double	sinHgt	= sin(45.0 * M_DEG_TO_RAD), cosHgt = cos(45.0 * M_DEG_TO_RAD), Azimuth = 315.0 * M_DEG_TO_RAD, zScale = 4.0;
+
+	CSG_Matrix	Smooth(Get_NX(), BAND_SIZE + 2);	// smoothed rows of the current band, first and last are the halo
+
+	//-----------------------------------------------------
+	for(int yBand=0; yBand<Get_NY() && Set_Progress(yBand); yBand+=BAND_SIZE)
+	{
+		int	yStop	= M_GET_MIN(yBand + BAND_SIZE, Get_NY());
+
+		#pragma omp parallel for
+		for(int y=M_GET_MAX(yBand - 1, 0); y<=M_GET_MIN(yStop, Get_NY() - 1); y++)
+		{
+			double	*Row	= Smooth[y - yBand + 1];
+
+			for(int x=0; x<Get_NX(); x++)
+			{
+				if( pDEMP->is_NoData(x, y) )
+				{
+					continue;
+				}
+
+				int		n	= 0;
+				double	s	= 0.0;
+
+				for(int i=0; i<nKernel; i++)
+				{
+					int	ix	= x + xKernel[i];
+					int	iy	= y + yKernel[i];
+
+					if( pDEMP->is_InGrid(ix, iy) )
+					{
+						s	+= pDEMP->asDouble(ix, iy);	n++;
+					}
+				}
+
+				Row[x]	= s / n;
+			}
+		}
+
+		//-------------------------------------------------
+		#pragma omp parallel for
+		for(int y=yBand; y<yStop; y++)
+		{
+			for(int x=0; x<Get_NX(); x++)
+			{
+				if( pDEMP->is_NoData(x, y) )
+				{
+					pSinks		->Set_NoData(x, y);
+					pShade		->Set_NoData(x, y);
+					pSlope		->Set_NoData(x, y);
+					pAspect		->Set_NoData(x, y);
+					pHCurv		->Set_NoData(x, y);
+					pVCurv		->Set_NoData(x, y);
+					pConvergence->Set_NoData(x, y);
+
+					continue;
+				}
+
+				int		i, ix, iy;
+				bool	bDir[8];
+				double	z	= pDEMP->asDouble(x, y), Dir[8], r, t, s, p, q, p2_q2;
+
+				//-----------------------------------------
+				if( pDEM->is_NoData(x, y) )	// grid calculator: g1 - g2
+				{
+					pSinks->Set_NoData(x, y);
+				}
+				else
+				{
+					pSinks->Set_Value(x, y, z - pDEM->asDouble(x, y));
+				}
+
+				//-----------------------------------------
+				if( !pDEMP->Get_Gradient(x, y, s, p) )
+				{
+					pShade->Set_NoData(x, y);
+				}
+				else
+				{
+					s	= M_PI_090 - atan(zScale * tan(s));
+
+					pShade->Set_Value(x, y, acos(sin(s) * sinHgt + cos(s) * cosHgt * cos(p - Azimuth)));
+				}
+
+				//-----------------------------------------
+				for(i=0; i<8; i++)
+				{
+					if( (bDir[i] = pDEMP->is_InGrid(ix = Get_xTo(i, x), iy = Get_yTo(i, y))) == true )
+					{
+						Dir[i]	= pDEMP->asDouble(ix, iy);
+					}
+				}
+
+				Get_Polynom(z, Dir, bDir, r, t, s, p, q);
+
+				pSlope->Set_Value(x, y, atan(sqrt(p*p + q*q)));
+
+				if( p != 0.0 || q != 0.0 )
+				{
+					pAspect->Set_Value(x, y, p != 0.0 ? M_PI_180 + atan2(q, p) : q > 0.0 ? M_PI_270 : M_PI_090);
+				}
+				else
+				{
+					pAspect->Set_NoData(x, y);
+				}
+
+				//-----------------------------------------
+				z	= Smooth[y - yBand + 1][x];
+
+				for(i=0; i<8; i++)
+				{
+					if( (bDir[i] = pDEMP->is_InGrid(ix = Get_xTo(i, x), iy = Get_yTo(i, y))) == true )
+					{
+						Dir[i]	= Smooth[iy - yBand + 1][ix];
+					}
+				}
+
+				Get_Polynom(z, Dir, bDir, r, t, s, p, q);
+
+				if( (p2_q2 = p*p + q*q) > 0.0 )
+				{
+					double	spq	= s * p * q, p2 = p*p, q2 = q*q;	r	*= 2;	t	*= 2;
+
+					pHCurv->Set_Value(x, y, -2 * (t * p2 + r * q2 - spq) / p2_q2);
+					pVCurv->Set_Value(x, y, -2 * (r * p2 + t * q2 + spq) / p2_q2);
+				}
+				else
+				{
+					pHCurv->Set_Value(x, y, 0.0);
+					pVCurv->Set_Value(x, y, 0.0);
+				}
+
+				//-----------------------------------------
+				pConvergence->Set_Value(x, y, Get_Convergence(z, Dir, bDir));
+			}
+		}
+	}
+
+	//-----------------------------------------------------
+	delete[](xKernel);
+
+	return( Process_Get_Okay() );	// false, if stopped by user
+}
+
+//---------------------------------------------------------
+// 9 parameter 2nd order polynom (Zevenbergen & Thorne 1987)
+// for the neighbourhood given in the direction order of
+// Get_xTo() / Get_yTo(), missing neighbours are mirrored.
+//---------------------------------------------------------
+void CTA_Standard::Get_Polynom(double z, const double Dir[8], const bool bDir[8], double &r, double &t, double &s, double &p, double &q)
+{
+	static const int	Index[8]	= { 5, 8, 7, 6, 3, 0, 1, 2 };
+
+	double	Z[9];	Z[4]	= 0.0;
+
+	for(int i=0; i<8; i++)
+	{
+		Z[Index[i]]	= bDir[i] ? Dir[i] - z : bDir[(i + 4) % 8] ? z - Dir[(i + 4) % 8] : 0.0;
+	}
+
+	r	= ((Z[3] + Z[5]) / 2.0 - Z[4]) / (    Get_Cellarea());
+	t	= ((Z[1] + Z[7]) / 2.0 - Z[4]) / (    Get_Cellarea());
+	s	=  (Z[0] - Z[2] - Z[6] + Z[8]) / (4 * Get_Cellarea());
+	p	=  (Z[5] - Z[3])               / (2 * Get_Cellsize());
+	q	=  (Z[7] - Z[1])               / (2 * Get_Cellsize());
+}
+
+//---------------------------------------------------------
+// Convergence index from the aspects of the four 2 x 2
+// sub-squares around the cell (Koethe & Lehmeier 1996).
+//---------------------------------------------------------
+double CTA_Standard::Get_Convergence(double z, const double Dir[8], const bool bDir[8])
+{
+	int		n	= 0;
+	double	dSum	= 0.0, iAspect = -M_PI_135;
+
+	for(int i=0; i<4; i++, iAspect+=M_PI_090)
+	{
+		double	Z[4];	// z[0] z[1] / z[2] z[3] as in CConvergence::Get_2x2_Gradient()
+
+		#define GET_Z(d)	((d) < 0 || !bDir[d] ? z : Dir[d])
+
+		switch( i )
+		{
+		case 0:	Z[0] = GET_Z(0); Z[1] = GET_Z(1); Z[2] = z       ; Z[3] = GET_Z(2);	break;
+		case 1:	Z[0] = z       ; Z[1] = GET_Z(2); Z[2] = GET_Z(4); Z[3] = GET_Z(3);	break;
+		case 2:	Z[0] = GET_Z(6); Z[1] = z       ; Z[2] = GET_Z(5); Z[3] = GET_Z(4);	break;
+		case 3:	Z[0] = GET_Z(7); Z[1] = GET_Z(0); Z[2] = GET_Z(6); Z[3] = z       ;	break;
+		}
+
+		#undef GET_Z
+
+		double	a	= ((Z[1] + Z[0]) - (Z[3] + Z[2])) / (2.0 * Get_Cellsize());
+		double	b	= ((Z[3] + Z[1]) - (Z[2] + Z[0])) / (2.0 * Get_Cellsize());
+
+		if( a != 0.0 || b != 0.0 )
+		{
+			double	d	= (a != 0.0 ? M_PI_180 + atan2(b, a) : b > 0.0 ? M_PI_270 : M_PI_090) - iAspect;
+
+			d	= fmod(d, M_PI_360);
+
+			if( d < -M_PI_180 )
+			{
+				d	+= M_PI_360;
+			}
+			else if( d > M_PI_180 )
+			{
+				d	-= M_PI_360;
+			}
+
+			dSum	+= fabs(d);
+			n++;
+		}
+	}
+
+	return( n > 0 ? (dSum / (double)n - M_PI_090) * 100.0 / M_PI_090 : 0.0 );
+}
+
+
 ///////////////////////////////////////////////////////////
 //														 //
 //														 //
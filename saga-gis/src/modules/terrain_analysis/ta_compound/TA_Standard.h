@@ -92,6 +92,15 @@ protected:
 
 	virtual bool			On_Execute		(void);
 
+
+private:
+
+	bool					Get_Local_Parameters	(CSG_Grid *pDEM, CSG_Grid *pDEMP);
+
+	void					Get_Polynom				(double z, const double Dir[8], const bool bDir[8], double &r, double &t, double &s, double &p, double &q);
+
+	double					Get_Convergence			(double z, const double Dir[8], const bool bDir[8]);
+
 };
 
 
@@ -126,6 +126,11 @@ CFlow_Parallel::CFlow_Parallel(void)
 		"    Precision Agriculture, 12(1), 32-43.\n"
 	));
 
+	m_Receivers	= NULL;
+	m_Donors	= NULL;
+	m_Direction	= NULL;
+	m_Fractions	= NULL;
+
 
 	//-----------------------------------------------------
 	Parameters.Add_Grid(
@@ -271,24 +276,67 @@ bool CFlow_Parallel::Calculate(int x, int y)
 bool CFlow_Parallel::Set_Flow(void)
 {
 	//-----------------------------------------------------
-	if( !m_pDTM->Set_Index() )
+	m_Method		= Parameters("METHOD")->asInt();
+
+	m_dLinear		= Parameters("LINEAR_DO")->asBool() ? Parameters("LINEAR_MIN")->asDouble() : -1.0;
+
+	m_pLinear_Val	= Parameters("LINEAR_VAL")->asGrid();
+
+	CSG_Grid	*pLinear_Dir	= Parameters("LINEAR_DIR")->asGrid();
+
+	//-----------------------------------------------------
+	// the Braunschweiger Reliefmodell and channel direction
+	// routing might send flow to higher cells, so these need
+	// the elevation sorted processing order...
+
+	if( m_Method == 2 || pLinear_Dir )
+	{
+		if( !Set_Flow_Sorted(pLinear_Dir) )
+		{
+			return( false );
+		}
+	}
+	else if( !Set_Flow_Ordered() )
 	{
 		return( false );
 	}
 
 	//-----------------------------------------------------
-	int Method	= Parameters("METHOD")->asInt();
-
-	if( Method == 2 )
+	if( m_pRoute )
 	{
-		BRM_Init();
+		if( !m_pDTM->Set_Index() )
+		{
+			return( false );
+		}
+
+		for(sLong n=0; n<Get_NCells() && Set_Progress_NCells(n); n++)
+		{
+			int		x, y;
+
+			if( m_pDTM->Get_Sorted(n, x, y, false) )
+			{
+				Check_Route(x, y);
+			}
+		}
 	}
 
 	//-----------------------------------------------------
-	double	dLinear	= Parameters("LINEAR_DO")->asBool() ? Parameters("LINEAR_MIN")->asDouble() : -1.0;
+	return( true );
+}
 
-	CSG_Grid	*pLinear_Val	= Parameters("LINEAR_VAL")->asGrid();
-	CSG_Grid	*pLinear_Dir	= Parameters("LINEAR_DIR")->asGrid();
+//---------------------------------------------------------
+bool CFlow_Parallel::Set_Flow_Sorted(CSG_Grid *pLinear_Dir)
+{
+	//-----------------------------------------------------
+	if( !m_pDTM->Set_Index() )
+	{
+		return( false );
+	}
+
+	if( m_Method == 2 )
+	{
+		BRM_Init();
+	}
 
 	//-----------------------------------------------------
 	for(sLong n=0; n<Get_NCells() && Set_Progress_NCells(n); n++)
@@ -306,11 +354,11 @@ bool CFlow_Parallel::Set_Flow(void)
 			{
 				Set_D8(x, y, pLinear_Dir->asInt(x, y));
 			}
-			else if( dLinear > 0.0 && dLinear <= (pLinear_Val && !pLinear_Val->is_NoData(x, y) ? pLinear_Val->asDouble(x, y) : m_pCatch->asDouble(x, y)) )
+			else if( is_Linear(x, y) )
 			{
-				Set_D8(x, y, pLinear_Dir && !pLinear_Dir->is_NoData(x, y) ? pLinear_Dir->asInt(x, y) : -1);
+				Set_D8(x, y);
 			}
-			else switch( Method )
+			else switch( m_Method )
 			{
 			case 0:	Set_D8    (x, y);	break;
 			case 1:	Set_Rho8  (x, y);	break;
@@ -323,24 +371,312 @@ bool CFlow_Parallel::Set_Flow(void)
 		}
 	}
 
+	return( true );
+}
+
+//---------------------------------------------------------
+bool CFlow_Parallel::is_Linear(int x, int y)
+{
+	return( m_dLinear > 0.0 && m_dLinear <= (m_pLinear_Val && !m_pLinear_Val->is_NoData(x, y)
+		? m_pLinear_Val->asDouble(x, y) : m_pCatch->asDouble(x, y))
+	);
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//				Topological Processing Order			 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// Instead of sorting the elevation model, each cell gets a
+// bit mask of the (lower) neighbours it drains to and a
+// count of the neighbours draining into it. Cells without
+// any pending donors form the next wave, all cells of one
+// wave are independent from each other and are processed
+// in parallel. Each cell only pulls the contributions of
+// its donors, so no cell is written by more than one thread.
+
+//---------------------------------------------------------
+bool CFlow_Parallel::Set_Flow_Ordered(void)
+{
 	//-----------------------------------------------------
-	if( m_pRoute )
+	bool	bSingle	= m_Method < 3;	// D8, Rho 8: a direction is all we need to store
+
+	m_Receivers	= (BYTE        *)SG_Calloc(Get_NCells(), sizeof(BYTE));
+	m_Donors	= (signed char *)SG_Calloc(Get_NCells(), sizeof(signed char));
+	m_Direction	= !bSingle ? NULL : (signed char *)SG_Malloc(Get_NCells() * sizeof(signed char));
+	m_Fractions	=  bSingle ? NULL : (float       *)SG_Malloc(Get_NCells() * 8 * sizeof(float));
+
+	if( !m_Receivers || !m_Donors || (!m_Direction && !m_Fractions) )
 	{
-		for(sLong n=0; n<Get_NCells() && Set_Progress_NCells(n); n++)
+		SG_FREE_SAFE(m_Receivers);
+		SG_FREE_SAFE(m_Donors);
+		SG_FREE_SAFE(m_Direction);
+		SG_FREE_SAFE(m_Fractions);
+
+		SG_UI_Msg_Add_Error(_TL("failed to allocate memory"));
+
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	int	x, y;
+
+	for(y=0; y<Get_NY() && Set_Progress(y); y++)
+	{
+		#pragma omp parallel for
+		for(x=0; x<Get_NX(); x++)
 		{
-			int		x, y;
+			m_Receivers[y * (sLong)Get_NX() + x]	= Get_Receivers(x, y);
+		}
+	}
 
-			if( m_pDTM->Get_Sorted(n, x, y, false) )
+	for(y=0; y<Get_NY() && Set_Progress(y); y++)
+	{
+		#pragma omp parallel for
+		for(x=0; x<Get_NX(); x++)
+		{
+			int	nDonors	= 0;
+
+			if( !m_pDTM->is_NoData(x, y) )
 			{
-				Check_Route(x, y);
+				for(int i=0; i<8; i++)
+				{
+					int	ix	= Get_xTo(i, x);
+					int	iy	= Get_yTo(i, y);
+
+					if( is_InGrid(ix, iy) && (m_Receivers[iy * (sLong)Get_NX() + ix] & (1 << ((i + 4) % 8))) )
+					{
+						nDonors++;
+					}
+				}
+			}
+
+			m_Donors[y * (sLong)Get_NX() + x]	= (signed char)nDonors;
+		}
+	}
+
+	//-----------------------------------------------------
+	CSG_Array	Cells[2];
+
+	Cells[0].Create(sizeof(sLong), 0, SG_ARRAY_GROWTH_3);
+	Cells[1].Create(sizeof(sLong), 0, SG_ARRAY_GROWTH_3);
+
+	for(sLong n=0; n<Get_NCells(); n++)
+	{
+		if( m_Donors[n] == 0 && !m_pDTM->is_NoData(n) )
+		{
+			m_Donors[n]	= -1;
+
+			Cells[0].Inc_Array(); ((sLong *)Cells[0].Get_Array())[Cells[0].Get_Size() - 1]	= n;
+		}
+	}
+
+	//-----------------------------------------------------
+	sLong	nDone	= 0;
+
+	for(int iWave=0; Cells[iWave].Get_Size() > 0 && Set_Progress_NCells(nDone); iWave=!iWave)
+	{
+		sLong	*pWave	= (sLong *)Cells[iWave].Get_Array(), nWave = (sLong)Cells[iWave].Get_Size();
+
+		#pragma omp parallel for
+		for(sLong i=0; i<nWave; i++)
+		{
+			int	x	= (int)(pWave[i] % Get_NX());
+			int	y	= (int)(pWave[i] / Get_NX());
+
+			Get_Inflow(x, y);
+
+			for(int j=0, Receivers=m_Receivers[pWave[i]]; j<8; j++)
+			{
+				if( Receivers & (1 << j) )
+				{
+					sLong	n	= Get_yTo(j, y) * (sLong)Get_NX() + Get_xTo(j, x);
+
+					#pragma omp atomic
+					m_Donors[n]	-= 1;
+				}
+			}
+		}
+
+		//-------------------------------------------------
+		CSG_Array	&Next	= Cells[!iWave];
+
+		Next.Set_Array(0, false);
+
+		for(sLong i=0; i<nWave; i++)
+		{
+			int	x	= (int)(pWave[i] % Get_NX());
+			int	y	= (int)(pWave[i] / Get_NX());
+
+			for(int j=0, Receivers=m_Receivers[pWave[i]]; j<8; j++)
+			{
+				sLong	n	= Get_yTo(j, y) * (sLong)Get_NX() + Get_xTo(j, x);
+
+				if( (Receivers & (1 << j)) && m_Donors[n] == 0 )
+				{
+					m_Donors[n]	= -1;
+
+					Next.Inc_Array(); ((sLong *)Next.Get_Array())[Next.Get_Size() - 1]	= n;
+				}
 			}
 		}
+
+		nDone	+= nWave;
 	}
 
 	//-----------------------------------------------------
+	SG_FREE_SAFE(m_Receivers);
+	SG_FREE_SAFE(m_Donors);
+	SG_FREE_SAFE(m_Direction);
+	SG_FREE_SAFE(m_Fractions);
+
 	return( true );
 }
 
+//---------------------------------------------------------
+BYTE CFlow_Parallel::Get_Receivers(int x, int y)
+{
+	if( m_pDTM->is_NoData(x, y) )
+	{
+		return( 0 );
+	}
+
+	//-----------------------------------------------------
+	// the fractions are evaluated only once per cell and
+	// stored for the inflow calculation of the receivers,
+	// Rho 8 is a random function anyway...
+
+	sLong	n	= y * (sLong)Get_NX() + x;
+
+	double	Fraction[8];
+
+	Get_Fractions(x, y, Fraction);
+
+	if( m_Direction )
+	{
+		m_Direction[n]	= -1;
+
+		for(int i=0; i<8; i++)
+		{
+			if( Fraction[i] > 0.0 )
+			{
+				m_Direction[n]	= (signed char)i;
+			}
+		}
+	}
+	else
+	{
+		for(int i=0; i<8; i++)
+		{
+			m_Fractions[8 * n + i]	= (float)Fraction[i];
+		}
+	}
+
+	if( m_dLinear > 0.0 )	// linear flow might be switched on by accumulated values
+	{
+		int	i	= m_pDTM->Get_Gradient_NeighborDir(x, y);
+
+		if( i >= 0 )
+		{
+			Fraction[i]	= 1.0;
+		}
+	}
+
+	//-----------------------------------------------------
+	BYTE	Receivers	= 0;
+
+	double	z	= m_pDTM->asDouble(x, y);
+
+	for(int i=0; i<8; i++)
+	{
+		int	ix	= Get_xTo(i, x);
+		int	iy	= Get_yTo(i, y);
+
+		if( Fraction[i] > 0.0 && m_pDTM->is_InGrid(ix, iy) && m_pDTM->asDouble(ix, iy) < z )
+		{
+			Receivers	|= 1 << i;
+		}
+	}
+
+	return( Receivers );
+}
+
+//---------------------------------------------------------
+void CFlow_Parallel::Get_Inflow(int x, int y)
+{
+	for(int i=0; i<8; i++)
+	{
+		int	ix	= Get_xTo(i, x);
+		int	iy	= Get_yTo(i, y);
+		int	j	= (i + 4) % 8;	// direction from donor to this cell
+
+		if( is_InGrid(ix, iy) && (m_Receivers[iy * (sLong)Get_NX() + ix] & (1 << j)) )
+		{
+			if( is_Linear(ix, iy) )
+			{
+				if( m_pDTM->Get_Gradient_NeighborDir(ix, iy) == j )
+				{
+					Add_Fraction(ix, iy, j);
+				}
+			}
+			else
+			{
+				sLong	n	= iy * (sLong)Get_NX() + ix;
+
+				double	Fraction	= m_Direction ? (m_Direction[n] == j ? 1.0 : 0.0) : m_Fractions[8 * n + j];
+
+				if( Fraction > 0.0 )	// receiver might only result from linear flow
+				{
+					Add_Fraction(ix, iy, j, Fraction);
+				}
+			}
+		}
+	}
+
+	if( m_bGT_Zero && m_pCatch->asDouble(x, y) < 0.0 )
+	{
+		m_pCatch->Set_Value(x, y, 0.0);
+	}
+}
+
+//---------------------------------------------------------
+void CFlow_Parallel::Get_Fractions(int x, int y, double Fraction[8])
+{
+	int	i;
+
+	switch( m_Method )
+	{
+	default:
+		for(i=0; i<8; i++)	Fraction[i]	= 0.0;
+
+		if( (i = m_Method == 1 ? Get_Rho8(x, y) : m_pDTM->Get_Gradient_NeighborDir(x, y)) >= 0 )
+		{
+			Fraction[i]	= 1.0;
+		}
+		break;
+
+	case 3:	Get_DInf  (x, y, Fraction);	break;
+	case 4:	Get_MFD   (x, y, Fraction);	break;
+	case 5:	Get_MDInf (x, y, Fraction);	break;
+	case 6:	Get_MMDGFD(x, y, Fraction);	break;
+	}
+}
+
+//---------------------------------------------------------
+void CFlow_Parallel::Add_Fractions(int x, int y, double Fraction[8])
+{
+	for(int i=0; i<8; i++)
+	{
+		if( Fraction[i] != 0.0 )
+		{
+			Add_Fraction(x, y, i, Fraction[i]);
+		}
+	}
+}
+
 
 ///////////////////////////////////////////////////////////
 //														 //
@@ -419,6 +755,12 @@ void CFlow_Parallel::Set_D8(int x, int y, int Direction)
 
 //---------------------------------------------------------
 void CFlow_Parallel::Set_Rho8(int x, int y)
+{
+	Add_Fraction(x, y, Get_Rho8(x, y));
+}
+
+//---------------------------------------------------------
+int CFlow_Parallel::Get_Rho8(int x, int y)
 {
 	int		iMax	= -1;
 	double	dMax, z	= m_pDTM->asDouble(x, y);
@@ -430,7 +772,7 @@ void CFlow_Parallel::Set_Rho8(int x, int y)
 
 		if( !m_pDTM->is_InGrid(ix, iy) )
 		{
-			return;
+			return( -1 );
 		}
 		else
 		{
@@ -449,10 +791,7 @@ void CFlow_Parallel::Set_Rho8(int x, int y)
 		}
 	}
 
-	if( iMax >= 0 )
-	{
-		Add_Fraction(x, y, iMax);
-	}
+	return( iMax );
 }
 
 /*void CFlow_Parallel::Set_Rho8(	int x, int y )
@@ -495,9 +834,21 @@ void CFlow_Parallel::Set_Rho8(int x, int y)
 
 //---------------------------------------------------------
 void CFlow_Parallel::Set_DInf(int x, int y)
+{
+	double	Fraction[8];
+
+	Get_DInf(x, y, Fraction);
+
+	Add_Fractions(x, y, Fraction);
+}
+
+//---------------------------------------------------------
+void CFlow_Parallel::Get_DInf(int x, int y, double Fraction[8])
 {
 	double	s, a;
 
+	for(int i=0; i<8; i++)	Fraction[i]	= 0.0;
+
 	if( m_pDTM->Get_Gradient(x, y, s, a) && a >= 0.0 )
 	{
 		int	i, ix, iy;
@@ -509,14 +860,19 @@ void CFlow_Parallel::Set_DInf(int x, int y)
 		if( m_pDTM->is_InGrid(ix = Get_xTo(i + 0, x), iy = Get_yTo(i + 0, y)) && m_pDTM->asDouble(ix, iy) < s
 		&&  m_pDTM->is_InGrid(ix = Get_xTo(i + 1, x), iy = Get_yTo(i + 1, y)) && m_pDTM->asDouble(ix, iy) < s )
 		{
-			Add_Fraction(x, y,  i         , 1.0 - a);
-			Add_Fraction(x, y, (i + 1) % 8,       a);
+			Fraction[ i         ]	= 1.0 - a;
+			Fraction[(i + 1) % 8]	=       a;
 
 			return;
 		}
 	}
 
-	Set_D8(x, y);
+	int	i	= m_pDTM->Get_Gradient_NeighborDir(x, y);
+
+	if( i >= 0 )
+	{
+		Fraction[i]	= 1.0;
+	}
 }
 
 
@@ -528,6 +884,16 @@ void CFlow_Parallel::Set_DInf(int x, int y)
 
 //---------------------------------------------------------
 void CFlow_Parallel::Set_MFD(int x, int y)
+{
+	double	Fraction[8];
+
+	Get_MFD(x, y, Fraction);
+
+	Add_Fractions(x, y, Fraction);
+}
+
+//---------------------------------------------------------
+void CFlow_Parallel::Get_MFD(int x, int y, double Fraction[8])
 {
 	int		i, ix, iy;
 	double	z, d, dzSum, dz[8];
@@ -568,15 +934,9 @@ void CFlow_Parallel::Set_MFD(int x, int y)
 	}
 
 	//-----------------------------------------------------
-	if( dzSum > 0.0 )
+	for(i=0; i<8; i++)
 	{
-		for(i=0; i<8; i++)
-		{
-			if( dz[i] > 0.0 )
-			{
-				Add_Fraction(x, y, i, dz[i] / dzSum);
-			}
-		}
+		Fraction[i]	= dzSum > 0.0 ? dz[i] / dzSum : 0.0;
 	}
 }
 
@@ -589,6 +949,16 @@ void CFlow_Parallel::Set_MFD(int x, int y)
 
 //---------------------------------------------------------
 void CFlow_Parallel::Set_MMDGFD(int x, int y)
+{
+	double	Fraction[8];
+
+	Get_MMDGFD(x, y, Fraction);
+
+	Add_Fractions(x, y, Fraction);
+}
+
+//---------------------------------------------------------
+void CFlow_Parallel::Get_MMDGFD(int x, int y, double Fraction[8])
 {
 	int		i, ix, iy;
 	double	z, d, dzMax, dzSum, dz[8];
@@ -634,25 +1004,17 @@ void CFlow_Parallel::Set_MMDGFD(int x, int y)
 	}
 
 	//-----------------------------------------------------
-	if( dzMax > 0.0 )
+	for(i=0, dzSum=0.0; i<8; i++)
 	{
-		dzMax	= dzMax < 1.0 ? 8.9 * dzMax + 1.1 : 10.0;
-
-		for(i=0, dzSum=0.0; i<8; i++)
+		if( dz[i] > 0.0 )
 		{
-			if( dz[i] > 0.0 )
-			{
-				dzSum	+= (dz[i]	= pow(dz[i], dzMax));
-			}
+			dzSum	+= (dz[i]	= pow(dz[i], dzMax < 1.0 ? 8.9 * dzMax + 1.1 : 10.0));
 		}
+	}
 
-		for(i=0; i<8; i++)
-		{
-			if( dz[i] > 0.0 )
-			{
-				Add_Fraction(x, y, i, dz[i] / dzSum);
-			}
-		}
+	for(i=0; i<8; i++)
+	{
+		Fraction[i]	= dzSum > 0.0 ? dz[i] / dzSum : 0.0;
 	}
 }
 
@@ -665,10 +1027,20 @@ void CFlow_Parallel::Set_MMDGFD(int x, int y)
 
 //---------------------------------------------------------
 void CFlow_Parallel::Set_MDInf(int x, int y)
+{
+	double	Fraction[8];
+
+	Get_MDInf(x, y, Fraction);
+
+	Add_Fractions(x, y, Fraction);
+}
+
+//---------------------------------------------------------
+void CFlow_Parallel::Get_MDInf(int x, int y, double portion[8])
 {
 	int		i, ix, iy;
 
-	double	dz[8], s_facet[8], r_facet[8], valley[8], portion[8];
+	double	dz[8], s_facet[8], r_facet[8], valley[8];
 
 	bool	bInGrid[8];
 
@@ -825,11 +1197,6 @@ void CFlow_Parallel::Set_MDInf(int x, int y)
 				portion[j]	+= valley[i] * (r_facet[i] - (i  ) * M_PI_045) / M_PI_045;	// vb-code: portion(j) = portion(j) + valley(i) * (r_facet(i) - (i - 1) * PI / 4) / (PI / 4)
 			}
 		}
-
-		for(i=0; i<8; i++)
-		{
-			Add_Fraction(x, y, i, portion[i]);
-		}
 	}
 }
 
@@ -100,16 +100,43 @@ protected:
 
 private:
 
+	int						m_Method;
+
+	double					m_dLinear;
+
+	BYTE					*m_Receivers;
+
+	signed char				*m_Donors, *m_Direction;
+
+	float					*m_Fractions;
+
+	CSG_Grid				*m_pLinear_Val;
+
+
 	bool					Set_Flow		(void);
+	bool					Set_Flow_Sorted	(CSG_Grid *pLinear_Dir);
+	bool					Set_Flow_Ordered(void);
+
+	bool					is_Linear		(int x, int y);
+
+	BYTE					Get_Receivers	(int x, int y);
+	void					Get_Inflow		(int x, int y);
+	void					Get_Fractions	(int x, int y, double Fraction[8]);
+	void					Add_Fractions	(int x, int y, double Fraction[8]);
 
 	void					Check_Route		(int x, int y);
 
 	void					Set_D8			(int x, int y, int Direction = -1);
 	void					Set_Rho8		(int x, int y );
+	int						Get_Rho8		(int x, int y );
 	void					Set_DInf		(int x, int y );
+	void					Get_DInf		(int x, int y, double Fraction[8]);
 	void					Set_MFD			(int x, int y );
+	void					Get_MFD			(int x, int y, double Fraction[8]);
 	void					Set_MMDGFD		(int x, int y );	
+	void					Get_MMDGFD		(int x, int y, double Fraction[8]);
 	void					Set_MDInf		(int x, int y );	
+	void					Get_MDInf		(int x, int y, double Fraction[8]);
 	void					Set_BRM			(int x, int y );
 
 	//-----------------------------------------------------
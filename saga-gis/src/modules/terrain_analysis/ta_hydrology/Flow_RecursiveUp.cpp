@@ -302,15 +302,74 @@ bool CFlow_RecursiveUp::Calculate(int x, int y)
 //														 //
 ///////////////////////////////////////////////////////////
 
+//---------------------------------------------------------
+class CFlow_Stack : public CSG_Stack
+{
+public:
+	CFlow_Stack(void) : CSG_Stack(3 * sizeof(int))	{}
+
+	bool					Push			(int  x, int  y, int  i)
+	{
+		int	*pRecord	= (int *)Get_Record_Push();
+
+		if( pRecord )
+		{
+			pRecord[0]	= x;
+			pRecord[1]	= y;
+			pRecord[2]	= i;
+
+			return( true );
+		}
+
+		return( false );
+	}
+
+	bool					Pop				(int &x, int &y, int &i)
+	{
+		int	*pRecord	= (int *)Get_Record_Pop();
+
+		if( pRecord )
+		{
+			x	= pRecord[0];
+			y	= pRecord[1];
+			i	= pRecord[2];
+
+			return( true );
+		}
+
+		return( false );
+	}
+};
+
+//---------------------------------------------------------
+// The upward recursion is unrolled with an explicit stack,
+// that keeps the direction to continue with for each cell,
+// so the depth of the flow paths is not limited by the call
+// stack. The processing order is the same as with the call
+// recursion. A donor count based ordering (see CFlow_Parallel)
+// is not applicable here: the aspect based methods and the
+// channel routes might send flow to cells that are not lower,
+// which is resolved by the locks, and a single cell's
+// calculation only visits its upslope area.
+
 //---------------------------------------------------------
 void CFlow_RecursiveUp::Get_Flow(int x, int y)
 {
-	if( is_Locked(x, y) == false )
+	if( is_Locked(x, y) )
 	{
-		Lock_Set (x, y);
-		Init_Cell(x, y);
+		return;
+	}
+
+	Lock_Set (x, y);
+	Init_Cell(x, y);
 
-		for(int i=0; i<8; i++)
+	CFlow_Stack	Stack;	Stack.Push(x, y, 0);
+
+	int	i;
+
+	while( Stack.Pop(x, y, i) )
+	{
+		for(; i<8; i++)
 		{
 			int	ix	= Get_xTo(i, x);
 			int	iy	= Get_yTo(i, y);
@@ -322,13 +381,25 @@ void CFlow_RecursiveUp::Get_Flow(int x, int y)
 
 				if( iFlow > 0.0 )
 				{
-					Get_Flow    (ix, iy);
+					if( !is_Locked(ix, iy) )	// process the donor first, then come back to this direction
+					{
+						Lock_Set (ix, iy);
+						Init_Cell(ix, iy);
+
+						break;
+					}
+
 					Add_Fraction(ix, iy, iDir, iFlow);
 				}
 			}
 		}
 
-		if( m_bGT_Zero && m_pCatch->asDouble(x, y) < 0.0 )
+		if( i < 8 )
+		{
+			Stack.Push(x, y, i);
+			Stack.Push(Get_xTo(i, x), Get_yTo(i, y), 0);
+		}
+		else if( m_bGT_Zero && m_pCatch->asDouble(x, y) < 0.0 )
 		{
 			m_pCatch->Set_Value(x, y, 0.0);
 		}
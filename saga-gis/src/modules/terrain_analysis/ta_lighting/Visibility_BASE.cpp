@@ -61,6 +61,8 @@
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
+#include <float.h>
+
 #include "Visibility_BASE.h"
 
 
@@ -108,129 +110,192 @@ void CVisibility_BASE::Initialize(CSG_Grid *pVisibility, int iMethod)
 }
 
 
+//---------------------------------------------------------
+// The viewshed is swept in concentric square rings around
+// the observer (XDraw). Each cell's line of sight crosses
+// the next inner ring between two cells, whose maximum
+// elevation angles are interpolated. A cell is visible if
+// its own elevation angle reaches this horizon, which it
+// then propagates to the next ring. Only the two current
+// rings are kept and the cells of a ring are independent,
+// so each ring is processed in parallel.
+//---------------------------------------------------------
+static inline int	Get_Ring_Index	(int dx, int dy, int k)
+{
+	if( dy == -k )	return(         dx + k );
+	if( dx ==  k )	return( 2 * k + dy + k );
+	if( dy ==  k )	return( 4 * k + k - dx );
+
+	return( 6 * k + k - dy );
+}
+
+//---------------------------------------------------------
+static inline void	Get_Ring_Cell	(int i, int k, int &dx, int &dy)
+{
+	if     ( i <= 2 * k )	{	dx	= i - k;			dy	= -k;				}
+	else if( i <= 4 * k )	{	dx	=  k;				dy	= i - 2 * k - k;	}
+	else if( i <= 6 * k )	{	dx	= k - (i - 4 * k);	dy	=  k;				}
+	else					{	dx	= -k;				dy	= k - (i - 6 * k);	}
+}
+
 //---------------------------------------------------------
 void CVisibility_BASE::Set_Visibility(CSG_Grid *pDTM, CSG_Grid *pVisibility, int x_Pos, int y_Pos, double z_Pos, double dHeight, int iMethod)
 {
-	double		Exaggeration	= 1.0;
+	int	nRings	= M_GET_MAX(M_GET_MAX(x_Pos, pDTM->Get_NX() - 1 - x_Pos), M_GET_MAX(y_Pos, pDTM->Get_NY() - 1 - y_Pos));
 
-	double		aziDTM, decDTM,
-				aziSrc, decSrc,
-				d, dx, dy, dz;
+	if( pDTM->is_NoData(x_Pos, y_Pos) )
+	{
+		pVisibility->Set_NoData(x_Pos, y_Pos);
+	}
+	else
+	{
+		Set_Visible(pDTM, pVisibility, x_Pos, y_Pos, 0.0, 0.0, z_Pos - pDTM->asDouble(x_Pos, y_Pos), dHeight, iMethod);
+	}
+
+	if( nRings < 1 )
+	{
+		return;
+	}
+
+	//-----------------------------------------------------
+	// maximum elevation angle (as tangent) along the line of sight, for the inner and the current ring
 
+	double	*Inner	= (double *)SG_Malloc(2 * (8 * nRings + 1) * sizeof(double));
+	double	*Outer	= Inner + 8 * nRings + 1;
 
-	for(int y=0; y<pDTM->Get_NY() && SG_UI_Process_Set_Progress(y, pDTM->Get_NY()); y++)
+	for(int k=1; k<=nRings && SG_UI_Process_Set_Progress(k, nRings); k++)
 	{
-		for(int x=0; x<pDTM->Get_NX(); x++)
+		#pragma omp parallel for if(k > 16)
+		for(int i=0; i<8*k; i++)
 		{
-			if( pDTM->is_NoData(x, y) )
+			int	dx, dy, x, y;
+
+			Get_Ring_Cell(i, k, dx, dy);
+
+			if( !pDTM->is_InGrid(x = x_Pos + dx, y = y_Pos + dy, false) )
 			{
-				pVisibility->Set_NoData(x, y);
+				continue;
 			}
-			else
+
+			//---------------------------------------------
+			double	Horizon	= -DBL_MAX;
+
+			if( k > 1 )
 			{
-				dx		= x_Pos - x;
-				dy		= y_Pos - y;
-				dz		= z_Pos - pDTM->asDouble(x, y);
+				int		ix, iy;	double	t;
 
-				//-----------------------------------------
-				if( Trace_Point(pDTM, x, y, dx, dy, dz) )
+				if( abs(dx) >= abs(dy) )	// the line of sight crosses the inner ring's column...
 				{
-					switch( iMethod )
-					{
-					case 0:		// Visibility
-						pVisibility->Set_Value(x, y, 1);
-						break;
+					double	py	= dy * (k - 1) / (double)k;
 
-					case 1:		// Shade
-						pDTM->Get_Gradient(x, y, decDTM, aziDTM);
-						decDTM	= M_PI_090 - atan(Exaggeration * tan(decDTM));
+					ix	= dx > 0 ? dx - 1 : dx + 1;
+					iy	= (int)floor(py);
+					t	= py - iy;
 
-						decSrc	= atan2(dz, sqrt(dx*dx + dy*dy));
-						aziSrc	= atan2(dx, dy);
+					Horizon	= Inner[Get_Ring_Index(ix, iy, k - 1)];
 
-						d		= acos(sin(decDTM) * sin(decSrc) + cos(decDTM) * cos(decSrc) * cos(aziDTM - aziSrc));
+					if( t > 0.0 )
+					{
+						Horizon	= (1.0 - t) * Horizon + t * Inner[Get_Ring_Index(ix, iy + 1, k - 1)];
+					}
+				}
+				else						// ...or its row
+				{
+					double	px	= dx * (k - 1) / (double)k;
 
-						if( d > M_PI_090 )
-							d = M_PI_090;
+					iy	= dy > 0 ? dy - 1 : dy + 1;
+					ix	= (int)floor(px);
+					t	= px - ix;
 
-						if( pVisibility->asDouble(x, y) > d )
-							pVisibility->Set_Value(x, y, d);
-						break;
+					Horizon	= Inner[Get_Ring_Index(ix, iy, k - 1)];
 
-					case 2:		// Distance
-						d		= pDTM->Get_Cellsize() * sqrt(dx*dx + dy*dy);
+					if( t > 0.0 )
+					{
+						Horizon	= (1.0 - t) * Horizon + t * Inner[Get_Ring_Index(ix + 1, iy, k - 1)];
+					}
+				}
+			}
 
-						if( pVisibility->is_NoData(x, y) || pVisibility->asDouble(x, y) > d )
-							pVisibility->Set_Value(x, y, d);
-						break;
+			//---------------------------------------------
+			if( pDTM->is_NoData(x, y) )
+			{
+				pVisibility->Set_NoData(x, y);
 
-					case 3:		// Size
-						if( (d = pDTM->Get_Cellsize() * sqrt(dx*dx + dy*dy)) > 0.0 )
-						{
-							d	= atan2(dHeight, d);
-							if( pVisibility->is_NoData(x, y) || pVisibility->asDouble(x, y) < d )
-								pVisibility->Set_Value(x, y, d);
-						}
-						break;
-					}
+				Outer[i]	= Horizon;	// does not block the view
+			}
+			else
+			{
+				double	dz		= z_Pos - pDTM->asDouble(x, y);
+				double	Angle	= -dz / sqrt((double)(dx*dx + dy*dy));
+
+				if( Angle >= Horizon )
+				{
+					Set_Visible(pDTM, pVisibility, x, y, -dx, -dy, dz, dHeight, iMethod);
+
+					Outer[i]	= Angle;
+				}
+				else
+				{
+					Outer[i]	= Horizon;
 				}
 			}
 		}
+
+		double	*Swap	= Inner;	Inner	= Outer;	Outer	= Swap;
 	}
 
+	SG_Free(Inner < Outer ? Inner : Outer);
+
 	return;
 }
 
-
 //---------------------------------------------------------
-bool CVisibility_BASE::Trace_Point(CSG_Grid *pDTM, int x, int y, double dx, double dy, double dz)
+void CVisibility_BASE::Set_Visible(CSG_Grid *pDTM, CSG_Grid *pVisibility, int x, int y, double dx, double dy, double dz, double dHeight, int iMethod)
 {
-	double	ix, iy, iz, id, d, dist;
+	double		Exaggeration	= 1.0;
 
-	d		= fabs(dx) > fabs(dy) ? fabs(dx) : fabs(dy);
+	double		aziDTM, decDTM,
+				aziSrc, decSrc,
+				d;
 
-	if( d > 0 )
+	switch( iMethod )
 	{
-		dist	= sqrt(dx*dx + dy*dy);
+	case 0:		// Visibility
+		pVisibility->Set_Value(x, y, 1);
+		break;
 
-		dx		/= d;
-		dy		/= d;
-		dz		/= d;
+	case 1:		// Shade
+		pDTM->Get_Gradient(x, y, decDTM, aziDTM);
+		decDTM	= M_PI_090 - atan(Exaggeration * tan(decDTM));
 
-		d		= dist / d;
+		decSrc	= atan2(dz, sqrt(dx*dx + dy*dy));
+		aziSrc	= atan2(dx, dy);
 
-		id		= 0.0;
-		ix		= x + 0.5;
-		iy		= y + 0.5;
-		iz		= pDTM->asDouble(x, y);
+		d		= acos(sin(decDTM) * sin(decSrc) + cos(decDTM) * cos(decSrc) * cos(aziDTM - aziSrc));
 
-		while( id < dist )
-		{
-			id	+= d;
+		if( d > M_PI_090 )
+			d = M_PI_090;
 
-			ix	+= dx;
-			iy	+= dy;
-			iz	+= dz;
+		if( pVisibility->asDouble(x, y) > d )
+			pVisibility->Set_Value(x, y, d);
+		break;
 
-			x	= (int)ix;
-			y	= (int)iy;
+	case 2:		// Distance
+		d		= pDTM->Get_Cellsize() * sqrt(dx*dx + dy*dy);
 
-			if( !pDTM->is_InGrid(x, y) )
-			{
-				return( true );
-			}
-			else if( iz < pDTM->asDouble(x, y) )
-			{
-				return( false );
-			}
-			else if( iz > pDTM->Get_ZMax() )
-			{
-				return( true );
-			}
+		if( pVisibility->is_NoData(x, y) || pVisibility->asDouble(x, y) > d )
+			pVisibility->Set_Value(x, y, d);
+		break;
+
+	case 3:		// Size
+		if( (d = pDTM->Get_Cellsize() * sqrt(dx*dx + dy*dy)) > 0.0 )
+		{
+			d	= atan2(dHeight, d);
+			if( pVisibility->is_NoData(x, y) || pVisibility->asDouble(x, y) < d )
+				pVisibility->Set_Value(x, y, d);
 		}
+		break;
 	}
-
-	return( true );
 }
 
 
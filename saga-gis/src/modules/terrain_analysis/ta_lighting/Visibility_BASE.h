@@ -93,11 +93,12 @@ protected:
 
 	void		Initialize		(CSG_Grid *pVisibility, int iMethod);
 	void		Set_Visibility	(CSG_Grid *pDTM, CSG_Grid *pVisibility, int x_Pos, int y_Pos, double z_Pos, double dHeight, int iMethod);
-	bool		Trace_Point		(CSG_Grid *pDTM, int x, int y, double dx, double dy, double dz);
 	void		Finalize		(CSG_Grid *pVisibility, int iMethod);
 
 private:
 
+	void		Set_Visible		(CSG_Grid *pDTM, CSG_Grid *pVisibility, int x, int y, double dx, double dy, double dz, double dHeight, int iMethod);
+
 
 };
 
@@ -288,50 +288,17 @@ bool CMRVBF::Get_Smoothed(CSG_Grid *pDEM, CSG_Grid *pSmoothed, int Radius, doubl
 {
 	if( pDEM && pSmoothed )
 	{
-		int		x, y, ix, iy, jx, jy, kx, ky;
-		double	d, s;
+		// exp(-(d / 3)^2) = exp(-(dx / 3)^2) * exp(-(dy / 3)^2), so the kernel can be applied separately to rows and columns
+		CSG_Vector	Kernel(1 + Radius);
 
-		CSG_Grid	Kernel(SG_DATATYPE_Double, 1 + 2 * Radius, 1 + 2 * Radius);
-
-		for(iy=-Radius, ky=0; iy<=Radius; iy++, ky++)
+		for(int i=0; i<=Radius; i++)
 		{
-			for(ix=-Radius, kx=0; ix<=Radius; ix++, kx++)
-			{
-				Kernel.Set_Value(kx, ky, 4.3565 * exp(-SG_Get_Square(sqrt((double)ix*ix + iy*iy) / 3.0)) );
-			//	Kernel.Set_Value(kx, ky, exp(-(ix*ix + iy*iy) / (2.0 * s)) / (2.0 * M_PI * s));
-			}
+			Kernel[i]	= exp(-SG_Get_Square(i / 3.0));
 		}
 
 		pSmoothed->Create(pDEM, SG_DATATYPE_Float);
 
-		for(y=0; y<pDEM->Get_NY() && Set_Progress(y, pDEM->Get_NY()); y++)
-		{
-			for(x=0; x<pDEM->Get_NX(); x++)
-			{
-				for(iy=-Radius, jy=y-Radius, ky=0, s=d=0.0; iy<=Radius; iy++, jy++, ky++)
-				{
-					for(ix=-Radius, jx=x-Radius, kx=0; ix<=Radius; ix++, jx++, kx++)
-					{
-						if( pDEM->is_InGrid(jx, jy) )
-						{
-							s	+= Kernel.asDouble(kx, ky) * pDEM->asDouble(jx, jy);
-							d	+= Kernel.asDouble(kx, ky);
-						}
-					}
-				}
-
-				if( d > 0.0 )
-				{
-					pSmoothed->Set_Value(x, y, s / d);
-				}
-				else
-				{
-					pSmoothed->Set_NoData(x, y);
-				}
-			}
-		}
-
-		return( true );
+		return( SG_Grid_Filter_Separable(pDEM, pSmoothed, Kernel, true) );
 	}
 
 	return( false );
@@ -0,0 +1,688 @@
+/**********************************************************
+ * Version $Id$
+ *********************************************************/
+
+///////////////////////////////////////////////////////////
+//                                                       //
+//                         SAGA                          //
+//                                                       //
+//      System for Automated Geoscientific Analyses      //
+//                                                       //
+//                    Module Library:                    //
+//                    ta_preprocessor                    //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//                   FillSinks_PF.cpp                    //
+//                                                       //
+//                 Copyright (C) 2015 by                 //
+//                      Olaf Conrad                      //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+// This file is part of 'SAGA - System for Automated     //
+// Geoscientific Analyses'. SAGA is free software; you   //
+// can redistribute it and/or modify it under the terms  //
+// of the GNU General Public License as published by the //
+// Free Software Foundation; version 2 of the License.   //
+//                                                       //
+// SAGA is distributed in the hope that it will be       //
+// useful, but WITHOUT ANY WARRANTY; without even the    //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A  //
+// PARTICULAR PURPOSE. See the GNU General Public        //
+// License for more details.                             //
+//                                                       //
+// You should have received a copy of the GNU General    //
+// Public License along with this program; if not,       //
+// write to the Free Software Foundation, Inc.,          //
+// 51 Franklin Street, 5th Floor, Boston, MA 02110-1301, //
+// USA.                                                  //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//    e-mail:     oconrad@saga-gis.org                   //
+//                                                       //
+//    contact:    Olaf Conrad                            //
+//                Institute of Geography                 //
+//                University of Hamburg                  //
+//                Germany                                //
+//                                                       //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+#include "FillSinks_PF.h"
+
+#include <float.h>
+#include <queue>
+#include <algorithm>
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+typedef struct SPF_Node
+{
+	sLong	n;
+
+	double	z;
+}
+TPF_Node;
+
+//---------------------------------------------------------
+struct SPF_Node_Greater
+{
+	bool operator () (const TPF_Node &a, const TPF_Node &b) const
+	{
+		return( a.z > b.z );
+	}
+};
+
+typedef std::priority_queue<TPF_Node, std::vector<TPF_Node>, SPF_Node_Greater>	CPF_Queue;
+
+//---------------------------------------------------------
+inline TPF_Node	PF_Node	(sLong n, double z)
+{
+	TPF_Node	Node;	Node.n	= n;	Node.z	= z;	return( Node );
+}
+
+//---------------------------------------------------------
+inline void		PF_Edge_Add		(CPF_Edges &Edges, sLong a, sLong b, double z)
+{
+	TPF_Edge	Edge;
+
+	Edge.a	= a < b ? a : b;
+	Edge.b	= a < b ? b : a;
+	Edge.z	= z;
+
+	Edges.push_back(Edge);
+}
+
+//---------------------------------------------------------
+bool			PF_Edge_Less	(const TPF_Edge &e1, const TPF_Edge &e2)
+{
+	return( e1.a < e2.a || (e1.a == e2.a && (e1.b < e2.b || (e1.b == e2.b && e1.z < e2.z))) );
+}
+
+bool			PF_Edge_Equal	(const TPF_Edge &e1, const TPF_Edge &e2)
+{
+	return( e1.a == e2.a && e1.b == e2.b );
+}
+
+//---------------------------------------------------------
+void			PF_Edges_Compact(CPF_Edges &Edges)	// keeps the lowest spill elevation for each pair of labels
+{
+	std::sort(Edges.begin(), Edges.end(), PF_Edge_Less);
+
+	Edges.erase(std::unique(Edges.begin(), Edges.end(), PF_Edge_Equal), Edges.end());
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+CFillSinks_PF::CFillSinks_PF(void)
+{
+	Set_Name		(_TL("Fill Sinks (Priority-Flood)"));
+
+	Set_Author		(SG_T("O.Conrad (c) 2015"));
+
+	Set_Description	(_TW(
+		"Depression filling with the Priority-Flood algorithm. Like the Wang & Liu method the DEM is "
+		"flooded from its border inwards, but cells that have to be raised, i.e. cells in depressions "
+		"and on flats, are processed with a plain queue instead of the priority queue. A minimum slope "
+		"can be preserved between cells (epsilon filling).\n"
+		"The tiled mode fills each tile independently and in parallel, treating the tile border as outlet. "
+		"Spill elevations are then resolved on a graph connecting the watersheds of the tile borders "
+		"and each tile is raised to the spill elevation of its watersheds in a second pass. "
+		"Memory is only needed for the tiles being processed and the watershed graph, so even very large DEMs "
+		"can be filled if the grids are kept in the file cache. The tiled mode fills to the spill elevation, "
+		"the minimum slope option is not supported.\n"
+		"\n"
+		"References:\n"
+		"Barnes, R., Lehman, C., Mulla, D. (2014): Priority-Flood: An optimal depression-filling and watershed-labeling "
+		"algorithm for digital elevation models. Computers & Geosciences, Vol. 62: 117-127.\n"
+		"\n"
+		"Barnes, R. (2016): Parallel Priority-Flood depression filling for trillion cell digital elevation models "
+		"on desktops or clusters. Computers & Geosciences, Vol. 96: 56-68.\n"
+		"\n"
+		"Wang, L. & H. Liu (2006): An efficient method for identifying and filling surface depressions in "
+		"digital elevation models for hydrologic analysis and modelling. International Journal of Geographical "
+		"Information Science, Vol. 20, No. 2: 193-213.\n"
+	));
+
+	Parameters.Add_Grid(
+		NULL, "ELEV"		, _TL("DEM"),
+		_TL("Digital elevation model"),
+		PARAMETER_INPUT
+	);
+
+	Parameters.Add_Grid(
+		NULL, "FILLED"		, _TL("Filled DEM"),
+		_TL("Depression-free digital elevation model"),
+		PARAMETER_OUTPUT
+	);
+
+	Parameters.Add_Choice(
+		NULL, "METHOD"		, _TL("Method"),
+		_TL(""),
+		CSG_String::Format(SG_T("%s|%s|"),
+			_TL("global queue"),
+			_TL("tiles")
+		), 0
+	);
+
+	Parameters.Add_Value(
+		NULL, "MINSLOPE"	, _TL("Minimum Slope [Degree]"),
+		_TL("Minimum slope gradient to preserve from cell to cell; with a value of zero sinks are filled up to the spill elevation (which results in flat areas). Unit [Degree]"),
+		PARAMETER_TYPE_Double, 0.0, 0.0, true
+	);
+
+	Parameters.Add_Value(
+		NULL, "TILE_SIZE"	, _TL("Tile Size"),
+		_TL("Number of rows and columns of a tile."),
+		PARAMETER_TYPE_Int, 1024, 16, true
+	);
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+int CFillSinks_PF::On_Parameters_Enable(CSG_Parameters *pParameters, CSG_Parameter *pParameter)
+{
+	if( !SG_STR_CMP(pParameter->Get_Identifier(), "METHOD") )
+	{
+		pParameters->Get_Parameter("MINSLOPE" )->Set_Enabled(pParameter->asInt() == 0);
+		pParameters->Get_Parameter("TILE_SIZE")->Set_Enabled(pParameter->asInt() == 1);
+	}
+
+	return( 1 );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CFillSinks_PF::On_Execute(void)
+{
+	//-----------------------------------------------------
+	m_pDEM		= Parameters("ELEV"  )->asGrid();
+	m_pFilled	= Parameters("FILLED")->asGrid();
+
+	m_pFilled->Set_Name(CSG_String::Format(SG_T("%s [%s]"), m_pDEM->Get_Name(), _TL("no sinks")));
+
+	//-----------------------------------------------------
+	double	MinSlope	= Parameters("METHOD")->asInt() == 0 ? tan(Parameters("MINSLOPE")->asDouble() * M_DEG_TO_RAD) : 0.0;
+
+	for(int i=0; i<8; i++)
+	{
+		m_dzMin[i]	= MinSlope * Get_Length(i);
+	}
+
+	//-----------------------------------------------------
+	switch( Parameters("METHOD")->asInt() )
+	{
+	default:	return( Fill_Grid () );
+	case  1:	return( Fill_Tiles(Parameters("TILE_SIZE")->asInt()) );
+	}
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//					Global Priority Queue				 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CFillSinks_PF::Fill_Grid(void)
+{
+	bool	bEpsilon	= m_dzMin[0] > 0.0;
+
+	CPF_Queue				Open;
+	std::queue<TPF_Node>	Pit;
+
+	m_pFilled->Assign_NoData();
+
+	//-----------------------------------------------------
+	for(int y=0; y<Get_NY() && Set_Progress(y); y++)
+	{
+		for(int x=0; x<Get_NX(); x++)
+		{
+			if( !m_pDEM->is_NoData(x, y) )
+			{
+				for(int i=0; i<8; i++)
+				{
+					int	ix	= Get_xTo(i, x);
+					int	iy	= Get_yTo(i, y);
+
+					if( !is_InGrid(ix, iy) || m_pDEM->is_NoData(ix, iy) )
+					{
+						m_pFilled->Set_Value(x, y, m_pDEM->asDouble(x, y));
+
+						Open.push(PF_Node(y * (sLong)Get_NX() + x, m_pDEM->asDouble(x, y)));
+
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	//-----------------------------------------------------
+	// cells raised to the level of their neighbour cannot be
+	// lower than anything in the priority queue, so these are
+	// processed with a plain queue. When preserving a minimum
+	// slope the raised cells are taken from the plain queue as
+	// long as they are not higher than the priority queue's top.
+
+	for(sLong n=0; !Open.empty() || !Pit.empty(); n++)
+	{
+		if( (n % 65536) == 0 && !Set_Progress_NCells(n) )
+		{
+			return( false );
+		}
+
+		TPF_Node	c;
+
+		if( !Pit.empty() && (!bEpsilon || Open.empty() || Pit.front().z <= Open.top().z) )
+		{
+			c	= Pit .front();	Pit .pop();
+		}
+		else
+		{
+			c	= Open.top  ();	Open.pop();
+		}
+
+		int	x	= (int)(c.n % Get_NX());
+		int	y	= (int)(c.n / Get_NX());
+
+		for(int i=0; i<8; i++)
+		{
+			int	ix	= Get_xTo(i, x);
+			int	iy	= Get_yTo(i, y);
+
+			if( is_InGrid(ix, iy) && !m_pDEM->is_NoData(ix, iy) && m_pFilled->is_NoData(ix, iy) )
+			{
+				double	z	= m_pDEM->asDouble(ix, iy);
+
+				if( bEpsilon ? z < c.z + m_dzMin[i] : z <= c.z )
+				{
+					z	= c.z + m_dzMin[i];
+
+					m_pFilled->Set_Value(ix, iy, z);
+
+					Pit .push(PF_Node(iy * (sLong)Get_NX() + ix, z));
+				}
+				else
+				{
+					m_pFilled->Set_Value(ix, iy, z);
+
+					Open.push(PF_Node(iy * (sLong)Get_NX() + ix, z));
+				}
+			}
+		}
+	}
+
+	//-----------------------------------------------------
+	return( true );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//						Tiles							 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// Pass 1 floods each tile from its border. Each border cell
+// starts its own watershed, except for cells draining out of
+// the grid or to no-data, which are labelled as 'ocean' (0).
+// The lowest spill elevations between neighbouring watersheds
+// are collected as edges of a graph, which are completed by
+// the edges linking the border cells of neighbouring tiles.
+// Flooding the graph from the ocean gives the spill elevation
+// of each watershed. Pass 2 repeats the flooding of each tile
+// and raises its cells to the spill elevation of their
+// watersheds. Only the labels of the tile borders are kept
+// between both passes.
+
+//---------------------------------------------------------
+bool CFillSinks_PF::Fill_Tiles(int Size)
+{
+	int		nxTiles		= 1 + (Get_NX() - 1) / Size;
+	int		nyTiles		= 1 + (Get_NY() - 1) / Size;
+
+	sLong	nPerTile	= 4 * (sLong)Size;	// maximum number of border cells
+	sLong	nLabels		= 1 + nPerTile * nxTiles * nyTiles;
+
+	bool	bParallel	= !m_pDEM   ->is_Cached() && !m_pDEM   ->is_Compressed()
+						&& !m_pFilled->is_Cached() && !m_pFilled->is_Compressed();
+
+	std::vector<sLong>	Border(nPerTile * nxTiles * nyTiles, -1);
+
+	CPF_Edges	Edges;
+
+	//-----------------------------------------------------
+	Process_Set_Text(_TL("flooding tiles"));
+
+	for(int ty=0; ty<nyTiles && Set_Progress(ty, nyTiles); ty++)
+	{
+		#pragma omp parallel for schedule(dynamic) if(bParallel)
+		for(int tx=0; tx<nxTiles; tx++)
+		{
+			int	xOff	= tx * Size, nx = M_GET_MIN(Size, Get_NX() - xOff);
+			int	yOff	= ty * Size, ny = M_GET_MIN(Size, Get_NY() - yOff);
+
+			sLong	iTile	= ty * (sLong)nxTiles + tx;
+
+			std::vector<double>	z(nx * ny);
+			std::vector<sLong>	Label(nx * ny);
+
+			CPF_Edges	Tile_Edges;
+
+			Fill_Tile(xOff, yOff, nx, ny, 1 + iTile * nPerTile, &z[0], &Label[0], &Tile_Edges);
+
+			//---------------------------------------------
+			sLong	*pBorder	= &Border[iTile * nPerTile];
+
+			for(int x=0; x<nx; x++)
+			{
+				pBorder[           x]	= Label[                x];
+				pBorder[    Size + x]	= Label[(ny - 1) * nx + x];
+			}
+
+			for(int y=0; y<ny; y++)
+			{
+				pBorder[2 * Size + y]	= Label[y * nx         ];
+				pBorder[3 * Size + y]	= Label[y * nx + nx - 1];
+			}
+
+			PF_Edges_Compact(Tile_Edges);
+
+			#pragma omp critical
+			{
+				Edges.insert(Edges.end(), Tile_Edges.begin(), Tile_Edges.end());
+			}
+		}
+	}
+
+	if( !Process_Get_Okay() )
+	{
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	#define GET_BORDER(x, y)	Border[((y) / Size * (sLong)nxTiles + (x) / Size) * nPerTile + (\
+		(y) % Size == 0                                      ?            (x) % Size :\
+		(y) % Size == Size - 1 || (y) == Get_NY() - 1        ?     Size + (x) % Size :\
+		(x) % Size == 0                                      ? 2 * Size + (y) % Size :\
+		                                                       3 * Size + (y) % Size)]
+
+	for(int tx=1; tx<nxTiles; tx++)
+	{
+		int	x	= tx * Size;
+
+		for(int y=0; y<Get_NY(); y++)
+		{
+			for(int iy=y-1; iy<=y+1; iy++)
+			{
+				if( is_InGrid(x, iy) && !m_pDEM->is_NoData(x - 1, y) && !m_pDEM->is_NoData(x, iy) && GET_BORDER(x - 1, y) != GET_BORDER(x, iy) )
+				{
+					PF_Edge_Add(Edges, GET_BORDER(x - 1, y), GET_BORDER(x, iy), M_GET_MAX(m_pDEM->asDouble(x - 1, y), m_pDEM->asDouble(x, iy)));
+				}
+			}
+		}
+	}
+
+	for(int ty=1; ty<nyTiles; ty++)
+	{
+		int	y	= ty * Size;
+
+		for(int x=0; x<Get_NX(); x++)
+		{
+			for(int ix=x-1; ix<=x+1; ix++)
+			{
+				if( is_InGrid(ix, y) && !m_pDEM->is_NoData(x, y - 1) && !m_pDEM->is_NoData(ix, y) && GET_BORDER(x, y - 1) != GET_BORDER(ix, y) )
+				{
+					PF_Edge_Add(Edges, GET_BORDER(x, y - 1), GET_BORDER(ix, y), M_GET_MAX(m_pDEM->asDouble(x, y - 1), m_pDEM->asDouble(ix, y)));
+				}
+			}
+		}
+	}
+
+	#undef GET_BORDER
+
+	Border.clear();
+
+	//-----------------------------------------------------
+	Process_Set_Text(_TL("resolving spill elevations"));
+
+	PF_Edges_Compact(Edges);
+
+	std::vector<sLong>	First(nLabels + 1, 0), Link(2 * Edges.size());
+
+	for(size_t i=0; i<Edges.size(); i++)
+	{
+		First[Edges[i].a + 1]++;
+		First[Edges[i].b + 1]++;
+	}
+
+	for(sLong i=0; i<nLabels; i++)
+	{
+		First[i + 1]	+= First[i];
+	}
+
+	{
+		std::vector<sLong>	Next(First.begin(), First.end() - 1);
+
+		for(size_t i=0; i<Edges.size(); i++)
+		{
+			Link[Next[Edges[i].a]++]	= i;
+			Link[Next[Edges[i].b]++]	= i;
+		}
+	}
+
+	//-----------------------------------------------------
+	std::vector<double>	Spill(nLabels, DBL_MAX);
+
+	CPF_Queue	Open;
+
+	Spill[0]	= -DBL_MAX;	Open.push(PF_Node(0, -DBL_MAX));
+
+	while( !Open.empty() )
+	{
+		TPF_Node	c	= Open.top();	Open.pop();
+
+		if( c.z <= Spill[c.n] )
+		{
+			for(sLong i=First[c.n]; i<First[c.n + 1]; i++)
+			{
+				const TPF_Edge	&Edge	= Edges[Link[i]];
+
+				sLong	n	= Edge.a == c.n ? Edge.b : Edge.a;
+				double	z	= M_GET_MAX(c.z, Edge.z);
+
+				if( z < Spill[n] )
+				{
+					Spill[n]	= z;
+
+					Open.push(PF_Node(n, z));
+				}
+			}
+		}
+	}
+
+	First.clear();	Link.clear();	Edges.clear();
+
+	//-----------------------------------------------------
+	Process_Set_Text(_TL("filling tiles"));
+
+	for(int ty=0; ty<nyTiles && Set_Progress(ty, nyTiles); ty++)
+	{
+		#pragma omp parallel for schedule(dynamic) if(bParallel)
+		for(int tx=0; tx<nxTiles; tx++)
+		{
+			int	xOff	= tx * Size, nx = M_GET_MIN(Size, Get_NX() - xOff);
+			int	yOff	= ty * Size, ny = M_GET_MIN(Size, Get_NY() - yOff);
+
+			std::vector<double>	z(nx * ny);
+			std::vector<sLong>	Label(nx * ny);
+
+			Fill_Tile(xOff, yOff, nx, ny, 1 + (ty * (sLong)nxTiles + tx) * nPerTile, &z[0], &Label[0], NULL);
+
+			for(int y=0, i=0; y<ny; y++)
+			{
+				for(int x=0; x<nx; x++, i++)
+				{
+					if( Label[i] < 0 )
+					{
+						m_pFilled->Set_NoData(xOff + x, yOff + y);
+					}
+					else
+					{
+						m_pFilled->Set_Value (xOff + x, yOff + y, Spill[Label[i]] < DBL_MAX ? M_GET_MAX(z[i], Spill[Label[i]]) : z[i]);
+					}
+				}
+			}
+		}
+	}
+
+	//-----------------------------------------------------
+	return( Process_Get_Okay() );
+}
+
+//---------------------------------------------------------
+void CFillSinks_PF::Fill_Tile(int xOff, int yOff, int nx, int ny, sLong Label0, double *z, sLong *Label, CPF_Edges *pEdges)
+{
+	CPF_Queue				Open;
+	std::queue<TPF_Node>	Pit;
+
+	//-----------------------------------------------------
+	for(int y=0, n=0; y<ny; y++)
+	{
+		for(int x=0; x<nx; x++, n++)
+		{
+			int	gx	= xOff + x;
+			int	gy	= yOff + y;
+
+			if( m_pDEM->is_NoData(gx, gy) )
+			{
+				Label[n]	= -1;	// no-data
+			}
+			else
+			{
+				Label[n]	= -2;	// not yet flooded
+				z    [n]	= m_pDEM->asDouble(gx, gy);
+
+				bool	bOutlet	= false;
+
+				for(int i=0; i<8 && !bOutlet; i++)
+				{
+					int	ix	= Get_xTo(i, gx);
+					int	iy	= Get_yTo(i, gy);
+
+					bOutlet	= !is_InGrid(ix, iy) || m_pDEM->is_NoData(ix, iy);
+				}
+
+				if( bOutlet )
+				{
+					Label[n]	= 0;
+				}
+				else if( x == 0 || y == 0 || x == nx - 1 || y == ny - 1 )
+				{
+					Label[n]	= Label0++;
+				}
+
+				if( Label[n] >= 0 )
+				{
+					Open.push(PF_Node(n, z[n]));
+				}
+			}
+		}
+	}
+
+	//-----------------------------------------------------
+	while( !Open.empty() || !Pit.empty() )
+	{
+		TPF_Node	c;
+
+		if( !Pit.empty() )
+		{
+			c	= Pit .front();	Pit .pop();
+		}
+		else
+		{
+			c	= Open.top  ();	Open.pop();
+		}
+
+		int	x	= (int)(c.n % nx);
+		int	y	= (int)(c.n / nx);
+
+		for(int i=0; i<8; i++)
+		{
+			int	ix	= Get_xTo(i, x);
+			int	iy	= Get_yTo(i, y);
+
+			if( ix >= 0 && ix < nx && iy >= 0 && iy < ny )
+			{
+				sLong	n	= iy * (sLong)nx + ix;
+
+				if( Label[n] == -2 )
+				{
+					Label[n]	= Label[c.n];
+
+					if( z[n] <= c.z )
+					{
+						z[n]	= c.z;
+
+						Pit .push(PF_Node(n, z[n]));
+					}
+					else
+					{
+						Open.push(PF_Node(n, z[n]));
+					}
+				}
+				else if( pEdges && Label[n] >= 0 && Label[n] != Label[c.n] )
+				{
+					PF_Edge_Add(*pEdges, Label[c.n], Label[n], M_GET_MAX(c.z, z[n]));
+				}
+			}
+		}
+	}
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
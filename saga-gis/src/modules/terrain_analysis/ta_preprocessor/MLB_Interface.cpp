@@ -97,6 +97,7 @@ CSG_String Get_Info(int i)
 
 #include "FillSinks.h"
 #include "FillSinks_WL.h"
+#include "FillSinks_PF.h"
 
 #include "burn_in_streams.h"
 
@@ -115,6 +116,8 @@ CSG_Module *		Create_Module(int i)
 	case  5:	return( new CFillSinks_WL_XXL );
 
 	case  6:	return( new CBurnIn_Streams );
+
+	case  7:	return( new CFillSinks_PF );
 	}
 
 	return( NULL );
@@ -71,6 +71,41 @@
 //														 //
 ///////////////////////////////////////////////////////////
 
+//---------------------------------------------------------
+#ifdef _OPENMP
+#include <omp.h>
+
+//---------------------------------------------------------
+// Data managers might be accessed concurrently by tools, that
+// are executed in parallel (see CSG_Module_Schedule). A single
+// recursive lock serializes all access to any data manager. It
+// is defined before g_Data_Manager to be destroyed after it.
+
+class CSG_Data_Manager_Lock
+{
+public:
+	CSG_Data_Manager_Lock(void)		{	omp_init_nest_lock   (&m_Lock);	}
+	~CSG_Data_Manager_Lock(void)	{	omp_destroy_nest_lock(&m_Lock);	}
+
+	omp_nest_lock_t		m_Lock;
+};
+
+static CSG_Data_Manager_Lock	g_Data_Manager_Lock;
+
+//---------------------------------------------------------
+class CSG_Data_Manager_Guard
+{
+public:
+	CSG_Data_Manager_Guard(void)	{	omp_set_nest_lock  (&g_Data_Manager_Lock.m_Lock);	}
+	~CSG_Data_Manager_Guard(void)	{	omp_unset_nest_lock(&g_Data_Manager_Lock.m_Lock);	}
+};
+
+#define DATA_MANAGER_LOCK	CSG_Data_Manager_Guard	Guard
+
+#else
+#define DATA_MANAGER_LOCK
+#endif
+
 //---------------------------------------------------------
 CSG_Data_Manager		g_Data_Manager;
 
@@ -219,7 +254,7 @@ bool CSG_Data_Collection::Delete_Unsaved(bool bDetachOnly)
 	{
 		if( !SG_File_Exists(Get(i - 1)->Get_File_Name()) )
 		{
-			Delete(i, bDetachOnly);
+			Delete(i - 1, bDetachOnly);
 		}
 	}
 
@@ -336,6 +371,8 @@ CSG_Data_Collection * CSG_Data_Manager::_Get_Collection(CSG_Data_Object *pObject
 //---------------------------------------------------------
 CSG_Grid_Collection * CSG_Data_Manager::Get_Grid_System(const CSG_Grid_System &System) const
 {
+	DATA_MANAGER_LOCK;
+
 	for(size_t i=0; i<Grid_System_Count(); i++)
 	{
 		CSG_Grid_Collection	*pSystem	= Get_Grid_System(i);
@@ -358,6 +395,8 @@ bool CSG_Data_Manager::Exists(const CSG_Grid_System &System) const
 //---------------------------------------------------------
 bool CSG_Data_Manager::Exists(CSG_Data_Object *pObject) const
 {
+	DATA_MANAGER_LOCK;
+
 	if( m_pTable      ->Exists(pObject) )	return( true );
 	if( m_pTIN        ->Exists(pObject) )	return( true );
 	if( m_pPoint_Cloud->Exists(pObject) )	return( true );
@@ -374,6 +413,8 @@ bool CSG_Data_Manager::Exists(CSG_Data_Object *pObject) const
 //---------------------------------------------------------
 CSG_Data_Object *  CSG_Data_Manager::Find(const CSG_String &File, bool bNative) const
 {
+	DATA_MANAGER_LOCK;
+
 	CSG_Data_Object	*pObject;
 
 	if( (pObject = m_pTable      ->Get(File, bNative)) != NULL )	return( pObject );
@@ -397,6 +438,8 @@ CSG_Data_Object *  CSG_Data_Manager::Find(const CSG_String &File, bool bNative)
 //---------------------------------------------------------
 bool CSG_Data_Manager::Add(CSG_Data_Object *pObject)
 {
+	DATA_MANAGER_LOCK;
+
 	CSG_Data_Collection	*pCollection	= _Get_Collection(pObject);
 
 	if( pCollection == NULL && pObject != DATAOBJECT_NOTSET && pObject != DATAOBJECT_CREATE && pObject->Get_ObjectType() == DATAOBJECT_TYPE_Grid && m_Grid_Systems.Inc_Array() )
@@ -412,6 +455,8 @@ bool CSG_Data_Manager::Add(CSG_Data_Object *pObject)
 //---------------------------------------------------------
 bool CSG_Data_Manager::Add(const CSG_String &File, TSG_Data_Object_Type Type)
 {
+	DATA_MANAGER_LOCK;
+
 	//-----------------------------------------------------
 	if( Type == DATAOBJECT_TYPE_Undefined )
 	{
@@ -610,6 +655,8 @@ CSG_Grid * CSG_Data_Manager::Add_Grid(int NX, int NY, double Cellsize, double xM
 //---------------------------------------------------------
 bool CSG_Data_Manager::Delete(CSG_Data_Collection *pCollection, bool bDetachOnly)
 {
+	DATA_MANAGER_LOCK;
+
 	if( pCollection == NULL || pCollection->m_pManager != this )
 	{
 		return( false );
@@ -660,6 +707,8 @@ bool CSG_Data_Manager::Delete(CSG_Data_Collection *pCollection, bool bDetachOnly
 //---------------------------------------------------------
 bool CSG_Data_Manager::Delete(CSG_Data_Object *pObject, bool bDetachOnly)
 {
+	DATA_MANAGER_LOCK;
+
 	CSG_Data_Collection	*pCollection	= _Get_Collection(pObject);
 
 	if( pCollection && pCollection->Delete(pObject, bDetachOnly) )
@@ -684,6 +733,8 @@ bool CSG_Data_Manager::Delete(const CSG_Grid_System &System, bool bDetachOnly)
 //---------------------------------------------------------
 bool CSG_Data_Manager::Delete_All(bool bDetachOnly)
 {
+	DATA_MANAGER_LOCK;
+
 	m_pTable      ->Delete_All(bDetachOnly);
 	m_pTIN        ->Delete_All(bDetachOnly);
 	m_pPoint_Cloud->Delete_All(bDetachOnly);
@@ -706,6 +757,8 @@ bool CSG_Data_Manager::Delete_All(bool bDetachOnly)
 //---------------------------------------------------------
 bool CSG_Data_Manager::Delete_Unsaved(bool bDetachOnly)
 {
+	DATA_MANAGER_LOCK;
+
 	m_pTable      ->Delete_Unsaved(bDetachOnly);
 	m_pTIN        ->Delete_Unsaved(bDetachOnly);
 	m_pPoint_Cloud->Delete_Unsaved(bDetachOnly);
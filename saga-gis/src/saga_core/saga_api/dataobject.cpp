@@ -66,6 +66,48 @@
 #include "dataobject.h"
 
 
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+#ifdef _OPENMP
+#include <omp.h>
+
+//---------------------------------------------------------
+// Tools running in parallel (see CSG_Module_Schedule) might
+// request the lazily updated statistics of a shared input at
+// the same time. Updates are serialized with a recursive lock,
+// because an update might query other data objects.
+
+class CSG_Data_Object_Update_Lock
+{
+public:
+	CSG_Data_Object_Update_Lock(void)	{	omp_init_nest_lock   (&m_Lock);	}
+	~CSG_Data_Object_Update_Lock(void)	{	omp_destroy_nest_lock(&m_Lock);	}
+
+	omp_nest_lock_t		m_Lock;
+};
+
+static CSG_Data_Object_Update_Lock	g_Data_Object_Update_Lock;
+
+//---------------------------------------------------------
+class CSG_Data_Object_Update_Guard
+{
+public:
+	CSG_Data_Object_Update_Guard(void)	{	omp_set_nest_lock  (&g_Data_Object_Update_Lock.m_Lock);	}
+	~CSG_Data_Object_Update_Guard(void)	{	omp_unset_nest_lock(&g_Data_Object_Update_Lock.m_Lock);	}
+};
+
+#define DATA_OBJECT_UPDATE_LOCK	CSG_Data_Object_Update_Guard	Guard
+
+#else
+#define DATA_OBJECT_UPDATE_LOCK
+#endif
+
+
 ///////////////////////////////////////////////////////////
 //														 //
 //														 //
@@ -353,9 +395,11 @@ bool CSG_Data_Object::Save_MetaData(const SG_Char *File_Name)
 //---------------------------------------------------------
 bool CSG_Data_Object::Update(void)
 {
+	DATA_OBJECT_UPDATE_LOCK;	// check and update under the lock, so that other threads wait for the results
+
 	if( m_bUpdate )
 	{
-		m_bUpdate	= false;
+		m_bUpdate	= false;	// reset before, On_Update() might request a further update
 
 		return( On_Update() );
 	}
@@ -253,12 +253,26 @@ void CSG_Grid::_On_Construction(void)
 
 	m_LineBuffer		= NULL;
 	m_LineBuffer_Count	= 5;
+	m_Buffer_Size		= 0;
+
+	m_Cache_Tiles		= NULL;
+
+	m_Map_Data			= NULL;
+	m_Map_Handle		= NULL;
+	m_Map_Size			= 0;
 
 	m_zScale			= 1.0;
 	m_zOffset			= 0.0;
 
 	m_Index				= NULL;
 	m_bIndex			= false;
+	m_bIndex32			= false;
+
+	m_zStats_bBlocks	= false;
+	m_zStats_bModified	= NULL;
+	m_zStats_Blocks		= NULL;
+	m_zStats_nBlocks	= 0;
+	m_zStats_nRows		= 1;
 
 	Set_Update_Flag();
 }
@@ -454,6 +468,8 @@ bool CSG_Grid::Destroy(void)
 {
 	_Memory_Destroy();
 
+	_Statistics_Destroy();
+
 	m_bCreated		= false;
 
 	m_Type			= SG_DATATYPE_Undefined;
@@ -504,6 +520,8 @@ void CSG_Grid::_Set_Properties(TSG_Data_Type Type, int NX, int NY, double Cellsi
 
 	m_zStats.Invalidate();
 
+	_Statistics_Destroy();
+
 }
 
 //---------------------------------------------------------
@@ -529,6 +547,8 @@ void CSG_Grid::Set_Scaling(double Scale, double Offset)
 
 		m_zOffset	= Offset;
 
+		m_zStats_bBlocks	= false;
+
 		Set_Update_Flag();
 	}
 }
@@ -603,6 +623,187 @@ bool CSG_Grid::is_Compatible(int NX, int NY, double Cellsize, double xMin, doubl
 }
 
 
+///////////////////////////////////////////////////////////
+//														 //
+//					Value access by Row					 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+template <typename TYPE>
+inline void	SG_Grid_Row_Get	(const void *pData, double *Values, int n)
+{
+	const TYPE	*pValue	= (const TYPE *)pData;
+
+	for(int x=0; x<n; x++)
+	{
+		Values[x]	= (double)pValue[x];
+	}
+}
+
+//---------------------------------------------------------
+/**
+  * Copies the values of row y to the Values array, which must
+  * provide space for Get_NX() values. Type conversion, scaling
+  * and no-data checks are done once per row instead of through
+  * the virtual cell accessors. If bNoData is not NULL it receives
+  * the no-data state of each cell.
+*/
+bool CSG_Grid::Get_Row(int y, double *Values, bool bScaled, bool *bNoData) const
+{
+	if( !is_Valid() || !Values || y < 0 || y >= Get_NY() )
+	{
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	const void	*pData	= NULL;
+
+	if( _is_Array() )
+	{
+		pData	= m_Values[y];
+	}
+	else if( is_Compressed() )
+	{
+		TSG_Grid_Line	*pLine	= _LineBuffer_Get_Line(y);
+
+		pData	= pLine ? pLine->Data : NULL;
+	}
+
+	if( pData )
+	{
+		switch( m_Type )
+		{
+		default:	return( false );
+		case SG_DATATYPE_Byte  :	SG_Grid_Row_Get<BYTE  >(pData, Values, Get_NX());	break;
+		case SG_DATATYPE_Char  :	SG_Grid_Row_Get<char  >(pData, Values, Get_NX());	break;
+		case SG_DATATYPE_Word  :	SG_Grid_Row_Get<WORD  >(pData, Values, Get_NX());	break;
+		case SG_DATATYPE_Short :	SG_Grid_Row_Get<short >(pData, Values, Get_NX());	break;
+		case SG_DATATYPE_DWord :	SG_Grid_Row_Get<DWORD >(pData, Values, Get_NX());	break;
+		case SG_DATATYPE_Int   :	SG_Grid_Row_Get<int   >(pData, Values, Get_NX());	break;
+		case SG_DATATYPE_Long  :	SG_Grid_Row_Get<sLong >(pData, Values, Get_NX());	break;
+		case SG_DATATYPE_Float :	SG_Grid_Row_Get<float >(pData, Values, Get_NX());	break;
+		case SG_DATATYPE_Double:	memcpy(Values, pData, Get_NX() * sizeof(double));	break;
+		case SG_DATATYPE_Bit   :
+			for(int x=0; x<Get_NX(); x++)
+			{
+				Values[x]	= (((const BYTE *)pData)[x / 8] & m_Bitmask[x % 8]) == 0 ? 0.0 : 1.0;
+			}
+			break;
+		}
+	}
+	else if( is_Cached() )
+	{
+		for(int x=0; x<Get_NX(); x++)
+		{
+			Values[x]	= _Cache_Get_Value(x, y);
+		}
+	}
+	else
+	{
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	if( bNoData )
+	{
+		for(int x=0; x<Get_NX(); x++)
+		{
+			bNoData[x]	= is_NoData_Value(Values[x]);
+		}
+	}
+
+	if( bScaled && is_Scaled() )
+	{
+		for(int x=0; x<Get_NX(); x++)
+		{
+			Values[x]	= m_zOffset + m_zScale * Values[x];
+		}
+	}
+
+	return( true );
+}
+
+//---------------------------------------------------------
+/**
+  * Sets the values of row y from the Values array. Cells, for
+  * which bNoData is given and true, are set to no-data.
+*/
+bool CSG_Grid::Set_Row(int y, const double *Values, bool bScaled, const bool *bNoData)
+{
+	if( !is_Valid() || !Values || y < 0 || y >= Get_NY() )
+	{
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	void	*pData	= NULL;
+
+	if( _is_Array() )
+	{
+		pData	= m_Values[y];
+	}
+	else if( is_Compressed() )
+	{
+		TSG_Grid_Line	*pLine	= _LineBuffer_Get_Line(y);
+
+		if( pLine )
+		{
+			pData	= pLine->Data;
+
+			pLine->bModified	= true;
+		}
+	}
+
+	if( !pData )
+	{
+		for(int x=0; x<Get_NX(); x++)
+		{
+			if( bNoData && bNoData[x] )
+			{
+				Set_NoData(x, y);
+			}
+			else
+			{
+				Set_Value(x, y, Values[x], bScaled);
+			}
+		}
+
+		return( true );
+	}
+
+	//-----------------------------------------------------
+	bScaled	= bScaled && is_Scaled();
+
+	for(int x=0; x<Get_NX(); x++)
+	{
+		double	Value	= bNoData && bNoData[x] ? Get_NoData_Value() : bScaled ? (Values[x] - m_zOffset) / m_zScale : Values[x];
+
+		switch( m_Type )
+		{
+		default:	return( false );
+		case SG_DATATYPE_Byte  :	((BYTE   *)pData)[x]	= SG_ROUND_TO_BYTE (Value);	break;
+		case SG_DATATYPE_Char  :	((char   *)pData)[x]	= SG_ROUND_TO_CHAR (Value);	break;
+		case SG_DATATYPE_Word  :	((WORD   *)pData)[x]	= SG_ROUND_TO_WORD (Value);	break;
+		case SG_DATATYPE_Short :	((short  *)pData)[x]	= SG_ROUND_TO_SHORT(Value);	break;
+		case SG_DATATYPE_DWord :	((DWORD  *)pData)[x]	= SG_ROUND_TO_DWORD(Value);	break;
+		case SG_DATATYPE_Int   :	((int    *)pData)[x]	= SG_ROUND_TO_INT  (Value);	break;
+		case SG_DATATYPE_Long  :	((sLong  *)pData)[x]	= SG_ROUND_TO_SLONG(Value);	break;
+		case SG_DATATYPE_Float :	((float  *)pData)[x]	= (float )Value;			break;
+		case SG_DATATYPE_Double:	((double *)pData)[x]	= (double)Value;			break;
+		case SG_DATATYPE_Bit   :	((BYTE   *)pData)[x / 8]	= Value != 0.0
+				? ((BYTE *)pData)[x / 8] |   m_Bitmask[x % 8]
+				: ((BYTE *)pData)[x / 8] & (~m_Bitmask[x % 8]);
+			break;
+		}
+	}
+
+	_Set_Modified(y);
+
+	return( true );
+}
+
+
 ///////////////////////////////////////////////////////////
 //														 //
 //		Value access by Position (-> Interpolation)		 //
@@ -1112,23 +1313,144 @@ inline bool CSG_Grid::_Get_ValAtPos_Fill4x4Submatrix(int x, int y, double z_xy[4
 //														 //
 ///////////////////////////////////////////////////////////
 
+//---------------------------------------------------------
+// Statistics are collected for blocks of rows, which are
+// evaluated in parallel and merged afterwards. Only blocks
+// that have been modified by Set_Value() or Set_Row() since
+// the last update are re-evaluated, any other modification
+// invalidates all blocks.
+//---------------------------------------------------------
+#define GRID_STATS_BLOCK_CELLS	65536
+
+//---------------------------------------------------------
+bool CSG_Grid::_Statistics_Create(void)
+{
+	_Statistics_Destroy();
+
+	if( Get_NX() > 0 && Get_NY() > 0 )
+	{
+		m_zStats_nRows		= Get_NX() < GRID_STATS_BLOCK_CELLS ? GRID_STATS_BLOCK_CELLS / Get_NX() : 1;
+		m_zStats_nBlocks	= 1 + (Get_NY() - 1) / m_zStats_nRows;
+
+		if( (m_zStats_bModified = (bool *)SG_Malloc(m_zStats_nBlocks * sizeof(bool))) != NULL )
+		{
+			m_zStats_Blocks	= new CSG_Simple_Statistics[m_zStats_nBlocks];
+
+			m_zStats_bBlocks	= false;
+
+			return( true );
+		}
+	}
+
+	m_zStats_nBlocks	= 0;
+	m_zStats_nRows		= 1;
+
+	return( false );
+}
+
+//---------------------------------------------------------
+void CSG_Grid::_Statistics_Destroy(void)
+{
+	if( m_zStats_Blocks )
+	{
+		delete[](m_zStats_Blocks);
+
+		m_zStats_Blocks	= NULL;
+	}
+
+	SG_FREE_SAFE(m_zStats_bModified);
+
+	m_zStats_bBlocks	= false;
+	m_zStats_nBlocks	= 0;
+	m_zStats_nRows		= 1;
+}
+
+//---------------------------------------------------------
+void CSG_Grid::_Statistics_Update(int iBlock)
+{
+	CSG_Simple_Statistics	&Statistics	= m_zStats_Blocks[iBlock];
+
+	Statistics.Invalidate();
+
+	m_zStats_bModified[iBlock]	= false;
+
+	double	*Values		= (double *)SG_Malloc(Get_NX() * (sizeof(double) + sizeof(bool)));
+	bool	*bNoData	= (bool   *)(Values + Get_NX());
+
+	if( Values )
+	{
+		for(int y=iBlock*m_zStats_nRows, yMax=y+m_zStats_nRows; y<yMax && y<Get_NY(); y++)
+		{
+			if( Get_Row(y, Values, true, bNoData) )
+			{
+				for(int x=0; x<Get_NX(); x++)
+				{
+					if( !bNoData[x] )
+					{
+						Statistics.Add_Value(Values[x]);
+					}
+				}
+			}
+		}
+
+		SG_Free(Values);
+	}
+}
+
 //---------------------------------------------------------
 bool CSG_Grid::On_Update(void)
 {
 	if( is_Valid() )
 	{
-		m_zStats.Invalidate();
+		if( !m_zStats_Blocks && !_Statistics_Create() )
+		{
+			return( false );
+		}
 
-		for(int y=0; y<Get_NY() && SG_UI_Process_Get_Okay(); y++)
+		if( !m_zStats_bBlocks )
 		{
-			for(int x=0; x<Get_NX(); x++)
+			memset(m_zStats_bModified, true, m_zStats_nBlocks * sizeof(bool));
+
+			m_zStats_bBlocks	= true;
+		}
+
+		//-------------------------------------------------
+		if( _is_Array() )	// direct memory access, blocks can be processed in parallel
+		{
+			#pragma omp parallel for schedule(dynamic)
+			for(int iBlock=0; iBlock<m_zStats_nBlocks; iBlock++)
 			{
-				if( !is_NoData(x, y) )
+				if( m_zStats_bModified[iBlock] )
 				{
-					m_zStats.Add_Value(asDouble(x, y));
+					_Statistics_Update(iBlock);
 				}
 			}
 		}
+		else				// line buffer and cache access are not thread safe
+		{
+			for(int iBlock=0; iBlock<m_zStats_nBlocks; iBlock++)
+			{
+				if( m_zStats_bModified[iBlock] )
+				{
+					if( !SG_UI_Process_Get_Okay() )
+					{
+						Set_Update_Flag();	// continue with the remaining blocks next time
+
+						break;
+					}
+
+					_Statistics_Update(iBlock);
+				}
+			}
+		}
+
+		//-------------------------------------------------
+		m_zStats.Invalidate();
+
+		for(int iBlock=0; iBlock<m_zStats_nBlocks; iBlock++)
+		{
+			m_zStats.Add(m_zStats_Blocks[iBlock]);
+		}
 
 		m_bIndex	= false;
 		SG_FREE_SAFE(m_Index);
@@ -1137,6 +1459,14 @@ bool CSG_Grid::On_Update(void)
 	return( true );
 }
 
+//---------------------------------------------------------
+bool CSG_Grid::On_NoData_Changed(void)
+{
+	m_zStats_bBlocks	= false;
+
+	return( true );
+}
+
 //---------------------------------------------------------
 double CSG_Grid::Get_ZMin(void)
 {
@@ -1180,8 +1510,20 @@ sLong CSG_Grid::Get_NoData_Count(void)
 }
 
 //---------------------------------------------------------
-double CSG_Grid::Get_Percentile(double Percent)
+/**
+  * Returns the given percentile of the grid's data values. If
+  * bExact is false the percentile is approximated from a histogram,
+  * which avoids the creation of the sorted index.
+*/
+double CSG_Grid::Get_Percentile(double Percent, bool bExact)
 {
+	if( !bExact )
+	{
+		CSG_Simple_Statistics	Statistics;
+
+		return( Get_Statistics(Statistics, 4096) ? Statistics.Get_Quantile(Percent) : Get_NoData_Value() );
+	}
+
 	Percent	= Percent <= 0.0 ? 0.0 : Percent >= 100.0 ? 1.0 : Percent / 100.0;
 
 	sLong	n	= (sLong)(Percent * (Get_Data_Count() - 1));
@@ -1194,6 +1536,80 @@ double CSG_Grid::Get_Percentile(double Percent)
 	return( Get_NoData_Value() );
 }
 
+//---------------------------------------------------------
+/**
+  * Copies the grid's statistics to Statistics. If nClasses is
+  * greater than zero a histogram with this number of classes
+  * ranging from the minimum to the maximum data value is collected
+  * additionally, which needs one more pass through the data.
+*/
+bool CSG_Grid::Get_Statistics(CSG_Simple_Statistics &Statistics, int nClasses)
+{
+	Update();
+
+	if( nClasses < 1 || m_zStats.Get_Count() < 1 )
+	{
+		Statistics.Create(m_zStats);
+
+		return( m_zStats.Get_Count() > 0 );
+	}
+
+	//-----------------------------------------------------
+	CSG_Simple_Statistics	Histogram;
+
+	Histogram.Set_Histogram(nClasses, m_zStats.Get_Minimum(), m_zStats.Get_Maximum());
+
+	if( _is_Array() )
+	{
+		#pragma omp parallel
+		{
+			CSG_Simple_Statistics	s(Histogram);
+
+			double	*Values		= (double *)SG_Malloc(Get_NX() * (sizeof(double) + sizeof(bool)));
+			bool	*bNoData	= (bool   *)(Values + Get_NX());
+
+			#pragma omp for schedule(dynamic)
+			for(int y=0; y<Get_NY(); y++)
+			{
+				if( Values && Get_Row(y, Values, true, bNoData) )
+				{
+					for(int x=0; x<Get_NX(); x++)
+					{
+						if( !bNoData[x] )
+						{
+							s.Add_Value(Values[x]);
+						}
+					}
+				}
+			}
+
+			SG_FREE_SAFE(Values);
+
+			#pragma omp critical
+			{
+				Histogram.Add(s);
+			}
+		}
+	}
+	else
+	{
+		for(int y=0; y<Get_NY(); y++)
+		{
+			for(int x=0; x<Get_NX(); x++)
+			{
+				if( !is_NoData(x, y) )
+				{
+					Histogram.Add_Value(asDouble(x, y));
+				}
+			}
+		}
+	}
+
+	Statistics.Create(Histogram);
+
+	return( true );
+}
+
 
 ///////////////////////////////////////////////////////////
 //														 //
@@ -1202,164 +1618,328 @@ double CSG_Grid::Get_Percentile(double Percent)
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-#define SORT_SWAP(a,b)	{itemp=(a);(a)=(b);(b)=itemp;}
+// The index is created with a stable, parallel LSD radix sort.
+// Each data value is read only once and mapped to an unsigned
+// integer key that preserves the value order (32 bits for data
+// types that fit, 64 bits otherwise). Keys are sorted together
+// with the cell indices, 8 bits per pass, skipping passes for
+// which all keys share the same digit. Cell indices are stored
+// with 32 bits for grids having less than 4G cells. No-data
+// cells follow the data cells in ascending order.
+//---------------------------------------------------------
+#define GRID_INDEX_CHUNK_MIN	65536
 
-bool CSG_Grid::_Set_Index(void)
+//---------------------------------------------------------
+static uLong SG_Grid_Index_Key(double Value, TSG_Data_Type Type)
 {
-	if( Get_Data_Count() <= 0 )
+	switch( Type )
 	{
-		return( false );	// nothing to do
+	case SG_DATATYPE_Bit   :
+	case SG_DATATYPE_Byte  :
+	case SG_DATATYPE_Word  :
+	case SG_DATATYPE_DWord :
+		return( (DWORD)Value );
+
+	case SG_DATATYPE_Char  :
+	case SG_DATATYPE_Short :
+	case SG_DATATYPE_Int   :
+		return( (DWORD)(int)Value ^ 0x80000000 );
+
+	case SG_DATATYPE_Float : {
+		float	f	= (float)Value;	DWORD	Bits;	memcpy(&Bits, &f, sizeof(Bits));
+
+		return( Bits & 0x80000000 ? (DWORD)~Bits : Bits | 0x80000000 ); }
+
+	case SG_DATATYPE_Long  :
+		return( (uLong)(sLong)Value ^ 0x8000000000000000ULL );
+
+	default                : {
+		uLong	Bits;	memcpy(&Bits, &Value, sizeof(Bits));
+
+		return( Bits & 0x8000000000000000ULL ? ~Bits : Bits | 0x8000000000000000ULL ); }
+	}
+}
+
+//---------------------------------------------------------
+// returns 1 on success, 0 if stopped by user, -1 if memory allocation failed
+template <typename KEY, typename INDEX>
+static int SG_Grid_Index_Create(const CSG_Grid *pGrid, INDEX *Index, bool bParallel)
+{
+	int		nx	= pGrid->Get_NX(), ny = pGrid->Get_NY();
+
+	sLong	*First	= (sLong *)SG_Calloc(ny + 1, sizeof(sLong));
+
+	if( !First )
+	{
+		return( -1 );
 	}
 
 	//-----------------------------------------------------
-	if( m_Index == NULL && (m_Index = (sLong *)SG_Malloc(Get_NCells() * sizeof(sLong))) == NULL )
+	// 1. number of data cells per row
+
+	#pragma omp parallel if(bParallel)
 	{
-		SG_UI_Msg_Add_Error(_TL("could not create index: insufficient memory"));
+		double	*Values		= (double *)SG_Malloc(nx * (sizeof(double) + sizeof(bool)));
+		bool	*bNoData	= (bool   *)(Values + nx);
 
-		return( false );
+		#pragma omp for
+		for(int y=0; y<ny; y++)
+		{
+			if( Values && pGrid->Get_Row(y, Values, false, bNoData) )
+			{
+				for(int x=0; x<nx; x++)
+				{
+					if( !bNoData[x] )
+					{
+						First[y + 1]++;
+					}
+				}
+			}
+		}
+
+		SG_FREE_SAFE(Values);
 	}
 
-	//-----------------------------------------------------
-	const sLong	M	= 7;
+	for(int y=0; y<ny; y++)
+	{
+		First[y + 1]	+= First[y];
+	}
 
-	sLong	i, j, k, l, ir, n, *istack, jstack, nstack, indxt, itemp;
-	double	a;
+	sLong	nData	= First[ny];
 
 	//-----------------------------------------------------
-	SG_UI_Process_Set_Text(CSG_String::Format(SG_T("%s: %s"), _TL("Create index"), Get_Name()));
+	KEY		*Keys	= (KEY   *)SG_Malloc(2 * nData * sizeof(KEY  ));
+	INDEX	*Temp	= (INDEX *)SG_Malloc(    nData * sizeof(INDEX));
 
-	for(i=0, j=0, k=Get_Data_Count(); i<Get_NCells(); i++)
+	if( !Keys || !Temp )
 	{
-		if( is_NoData(i) )
-		{
-			m_Index[k++]	= i;
-		}
-		else // if( !is_NoData(i) )
-		{
-			m_Index[j++]	= i;
-		}
+		SG_FREE_SAFE(Keys); SG_FREE_SAFE(Temp); SG_Free(First);
+
+		return( -1 );
 	}
 
 	//-----------------------------------------------------
-	l		= 0;
-	n		= 0;
-	ir		= Get_Data_Count() - 1;
+	// 2. key extraction, data cells in front, no-data cells at the end
+
+	TSG_Data_Type	Type	= pGrid->Get_Type();
 
-	nstack	= 64;
-	istack	= (sLong *)SG_Malloc(nstack * sizeof(sLong));
-	jstack	= 0;
+	bool	bInvert	= pGrid->Get_Scaling() < 0.0;
 
-	for(;;)
+	#pragma omp parallel if(bParallel)
 	{
-		if( ir - l < M )
+		double	*Values		= (double *)SG_Malloc(nx * (sizeof(double) + sizeof(bool)));
+		bool	*bNoData	= (bool   *)(Values + nx);
+
+		#pragma omp for
+		for(int y=0; y<ny; y++)
 		{
-			if( !SG_UI_Process_Set_Progress((double)(n += M - 1), (double)Get_Data_Count()) )
-			{
-				SG_FREE_SAFE(istack);
-				SG_FREE_SAFE(m_Index);
+			sLong	n	= (sLong)y * nx, i = First[y], j = nData + n - First[y];
 
-				SG_UI_Msg_Add_Error(_TL("index creation stopped by user"));
-				SG_UI_Process_Set_Ready();
+			if( !Values || !pGrid->Get_Row(y, Values, false, bNoData) )
+			{
+				for(int x=0; x<nx; x++, n++)	{	Index[j++]	= (INDEX)n;	}
 
-				return( false );
+				continue;
 			}
 
-			for(j=l+1; j<=ir; j++)
+			for(int x=0; x<nx; x++, n++)
 			{
-				indxt	= m_Index[j];
-				a		= asDouble(indxt);
-
-				for(i=j-1; i>=0; i--)
+				if( bNoData[x] )
 				{
-					if( asDouble(m_Index[i]) <= a )
-					{
-						break;
-					}
-
-					m_Index[i + 1]	= m_Index[i];
+					Index[j++]	= (INDEX)n;
 				}
+				else
+				{
+					uLong	Key	= SG_Grid_Index_Key(Values[x], Type);
 
-				m_Index[i + 1]	= indxt;
+					Keys [i  ]	= (KEY)(bInvert ? ~Key : Key);
+					Index[i++]	= (INDEX)n;
+				}
 			}
+		}
 
-			if( jstack == 0 )
-			{
-				break;
-			}
+		SG_FREE_SAFE(Values);
+	}
 
-			ir		= istack[jstack--];
-			l		= istack[jstack--];
-		}
+	SG_Free(First);
 
-		//-------------------------------------------------
-		else
-		{
-			k		= (l + ir) >> 1;
+	//-----------------------------------------------------
+	// 3. radix sort of the data cells
 
-			SORT_SWAP(m_Index[k], m_Index[l + 1]);
+#ifdef _OPENMP
+	int		nChunks	= nData < GRID_INDEX_CHUNK_MIN ? 1 : SG_Get_Max_Num_Threads_Omp();
+#else
+	int		nChunks	= 1;
+#endif
 
-			if( asDouble( m_Index[l + 1]) > asDouble(m_Index[ir]) )
-				SORT_SWAP(m_Index[l + 1],            m_Index[ir]);
+	sLong	nChunk	= nData / nChunks + 1;
 
-			if( asDouble( m_Index[l    ]) > asDouble(m_Index[ir]) )
-				SORT_SWAP(m_Index[l    ],            m_Index[ir]);
+	sLong	*Count	= (sLong *)SG_Malloc(nChunks * 256 * sizeof(sLong));
 
-			if( asDouble( m_Index[l + 1]) > asDouble(m_Index[l ]) )
-				SORT_SWAP(m_Index[l + 1],            m_Index[l ]);
+	KEY		*kSrc	= Keys, *kDst = Keys + nData;
+	INDEX	*iSrc	= Index, *iDst = Temp;
 
-			i		= l + 1;
-			j		= ir;
-			indxt	= m_Index[l];
-			a		= asDouble(indxt);
+	int		Result	= Count ? 1 : -1;
 
-			for(;;)
-			{
-				do	i++;	while(asDouble(m_Index[i]) < a);
-				do	j--;	while(asDouble(m_Index[j]) > a);
+	for(int iPass=0, nPasses=(int)sizeof(KEY); Result == 1 && iPass<nPasses; iPass++)
+	{
+		if( !SG_UI_Process_Set_Progress(iPass, nPasses) )
+		{
+			Result	= 0;
 
-				if( j < i )
-				{
-					break;
-				}
+			break;
+		}
+
+		int		Shift	= 8 * iPass;
+
+		#pragma omp parallel for
+		for(int iChunk=0; iChunk<nChunks; iChunk++)
+		{
+			sLong	*c	= Count + 256 * iChunk;
 
-				SORT_SWAP(m_Index[i], m_Index[j]);
+			memset(c, 0, 256 * sizeof(sLong));
+
+			for(sLong i=iChunk*nChunk, iEnd=M_GET_MIN(i + nChunk, nData); i<iEnd; i++)
+			{
+				c[(kSrc[i] >> Shift) & 0xFF]++;
 			}
+		}
 
-			m_Index[l]	= m_Index[j];
-			m_Index[j]	= indxt;
-			jstack		+= 2;
+		//-------------------------------------------------
+		bool	bTrivial	= false;
+
+		for(sLong Digit=0, Offset=0; Digit<256; Digit++)
+		{
+			sLong	nDigit	= 0;
 
-			if( jstack >= nstack )
+			for(int iChunk=0; iChunk<nChunks; iChunk++)
 			{
-				nstack	+= 64;
-				istack	= (sLong *)SG_Realloc(istack, nstack * sizeof(int));
+				sLong	n	= Count[256 * iChunk + Digit];
+
+				Count[256 * iChunk + Digit]	= Offset;
+
+				Offset	+= n;
+				nDigit	+= n;
 			}
 
-			if( ir - i + 1 >= j - l )
+			if( nDigit == nData )
 			{
-				istack[jstack]		= ir;
-				istack[jstack - 1]	= i;
-				ir					= j - 1;
+				bTrivial	= true;	// all keys share this digit, nothing to do
 			}
-			else
+		}
+
+		if( bTrivial )
+		{
+			continue;
+		}
+
+		//-------------------------------------------------
+		#pragma omp parallel for
+		for(int iChunk=0; iChunk<nChunks; iChunk++)
+		{
+			sLong	*c	= Count + 256 * iChunk;
+
+			for(sLong i=iChunk*nChunk, iEnd=M_GET_MIN(i + nChunk, nData); i<iEnd; i++)
 			{
-				istack[jstack]		= j - 1;
-				istack[jstack - 1]	= l;
-				l					= i;
+				sLong	j	= c[(kSrc[i] >> Shift) & 0xFF]++;
+
+				kDst[j]	= kSrc[i];
+				iDst[j]	= iSrc[i];
 			}
 		}
+
+		KEY		*k	= kSrc;	kSrc	= kDst;	kDst	= k;
+		INDEX	*t	= iSrc;	iSrc	= iDst;	iDst	= t;
+	}
+
+	if( Result == 1 && iSrc != Index )
+	{
+		memcpy(Index, iSrc, nData * sizeof(INDEX));
 	}
 
 	//-----------------------------------------------------
-	SG_Free(istack);
+	SG_FREE_SAFE(Count);
+
+	SG_Free(Keys);
+	SG_Free(Temp);
+
+	return( Result );
+}
+
+//---------------------------------------------------------
+bool CSG_Grid::_Set_Index(void)
+{
+	if( Get_Data_Count() <= 0 )
+	{
+		return( false );	// nothing to do
+	}
+
+	bool	bResult	= true;
+
+	#pragma omp critical (grid_index)	// tools running in parallel might ask for the index of a shared input grid
+	{
+		if( !m_bIndex )
+		{
+			bResult	= _Create_Index();
+		}
+	}
+
+	return( bResult );
+}
+
+//---------------------------------------------------------
+bool CSG_Grid::_Create_Index(void)
+{
+	SG_FREE_SAFE(m_Index);
+
+	m_bIndex32	= Get_NCells() <= 0xFFFFFFFF;
+
+	if( (m_Index = SG_Malloc(Get_NCells() * (m_bIndex32 ? sizeof(DWORD) : sizeof(sLong)))) == NULL )
+	{
+		SG_UI_Msg_Add_Error(_TL("could not create index: insufficient memory"));
+
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	bool	bKey32;
+
+	switch( m_Type )
+	{
+	default:
+		bKey32	= false;	break;
+
+	case SG_DATATYPE_Bit  : case SG_DATATYPE_Byte : case SG_DATATYPE_Char : case SG_DATATYPE_Word :
+	case SG_DATATYPE_Short: case SG_DATATYPE_DWord: case SG_DATATYPE_Int  : case SG_DATATYPE_Float:
+		bKey32	= true;		break;
+	}
+
+	//-----------------------------------------------------
+	SG_UI_Process_Set_Text(CSG_String::Format(SG_T("%s: %s"), _TL("Create index"), Get_Name()));
+
+	int	Result	= m_bIndex32
+		? (bKey32 ? SG_Grid_Index_Create<DWORD, DWORD>(this, (DWORD *)m_Index, _is_Array()) : SG_Grid_Index_Create<uLong, DWORD>(this, (DWORD *)m_Index, _is_Array()))
+		: (bKey32 ? SG_Grid_Index_Create<DWORD, sLong>(this, (sLong *)m_Index, _is_Array()) : SG_Grid_Index_Create<uLong, sLong>(this, (sLong *)m_Index, _is_Array()));
 
 	SG_UI_Process_Set_Ready();
 
+	if( Result != 1 )
+	{
+		SG_FREE_SAFE(m_Index);
+
+		SG_UI_Msg_Add_Error(Result == 0
+			? _TL("index creation stopped by user")
+			: _TL("could not create index: insufficient memory")
+		);
+
+		return( false );
+	}
+
+	//-----------------------------------------------------
 	m_bIndex	= true;
 
 	return( true );
 }
-#undef SORT_SWAP
 
 
 ///////////////////////////////////////////////////////////
@@ -89,10 +89,20 @@ typedef enum ESG_Grid_Memory_Type
 {
 	GRID_MEMORY_Normal					= 0,
 	GRID_MEMORY_Cache,
-	GRID_MEMORY_Compression
+	GRID_MEMORY_Compression,
+	GRID_MEMORY_Mapped
 }
 TSG_Grid_Memory_Type;
 
+//---------------------------------------------------------
+typedef enum ESG_Grid_Compression
+{
+	GRID_COMPRESSION_None				= 0,
+	GRID_COMPRESSION_RLE,
+	GRID_COMPRESSION_LZ
+}
+TSG_Grid_Compression;
+
 
 ///////////////////////////////////////////////////////////
 //														 //
@@ -517,7 +527,9 @@ public:		///////////////////////////////////////////////
 	double						Get_Mean		(void);
 	double						Get_StdDev		(void);
 	double						Get_Variance	(void);
-	double						Get_Percentile	(double Percent);
+	double						Get_Percentile	(double Percent, bool bExact = true);
+
+	bool						Get_Statistics	(CSG_Simple_Statistics &Statistics, int nClasses = 0);
 
 	sLong						Get_Data_Count	(void);
 	sLong						Get_NoData_Count(void);
@@ -551,7 +563,7 @@ public:		///////////////////////////////////////////////
 	double						Get_Memory_Size_MB			(void)		const	{	return( (double)Get_Memory_Size() / N_MEGABYTE_BYTES );	}
 
 	bool						Set_Buffer_Size				(sLong nBytes);
-	int							Get_Buffer_Size				(void)		const	{	return( m_LineBuffer_Count * Get_nLineBytes() );	}
+	sLong						Get_Buffer_Size				(void)		const	{	return( m_Cache_Tiles ? (sLong)m_Cache_Tiles->nSlots * m_Cache_Tiles->nBytes : (sLong)m_LineBuffer_Count * Get_nLineBytes() );	}
 
 	bool						Set_Cache					(bool bOn);
 	bool						is_Cached					(void)		const	{	return( m_Memory_Type == GRID_MEMORY_Cache );	}
@@ -560,6 +572,9 @@ public:		///////////////////////////////////////////////
 	bool						is_Compressed				(void)		const	{	return( m_Memory_Type == GRID_MEMORY_Compression );	};
 	double						Get_Compression_Ratio		(void)		const;
 
+	bool						Set_Mapping					(bool bOn);
+	bool						is_Mapped					(void)		const	{	return( m_Memory_Type == GRID_MEMORY_Mapped );	}
+
 
 	//-----------------------------------------------------
 	// Operations...
@@ -596,6 +611,8 @@ public:		///////////////////////////////////////////////
 			Set_Update_Flag();
 
 			Set_Index(false);
+
+			m_zStats_bBlocks	= false;	// all row blocks need to be re-evaluated
 		}
 	}
 
@@ -619,7 +636,7 @@ public:		///////////////////////////////////////////////
 	{
 		if( Position >= 0 && Position < Get_NCells() && (m_bIndex || _Set_Index()) )
 		{
-			Position	= m_Index[bDown ? Get_NCells() - Position - 1 : Position];
+			Position	= _Get_Index(bDown ? Get_NCells() - Position - 1 : Position);
 
 			if( !bCheckNoData || !is_NoData(Position) )
 			{
@@ -727,9 +744,9 @@ public:		///////////////////////////////////////////////
 	{
 		double	Value;
 
-		if( m_Memory_Type != GRID_MEMORY_Normal )
+		if( !_is_Array() )
 		{
-			Value	= _LineBuffer_Get_Value(x, y);
+			Value	= is_Cached() ? _Cache_Get_Value(x, y) : _LineBuffer_Get_Value(x, y);
 		}
 		else switch( m_Type )
 		{
@@ -755,6 +772,16 @@ public:		///////////////////////////////////////////////
 	}
 
 
+	//-----------------------------------------------------
+	// Row access...
+
+	/** Returns the data of row y, if the grid values are held in a plain array (normal or memory mapped), otherwise NULL. The data type is that of Get_Type(), values are not scaled. */
+	void *						Get_Row_Data	(int y)	const	{	return( _is_Array() && y >= 0 && y < Get_NY() ? m_Values[y] : NULL );	}
+
+	bool						Get_Row			(int y,       double *Values, bool bScaled = true,       bool *bNoData = NULL)	const;
+	bool						Set_Row			(int y, const double *Values, bool bScaled = true, const bool *bNoData = NULL);
+
+
 	//-----------------------------------------------------
 	// Set Value...
 
@@ -777,9 +804,16 @@ public:		///////////////////////////////////////////////
 			Value	= (Value - m_zOffset) / m_zScale;
 		}
 
-		if( m_Memory_Type != GRID_MEMORY_Normal )
+		if( !_is_Array() )
 		{
-			_LineBuffer_Set_Value(x, y, Value);
+			if( is_Cached() )
+			{
+				_Cache_Set_Value(x, y, Value);
+			}
+			else
+			{
+				_LineBuffer_Set_Value(x, y, Value);
+			}
 		}
 		else switch( m_Type )
 		{
@@ -799,7 +833,7 @@ public:		///////////////////////////////////////////////
 				break;
 		}
 
-		Set_Modified();
+		_Set_Modified(y);
 	}
 
 
@@ -808,22 +842,26 @@ protected:	///////////////////////////////////////////////
 
 	virtual bool				On_Update				(void);
 
+	virtual bool				On_NoData_Changed		(void);
+
 
 //---------------------------------------------------------
 private:	///////////////////////////////////////////////
 
-	void						**m_Values;
+	void						**m_Values, *m_Index;
 
-	bool						m_bCreated, m_bIndex, m_Memory_bLock,
+	bool						m_bCreated, m_bIndex, m_bIndex32, m_Memory_bLock, m_zStats_bBlocks,
 								m_Cache_bTemp, m_Cache_bSwap, m_Cache_bFlip;
 
-	int							m_LineBuffer_Count;
+	int							m_LineBuffer_Count, m_zStats_nRows, m_zStats_nBlocks;
 
-	sLong						*m_Index, m_Cache_Offset;
+	sLong						m_Cache_Offset, m_Map_Size, m_Buffer_Size;
 
 	double						m_zOffset, m_zScale;
 
-	CSG_Simple_Statistics		m_zStats;
+	bool						*m_zStats_bModified;
+
+	CSG_Simple_Statistics		m_zStats, *m_zStats_Blocks;
 
 	CSG_File					m_Cache_Stream;
 
@@ -850,6 +888,27 @@ private:	///////////////////////////////////////////////
 
 	TSG_Grid_Line				*m_LineBuffer;
 
+	//-----------------------------------------------------
+	typedef struct
+	{
+		bool	bModified, bUsed;
+		int		Index;
+		char	*Data;
+	}
+	TSG_Grid_Tile;
+
+	typedef struct
+	{
+		int				nx, ny, nLineBytes, nBytes, nTiles_X, nTiles_Y, nSlots, iClock, *Index;
+
+		TSG_Grid_Tile	*Tiles;
+	}
+	TSG_Grid_Tiles;
+
+	TSG_Grid_Tiles				*m_Cache_Tiles;
+
+	void						*m_Map_Data, *m_Map_Handle;
+
 
 	//-----------------------------------------------------
 	void						_On_Construction		(void);
@@ -857,6 +916,26 @@ private:	///////////////////////////////////////////////
 	void						_Set_Properties			(TSG_Data_Type m_Type, int NX, int NY, double Cellsize, double xMin, double yMin);
 
 	bool						_Set_Index				(void);
+	bool						_Create_Index			(void);
+	sLong						_Get_Index				(sLong i)	const	{	return( m_bIndex32 ? (sLong)((DWORD *)m_Index)[i] : ((sLong *)m_Index)[i] );	}
+
+	void						_Set_Modified			(int y)	// row-wise modification, keeps the statistics of unchanged row blocks
+	{
+		if( m_zStats_bModified )
+		{
+			m_zStats_bModified[y / m_zStats_nRows]	= true;
+		}
+
+		CSG_Data_Object::Set_Modified();
+
+		Set_Update_Flag();
+
+		Set_Index(false);
+	}
+
+	bool						_Statistics_Create		(void);
+	void						_Statistics_Destroy		(void);
+	void						_Statistics_Update		(int iBlock);
 
 
 	//-----------------------------------------------------
@@ -864,6 +943,8 @@ private:	///////////////////////////////////////////////
 
 	int							_Get_nLineBytes			(void)	{	return( m_Type == SG_DATATYPE_Bit ? Get_NX() / 8 + 1 : Get_NX() * Get_nValueBytes() );	}
 
+	bool						_is_Array				(void)	const	{	return( m_Memory_Type == GRID_MEMORY_Normal || m_Memory_Type == GRID_MEMORY_Mapped );	}
+
 	bool						_Memory_Create			(TSG_Grid_Memory_Type aMemory_Type);
 	void						_Memory_Destroy			(void);
 
@@ -880,14 +961,28 @@ private:	///////////////////////////////////////////////
 	bool						_Cache_Create			(const SG_Char *FilePath, TSG_Data_Type File_Type, sLong Offset, bool bSwap, bool bFlip);
 	bool						_Cache_Create			(void);
 	bool						_Cache_Destroy			(bool bMemory_Restore);
-	void						_Cache_LineBuffer_Save	(TSG_Grid_Line *pLine)			const;
-	void						_Cache_LineBuffer_Load	(TSG_Grid_Line *pLine, int y)	const;
+	void						_Cache_Tiles_Create		(void);
+	void						_Cache_Tiles_Destroy	(void);
+	void						_Cache_Tiles_Flush		(void);
+	void						_Cache_Tile_Get_Extent	(int iTile, int &x0, int &y0, int &nx, int &ny, int &nBytes)	const;
+	TSG_Grid_Tile *				_Cache_Get_Tile			(int x, int y)					const;
+	void						_Cache_Set_Value		(int x, int y, double Value);
+	double						_Cache_Get_Value		(int x, int y)					const;
+	void						_Cache_Tile_Swap		(TSG_Grid_Tile *pTile, int ny, int nBytes)	const;
+	void						_Cache_Tile_Save		(TSG_Grid_Tile *pTile)			const;
+	void						_Cache_Tile_Load		(TSG_Grid_Tile *pTile, int iTile)	const;
 
 	bool						_Compr_Create			(void);
 	bool						_Compr_Destroy			(bool bMemory_Restore);
 	void						_Compr_LineBuffer_Save	(TSG_Grid_Line *pLine)			const;
 	void						_Compr_LineBuffer_Load	(TSG_Grid_Line *pLine, int y)	const;
 
+	bool						_Map_Create				(const SG_Char *FilePath, TSG_Data_Type File_Type, sLong Offset, bool bSwap, bool bFlip);
+	bool						_Map_Create				(void);
+	bool						_Map_Destroy			(bool bMemory_Restore);
+	bool						_Map_Open				(sLong Offset, bool bWrite, bool bFlip);
+	void						_Map_Close				(void);
+
 
 	//-----------------------------------------------------
 	// File access...
@@ -970,14 +1065,123 @@ SAGA_API_DLL_EXPORT void			SG_Grid_Cache_Set_Directory		(const SG_Char *Director
 SAGA_API_DLL_EXPORT void			SG_Grid_Cache_Set_Automatic		(bool bOn);
 SAGA_API_DLL_EXPORT bool			SG_Grid_Cache_Get_Automatic		(void);
 
+/** Use memory mapped files instead of the file cache, when caching is activated automatically */
+SAGA_API_DLL_EXPORT void			SG_Grid_Cache_Set_Mapping		(bool bOn);
+SAGA_API_DLL_EXPORT bool			SG_Grid_Cache_Get_Mapping		(void);
+
 SAGA_API_DLL_EXPORT void			SG_Grid_Cache_Set_Confirm		(int Confirm);
 SAGA_API_DLL_EXPORT int				SG_Grid_Cache_Get_Confirm		(void);
 
-SAGA_API_DLL_EXPORT void			SG_Grid_Cache_Set_Threshold		(int nBytes);
+SAGA_API_DLL_EXPORT void			SG_Grid_Cache_Set_Threshold		(sLong nBytes);
 SAGA_API_DLL_EXPORT void			SG_Grid_Cache_Set_Threshold_MB	(double nMegabytes);
 SAGA_API_DLL_EXPORT sLong			SG_Grid_Cache_Get_Threshold		(void);
 SAGA_API_DLL_EXPORT double			SG_Grid_Cache_Get_Threshold_MB	(void);
 
+/** Set the codec used for row compression (TSG_Grid_Compression) */
+SAGA_API_DLL_EXPORT void			SG_Grid_Compression_Set_Codec		(int Codec);
+SAGA_API_DLL_EXPORT int				SG_Grid_Compression_Get_Codec		(void);
+
+/** Apply the delta and byte shuffle predictor before compressing a row */
+SAGA_API_DLL_EXPORT void			SG_Grid_Compression_Set_Predictor	(bool bOn);
+SAGA_API_DLL_EXPORT bool			SG_Grid_Compression_Get_Predictor	(void);
+
+//---------------------------------------------------------
+/** Mean of the valid cells within a square or circular window. If bFill is true, no-data cells get the mean of their valid neighbours. */
+SAGA_API_DLL_EXPORT bool			SG_Grid_Filter_Mean					(CSG_Grid *pInput, CSG_Grid *pOutput, int Radius, bool bSquare = true, bool bFill = false);
+
+/** Weighted mean with the separable kernel K(dx, dy) = Kernel[|dx|] * Kernel[|dy|] */
+SAGA_API_DLL_EXPORT bool			SG_Grid_Filter_Separable			(CSG_Grid *pInput, CSG_Grid *pOutput, const CSG_Vector &Kernel, bool bFill = false);
+
+/** Gaussian weighted mean within a square window */
+SAGA_API_DLL_EXPORT bool			SG_Grid_Filter_Gaussian				(CSG_Grid *pInput, CSG_Grid *pOutput, double Sigma, int Radius, bool bFill = false);
+
+/** Gaussian smoothing with a recursive filter, the cost per cell does not depend on Sigma */
+SAGA_API_DLL_EXPORT bool			SG_Grid_Filter_Gaussian_Recursive	(CSG_Grid *pInput, CSG_Grid *pOutput, double Sigma, bool bFill = false);
+
+/** Minimum or maximum of the valid cells within a square window */
+SAGA_API_DLL_EXPORT bool			SG_Grid_Filter_Extreme				(CSG_Grid *pInput, CSG_Grid *pOutput, int Radius, bool bMaximum, bool bFill = false);
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//					Zonal Statistics					 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+/**
+  * CSG_Zonal_Statistics collects statistics for each unique
+  * combination of the values of one or more key grids (zones,
+  * categories). The key values of a cell are packed into bit
+  * fields and looked up in a hash table. Each thread collects
+  * into a table of its own, the tables are merged at the end.
+  * Zones are reported in ascending order of their keys.
+*/
+//---------------------------------------------------------
+class SAGA_API_DLL_EXPORT CSG_Zonal_Statistics
+{
+public:
+	CSG_Zonal_Statistics(void);
+	virtual ~CSG_Zonal_Statistics(void);
+
+	void						Destroy				(void);
+
+	/// Adds a key grid. If bNoData is false, no-data cells are skipped, otherwise they form zones with the no-data value as key.
+	bool						Add_Key				(CSG_Grid *pGrid, bool bNoData = true);
+
+	/// Adds a grid to be analysed. Quantiles are exact if nClasses is zero, otherwise approximated with a histogram of nClasses classes. Directions (radians) additionally collect the mean direction.
+	bool						Add_Value			(CSG_Grid *pGrid, bool bQuantiles = false, int nClasses = 0, bool bDirection = false);
+
+	bool						Execute				(void);
+
+	int							Get_Key_Count		(void)	const	{	return( m_nKeys   );	}
+	int							Get_Value_Count		(void)	const	{	return( m_nValues );	}
+
+	sLong						Get_Count			(void)	const;
+	int							Get_Key				(sLong iZone, int iKey  )	const;
+	sLong						Get_Cells			(sLong iZone)				const;
+	CSG_Simple_Statistics &		Get_Statistics		(sLong iZone, int iValue);
+	double						Get_Direction		(sLong iZone, int iValue)	const;
+
+
+private:
+
+	typedef struct SKey
+	{
+		bool					bNoData;
+
+		int						Offset, Bits, Word, Shift;
+
+		CSG_Grid				*pGrid;
+	}
+	TKey;
+
+	typedef struct SValue
+	{
+		bool					bQuantiles, bDirection;
+
+		int						nClasses;
+
+		double					Min, Max;
+
+		CSG_Grid				*pGrid;
+	}
+	TValue;
+
+
+	int							m_nKeys, m_nValues, m_nWords;
+
+	TKey						*m_Keys;
+
+	TValue						*m_Values;
+
+	class CSG_Zonal_Table		*m_pZones;
+
+
+	bool						_Set_Key_Layout		(void);
+
+};
+
 
 ///////////////////////////////////////////////////////////
 //														 //
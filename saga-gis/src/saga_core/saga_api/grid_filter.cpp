@@ -0,0 +1,820 @@
+/**********************************************************
+ * Version $Id$
+ *********************************************************/
+
+///////////////////////////////////////////////////////////
+//                                                       //
+//                         SAGA                          //
+//                                                       //
+//      System for Automated Geoscientific Analyses      //
+//                                                       //
+//           Application Programming Interface           //
+//                                                       //
+//                  Library: SAGA_API                    //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//                    grid_filter.cpp                    //
+//                                                       //
+//                 Copyright (C) 2015 by                 //
+//                      Olaf Conrad                      //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+// This file is part of 'SAGA - System for Automated     //
+// Geoscientific Analyses'.                              //
+//                                                       //
+// This library is free software; you can redistribute   //
+// it and/or modify it under the terms of the GNU Lesser //
+// General Public License as published by the Free       //
+// Software Foundation, version 2.1 of the License.      //
+//                                                       //
+// This library is distributed in the hope that it will  //
+// be useful, but WITHOUT ANY WARRANTY; without even the //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A  //
+// PARTICULAR PURPOSE. See the GNU Lesser General Public //
+// License for more details.                             //
+//                                                       //
+// You should have received a copy of the GNU Lesser     //
+// General Public License along with this program; if    //
+// not, write to the Free Software Foundation, Inc.,     //
+// 51 Franklin Street, 5th Floor, Boston, MA 02110-1301, //
+// USA.                                                  //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//    e-mail:     oconrad@saga-gis.org                   //
+//                                                       //
+//    contact:    Olaf Conrad                            //
+//                Institute of Geography                 //
+//                University of Hamburg                  //
+//                Germany                                //
+//                                                       //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+#include "grid.h"
+
+#include <float.h>
+#include <vector>
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// The filters process the grid in bands of rows. Bands are
+// independent of each other and run in parallel. Within a
+// band each row is read once with CSG_Grid::Get_Row() and
+// the neighbourhood is updated incrementally, so a filter
+// needs a few rows per thread and no copy of the grid.
+// No-data cells are excluded by filtering the values (set
+// to zero) and their weights (zero or one) side by side.
+// If bFill is false, no-data cells stay no-data.
+
+//---------------------------------------------------------
+typedef struct SSG_Grid_Filter
+{
+	bool			bSquare, bFill, bMaximum;
+
+	int				Radius;
+
+	const double	*Kernel;
+
+	CSG_Grid		*pInput, *pOutput;
+}
+TSG_Grid_Filter;
+
+typedef void (* TSG_PFNC_Grid_Filter_Band)	(const TSG_Grid_Filter &Filter, int yFrom, int yTo);
+
+//---------------------------------------------------------
+class CSG_Grid_Filter_Row
+{
+public:
+	CSG_Grid_Filter_Row(CSG_Grid *pGrid) : m_pGrid(pGrid)
+	{
+		m_bNoData	= new bool[pGrid->Get_NX()];
+	}
+
+	~CSG_Grid_Filter_Row(void)
+	{
+		delete[](m_bNoData);
+	}
+
+	//-----------------------------------------------------
+	/** Reads row y, z receives the values (zero for no-data), w the weights (zero for no-data, else one). */
+	void				Read		(int y, double *z, double *w)
+	{
+		if( !m_pGrid->Get_Row(y, z, true, m_bNoData) )
+		{
+			for(int x=0; x<m_pGrid->Get_NX(); x++)
+			{
+				z[x]	= m_pGrid->asDouble(x, y);	m_bNoData[x]	= m_pGrid->is_NoData(x, y);
+			}
+		}
+
+		for(int x=0; x<m_pGrid->Get_NX(); x++)
+		{
+			if( m_bNoData[x] )
+			{
+				z[x]	= 0.0;	w[x]	= 0.0;
+			}
+			else
+			{
+				w[x]	= 1.0;
+			}
+		}
+	}
+
+	//-----------------------------------------------------
+	/** Returns the no-data flags of row y. */
+	const bool *		Get_NoData	(int y, double *z)
+	{
+		if( !m_pGrid->Get_Row(y, z, true, m_bNoData) )
+		{
+			for(int x=0; x<m_pGrid->Get_NX(); x++)
+			{
+				m_bNoData[x]	= m_pGrid->is_NoData(x, y);
+			}
+		}
+
+		return( m_bNoData );
+	}
+
+
+private:
+
+	bool				*m_bNoData;
+
+	CSG_Grid			*m_pGrid;
+
+};
+
+//---------------------------------------------------------
+bool	SG_Grid_Filter_is_Parallel	(CSG_Grid *pInput, CSG_Grid *pOutput)
+{
+	return( !pInput ->is_Cached() && !pInput ->is_Compressed()
+		&&  !pOutput->is_Cached() && !pOutput->is_Compressed()
+	);
+}
+
+//---------------------------------------------------------
+bool	SG_Grid_Filter_Run	(TSG_PFNC_Grid_Filter_Band Band, const TSG_Grid_Filter &Filter)
+{
+	if( !Filter.pInput || !Filter.pInput->is_Valid() || !Filter.pOutput || Filter.pOutput == Filter.pInput
+	||  !Filter.pOutput->is_Compatible(Filter.pInput) || Filter.Radius < 0 )
+	{
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	int		NY			= Filter.pInput->Get_NY();
+
+	bool	bParallel	= SG_Grid_Filter_is_Parallel(Filter.pInput, Filter.pOutput);
+
+#ifdef _OPENMP
+	int		nThreads	= bParallel ? SG_Get_Max_Num_Threads_Omp() : 1;
+#else
+	int		nThreads	= 1;
+#endif
+
+	// each band has to read 2 * Radius rows in advance, so bands should be large compared to the radius
+	int		nRows		= M_GET_MAX(16, M_GET_MIN(M_GET_MAX(64, 4 * Filter.Radius), 1 + NY / nThreads));
+	int		nBands		= 1 + (NY - 1) / nRows;
+
+	//-----------------------------------------------------
+	for(int iBand=0; iBand<nBands; iBand+=nThreads)
+	{
+		if( !SG_UI_Process_Set_Progress(iBand, nBands) )
+		{
+			return( false );
+		}
+
+		int	jBand	= M_GET_MIN(nBands, iBand + nThreads);
+
+		#pragma omp parallel for if(bParallel)
+		for(int i=iBand; i<jBand; i++)
+		{
+			Band(Filter, i * nRows, M_GET_MIN(NY, (i + 1) * nRows));
+		}
+	}
+
+	return( true );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//						Mean							 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// Square windows: running column sums over the rows of the
+// window, prefix sums along the row give each cell's window
+// sum in constant time.
+
+void	SG_Grid_Filter_Mean_Square	(const TSG_Grid_Filter &Filter, int yFrom, int yTo)
+{
+	int		NX	= Filter.pInput->Get_NX(), NY = Filter.pInput->Get_NY(), r = Filter.Radius;
+
+	std::vector<double>	S(NX, 0.0), N(NX, 0.0), P(NX + 1, 0.0), Q(NX + 1, 0.0), z(NX), w(NX);
+
+	CSG_Grid_Filter_Row	Row(Filter.pInput);
+
+	bool	*bNoData	= new bool[NX];
+
+	int		yFirst		= M_GET_MAX(0, yFrom - r);
+
+	//-----------------------------------------------------
+	for(int y=yFirst; y<yFrom+r && y<NY; y++)
+	{
+		Row.Read(y, &z[0], &w[0]);
+
+		for(int x=0; x<NX; x++)	{	S[x]	+= z[x];	N[x]	+= w[x];	}
+	}
+
+	//-----------------------------------------------------
+	for(int y=yFrom; y<yTo; y++)
+	{
+		if( y + r < NY )
+		{
+			Row.Read(y + r, &z[0], &w[0]);
+
+			for(int x=0; x<NX; x++)	{	S[x]	+= z[x];	N[x]	+= w[x];	}
+		}
+
+		if( y - r - 1 >= yFirst )
+		{
+			Row.Read(y - r - 1, &z[0], &w[0]);
+
+			for(int x=0; x<NX; x++)	{	S[x]	-= z[x];	N[x]	-= w[x];	}
+		}
+
+		for(int x=0; x<NX; x++)
+		{
+			P[x + 1]	= P[x] + S[x];
+			Q[x + 1]	= Q[x] + N[x];
+		}
+
+		//-------------------------------------------------
+		const bool	*bCenter	= Row.Get_NoData(y, &z[0]);
+
+		for(int x=0; x<NX; x++)
+		{
+			int		ax	= M_GET_MAX(0, x - r), bx = M_GET_MIN(NX - 1, x + r);
+
+			double	n	= Q[bx + 1] - Q[ax];
+
+			if( (bNoData[x] = (!Filter.bFill && bCenter[x]) || n < 0.5) == false )
+			{
+				z[x]	= (P[bx + 1] - P[ax]) / n;
+			}
+		}
+
+		Filter.pOutput->Set_Row(y, &z[0], true, bNoData);
+	}
+
+	delete[](bNoData);
+}
+
+//---------------------------------------------------------
+// Circles: prefix sums of each row of the window, the sum of
+// a cell's circle is collected from one span per row.
+
+void	SG_Grid_Filter_Mean_Circle	(const TSG_Grid_Filter &Filter, int yFrom, int yTo)
+{
+	int		NX	= Filter.pInput->Get_NX(), NY = Filter.pInput->Get_NY(), r = Filter.Radius, nRing = 2 * r + 1;
+
+	std::vector<int>	Width(r + 1);
+
+	for(int dy=0; dy<=r; dy++)	// same cells as CSG_Grid_Cell_Addressor::Set_Radius()
+	{
+		for(Width[dy]=0; Width[dy]<r && SG_Get_Length(Width[dy] + 1, dy) <= r; Width[dy]++)	{}
+	}
+
+	std::vector<double>	P(nRing * (NX + 1)), Q(nRing * (NX + 1)), z(NX), w(NX);
+
+	CSG_Grid_Filter_Row	Row(Filter.pInput);
+
+	bool	*bNoData	= new bool[NX];
+
+	//-----------------------------------------------------
+	for(int y=M_GET_MAX(0, yFrom - r), yNext=y; y<yTo; y++)
+	{
+		for( ; yNext<=y+r && yNext<NY; yNext++)
+		{
+			double	*p	= &P[(yNext % nRing) * (NX + 1)], *q = &Q[(yNext % nRing) * (NX + 1)];
+
+			Row.Read(yNext, &z[0], &w[0]);
+
+			for(int x=0; x<NX; x++)
+			{
+				p[x + 1]	= p[x] + z[x];	q[x + 1]	= q[x] + w[x];
+			}
+		}
+
+		if( y < yFrom )
+		{
+			continue;
+		}
+
+		//-------------------------------------------------
+		const bool	*bCenter	= Row.Get_NoData(y, &z[0]);
+
+		for(int x=0; x<NX; x++)
+		{
+			double	s	= 0.0, n = 0.0;
+
+			if( Filter.bFill || !bCenter[x] )
+			{
+				for(int dy=-r; dy<=r; dy++)
+				{
+					int	iy	= y + dy;
+
+					if( iy >= 0 && iy < NY )
+					{
+						int		ax	= M_GET_MAX(0, x - Width[abs(dy)]), bx = M_GET_MIN(NX - 1, x + Width[abs(dy)]);
+
+						double	*p	= &P[(iy % nRing) * (NX + 1)], *q = &Q[(iy % nRing) * (NX + 1)];
+
+						s	+= p[bx + 1] - p[ax];
+						n	+= q[bx + 1] - q[ax];
+					}
+				}
+			}
+
+			if( (bNoData[x] = n < 0.5) == false )
+			{
+				z[x]	= s / n;
+			}
+		}
+
+		Filter.pOutput->Set_Row(y, &z[0], true, bNoData);
+	}
+
+	delete[](bNoData);
+}
+
+//---------------------------------------------------------
+/**
+  * Mean of the valid cells within Radius, which is a square
+  * window or, if bSquare is false, a circle. The cost per cell
+  * is independent of the radius for squares and grows linearly
+  * with the radius for circles. If bFill is true, no-data cells
+  * get the mean of their valid neighbours.
+*/
+bool	SG_Grid_Filter_Mean	(CSG_Grid *pInput, CSG_Grid *pOutput, int Radius, bool bSquare, bool bFill)
+{
+	TSG_Grid_Filter	Filter;
+
+	Filter.pInput	= pInput;
+	Filter.pOutput	= pOutput;
+	Filter.Radius	= Radius;
+	Filter.bSquare	= bSquare;
+	Filter.bFill	= bFill;
+
+	return( SG_Grid_Filter_Run(bSquare ? SG_Grid_Filter_Mean_Square : SG_Grid_Filter_Mean_Circle, Filter) );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//					Separable Kernels					 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// Each row entering the window is filtered horizontally and
+// kept in a ring buffer, the vertical pass combines the rows
+// of the ring.
+
+void	SG_Grid_Filter_Separable_Band	(const TSG_Grid_Filter &Filter, int yFrom, int yTo)
+{
+	int		NX	= Filter.pInput->Get_NX(), NY = Filter.pInput->Get_NY(), r = Filter.Radius, nRing = 2 * r + 1;
+
+	const double	*K	= Filter.Kernel;
+
+	std::vector<double>	V(nRing * NX), W(nRing * NX), z(NX), w(NX);
+
+	CSG_Grid_Filter_Row	Row(Filter.pInput);
+
+	bool	*bNoData	= new bool[NX];
+
+	//-----------------------------------------------------
+	for(int y=M_GET_MAX(0, yFrom - r), yNext=y; y<yTo; y++)
+	{
+		for( ; yNext<=y+r && yNext<NY; yNext++)
+		{
+			double	*v	= &V[(yNext % nRing) * NX], *h = &W[(yNext % nRing) * NX];
+
+			Row.Read(yNext, &z[0], &w[0]);
+
+			for(int x=0; x<NX; x++)
+			{
+				double	sv	= K[0] * z[x], sw = K[0] * w[x];
+
+				for(int dx=1; dx<=r; dx++)
+				{
+					if( x - dx >= 0 )	{	sv	+= K[dx] * z[x - dx];	sw	+= K[dx] * w[x - dx];	}
+					if( x + dx <  NX )	{	sv	+= K[dx] * z[x + dx];	sw	+= K[dx] * w[x + dx];	}
+				}
+
+				v[x]	= sv;	h[x]	= sw;
+			}
+		}
+
+		if( y < yFrom )
+		{
+			continue;
+		}
+
+		//-------------------------------------------------
+		const bool	*bCenter	= Row.Get_NoData(y, &z[0]);
+
+		for(int x=0; x<NX; x++)
+		{
+			double	sv	= 0.0, sw = 0.0;
+
+			if( Filter.bFill || !bCenter[x] )
+			{
+				for(int dy=-r; dy<=r; dy++)
+				{
+					int	iy	= y + dy;
+
+					if( iy >= 0 && iy < NY )
+					{
+						sv	+= K[abs(dy)] * V[(iy % nRing) * NX + x];
+						sw	+= K[abs(dy)] * W[(iy % nRing) * NX + x];
+					}
+				}
+			}
+
+			if( (bNoData[x] = sw <= 0.0) == false )
+			{
+				z[x]	= sv / sw;
+			}
+		}
+
+		Filter.pOutput->Set_Row(y, &z[0], true, bNoData);
+	}
+
+	delete[](bNoData);
+}
+
+//---------------------------------------------------------
+/**
+  * Weighted mean with the separable kernel
+  * K(dx, dy) = Kernel[|dx|] * Kernel[|dy|], with Kernel[0]
+  * being the weight of the center and Kernel.Get_N() - 1
+  * the radius of the square window. Weights of no-data cells
+  * are excluded. The cost per cell grows linearly with the
+  * radius instead of quadratically.
+*/
+bool	SG_Grid_Filter_Separable	(CSG_Grid *pInput, CSG_Grid *pOutput, const CSG_Vector &Kernel, bool bFill)
+{
+	TSG_Grid_Filter	Filter;
+
+	Filter.pInput	= pInput;
+	Filter.pOutput	= pOutput;
+	Filter.Radius	= Kernel.Get_N() - 1;
+	Filter.Kernel	= Kernel.Get_Data();
+	Filter.bFill	= bFill;
+
+	return( Kernel.Get_N() > 0 && SG_Grid_Filter_Run(SG_Grid_Filter_Separable_Band, Filter) );
+}
+
+//---------------------------------------------------------
+/**
+  * Gaussian weighted mean within a square window of the given
+  * radius, computed as separable kernel.
+*/
+bool	SG_Grid_Filter_Gaussian	(CSG_Grid *pInput, CSG_Grid *pOutput, double Sigma, int Radius, bool bFill)
+{
+	if( Sigma <= 0.0 || Radius < 0 )
+	{
+		return( false );
+	}
+
+	CSG_Vector	Kernel(1 + Radius);
+
+	for(int i=0; i<=Radius; i++)
+	{
+		Kernel[i]	= exp(-(i * i) / (2.0 * Sigma * Sigma));
+	}
+
+	return( SG_Grid_Filter_Separable(pInput, pOutput, Kernel, bFill) );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//				Recursive Gaussian Filter				 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// Young, I.T. & van Vliet, L.J. (1995): Recursive implementation
+// of the Gaussian filter. Signal Processing, 44: 139-151.
+
+void	SG_Grid_Filter_IIR	(double *a, int n, int Step, const double c[4])
+{
+	double	w1 = 0.0, w2 = 0.0, w3 = 0.0;
+
+	for(int i=0; i<n; i++)
+	{
+		double	w	= c[0] * a[i * Step] + c[1] * w1 + c[2] * w2 + c[3] * w3;
+
+		a[i * Step]	= w;	w3	= w2;	w2	= w1;	w1	= w;
+	}
+
+	w1 = w2 = w3 = 0.0;
+
+	for(int i=n-1; i>=0; i--)
+	{
+		double	w	= c[0] * a[i * Step] + c[1] * w1 + c[2] * w2 + c[3] * w3;
+
+		a[i * Step]	= w;	w3	= w2;	w2	= w1;	w1	= w;
+	}
+}
+
+//---------------------------------------------------------
+/**
+  * Gaussian smoothing with a recursive (IIR) filter. The cost
+  * per cell is constant and independent of Sigma, the kernel is
+  * not truncated. Needs two temporary grids of type float.
+*/
+bool	SG_Grid_Filter_Gaussian_Recursive	(CSG_Grid *pInput, CSG_Grid *pOutput, double Sigma, bool bFill)
+{
+	if( !pInput || !pInput->is_Valid() || !pOutput || pOutput == pInput || !pOutput->is_Compatible(pInput) || Sigma <= 0.0 )
+	{
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	double	q	= Sigma >= 2.5 ? 0.98711 * Sigma - 0.96330 : 3.97156 - 4.14554 * sqrt(1.0 - 0.26891 * M_GET_MAX(0.5, Sigma));
+
+	double	b0	= 1.57825 + 2.44413 * q + 1.4281 * q*q + 0.422205 * q*q*q;
+	double	b1	=           2.44413 * q + 2.85619 * q*q + 1.26661 * q*q*q;
+	double	b2	=                       - 1.4281  * q*q - 1.26661 * q*q*q;
+	double	b3	=                                       0.422205 * q*q*q;
+
+	double	c[4];
+
+	c[1]	= b1 / b0;
+	c[2]	= b2 / b0;
+	c[3]	= b3 / b0;
+	c[0]	= 1.0 - (c[1] + c[2] + c[3]);
+
+	//-----------------------------------------------------
+	int		NX	= pInput->Get_NX(), NY = pInput->Get_NY();
+
+	bool	bParallel	= SG_Grid_Filter_is_Parallel(pInput, pOutput);
+
+	CSG_Grid	V(pInput->Get_System(), SG_DATATYPE_Float), W(pInput->Get_System(), SG_DATATYPE_Float);
+
+	if( !V.is_Valid() || !W.is_Valid() )
+	{
+		return( false );
+	}
+
+	bParallel	= bParallel && SG_Grid_Filter_is_Parallel(&V, &W);
+
+	//-----------------------------------------------------
+	#pragma omp parallel for if(bParallel)
+	for(int y=0; y<NY; y++)
+	{
+		std::vector<double>	z(NX), w(NX);
+
+		CSG_Grid_Filter_Row	Row(pInput);
+
+		Row.Read(y, &z[0], &w[0]);
+
+		SG_Grid_Filter_IIR(&z[0], NX, 1, c);
+		SG_Grid_Filter_IIR(&w[0], NX, 1, c);
+
+		V.Set_Row(y, &z[0]);
+		W.Set_Row(y, &w[0]);
+	}
+
+	if( !SG_UI_Process_Set_Progress(1, 3) )
+	{
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	const int	Strip	= 64;	// columns processed together for cache friendly row access
+
+	#pragma omp parallel for if(bParallel)
+	for(int xStrip=0; xStrip<NX; xStrip+=Strip)
+	{
+		int	nx	= M_GET_MIN(Strip, NX - xStrip);
+
+		std::vector<double>	z(nx * NY), w(nx * NY);
+
+		for(int y=0; y<NY; y++)
+		{
+			for(int i=0; i<nx; i++)
+			{
+				z[y * nx + i]	= V.asDouble(xStrip + i, y);
+				w[y * nx + i]	= W.asDouble(xStrip + i, y);
+			}
+		}
+
+		for(int i=0; i<nx; i++)
+		{
+			SG_Grid_Filter_IIR(&z[i], NY, nx, c);
+			SG_Grid_Filter_IIR(&w[i], NY, nx, c);
+		}
+
+		for(int y=0; y<NY; y++)
+		{
+			for(int i=0; i<nx; i++)
+			{
+				V.Set_Value(xStrip + i, y, z[y * nx + i]);
+				W.Set_Value(xStrip + i, y, w[y * nx + i]);
+			}
+		}
+	}
+
+	if( !SG_UI_Process_Set_Progress(2, 3) )
+	{
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	#pragma omp parallel for if(bParallel)
+	for(int y=0; y<NY; y++)
+	{
+		std::vector<double>	z(NX), w(NX);
+
+		CSG_Grid_Filter_Row	Row(pInput);
+
+		const bool	*bCenter	= Row.Get_NoData(y, &z[0]);
+
+		bool	*bNoData	= new bool[NX];
+
+		V.Get_Row(y, &z[0]);
+		W.Get_Row(y, &w[0]);
+
+		for(int x=0; x<NX; x++)
+		{
+			if( (bNoData[x] = (!bFill && bCenter[x]) || w[x] < 0.001) == false )
+			{
+				z[x]	/= w[x];
+			}
+		}
+
+		pOutput->Set_Row(y, &z[0], true, bNoData);
+
+		delete[](bNoData);
+	}
+
+	return( true );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//					Minimum / Maximum					 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// van Herk, M. (1992): A fast algorithm for local minimum and
+// maximum filters on rectangular and octagonal kernels.
+// Pattern Recognition Letters, 13: 517-521.
+// Gil, J. & Werman, M. (1993): Computing 2-D min, median, and
+// max filters. IEEE Trans. PAMI, 15: 504-507.
+//
+// Block-wise running extremes from left and right give the
+// extreme of any window with three comparisons per cell.
+
+void	SG_Grid_Filter_Extreme_1D	(const double *a, double *b, int n, int Step, int r, bool bMaximum, std::vector<double> &g, std::vector<double> &h)
+{
+	int		k	= 2 * r + 1, m = n + 2 * r;
+
+	double	Neutral	= bMaximum ? -DBL_MAX : DBL_MAX;
+
+	g.resize(m);	h.resize(m);
+
+	#define EXTREME_A(i)		((i) < r || (i) >= n + r ? Neutral : a[((i) - r) * Step])
+	#define EXTREME_B(u, v)	(bMaximum ? ((u) > (v) ? (u) : (v)) : ((u) < (v) ? (u) : (v)))
+
+	for(int i=0; i<m; i++)
+	{
+		g[i]	= i % k == 0 ? EXTREME_A(i) : EXTREME_B(g[i - 1], EXTREME_A(i));
+	}
+
+	for(int i=m-1; i>=0; i--)
+	{
+		h[i]	= i % k == k - 1 || i == m - 1 ? EXTREME_A(i) : EXTREME_B(h[i + 1], EXTREME_A(i));
+	}
+
+	for(int i=0; i<n; i++)
+	{
+		b[i * Step]	= EXTREME_B(h[i], g[i + 2 * r]);
+	}
+
+	#undef EXTREME_A
+	#undef EXTREME_B
+}
+
+//---------------------------------------------------------
+void	SG_Grid_Filter_Extreme_Band	(const TSG_Grid_Filter &Filter, int yFrom, int yTo)
+{
+	int		NX	= Filter.pInput->Get_NX(), NY = Filter.pInput->Get_NY(), r = Filter.Radius;
+
+	int		yA	= M_GET_MAX(0, yFrom - r), yB = M_GET_MIN(NY, yTo + r), ny = yB - yA;
+
+	double	Neutral	= Filter.bMaximum ? -DBL_MAX : DBL_MAX;
+
+	std::vector<double>	H(ny * NX), z(NX), w(NX), c(ny), g, h;
+
+	CSG_Grid_Filter_Row	Row(Filter.pInput);
+
+	bool	*bNoData	= new bool[NX];
+
+	//-----------------------------------------------------
+	for(int y=yA; y<yB; y++)
+	{
+		Row.Read(y, &z[0], &w[0]);
+
+		for(int x=0; x<NX; x++)
+		{
+			if( w[x] <= 0.0 )
+			{
+				z[x]	= Neutral;
+			}
+		}
+
+		SG_Grid_Filter_Extreme_1D(&z[0], &H[(y - yA) * NX], NX, 1, r, Filter.bMaximum, g, h);
+	}
+
+	for(int x=0; x<NX; x++)
+	{
+		SG_Grid_Filter_Extreme_1D(&H[x], &c[0], ny, NX, r, Filter.bMaximum, g, h);
+
+		for(int y=0; y<ny; y++)
+		{
+			H[y * NX + x]	= c[y];
+		}
+	}
+
+	//-----------------------------------------------------
+	for(int y=yFrom; y<yTo; y++)
+	{
+		const bool	*bCenter	= Row.Get_NoData(y, &z[0]);
+
+		for(int x=0; x<NX; x++)
+		{
+			z[x]	= H[(y - yA) * NX + x];
+
+			bNoData[x]	= (!Filter.bFill && bCenter[x]) || z[x] == Neutral;
+		}
+
+		Filter.pOutput->Set_Row(y, &z[0], true, bNoData);
+	}
+
+	delete[](bNoData);
+}
+
+//---------------------------------------------------------
+/**
+  * Minimum or, if bMaximum is true, maximum of the valid cells
+  * within a square window of the given radius (van Herk/Gil-Werman).
+  * The cost per cell is independent of the radius.
+*/
+bool	SG_Grid_Filter_Extreme	(CSG_Grid *pInput, CSG_Grid *pOutput, int Radius, bool bMaximum, bool bFill)
+{
+	TSG_Grid_Filter	Filter;
+
+	Filter.pInput	= pInput;
+	Filter.pOutput	= pOutput;
+	Filter.Radius	= Radius;
+	Filter.bMaximum	= bMaximum;
+	Filter.bFill	= bFill;
+
+	return( SG_Grid_Filter_Run(SG_Grid_Filter_Extreme_Band, Filter) );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
@@ -120,7 +120,7 @@ bool CSG_Grid::_Load(const CSG_String &File_Name, TSG_Data_Type Type, TSG_Grid_M
 	{
 		CSG_Grid	*pGrid	= (CSG_Grid *)tmpMgr.Get_Grid_System(0)->Get(0);
 
-		if( pGrid->is_Cached() || pGrid->is_Compressed() )
+		if( pGrid->is_Cached() || pGrid->is_Compressed() || pGrid->is_Mapped() )
 		{
 			return( Create(*pGrid) );
 		}
@@ -261,7 +261,7 @@ bool CSG_Grid::_Load_Binary(CSG_File &Stream, TSG_Data_Type File_Type, bool bFli
 	{
 		int	nxBytes	= Get_NX() / 8 + 1;
 
-		if( m_Type == File_Type && m_Memory_Type == GRID_MEMORY_Normal )
+		if( m_Type == File_Type && _is_Array() )
 		{
 			for(int iy=0; iy<Get_NY() && !Stream.is_EOF() && SG_UI_Process_Set_Progress(iy, Get_NY()); iy++, y+=dy)
 			{
@@ -297,7 +297,7 @@ bool CSG_Grid::_Load_Binary(CSG_File &Stream, TSG_Data_Type File_Type, bool bFli
 		int	nValueBytes	= (int)SG_Data_Type_Get_Size(File_Type);
 		int	nxBytes		= Get_NX() * nValueBytes;
 
-		if( m_Type == File_Type && m_Memory_Type == GRID_MEMORY_Normal && !bSwapBytes )
+		if( m_Type == File_Type && _is_Array() && !bSwapBytes )
 		{
 			for(int iy=0; iy<Get_NY() && !Stream.is_EOF() && SG_UI_Process_Set_Progress(iy, Get_NY()); iy++, y+=dy)
 			{
@@ -365,7 +365,7 @@ bool CSG_Grid::_Save_Binary(CSG_File &Stream, int xA, int yA, int xN, int yN, TS
 	{
 		int	nxBytes	= xN / 8 + 1;
 
-		if( m_Type == File_Type && m_Memory_Type == GRID_MEMORY_Normal && xA % 8 == 0 )
+		if( m_Type == File_Type && _is_Array() && xA % 8 == 0 )
 		{
 			int	axBytes	= xA / 8;
 
@@ -403,7 +403,7 @@ bool CSG_Grid::_Save_Binary(CSG_File &Stream, int xA, int yA, int xN, int yN, TS
 		int	nValueBytes	= (int)SG_Data_Type_Get_Size(File_Type);
 		int	nxBytes		= xN * nValueBytes;
 
-		if( m_Type == File_Type && m_Memory_Type == GRID_MEMORY_Normal && !bSwapBytes )
+		if( m_Type == File_Type && _is_Array() && !bSwapBytes )
 		{
 			int	axBytes	= xA * nValueBytes;
 
@@ -655,9 +655,21 @@ bool CSG_Grid::_Load_Native(const CSG_String &File_Name, TSG_Grid_Memory_Type Me
 	//-----------------------------------------------------
 	else	// Binary...
 	{
-		if( SG_Grid_Cache_Check(m_System, Get_nValueBytes()) > 0 )
+		sLong	nBuffer	= Memory_Type == GRID_MEMORY_Mapped ? 0 : SG_Grid_Cache_Check(m_System, Get_nValueBytes());
+
+		if( Memory_Type == GRID_MEMORY_Mapped || (nBuffer > 0 && SG_Grid_Cache_Get_Mapping()) )
+		{
+			if( _Map_Create(Info.m_Data_File                                , m_Type, Info.m_Offset, Info.m_bSwapBytes, Info.m_bFlip)
+			||	_Map_Create(SG_File_Make_Path(NULL, File_Name, SG_T( "dat")), m_Type, Info.m_Offset, Info.m_bSwapBytes, Info.m_bFlip)
+			||	_Map_Create(SG_File_Make_Path(NULL, File_Name, SG_T("sdat")), m_Type, Info.m_Offset, Info.m_bSwapBytes, Info.m_bFlip) )
+			{
+				return( true );
+			}
+		}
+
+		if( nBuffer > 0 )
 		{
-			Set_Buffer_Size(SG_Grid_Cache_Check(m_System, Get_nValueBytes()));
+			Set_Buffer_Size(nBuffer);
 
 			if( _Cache_Create(Info.m_Data_File                                , m_Type, Info.m_Offset, Info.m_bSwapBytes, Info.m_bFlip)
 			||	_Cache_Create(SG_File_Make_Path(NULL, File_Name, SG_T( "dat")), m_Type, Info.m_Offset, Info.m_bSwapBytes, Info.m_bFlip)
@@ -688,30 +700,60 @@ bool CSG_Grid::_Load_Native(const CSG_String &File_Name, TSG_Grid_Memory_Type Me
 //---------------------------------------------------------
 bool CSG_Grid::_Save_Native(const CSG_String &File_Name, int xA, int yA, int xN, int yN, bool bBinary)
 {
+	CSG_String	Data_File(SG_File_Make_Path(NULL, File_Name, SG_T("sdat")));
+
+	//-----------------------------------------------------
+	// rewriting a mapped data file would truncate it under
+	// the mapping, so copy the data to memory first and map
+	// the new file again after it has been written
+
+	bool	bRemap	= is_Mapped() && !m_Cache_bTemp
+		&& !SG_File_Get_Path_Absolute(Data_File).Cmp(SG_File_Get_Path_Absolute(m_Cache_Path));
+
+	if( bRemap && !_Map_Destroy(true) )
+	{
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	bool	bResult	= false;
+
 	CSG_Grid_File_Info	Info(*this);
 
 	if(	Info.Save(File_Name, bBinary) )
 	{
 		CSG_File	Stream;
 
-		if( Stream.Open(SG_File_Make_Path(NULL, File_Name, SG_T("sdat")), SG_FILE_W, true) )
+		if( Stream.Open(Data_File, SG_FILE_W, true) )
 		{
 			if( bBinary )
 			{
 #ifdef WORDS_BIGENDIAN
-				return( _Save_Binary(Stream, xA, yA, xN, yN, m_Type, false,  true) );
+				bResult	= _Save_Binary(Stream, xA, yA, xN, yN, m_Type, false,  true);
 #else
-				return( _Save_Binary(Stream, xA, yA, xN, yN, m_Type, false, false) );
+				bResult	= _Save_Binary(Stream, xA, yA, xN, yN, m_Type, false, false);
 #endif
 			}
 			else
 			{
-				return( _Save_ASCII (Stream, xA, yA, xN, yN) );
+				bResult	= _Save_ASCII (Stream, xA, yA, xN, yN);
 			}
+
+			Stream.Close();
 		}
 	}
 
-	return( false );
+	//-----------------------------------------------------
+	if( bRemap && bResult && bBinary && xA == 0 && yA == 0 && xN == Get_NX() && yN == Get_NY() )
+	{
+#ifdef WORDS_BIGENDIAN
+		_Map_Create(Data_File, m_Type, 0,  true, false);	// fails, grid stays in memory
+#else
+		_Map_Create(Data_File, m_Type, 0, false, false);
+#endif
+	}
+
+	return( bResult );
 }
 
 
@@ -65,6 +65,14 @@
 //---------------------------------------------------------
 #include <memory.h>
 
+#ifdef _SAGA_LINUX
+#include <sys/mman.h>
+#include <stdio.h>
+#else
+#include <windows.h>
+#include <io.h>
+#endif
+
 #include "grid.h"
 #include "parameters.h"
 
@@ -104,6 +112,19 @@ bool				SG_Grid_Cache_Get_Automatic(void)
 	return( gSG_Grid_Cache_bAutomatic );
 }
 
+//---------------------------------------------------------
+static bool			gSG_Grid_Cache_bMapping		= false;
+
+void				SG_Grid_Cache_Set_Mapping(bool bOn)
+{
+	gSG_Grid_Cache_bMapping		= bOn;
+}
+
+bool				SG_Grid_Cache_Get_Mapping(void)
+{
+	return( gSG_Grid_Cache_bMapping );
+}
+
 //---------------------------------------------------------
 static int			gSG_Grid_Cache_Confirm		= 2;
 
@@ -120,7 +141,7 @@ int					SG_Grid_Cache_Get_Confirm(void)
 //---------------------------------------------------------
 static sLong		gSG_Grid_Cache_Threshold	= 250 * N_MEGABYTE_BYTES;
 
-void				SG_Grid_Cache_Set_Threshold(int nBytes)
+void				SG_Grid_Cache_Set_Threshold(sLong nBytes)
 {
 	if( nBytes >= 0 )
 	{
@@ -130,7 +151,7 @@ void				SG_Grid_Cache_Set_Threshold(int nBytes)
 
 void				SG_Grid_Cache_Set_Threshold_MB(double nMegabytes)
 {
-	SG_Grid_Cache_Set_Threshold((int)(nMegabytes * N_MEGABYTE_BYTES));
+	SG_Grid_Cache_Set_Threshold((sLong)(nMegabytes * N_MEGABYTE_BYTES));
 }
 
 sLong				SG_Grid_Cache_Get_Threshold(void)
@@ -159,7 +180,7 @@ bool CSG_Grid::_Memory_Create(TSG_Grid_Memory_Type Memory_Type)
 
 		Set_Buffer_Size(gSG_Grid_Cache_Threshold);
 
-		if(	Memory_Type != GRID_MEMORY_Cache && gSG_Grid_Cache_bAutomatic && Get_Memory_Size() > gSG_Grid_Cache_Threshold )
+		if(	Memory_Type != GRID_MEMORY_Cache && Memory_Type != GRID_MEMORY_Mapped && gSG_Grid_Cache_bAutomatic && Get_Memory_Size() > gSG_Grid_Cache_Threshold )
 		{
 			switch( gSG_Grid_Cache_Confirm )
 			{
@@ -204,6 +225,11 @@ bool CSG_Grid::_Memory_Create(TSG_Grid_Memory_Type Memory_Type)
 				}
 				break;
 			}
+
+			if( Memory_Type == GRID_MEMORY_Cache && gSG_Grid_Cache_bMapping )
+			{
+				Memory_Type	= GRID_MEMORY_Mapped;
+			}
 		}
 
 		//-------------------------------------------------
@@ -217,6 +243,9 @@ bool CSG_Grid::_Memory_Create(TSG_Grid_Memory_Type Memory_Type)
 
 		case GRID_MEMORY_Compression:
 			return( _Compr_Create() );
+
+		case GRID_MEMORY_Mapped:
+			return( _Map_Create() );
 		}
 	}
 
@@ -234,6 +263,7 @@ void CSG_Grid::_Memory_Destroy(void)
 	case GRID_MEMORY_Normal:		_Array_Destroy();		break;
 	case GRID_MEMORY_Cache:			_Cache_Destroy(false);	break;
 	case GRID_MEMORY_Compression:	_Compr_Destroy(false);	break;
+	case GRID_MEMORY_Mapped:		_Map_Destroy(false);	break;
 	}
 
 	_LineBuffer_Destroy();
@@ -285,6 +315,18 @@ bool CSG_Grid::Set_Buffer_Size(sLong nBytes)
 {
 	if( m_System.is_Valid() && m_Type != SG_DATATYPE_Undefined )
 	{
+		if( m_Buffer_Size != nBytes )
+		{
+			m_Buffer_Size	= nBytes;
+
+			if( m_Cache_Tiles )	// re-create tile slots for the new memory budget
+			{
+				_Cache_Tiles_Flush();
+				_Cache_Tiles_Create();
+			}
+		}
+
+		//-------------------------------------------------
 		int	nLines	= (int)(nBytes / Get_nLineBytes());
 
 		if( nLines < 1 )
@@ -346,10 +388,6 @@ void CSG_Grid::_LineBuffer_Flush(void)
 		    default:
 		        break;
 
-			case GRID_MEMORY_Cache:
-				_Cache_LineBuffer_Save(m_LineBuffer + i);
-				break;
-
 			case GRID_MEMORY_Compression:
 				_Compr_LineBuffer_Save(m_LineBuffer + i);
 				break;
@@ -387,11 +425,6 @@ CSG_Grid::TSG_Grid_Line * CSG_Grid::_LineBuffer_Get_Line(int y) const
 				default:
 					break;
 
-				case GRID_MEMORY_Cache:
-					_Cache_LineBuffer_Save(m_LineBuffer + iLine);
-					_Cache_LineBuffer_Load(m_LineBuffer + iLine, y);
-					break;
-
 				case GRID_MEMORY_Compression:
 					_Compr_LineBuffer_Save(m_LineBuffer + iLine);
 					_Compr_LineBuffer_Load(m_LineBuffer + iLine, y);
@@ -526,6 +559,10 @@ void CSG_Grid::_Array_Destroy(void)
 //														 //
 ///////////////////////////////////////////////////////////
 
+//---------------------------------------------------------
+#define GRID_CACHE_TILE_SIZE	256
+#define GRID_CACHE_TILE_MIN		4
+
 //---------------------------------------------------------
 bool CSG_Grid::Set_Cache(bool bOn)
 {
@@ -558,7 +595,7 @@ bool CSG_Grid::_Cache_Create(const SG_Char *FilePath, TSG_Data_Type File_Type, s
 			m_Cache_bSwap	= bSwap;
 			m_Cache_bFlip	= bFlip;
 
-			_LineBuffer_Create();
+			_Cache_Tiles_Create();
 
 			m_Memory_bLock	= false;
 			m_Memory_Type	= GRID_MEMORY_Cache;
@@ -573,8 +610,6 @@ bool CSG_Grid::_Cache_Create(const SG_Char *FilePath, TSG_Data_Type File_Type, s
 //---------------------------------------------------------
 bool CSG_Grid::_Cache_Create(void)
 {
-	TSG_Grid_Line	Line;
-
 	if( m_System.is_Valid() && m_Type != SG_DATATYPE_Undefined && m_Memory_Type == GRID_MEMORY_Normal )
 	{
 		m_Cache_Path	= SG_File_Get_Name_Temp(SG_T("sg_grd"), SG_Grid_Cache_Get_Directory());
@@ -589,20 +624,33 @@ bool CSG_Grid::_Cache_Create(void)
 			m_Cache_bSwap	= false;
 			m_Cache_bFlip	= false;
 
-			_LineBuffer_Create();
+			_Cache_Tiles_Create();
 
 			if( m_Values )
 			{
-				Line.Data	= (char *)SG_Malloc(Get_nLineBytes());
+				TSG_Grid_Tile	Tile;
 
-				for(Line.y=0; Line.y<Get_NY() && SG_UI_Process_Set_Progress(Line.y, Get_NY()); Line.y++)
+				Tile.Data	= (char *)SG_Malloc(m_Cache_Tiles->nBytes);
+
+				int	nTiles	= m_Cache_Tiles->nTiles_X * m_Cache_Tiles->nTiles_Y;
+
+				for(Tile.Index=0; Tile.Index<nTiles && SG_UI_Process_Set_Progress(Tile.Index, nTiles); Tile.Index++)
 				{
-					Line.bModified	= true;
-					memcpy(Line.Data, m_Values[Line.y], Get_nLineBytes());
-					_Cache_LineBuffer_Save(&Line);
+					int	x0, y0, nx, ny, nBytes;	_Cache_Tile_Get_Extent(Tile.Index, x0, y0, nx, ny, nBytes);
+
+					memset(Tile.Data, 0, m_Cache_Tiles->nBytes);
+
+					for(int iy=0; iy<ny; iy++)
+					{
+						memcpy(Tile.Data + iy * m_Cache_Tiles->nLineBytes, (char *)m_Values[y0 + iy] + x0, nBytes);
+					}
+
+					Tile.bModified	= true;
+
+					_Cache_Tile_Save(&Tile);
 				}
 
-				SG_Free(Line.Data);
+				SG_Free(Tile.Data);
 
 				_Array_Destroy();
 
@@ -620,32 +668,35 @@ bool CSG_Grid::_Cache_Create(void)
 //---------------------------------------------------------
 bool CSG_Grid::_Cache_Destroy(bool bMemory_Restore)
 {
-	int				y;
-	TSG_Grid_Line	*pLine;
-
 	if( is_Valid() && m_Memory_Type == GRID_MEMORY_Cache )
 	{
 		m_Memory_bLock	= true;
 
 		if( !m_Cache_bTemp )
 		{
-			_LineBuffer_Flush();
+			_Cache_Tiles_Flush();
 		}
 
 		if( bMemory_Restore && _Array_Create() )
 		{
-			for(y=0; y<Get_NY() && SG_UI_Process_Set_Progress(y, Get_NY()); y++)
+			int	nTiles	= m_Cache_Tiles->nTiles_X * m_Cache_Tiles->nTiles_Y;
+
+			for(int iTile=0; iTile<nTiles && SG_UI_Process_Set_Progress(iTile, nTiles); iTile++)
 			{
-				if( (pLine = _LineBuffer_Get_Line(y)) != NULL )
+				int	x0, y0, nx, ny, nBytes;	_Cache_Tile_Get_Extent(iTile, x0, y0, nx, ny, nBytes);
+
+				TSG_Grid_Tile	*pTile	= _Cache_Get_Tile((iTile % m_Cache_Tiles->nTiles_X) * m_Cache_Tiles->nx, y0);
+
+				for(int iy=0; pTile && iy<ny; iy++)
 				{
-					memcpy(m_Values[y], pLine->Data, Get_nLineBytes());
+					memcpy((char *)m_Values[y0 + iy] + x0, pTile->Data + iy * m_Cache_Tiles->nLineBytes, nBytes);
 				}
 			}
 
 			SG_UI_Process_Set_Ready();
 		}
 
-		_LineBuffer_Destroy();
+		_Cache_Tiles_Destroy();
 
 		m_Memory_bLock	= false;
 		m_Memory_Type	= GRID_MEMORY_Normal;
@@ -667,346 +718,873 @@ bool CSG_Grid::_Cache_Destroy(bool bMemory_Restore)
 
 ///////////////////////////////////////////////////////////
 //														 //
-//					Cache: Save / Load					 //
+//					Cache: Tiles						 //
 //														 //
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-void CSG_Grid::_Cache_LineBuffer_Save(TSG_Grid_Line *pLine) const
+/**
+  * The file cache holds rectangular blocks (tiles) of cells
+  * instead of complete rows, so that column-wise and
+  * neighbourhood access patterns are served from memory, too.
+  * Tiles are addressed by a direct lookup table and replaced
+  * following the clock (second chance) strategy.
+*/
+void CSG_Grid::_Cache_Tiles_Create(void)
 {
-	if( pLine && pLine->bModified )
-	{
-		pLine->bModified	= false;
-
-		if( pLine->y >= 0 && pLine->y < Get_NY() )
-		{
-			sLong	Line_Y		= m_Cache_bFlip ? Get_NY() - 1 - pLine->y : pLine->y;
-			sLong	Line_Size	= Get_nLineBytes();
-			sLong	Line_Pos	= m_Cache_Offset + Line_Y * Line_Size;
+	_Cache_Tiles_Destroy();
 
-			//-------------------------------------------------
-			if( m_Cache_bSwap && m_Type != SG_DATATYPE_Bit )
-			{
-				char	*pValue	= pLine->Data;
+	m_Cache_Tiles	= (TSG_Grid_Tiles *)SG_Malloc(sizeof(TSG_Grid_Tiles));
 
-				for(int x=0; x<Get_NX(); x++, pValue+=Get_nValueBytes())
-				{
-					_Swap_Bytes(pValue, Get_nValueBytes());
-				}
-			}
+	TSG_Grid_Tiles	&t	= *m_Cache_Tiles;
 
-			m_Cache_Stream.Seek(Line_Pos);
-			m_Cache_Stream.Write(pLine->Data, sizeof(char), Line_Size);
-			m_Cache_Stream.Flush();
+	t.nx		= Get_NX() > GRID_CACHE_TILE_SIZE ? GRID_CACHE_TILE_SIZE : Get_NX();
+	t.ny		= Get_NY() > GRID_CACHE_TILE_SIZE ? GRID_CACHE_TILE_SIZE : Get_NY();
 
-			if( m_Cache_bSwap && m_Type != SG_DATATYPE_Bit )
-			{
-				char	*pValue	= pLine->Data;
+	t.nLineBytes	= m_Type != SG_DATATYPE_Bit ? t.nx * Get_nValueBytes() : (t.nx < Get_NX() ? t.nx / 8 : Get_nLineBytes());
+	t.nBytes		= t.ny * t.nLineBytes;
 
-				for(int x=0; x<Get_NX(); x++, pValue+=Get_nValueBytes())
-				{
-					_Swap_Bytes(pValue, Get_nValueBytes());
-				}
-			}
-		}
-	}
-}
+	t.nTiles_X	= 1 + (Get_NX() - 1) / t.nx;
+	t.nTiles_Y	= 1 + (Get_NY() - 1) / t.ny;
 
-//---------------------------------------------------------
-void CSG_Grid::_Cache_LineBuffer_Load(TSG_Grid_Line *pLine, int y) const
-{
-	if( pLine )
-	{
-		pLine->bModified	= false;
-		pLine->y			= y;
+	int	nTiles	= t.nTiles_X * t.nTiles_Y;
 
-		if( pLine->y >= 0 && pLine->y < Get_NY() )
-		{
-			sLong	Line_Y		= m_Cache_bFlip ? Get_NY() - 1 - pLine->y : pLine->y;
-			sLong	Line_Size	= Get_nLineBytes();
-			sLong	Line_Pos	= m_Cache_Offset + Line_Y * Line_Size;
+	sLong	nSlots	= m_Buffer_Size / t.nBytes;
 
-			//-------------------------------------------------
-			m_Cache_Stream.Seek(Line_Pos);
-			m_Cache_Stream.Read(pLine->Data, sizeof(char), Line_Size);
+	t.nSlots	= (int)(nSlots < GRID_CACHE_TILE_MIN ? GRID_CACHE_TILE_MIN : nSlots > nTiles ? nTiles : nSlots);
+	t.iClock	= 0;
 
-			if( m_Cache_bSwap && m_Type != SG_DATATYPE_Bit )
-			{
-				char	*pValue	= pLine->Data;
+	//-----------------------------------------------------
+	t.Index		= (int *)SG_Malloc(nTiles * sizeof(int));
 
-				for(int x=0; x<Get_NX(); x++, pValue+=Get_nValueBytes())
-				{
-					_Swap_Bytes(pValue, Get_nValueBytes());
-				}
-			}
-		}
+	for(int i=0; i<nTiles; i++)
+	{
+		t.Index[i]	= -1;
 	}
-}
 
+	t.Tiles		= (TSG_Grid_Tile *)SG_Malloc(t.nSlots * sizeof(TSG_Grid_Tile));
 
-///////////////////////////////////////////////////////////
-//														 //
-//					RTL - Compression					 //
-//														 //
-///////////////////////////////////////////////////////////
-
-//---------------------------------------------------------
-bool CSG_Grid::Set_Compression(bool bOn)
-{
-	return( bOn ? _Compr_Create() : _Compr_Destroy(true) );
+	for(int i=0; i<t.nSlots; i++)
+	{
+		t.Tiles[i].bModified	= false;
+		t.Tiles[i].bUsed		= false;
+		t.Tiles[i].Index		= -1;
+		t.Tiles[i].Data			= (char *)SG_Malloc(t.nBytes);
+	}
 }
 
 //---------------------------------------------------------
-double CSG_Grid::Get_Compression_Ratio(void) const
+void CSG_Grid::_Cache_Tiles_Destroy(void)
 {
-	if( is_Valid() && is_Compressed() )
+	if( m_Cache_Tiles )
 	{
-		sLong	nCompressed	= 0;
-
-		for(int y=0; y<Get_NY(); y++)
+		for(int i=0; i<m_Cache_Tiles->nSlots; i++)
 		{
-			nCompressed	+= *((int *)m_Values[y]);
+			SG_Free(m_Cache_Tiles->Tiles[i].Data);
 		}
 
-		return( (double)nCompressed / (double)(Get_NCells() * Get_nValueBytes()) );
-	}
+		SG_Free(m_Cache_Tiles->Tiles);
+		SG_Free(m_Cache_Tiles->Index);
 
-	return( 1.0 );
+		SG_FREE_SAFE(m_Cache_Tiles);
+	}
 }
 
-
-///////////////////////////////////////////////////////////
-//														 //
-//			RTL - Compression: Create / Destroy			 //
-//														 //
-///////////////////////////////////////////////////////////
-
 //---------------------------------------------------------
-bool CSG_Grid::_Compr_Create(void)
+void CSG_Grid::_Cache_Tiles_Flush(void)
 {
-	TSG_Grid_Line	Line;
-
-	if( m_System.is_Valid() && m_Type != SG_DATATYPE_Undefined && m_Memory_Type == GRID_MEMORY_Normal )
+	if( m_Cache_Tiles )
 	{
-		m_Memory_bLock	= true;
-
-		Line.Data		= (char *)SG_Calloc(1, _Get_nLineBytes());
-
-		if( m_Values )	// compress loaded data...
-		{
-			void	**Values	= m_Values;
-			
-			m_Values	= (void **)SG_Calloc(Get_NY(), sizeof(void *));
-
-			for(Line.y=0; Line.y<Get_NY() && SG_UI_Process_Set_Progress(Line.y, Get_NY()); Line.y++)
-			{
-				memcpy(Line.Data, Values[Line.y], Get_nLineBytes());
-				Line.bModified	= true;
-				_Compr_LineBuffer_Save(&Line);
-			}
-
-			SG_Free(Values[0]);
-			SG_Free(Values);
-		}
-		else			// create empty grid...
+		for(int i=0; i<m_Cache_Tiles->nSlots; i++)
 		{
-			m_Values	= (void **)SG_Malloc(Get_NY() * sizeof(void *));
-
-			for(Line.y=0; Line.y<Get_NY() && SG_UI_Process_Set_Progress(Line.y, Get_NY()); Line.y++)
-			{
-				m_Values[Line.y]	= (void *)SG_Calloc(1, Get_nLineBytes());
-				Line.bModified	= true;
-				_Compr_LineBuffer_Save(&Line);
-			}
+			_Cache_Tile_Save(m_Cache_Tiles->Tiles + i);
 		}
+	}
+}
 
-		SG_Free(Line.Data);
+//---------------------------------------------------------
+/**
+  * Returns the tile's upper left cell position, with x as byte
+  * offset within a row, its number of rows and columns and the
+  * number of bytes of each tile row in the grid's rows.
+*/
+void CSG_Grid::_Cache_Tile_Get_Extent(int iTile, int &x0, int &y0, int &nx, int &ny, int &nBytes) const
+{
+	const TSG_Grid_Tiles	&t	= *m_Cache_Tiles;
 
-		_LineBuffer_Create();
+	int	ix	= iTile % t.nTiles_X;
+	int	iy	= iTile / t.nTiles_X;
 
-		m_Memory_bLock	= false;
-		m_Memory_Type	= GRID_MEMORY_Compression;
+	nx		= ix < t.nTiles_X - 1 ? t.nx : Get_NX() - ix * t.nx;
+	ny		= iy < t.nTiles_Y - 1 ? t.ny : Get_NY() - iy * t.ny;
 
-		SG_UI_Process_Set_Ready();
-	}
+	x0		= ix * t.nLineBytes;
+	y0		= iy * t.ny;
 
-	return( is_Compressed() );
+	nBytes	= Get_nLineBytes() - x0 < t.nLineBytes ? Get_nLineBytes() - x0 : t.nLineBytes;
 }
 
 //---------------------------------------------------------
-bool CSG_Grid::_Compr_Destroy(bool bMemory_Restore)
+CSG_Grid::TSG_Grid_Tile * CSG_Grid::_Cache_Get_Tile(int x, int y) const
 {
-	TSG_Grid_Line	Line;
-
-	if( !is_Valid() || m_Memory_Type != GRID_MEMORY_Compression )
+	if( !m_Cache_Tiles || x < 0 || x >= Get_NX() || y < 0 || y >= Get_NY() )
 	{
-		return( false );
+		return( NULL );
 	}
 
-	m_Memory_bLock	= true;
+	TSG_Grid_Tiles	&t	= *m_Cache_Tiles;
+
+	int	iTile	= (y / t.ny) * t.nTiles_X + x / t.nx;
+	int	iSlot	= t.Index[iTile];
 
 	//-----------------------------------------------------
-	if( !bMemory_Restore )
-	{
-		_Array_Destroy();
-	}
-	else
+	if( iSlot < 0 )
 	{
-		_LineBuffer_Flush();
+		while( t.Tiles[t.iClock].bUsed )	// give recently used tiles a second chance
+		{
+			t.Tiles[t.iClock].bUsed	= false;
 
-		void	**vCompr	= m_Values;
+			t.iClock	= (t.iClock + 1) % t.nSlots;
+		}
 
-		m_Values	= NULL;
+		iSlot		= t.iClock;
+		t.iClock	= (t.iClock + 1) % t.nSlots;
 
-		if( !_Array_Create() )
+		TSG_Grid_Tile	*pTile	= t.Tiles + iSlot;
+
+		if( pTile->Index >= 0 )
 		{
-			m_Values		= vCompr;
-			m_Memory_bLock	= false;
+			_Cache_Tile_Save(pTile);
 
-			return( false );
+			t.Index[pTile->Index]	= -1;
 		}
 
-		void	**vArray	= m_Values;
+		_Cache_Tile_Load(pTile, iTile);
 
-		m_Values	= vCompr;
-		Line.Data	= (char *)SG_Calloc(1, _Get_nLineBytes());
+		t.Index[iTile]	= iSlot;
+	}
 
-		for(int y=0; y<Get_NY() && SG_UI_Process_Set_Progress(y, Get_NY()); y++)
-		{
-			_Compr_LineBuffer_Load(&Line, y);
-			memcpy(vArray[y], Line.Data, Get_nLineBytes());
-			SG_Free(vCompr[y]);
-		}
+	//-----------------------------------------------------
+	t.Tiles[iSlot].bUsed	= true;
 
-		m_Values	= vArray;
+	return( t.Tiles + iSlot );
+}
 
-		SG_Free(vCompr);
+//---------------------------------------------------------
+void CSG_Grid::_Cache_Set_Value(int x, int y, double Value)
+{
+	TSG_Grid_Tile	*pTile	= _Cache_Get_Tile(x, y);
 
-		SG_Free(Line.Data);
+	if( pTile )
+	{
+		char	*pLine	= pTile->Data + (y % m_Cache_Tiles->ny) * m_Cache_Tiles->nLineBytes;
 
-		SG_UI_Process_Set_Ready();
+		x	%= m_Cache_Tiles->nx;
+
+		switch( m_Type )
+		{
+		case SG_DATATYPE_Byte  :	((BYTE   *)pLine)[x]	= (BYTE  )Value;	break;
+		case SG_DATATYPE_Char  :	((char   *)pLine)[x]	= (char  )Value;	break;
+		case SG_DATATYPE_Word  :	((WORD   *)pLine)[x]	= (WORD  )Value;	break;
+		case SG_DATATYPE_Short :	((short  *)pLine)[x]	= (short )Value;	break;
+		case SG_DATATYPE_DWord :	((DWORD  *)pLine)[x]	= (DWORD )Value;	break;
+		case SG_DATATYPE_Int   :	((int    *)pLine)[x]	= (int   )Value;	break;
+		case SG_DATATYPE_Long  :	((sLong  *)pLine)[x]	= (sLong )Value;	break;
+		case SG_DATATYPE_Float :	((float  *)pLine)[x]	= (float )Value;	break;
+		case SG_DATATYPE_Double:	((double *)pLine)[x]	= (double)Value;	break;
+		case SG_DATATYPE_Bit   :	((BYTE   *)pLine)[x / 8]	= Value != 0.0
+				? ((BYTE *)pLine)[x / 8] |   m_Bitmask[x % 8]
+				: ((BYTE *)pLine)[x / 8] & (~m_Bitmask[x % 8]);
+			break;
+		default:	break;
+		}
+
+		pTile->bModified	= true;
 	}
+}
 
-	//-----------------------------------------------------
-	_LineBuffer_Destroy();
+//---------------------------------------------------------
+double CSG_Grid::_Cache_Get_Value(int x, int y) const
+{
+	TSG_Grid_Tile	*pTile	= _Cache_Get_Tile(x, y);
 
-	m_Memory_bLock	= false;
-	m_Memory_Type	= GRID_MEMORY_Normal;
+	if( pTile )
+	{
+		char	*pLine	= pTile->Data + (y % m_Cache_Tiles->ny) * m_Cache_Tiles->nLineBytes;
 
-	return( true );
+		x	%= m_Cache_Tiles->nx;
+
+		switch( m_Type )
+		{
+		case SG_DATATYPE_Byte  :	return( (double)((BYTE   *)pLine)[x] );
+		case SG_DATATYPE_Char  :	return( (double)((char   *)pLine)[x] );
+		case SG_DATATYPE_Word  :	return( (double)((WORD   *)pLine)[x] );
+		case SG_DATATYPE_Short :	return( (double)((short  *)pLine)[x] );
+		case SG_DATATYPE_DWord :	return( (double)((DWORD  *)pLine)[x] );
+		case SG_DATATYPE_Int   :	return( (double)((int    *)pLine)[x] );
+		case SG_DATATYPE_Long  :	return( (double)((sLong  *)pLine)[x] );
+		case SG_DATATYPE_Float :	return( (double)((float  *)pLine)[x] );
+		case SG_DATATYPE_Double:	return( (double)((double *)pLine)[x] );
+		case SG_DATATYPE_Bit   :	return( (((BYTE *)pLine)[x / 8] & m_Bitmask[x % 8]) == 0 ? 0.0 : 1.0 );
+		default:	break;
+		}
+	}
+
+	return( 0.0 );
 }
 
 
 ///////////////////////////////////////////////////////////
 //														 //
-//			RTL - Compression: Save / Load				 //
+//					Cache: Save / Load					 //
 //														 //
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-void CSG_Grid::_Compr_LineBuffer_Save(TSG_Grid_Line *pLine) const
+void CSG_Grid::_Cache_Tile_Swap(TSG_Grid_Tile *pTile, int ny, int nBytes) const
 {
-	char	*pResult, *pNoCompress, *pCompress, *pNext;
-	int		x, ix, Threshold, nCompress, nNoCompress, nBytesTotal, Line_Pos;
-
-	if( pLine && pLine->bModified )
+	if( m_Cache_bSwap && m_Type != SG_DATATYPE_Bit )
 	{
-		pLine->bModified	= false;
-
-		if( pLine->y >= 0 && pLine->y < Get_NY() )
+		for(int iy=0; iy<ny; iy++)
 		{
-			Threshold	= 1 + (sizeof(WORD) + sizeof(bool) + Get_nValueBytes()) / Get_nValueBytes();
+			char	*pValue	= pTile->Data + iy * m_Cache_Tiles->nLineBytes;
 
-			nBytesTotal	= Line_Pos	= sizeof(nBytesTotal);
-			pResult		= (char *)SG_Malloc(nBytesTotal);
-			pNoCompress	= pLine->Data;
-			nNoCompress	= 0;
+			for(int i=0; i<nBytes; i+=Get_nValueBytes(), pValue+=Get_nValueBytes())
+			{
+				_Swap_Bytes(pValue, Get_nValueBytes());
+			}
+		}
+	}
+}
 
-			//---------------------------------------------
-			for(x=0; x<Get_NX(); )
+//---------------------------------------------------------
+void CSG_Grid::_Cache_Tile_Save(TSG_Grid_Tile *pTile) const
+{
+	if( pTile && pTile->bModified )
+	{
+		pTile->bModified	= false;
+
+		if( pTile->Index >= 0 && pTile->Index < m_Cache_Tiles->nTiles_X * m_Cache_Tiles->nTiles_Y )
+		{
+			if( m_Cache_bTemp )	// temporary files are organized tile by tile
+			{
+				m_Cache_Stream.Seek(pTile->Index * (sLong)m_Cache_Tiles->nBytes);
+				m_Cache_Stream.Write(pTile->Data, sizeof(char), m_Cache_Tiles->nBytes);
+			}
+			else				// grid files are organized row by row
 			{
-				nCompress	= 1;
-				pCompress	= pLine->Data + x * Get_nValueBytes();
-				pNext		= pCompress + Get_nValueBytes();
+				int	x0, y0, nx, ny, nBytes;	_Cache_Tile_Get_Extent(pTile->Index, x0, y0, nx, ny, nBytes);
 
-				for(ix=x+1; ix<Get_NX(); ix++, pNext+=Get_nValueBytes())
-				{
-					if( memcmp(pCompress, pNext, Get_nValueBytes()) )
-					{
-						break;
-					}
-					else
-					{
-						nCompress++;
-					}
-				}
+				_Cache_Tile_Swap(pTile, ny, nBytes);
 
-				//-----------------------------------------
-				if( nCompress <= Threshold )
-				{
-					nNoCompress++;
-					x++;
-				}
-				else
+				for(int iy=0; iy<ny; iy++)
 				{
-					nBytesTotal	+= sizeof(WORD) + sizeof(bool) + Get_nValueBytes();
+					sLong	Line_Y	= m_Cache_bFlip ? Get_NY() - 1 - (y0 + iy) : y0 + iy;
 
-					if( nNoCompress > 0 )
-					{
-						nBytesTotal	+= sizeof(WORD) + sizeof(bool) + nNoCompress * Get_nValueBytes();
-						pResult	= (char *)SG_Realloc(pResult, nBytesTotal);
-
-						*((WORD *)(pResult + Line_Pos))	= nNoCompress;
-						Line_Pos	+= sizeof(WORD);
-						*((bool *)(pResult + Line_Pos))	= false;
-						Line_Pos	+= sizeof(bool);
+					m_Cache_Stream.Seek(m_Cache_Offset + Line_Y * Get_nLineBytes() + x0);
+					m_Cache_Stream.Write(pTile->Data + iy * m_Cache_Tiles->nLineBytes, sizeof(char), nBytes);
+				}
 
-						memcpy(pResult + Line_Pos, pNoCompress, nNoCompress * Get_nValueBytes());
-						Line_Pos	+= nNoCompress * Get_nValueBytes();
+				_Cache_Tile_Swap(pTile, ny, nBytes);
+			}
 
-						nNoCompress	= 0;
-					}
-					else
-					{
-						pResult	= (char *)SG_Realloc(pResult, nBytesTotal);
-					}
+			m_Cache_Stream.Flush();
+		}
+	}
+}
 
-					*((WORD *)(pResult + Line_Pos))	= nCompress;
-					Line_Pos	+= sizeof(WORD);
-					*((bool *)(pResult + Line_Pos))	= true;
-					Line_Pos	+= sizeof(bool);
+//---------------------------------------------------------
+void CSG_Grid::_Cache_Tile_Load(TSG_Grid_Tile *pTile, int iTile) const
+{
+	if( pTile )
+	{
+		pTile->bModified	= false;
+		pTile->Index		= iTile;
 
-					memcpy(pResult + Line_Pos, pCompress, Get_nValueBytes());
-					Line_Pos	+= Get_nValueBytes();
+		if( pTile->Index >= 0 && pTile->Index < m_Cache_Tiles->nTiles_X * m_Cache_Tiles->nTiles_Y )
+		{
+			if( m_Cache_bTemp )
+			{
+				m_Cache_Stream.Seek(pTile->Index * (sLong)m_Cache_Tiles->nBytes);
 
-					pNoCompress	= pCompress + nCompress * Get_nValueBytes();
-					x			+= nCompress;
+				if( m_Cache_Stream.Read(pTile->Data, sizeof(char), m_Cache_Tiles->nBytes) < (size_t)m_Cache_Tiles->nBytes )
+				{	// not yet written, initialize with zero
+					memset(pTile->Data, 0, m_Cache_Tiles->nBytes);
 				}
 			}
+			else
+			{
+				int	x0, y0, nx, ny, nBytes;	_Cache_Tile_Get_Extent(pTile->Index, x0, y0, nx, ny, nBytes);
+
+				for(int iy=0; iy<ny; iy++)
+				{
+					sLong	Line_Y	= m_Cache_bFlip ? Get_NY() - 1 - (y0 + iy) : y0 + iy;
+
+					m_Cache_Stream.Seek(m_Cache_Offset + Line_Y * Get_nLineBytes() + x0);
+					m_Cache_Stream.Read(pTile->Data + iy * m_Cache_Tiles->nLineBytes, sizeof(char), nBytes);
+				}
+
+				_Cache_Tile_Swap(pTile, ny, nBytes);
+			}
+		}
+	}
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//				Compression: Codecs						 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+static int			gSG_Grid_Compression_Codec		= GRID_COMPRESSION_LZ;
+
+void				SG_Grid_Compression_Set_Codec(int Codec)
+{
+	if( Codec >= GRID_COMPRESSION_None && Codec <= GRID_COMPRESSION_LZ )
+	{
+		gSG_Grid_Compression_Codec	= Codec;
+	}
+}
+
+int					SG_Grid_Compression_Get_Codec(void)
+{
+	return( gSG_Grid_Compression_Codec );
+}
+
+//---------------------------------------------------------
+static bool			gSG_Grid_Compression_bPredictor	= true;
+
+void				SG_Grid_Compression_Set_Predictor(bool bOn)
+{
+	gSG_Grid_Compression_bPredictor	= bOn;
+}
+
+bool				SG_Grid_Compression_Get_Predictor(void)
+{
+	return( gSG_Grid_Compression_bPredictor );
+}
+
+//---------------------------------------------------------
+// Each compressed row starts with a header that stores the
+// row's total size in bytes, the codec and the predictor
+// flag, so that rows can be decoded independently.
+
+#define SG_COMPR_HEADER			(sizeof(int) + 2)
+
+#define SG_COMPR_BOUND(n)		(2 * (n) + 64)
+
+//---------------------------------------------------------
+/**
+  * Predictor: replaces each value by its difference to the
+  * preceding value, treating values as unsigned integers of
+  * their byte size (lossless also for floating point data),
+  * and splits the differences into byte planes (shuffle).
+  * Smooth surfaces then give long runs of identical bytes
+  * in the higher order planes.
+*/
+static void			SG_Compr_Predictor_Encode	(const BYTE *pIn, BYTE *pOut, int nValues, int nValueBytes)
+{
+	uLong	Last	= 0;
+
+	for(int i=0; i<nValues; i++, pIn+=nValueBytes)
+	{
+		uLong	Value;
+
+		switch( nValueBytes )
+		{
+		default:	Value	= *pIn;								break;
+		case 2:		Value	= *((const WORD         *)pIn);	break;
+		case 4:		Value	= *((const unsigned int *)pIn);	break;
+		case 8:		Value	= *((const uLong        *)pIn);	break;
+		}
+
+		uLong	Delta	= Value - Last;	Last	= Value;
+
+		for(int k=0; k<nValueBytes; k++, Delta>>=8)
+		{
+			pOut[k * nValues + i]	= (BYTE)(Delta & 0xFF);
+		}
+	}
+}
+
+//---------------------------------------------------------
+static void			SG_Compr_Predictor_Decode	(const BYTE *pIn, BYTE *pOut, int nValues, int nValueBytes)
+{
+	uLong	Last	= 0;
+
+	for(int i=0; i<nValues; i++, pOut+=nValueBytes)
+	{
+		uLong	Delta	= 0;
+
+		for(int k=nValueBytes-1; k>=0; k--)
+		{
+			Delta	= (Delta << 8) | pIn[k * nValues + i];
+		}
+
+		Last	+= Delta;
+
+		switch( nValueBytes )
+		{
+		default:	*pOut					= (BYTE        )Last;	break;
+		case 2:		*((WORD         *)pOut)	= (WORD        )Last;	break;
+		case 4:		*((unsigned int *)pOut)	= (unsigned int)Last;	break;
+		case 8:		*((uLong        *)pOut)	= (uLong       )Last;	break;
+		}
+	}
+}
+
+//---------------------------------------------------------
+/**
+  * Run length encoding of values with nValueBytes each. Blocks
+  * start with the number of values (WORD) and a flag telling if
+  * a single repeated value or a sequence of literal values follows.
+*/
+static int			SG_Compr_RLE_Encode		(const BYTE *pIn, int nBytes, int nValueBytes, BYTE *pOut)
+{
+	int	nValues		= nBytes / nValueBytes;
+	int	Threshold	= 1 + (int)(sizeof(WORD) + sizeof(bool) + nValueBytes) / nValueBytes;
+	int	nOut		= 0, nLiterals = 0;
+
+	const BYTE	*pLiterals	= pIn;
+
+	for(int x=0; x<=nValues; )
+	{
+		int	nRun	= 0;
+
+		if( x < nValues )
+		{
+			for(nRun=1; x+nRun<nValues && nRun<0xFFFF && !memcmp(pIn + x * nValueBytes, pIn + (x + nRun) * nValueBytes, nValueBytes); nRun++)	{}
+		}
+
+		//-------------------------------------------------
+		if( nLiterals > 0 && (x >= nValues || nRun > Threshold || nLiterals == 0xFFFF) )
+		{
+			*((WORD *)(pOut + nOut))	= (WORD)nLiterals;	nOut	+= sizeof(WORD);
+			*((bool *)(pOut + nOut))	= false;			nOut	+= sizeof(bool);
+
+			memcpy(pOut + nOut, pLiterals, nLiterals * nValueBytes);	nOut	+= nLiterals * nValueBytes;
+
+			nLiterals	= 0;
+		}
+
+		if( x >= nValues )
+		{
+			break;
+		}
+
+		//-------------------------------------------------
+		if( nRun > Threshold )
+		{
+			*((WORD *)(pOut + nOut))	= (WORD)nRun;	nOut	+= sizeof(WORD);
+			*((bool *)(pOut + nOut))	= true;			nOut	+= sizeof(bool);
+
+			memcpy(pOut + nOut, pIn + x * nValueBytes, nValueBytes);	nOut	+= nValueBytes;
+
+			x	+= nRun;
+		}
+		else
+		{
+			if( nLiterals++ == 0 )
+			{
+				pLiterals	= pIn + x * nValueBytes;
+			}
+
+			x++;
+		}
+	}
+
+	return( nOut );
+}
+
+//---------------------------------------------------------
+static void			SG_Compr_RLE_Decode		(const BYTE *pIn, BYTE *pOut, int nBytes, int nValueBytes)
+{
+	for(int n=0; n<nBytes; )
+	{
+		int		nValues		= *((const WORD *)pIn);	pIn	+= sizeof(WORD);
+		bool	bRepeated	= *((const bool *)pIn);	pIn	+= sizeof(bool);
+
+		if( bRepeated )
+		{
+			for(int i=0; i<nValues && n<nBytes; i++, n+=nValueBytes)
+			{
+				memcpy(pOut + n, pIn, nValueBytes);
+			}
+
+			pIn	+= nValueBytes;
+		}
+		else
+		{
+			memcpy(pOut + n, pIn, nValues * nValueBytes);
+
+			n	+= nValues * nValueBytes;
+			pIn	+= nValues * nValueBytes;
+		}
+	}
+}
+
+//---------------------------------------------------------
+/**
+  * Byte oriented Lempel-Ziv (LZ77) block compression with the
+  * sequence layout known from LZ4: a token with the literal and
+  * match lengths, the literals, a 16 bit match offset and length
+  * extensions. Matches are found greedily through a hash table.
+*/
+#define SG_COMPR_LZ_HASH_BITS	12
+#define SG_COMPR_LZ_MIN_MATCH	4
+
+//---------------------------------------------------------
+static inline unsigned int	SG_Compr_LZ_Read4	(const BYTE *p)
+{
+	unsigned int	v;	memcpy(&v, p, sizeof(v));	return( v );
+}
+
+//---------------------------------------------------------
+static inline int	SG_Compr_LZ_Put_Length	(BYTE *pOut, int Length)
+{
+	int	n	= 0;
+
+	for(Length-=15; Length>=255; Length-=255)
+	{
+		pOut[n++]	= 255;
+	}
+
+	pOut[n++]	= (BYTE)Length;
+
+	return( n );
+}
+
+//---------------------------------------------------------
+static int			SG_Compr_LZ_Encode		(const BYTE *pIn, int nIn, BYTE *pOut)
+{
+	int	Hash[1 << SG_COMPR_LZ_HASH_BITS];
+
+	for(int i=0; i<(1 << SG_COMPR_LZ_HASH_BITS); i++)
+	{
+		Hash[i]	= -1;
+	}
+
+	int	iIn	= 0, iLiterals = 0, nOut = 0;
+
+	//-----------------------------------------------------
+	while( iIn <= nIn - SG_COMPR_LZ_MIN_MATCH )
+	{
+		unsigned int	Sequence	= SG_Compr_LZ_Read4(pIn + iIn);
+		unsigned int	h			= (Sequence * 2654435761u) >> (32 - SG_COMPR_LZ_HASH_BITS);
+
+		int	iRef	= Hash[h];	Hash[h]	= iIn;
+
+		if( iRef < 0 || iIn - iRef > 0xFFFF || SG_Compr_LZ_Read4(pIn + iRef) != Sequence )
+		{
+			iIn++;
+
+			continue;
+		}
+
+		//-------------------------------------------------
+		int	nMatch		= SG_COMPR_LZ_MIN_MATCH;
+
+		while( iIn + nMatch < nIn && pIn[iRef + nMatch] == pIn[iIn + nMatch] )
+		{
+			nMatch++;
+		}
+
+		int	nLiterals	= iIn - iLiterals;
+		int	Token		= nOut++;
+
+		pOut[Token]	= (BYTE)(((nLiterals < 15 ? nLiterals : 15) << 4) | (nMatch - SG_COMPR_LZ_MIN_MATCH < 15 ? nMatch - SG_COMPR_LZ_MIN_MATCH : 15));
+
+		if( nLiterals >= 15 )
+		{
+			nOut	+= SG_Compr_LZ_Put_Length(pOut + nOut, nLiterals);
+		}
+
+		memcpy(pOut + nOut, pIn + iLiterals, nLiterals);	nOut	+= nLiterals;
+
+		pOut[nOut++]	= (BYTE)((iIn - iRef) & 0xFF);
+		pOut[nOut++]	= (BYTE)((iIn - iRef) >> 8);
+
+		if( nMatch - SG_COMPR_LZ_MIN_MATCH >= 15 )
+		{
+			nOut	+= SG_Compr_LZ_Put_Length(pOut + nOut, nMatch - SG_COMPR_LZ_MIN_MATCH);
+		}
+
+		iIn	= iLiterals	= iIn + nMatch;
+	}
+
+	//-----------------------------------------------------
+	int	nLiterals	= nIn - iLiterals;
+
+	pOut[nOut++]	= (BYTE)((nLiterals < 15 ? nLiterals : 15) << 4);
+
+	if( nLiterals >= 15 )
+	{
+		nOut	+= SG_Compr_LZ_Put_Length(pOut + nOut, nLiterals);
+	}
+
+	memcpy(pOut + nOut, pIn + iLiterals, nLiterals);	nOut	+= nLiterals;
+
+	return( nOut );
+}
+
+//---------------------------------------------------------
+static void			SG_Compr_LZ_Decode		(const BYTE *pIn, int nIn, BYTE *pOut, int nOut)
+{
+	const BYTE	*pEnd	= pIn + nIn;
+
+	for(int n=0; pIn<pEnd && n<nOut; )
+	{
+		int	Token		= *pIn++;
+		int	nLiterals	= Token >> 4;
+
+		if( nLiterals == 15 )
+		{
+			int	i;	do	{	nLiterals	+= (i = *pIn++);	}	while( i == 255 );
+		}
+
+		memcpy(pOut + n, pIn, nLiterals);	n	+= nLiterals;	pIn	+= nLiterals;
+
+		if( pIn >= pEnd )	// last sequence has no match
+		{
+			break;
+		}
+
+		int	Offset	= pIn[0] | (pIn[1] << 8);	pIn	+= 2;
+		int	nMatch	= Token & 0x0F;
+
+		if( nMatch == 15 )
+		{
+			int	i;	do	{	nMatch	+= (i = *pIn++);	}	while( i == 255 );
+		}
+
+		nMatch	+= SG_COMPR_LZ_MIN_MATCH;
+
+		for(BYTE *pRef=pOut+n-Offset; nMatch>0 && n<nOut; nMatch--)	// byte-wise, source and target may overlap
+		{
+			pOut[n++]	= *pRef++;
+		}
+	}
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//					RTL - Compression					 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CSG_Grid::Set_Compression(bool bOn)
+{
+	return( bOn ? _Compr_Create() : _Compr_Destroy(true) );
+}
+
+//---------------------------------------------------------
+double CSG_Grid::Get_Compression_Ratio(void) const
+{
+	if( is_Valid() && is_Compressed() )
+	{
+		sLong	nCompressed	= 0;
+
+		for(int y=0; y<Get_NY(); y++)
+		{
+			nCompressed	+= *((int *)m_Values[y]);
+		}
+
+		return( (double)nCompressed / (double)(Get_NY() * (sLong)Get_nLineBytes()) );
+	}
+
+	return( 1.0 );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//			RTL - Compression: Create / Destroy			 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CSG_Grid::_Compr_Create(void)
+{
+	TSG_Grid_Line	Line;
+
+	if( m_System.is_Valid() && m_Type != SG_DATATYPE_Undefined && m_Memory_Type == GRID_MEMORY_Normal )
+	{
+		m_Memory_bLock	= true;
+
+		Line.Data		= (char *)SG_Calloc(1, _Get_nLineBytes());
+
+		if( m_Values )	// compress loaded data...
+		{
+			void	**Values	= m_Values;
+			
+			m_Values	= (void **)SG_Calloc(Get_NY(), sizeof(void *));
+
+			for(Line.y=0; Line.y<Get_NY() && SG_UI_Process_Set_Progress(Line.y, Get_NY()); Line.y++)
+			{
+				memcpy(Line.Data, Values[Line.y], Get_nLineBytes());
+				Line.bModified	= true;
+				_Compr_LineBuffer_Save(&Line);
+			}
+
+			SG_Free(Values[0]);
+			SG_Free(Values);
+		}
+		else			// create empty grid...
+		{
+			m_Values	= (void **)SG_Calloc(Get_NY(), sizeof(void *));
+
+			for(Line.y=0; Line.y<Get_NY() && SG_UI_Process_Set_Progress(Line.y, Get_NY()); Line.y++)
+			{
+				Line.bModified	= true;
+				_Compr_LineBuffer_Save(&Line);
+			}
+		}
+
+		SG_Free(Line.Data);
+
+		_LineBuffer_Create();
+
+		m_Memory_bLock	= false;
+		m_Memory_Type	= GRID_MEMORY_Compression;
+
+		SG_UI_Process_Set_Ready();
+	}
+
+	return( is_Compressed() );
+}
+
+//---------------------------------------------------------
+bool CSG_Grid::_Compr_Destroy(bool bMemory_Restore)
+{
+	TSG_Grid_Line	Line;
+
+	if( !is_Valid() || m_Memory_Type != GRID_MEMORY_Compression )
+	{
+		return( false );
+	}
+
+	m_Memory_bLock	= true;
+
+	//-----------------------------------------------------
+	if( !bMemory_Restore )
+	{
+		_Array_Destroy();
+	}
+	else
+	{
+		_LineBuffer_Flush();
+
+		void	**vCompr	= m_Values;
+
+		m_Values	= NULL;
+
+		if( !_Array_Create() )
+		{
+			m_Values		= vCompr;
+			m_Memory_bLock	= false;
+
+			return( false );
+		}
+
+		void	**vArray	= m_Values;
+
+		m_Values	= vCompr;
+		Line.Data	= (char *)SG_Calloc(1, _Get_nLineBytes());
+
+		for(int y=0; y<Get_NY() && SG_UI_Process_Set_Progress(y, Get_NY()); y++)
+		{
+			_Compr_LineBuffer_Load(&Line, y);
+			memcpy(vArray[y], Line.Data, Get_nLineBytes());
+			SG_Free(vCompr[y]);
+		}
+
+		m_Values	= vArray;
+
+		SG_Free(vCompr);
+
+		SG_Free(Line.Data);
+
+		SG_UI_Process_Set_Ready();
+	}
+
+	//-----------------------------------------------------
+	_LineBuffer_Destroy();
+
+	m_Memory_bLock	= false;
+	m_Memory_Type	= GRID_MEMORY_Normal;
+
+	return( true );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//			RTL - Compression: Save / Load				 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+void CSG_Grid::_Compr_LineBuffer_Save(TSG_Grid_Line *pLine) const
+{
+	if( pLine && pLine->bModified )
+	{
+		pLine->bModified	= false;
+
+		if( pLine->y >= 0 && pLine->y < Get_NY() )
+		{
+			int		nBytes		= Get_nLineBytes();
+			int		nValueBytes	= m_Type == SG_DATATYPE_Bit ? 1 : Get_nValueBytes();
+			int		Codec		= gSG_Grid_Compression_Codec;
+			bool	bPredictor	= gSG_Grid_Compression_bPredictor && Codec != GRID_COMPRESSION_None && nValueBytes > 0;
+
+			BYTE	*pResult	= (BYTE *)SG_Malloc(SG_COMPR_HEADER + SG_COMPR_BOUND(nBytes) + (bPredictor ? nBytes : 0));
+			BYTE	*pData		= (BYTE *)pLine->Data;
+
+			if( bPredictor )
+			{
+				pData	= pResult + SG_COMPR_HEADER + SG_COMPR_BOUND(nBytes);
+
+				SG_Compr_Predictor_Encode((BYTE *)pLine->Data, pData, nBytes / nValueBytes, nValueBytes);
+
+				nValueBytes	= 1;
+			}
 
 			//---------------------------------------------
-			if( nNoCompress > 0 )
+			int		nResult;
+
+			switch( Codec )
 			{
-				nBytesTotal	+= sizeof(WORD) + sizeof(bool) + nNoCompress * Get_nValueBytes();
-				pResult	= (char *)SG_Realloc(pResult, nBytesTotal);
+			default:					nResult	= nBytes;	break;
+			case GRID_COMPRESSION_RLE:	nResult	= SG_Compr_RLE_Encode(pData, nBytes, nValueBytes, pResult + SG_COMPR_HEADER);	break;
+			case GRID_COMPRESSION_LZ:	nResult	= SG_Compr_LZ_Encode (pData, nBytes             , pResult + SG_COMPR_HEADER);	break;
+			}
 
-				*((WORD *)(pResult + Line_Pos))	= nNoCompress;
-				Line_Pos	+= sizeof(WORD);
-				*((bool *)(pResult + Line_Pos))	= false;
-				Line_Pos	+= sizeof(bool);
+			if( nResult >= nBytes )	// not compressible, store as it is
+			{
+				Codec		= GRID_COMPRESSION_None;
+				bPredictor	= false;
+				nResult		= nBytes;
 
-				memcpy(pResult + Line_Pos, pNoCompress, nNoCompress * Get_nValueBytes());
+				memcpy(pResult + SG_COMPR_HEADER, pLine->Data, nBytes);
 			}
 
-			//-------------------------------------------------
-			memcpy(pResult, &nBytesTotal, sizeof(nBytesTotal));
+			//---------------------------------------------
+			nResult	+= SG_COMPR_HEADER;
+
+			*((int *)pResult)			= nResult;
+			pResult[sizeof(int)    ]	= (BYTE)Codec;
+			pResult[sizeof(int) + 1]	= (BYTE)bPredictor;
 
 			if( m_Values[pLine->y] )
 			{
 				SG_Free(m_Values[pLine->y]);
 			}
 
-			m_Values[pLine->y]	= pResult;
+			m_Values[pLine->y]	= SG_Realloc(pResult, nResult);
 		}
 	}
 }
@@ -1014,11 +1592,6 @@ void CSG_Grid::_Compr_LineBuffer_Save(TSG_Grid_Line *pLine) const
 //---------------------------------------------------------
 void CSG_Grid::_Compr_LineBuffer_Load(TSG_Grid_Line *pLine, int y) const
 {
-	bool	bCompressed;
-	char	*pData, *pValue;
-	int		x, iValue;
-	WORD	nValues;
-
 	if( pLine )
 	{
 		pLine->bModified	= false;
@@ -1026,35 +1599,309 @@ void CSG_Grid::_Compr_LineBuffer_Load(TSG_Grid_Line *pLine, int y) const
 
 		if( pLine->y >= 0 && pLine->y < Get_NY() )
 		{
-			pValue		= (char *)m_Values[y] + sizeof(int);
-			pData		= pLine->Data;
+			const BYTE	*pCompr		= (const BYTE *)m_Values[y];
+
+			int		nCompr		= *((const int *)pCompr) - (int)SG_COMPR_HEADER;
+			int		Codec		= pCompr[sizeof(int)    ];
+			bool	bPredictor	= pCompr[sizeof(int) + 1] != 0;
+
+			pCompr	+= SG_COMPR_HEADER;
+
+			int		nBytes		= Get_nLineBytes();
+			int		nValueBytes	= m_Type == SG_DATATYPE_Bit ? 1 : Get_nValueBytes();
+			BYTE	*pData		= bPredictor ? (BYTE *)SG_Malloc(nBytes) : (BYTE *)pLine->Data;
+
+			//---------------------------------------------
+			switch( Codec )
+			{
+			default:					memcpy(pData, pCompr, nBytes);	break;
+			case GRID_COMPRESSION_RLE:	SG_Compr_RLE_Decode(pCompr, pData, nBytes, bPredictor ? 1 : nValueBytes);	break;
+			case GRID_COMPRESSION_LZ:	SG_Compr_LZ_Decode (pCompr, nCompr, pData, nBytes);	break;
+			}
+
+			if( bPredictor )
+			{
+				SG_Compr_Predictor_Decode(pData, (BYTE *)pLine->Data, nBytes / nValueBytes, nValueBytes);
+
+				SG_Free(pData);
+			}
+		}
+	}
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//					Memory Mapping						 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CSG_Grid::Set_Mapping(bool bOn)
+{
+	return( bOn ? _Map_Create() : _Map_Destroy(true) );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//			Memory Mapping: Create / Destroy			 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+/**
+  * Maps the data file of a native grid directly into the
+  * address space. Only possible, if the file's data type
+  * equals the grid's data type and no byte swapping is
+  * needed. If the file cannot be opened for writing, the
+  * mapping is private and modifications are not stored.
+*/
+bool CSG_Grid::_Map_Create(const SG_Char *FilePath, TSG_Data_Type File_Type, sLong Offset, bool bSwap, bool bFlip)
+{
+	if( m_System.is_Valid() && m_Type != SG_DATATYPE_Undefined && m_Memory_Type == GRID_MEMORY_Normal
+	&&  m_Type == File_Type && !bSwap && Offset >= 0 )
+	{
+		m_Cache_Path	= FilePath;
+
+		bool	bWrite	= m_Cache_Stream.Open(m_Cache_Path, SG_FILE_RWA, true);
+
+		if( bWrite || m_Cache_Stream.Open(m_Cache_Path, SG_FILE_R, true) )
+		{
+			if( m_Cache_Stream.Length() >= Offset + Get_NY() * (sLong)Get_nLineBytes() )
+			{
+				m_Memory_bLock	= true;
+
+				_Array_Destroy();
+
+				if( _Map_Open(Offset, bWrite, bFlip) )
+				{
+					m_Cache_bTemp	= false;
+					m_Cache_Offset	= Offset;
+					m_Cache_bSwap	= false;
+					m_Cache_bFlip	= bFlip;
+
+					m_Memory_Type	= GRID_MEMORY_Mapped;
+				}
+
+				m_Memory_bLock	= false;
+			}
+
+			if( !is_Mapped() )
+			{
+				m_Cache_Stream.Close();
+			}
+		}
+	}
+
+	return( is_Mapped() );
+}
+
+//---------------------------------------------------------
+bool CSG_Grid::_Map_Create(void)
+{
+	if( m_System.is_Valid() && m_Type != SG_DATATYPE_Undefined && m_Memory_Type == GRID_MEMORY_Normal )
+	{
+		m_Cache_Path	= SG_File_Get_Name_Temp(SG_T("sg_grd"), SG_Grid_Cache_Get_Directory());
+
+		if( m_Cache_Stream.Open(m_Cache_Path, SG_FILE_RW, true) )
+		{
+			sLong	nBytes	= Get_NY() * (sLong)Get_nLineBytes();
+			char	Zero	= 0;
 
-			for(x=0; x<Get_NX(); )
+			if( m_Cache_Stream.Seek(nBytes - 1) && m_Cache_Stream.Write(&Zero, sizeof(char)) == 1 && m_Cache_Stream.Flush() )
 			{
-				nValues		= *((WORD *)pValue);
-				pValue		+= sizeof(WORD);
-				bCompressed	= *((bool *)pValue);
-				pValue		+= sizeof(bool);
+				m_Memory_bLock	= true;
+
+				void	**Values	= m_Values;	m_Values	= NULL;
 
-				if( bCompressed )
+				if( _Map_Open(0, true, false) )
 				{
-					for(iValue=0; iValue<nValues && x<Get_NX(); iValue++, x++, pData+=Get_nValueBytes())
+					m_Cache_bTemp	= true;
+					m_Cache_Offset	= 0;
+					m_Cache_bSwap	= false;
+					m_Cache_bFlip	= false;
+
+					if( Values )
 					{
-						memcpy(pData, pValue, Get_nValueBytes());
+						for(int y=0; y<Get_NY() && SG_UI_Process_Set_Progress(y, Get_NY()); y++)
+						{
+							memcpy(m_Values[y], Values[y], Get_nLineBytes());
+						}
+
+						SG_Free(Values[0]);
+						SG_Free(Values);
+
+						SG_UI_Process_Set_Ready();
 					}
 
-					pValue	+= Get_nValueBytes();
+					m_Memory_Type	= GRID_MEMORY_Mapped;
 				}
 				else
 				{
-					memcpy(pData, pValue, Get_nValueBytes() * nValues);
-					x		+= nValues;
-					pData	+= Get_nValueBytes() * nValues;
-					pValue	+= Get_nValueBytes() * nValues;
+					m_Values	= Values;
 				}
+
+				m_Memory_bLock	= false;
 			}
+
+			if( !is_Mapped() )
+			{
+				m_Cache_Stream.Close();
+
+				SG_File_Delete(m_Cache_Path);
+			}
+		}
+	}
+
+	return( is_Mapped() );
+}
+
+//---------------------------------------------------------
+bool CSG_Grid::_Map_Destroy(bool bMemory_Restore)
+{
+	if( !is_Valid() || m_Memory_Type != GRID_MEMORY_Mapped )
+	{
+		return( false );
+	}
+
+	m_Memory_bLock	= true;
+
+	//-----------------------------------------------------
+	if( bMemory_Restore )
+	{
+		void	**vMapped	= m_Values;
+
+		m_Values	= NULL;
+
+		if( !_Array_Create() )
+		{
+			m_Values		= vMapped;
+			m_Memory_bLock	= false;
+
+			return( false );
+		}
+
+		for(int y=0; y<Get_NY() && SG_UI_Process_Set_Progress(y, Get_NY()); y++)
+		{
+			memcpy(m_Values[y], vMapped[y], Get_nLineBytes());
 		}
+
+		void	**vArray	= m_Values;
+
+		m_Values	= vMapped;
+
+		_Map_Close();
+
+		m_Values	= vArray;
+
+		SG_UI_Process_Set_Ready();
+	}
+	else
+	{
+		_Map_Close();
+	}
+
+	//-----------------------------------------------------
+	m_Cache_Stream.Close();
+
+	if( m_Cache_bTemp )
+	{
+		SG_File_Delete(m_Cache_Path);
+	}
+
+	m_Memory_bLock	= false;
+	m_Memory_Type	= GRID_MEMORY_Normal;
+
+	return( true );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//			Memory Mapping: Open / Close				 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CSG_Grid::_Map_Open(sLong Offset, bool bWrite, bool bFlip)
+{
+	if( !m_Cache_Stream.is_Open() || m_Map_Data )
+	{
+		return( false );
+	}
+
+	sLong	nLineBytes	= Get_nLineBytes();
+
+	m_Map_Size	= Offset + Get_NY() * nLineBytes;
+
+	//-----------------------------------------------------
+#ifdef _SAGA_LINUX
+	void	*pData	= mmap(NULL, (size_t)m_Map_Size, PROT_READ|PROT_WRITE, bWrite ? MAP_SHARED : MAP_PRIVATE, fileno(m_Cache_Stream.Get_Stream()), 0);
+
+	if( pData == MAP_FAILED )
+	{
+		return( false );
+	}
+#else
+	HANDLE	hFile	= (HANDLE)_get_osfhandle(_fileno(m_Cache_Stream.Get_Stream()));
+	HANDLE	hMap	= CreateFileMapping(hFile, NULL, bWrite ? PAGE_READWRITE : PAGE_WRITECOPY, (DWORD)(m_Map_Size >> 32), (DWORD)(m_Map_Size & 0xFFFFFFFF), NULL);
+
+	if( hMap == NULL )
+	{
+		return( false );
+	}
+
+	void	*pData	= MapViewOfFile(hMap, bWrite ? FILE_MAP_WRITE : FILE_MAP_COPY, 0, 0, (SIZE_T)m_Map_Size);
+
+	if( pData == NULL )
+	{
+		CloseHandle(hMap);
+
+		return( false );
+	}
+
+	m_Map_Handle	= hMap;
+#endif
+
+	m_Map_Data	= pData;
+
+	//-----------------------------------------------------
+	// the row pointers refer to the mapped file, so that
+	// the grid's normal array access applies without copying
+
+	m_Values	= (void **)SG_Malloc(Get_NY() * sizeof(void *));
+
+	char	*pLine	= (char *)m_Map_Data + Offset;
+
+	for(int y=0; y<Get_NY(); y++, pLine+=nLineBytes)
+	{
+		m_Values[bFlip ? Get_NY() - 1 - y : y]	= pLine;
+	}
+
+	return( true );
+}
+
+//---------------------------------------------------------
+void CSG_Grid::_Map_Close(void)
+{
+	if( m_Map_Data )
+	{
+#ifdef _SAGA_LINUX
+		munmap(m_Map_Data, (size_t)m_Map_Size);
+#else
+		UnmapViewOfFile(m_Map_Data);
+
+		CloseHandle((HANDLE)m_Map_Handle);
+
+		m_Map_Handle	= NULL;
+#endif
+
+		m_Map_Data	= NULL;
+		m_Map_Size	= 0;
 	}
+
+	SG_FREE_SAFE(m_Values);
 }
 
 
@@ -85,7 +85,7 @@ bool CSG_Grid::Assign(double Value)
 {
 	if( is_Valid() )
 	{
-		if( Value == 0.0 && m_Memory_Type == GRID_MEMORY_Normal )
+		if( Value == 0.0 && _is_Array() )
 		{
 			for(int n=0, m=_Get_nLineBytes(); n<Get_NY(); n++)
 			{
@@ -107,6 +107,8 @@ bool CSG_Grid::Assign(double Value)
 		//-------------------------------------------------
 		m_zStats.Invalidate();
 
+		m_zStats_bBlocks	= false;
+
 		Set_Update_Flag(false);
 
 		return( true );
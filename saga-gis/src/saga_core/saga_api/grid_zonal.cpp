@@ -0,0 +1,587 @@
+/**********************************************************
+ * Version $Id$
+ *********************************************************/
+
+///////////////////////////////////////////////////////////
+//                                                       //
+//                         SAGA                          //
+//                                                       //
+//      System for Automated Geoscientific Analyses      //
+//                                                       //
+//           Application Programming Interface           //
+//                                                       //
+//                  Library: SAGA_API                    //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//                     grid_zonal.cpp                    //
+//                                                       //
+//                 Copyright (C) 2015 by                 //
+//                      Olaf Conrad                      //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+// This file is part of 'SAGA - System for Automated     //
+// Geoscientific Analyses'.                              //
+//                                                       //
+// This library is free software; you can redistribute   //
+// it and/or modify it under the terms of the GNU Lesser //
+// General Public License as published by the Free       //
+// Software Foundation, version 2.1 of the License.      //
+//                                                       //
+// This library is distributed in the hope that it will  //
+// be useful, but WITHOUT ANY WARRANTY; without even the //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A  //
+// PARTICULAR PURPOSE. See the GNU Lesser General Public //
+// License for more details.                             //
+//                                                       //
+// You should have received a copy of the GNU Lesser     //
+// General Public License along with this program; if    //
+// not, write to the Free Software Foundation, Inc.,     //
+// 51 Franklin Street, 5th Floor, Boston, MA 02110-1301, //
+// USA.                                                  //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//    e-mail:     oconrad@saga-gis.org                   //
+//                                                       //
+//    contact:    Olaf Conrad                            //
+//                Institute of Geography                 //
+//                University of Hamburg                  //
+//                Germany                                //
+//                                                       //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+#include "grid.h"
+
+#include <algorithm>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// Zones of one thread: packed keys, cell counts, statistics
+// (contiguous, indexed by zone * number of values + value)
+// and an open addressing (linear probing) hash table, which
+// maps packed keys to zone indices.
+
+class CSG_Zonal_Table
+{
+public:
+	CSG_Zonal_Table(int nWords, const std::vector<bool> &bHold) : m_nWords(nWords), m_nValues((int)bHold.size()), m_bHold(bHold)
+	{
+		m_Slots.assign(1024, -1);
+
+		m_Key.assign(nWords, 0);
+	}
+
+	//-----------------------------------------------------
+	sLong					Get_Count		(void)	const	{	return( (sLong)m_Cells.size() );	}
+
+	uLong *					Get_Key			(void)			{	return( &m_Key[0] );	}
+	const uLong *			Get_Key			(sLong i) const	{	return( &m_Keys[(size_t)i * m_nWords] );	}
+
+	//-----------------------------------------------------
+	/** Returns the zone with the packed key Key, adds it if not found. */
+	sLong					Get_Zone		(const uLong *Key)
+	{
+		size_t	Mask	= m_Slots.size() - 1, i = _Get_Hash(Key) & Mask;
+
+		for(sLong iZone; (iZone = m_Slots[i]) >= 0; i = (i + 1) & Mask)
+		{
+			if( std::equal(Key, Key + m_nWords, Get_Key(iZone)) )
+			{
+				return( iZone );
+			}
+		}
+
+		//-------------------------------------------------
+		sLong	iZone	= Get_Count();
+
+		m_Keys .insert(m_Keys.end(), Key, Key + m_nWords);
+		m_Cells.push_back(0);
+		m_Sin  .resize(m_Sin.size() + m_nValues, 0.0);
+		m_Cos  .resize(m_Cos.size() + m_nValues, 0.0);
+
+		for(int iValue=0; iValue<m_nValues; iValue++)
+		{
+			m_Stats.push_back(CSG_Simple_Statistics(m_bHold[iValue]));
+		}
+
+		m_Slots[i]	= iZone;
+
+		if( 2 * (size_t)Get_Count() > m_Slots.size() )
+		{
+			_Rehash();
+		}
+
+		return( iZone );
+	}
+
+	//-----------------------------------------------------
+	sLong &					Get_Cells		(sLong iZone)				{	return( m_Cells[(size_t)iZone] );	}
+	CSG_Simple_Statistics &	Get_Stats		(sLong iZone, int iValue)	{	return( m_Stats[(size_t)iZone * m_nValues + iValue] );	}
+	double &				Get_Sin			(sLong iZone, int iValue)	{	return( m_Sin[(size_t)iZone * m_nValues + iValue] );	}
+	double &				Get_Cos			(sLong iZone, int iValue)	{	return( m_Cos[(size_t)iZone * m_nValues + iValue] );	}
+
+	//-----------------------------------------------------
+	/** Adds zone j of table Table to zone i of this table. */
+	void					Merge			(sLong i, CSG_Zonal_Table &Table, sLong j)
+	{
+		Get_Cells(i)	+= Table.Get_Cells(j);
+
+		for(int iValue=0; iValue<m_nValues; iValue++)
+		{
+			Get_Stats(i, iValue)	+= Table.Get_Stats(j, iValue);
+			Get_Sin  (i, iValue)	+= Table.Get_Sin  (j, iValue);
+			Get_Cos  (i, iValue)	+= Table.Get_Cos  (j, iValue);
+		}
+	}
+
+	//-----------------------------------------------------
+	std::vector<sLong>		m_Order;
+
+
+private:
+
+	int						m_nWords, m_nValues;
+
+	std::vector<bool>		m_bHold;
+
+	std::vector<sLong>		m_Slots, m_Cells;
+
+	std::vector<uLong>		m_Keys, m_Key;
+
+	std::vector<double>		m_Sin, m_Cos;
+
+	std::vector<CSG_Simple_Statistics>	m_Stats;
+
+
+	//-----------------------------------------------------
+	size_t					_Get_Hash		(const uLong *Key)	const
+	{
+		uLong	h	= 0x9E3779B97F4A7C15ULL;
+
+		for(int i=0; i<m_nWords; i++)	// splitmix64 finaliser
+		{
+			uLong	z	= (h ^ Key[i]) + 0x9E3779B97F4A7C15ULL;
+
+			z	= (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z	= (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			h	=  z ^ (z >> 31);
+		}
+
+		return( (size_t)h );
+	}
+
+	//-----------------------------------------------------
+	void					_Rehash			(void)
+	{
+		m_Slots.assign(2 * m_Slots.size(), -1);
+
+		size_t	Mask	= m_Slots.size() - 1;
+
+		for(sLong iZone=0; iZone<Get_Count(); iZone++)
+		{
+			size_t	i	= _Get_Hash(Get_Key(iZone)) & Mask;
+
+			while( m_Slots[i] >= 0 )
+			{
+				i	= (i + 1) & Mask;
+			}
+
+			m_Slots[i]	= iZone;
+		}
+	}
+
+};
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+CSG_Zonal_Statistics::CSG_Zonal_Statistics(void)
+{
+	m_nKeys		= 0;	m_Keys		= NULL;
+	m_nValues	= 0;	m_Values	= NULL;
+	m_nWords	= 0;
+
+	m_pZones	= NULL;
+}
+
+//---------------------------------------------------------
+CSG_Zonal_Statistics::~CSG_Zonal_Statistics(void)
+{
+	Destroy();
+}
+
+//---------------------------------------------------------
+void CSG_Zonal_Statistics::Destroy(void)
+{
+	if( m_pZones )
+	{
+		delete(m_pZones);
+
+		m_pZones	= NULL;
+	}
+
+	SG_FREE_SAFE(m_Keys  );	m_nKeys		= 0;
+	SG_FREE_SAFE(m_Values);	m_nValues	= 0;
+
+	m_nWords	= 0;
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CSG_Zonal_Statistics::Add_Key(CSG_Grid *pGrid, bool bNoData)
+{
+	if( !pGrid || !pGrid->is_Valid() || (m_nKeys > 0 && !pGrid->is_Compatible(m_Keys[0].pGrid)) )
+	{
+		return( false );
+	}
+
+	m_Keys	= (TKey *)SG_Realloc(m_Keys, (m_nKeys + 1) * sizeof(TKey));
+
+	m_Keys[m_nKeys].pGrid	= pGrid;
+	m_Keys[m_nKeys].bNoData	= bNoData;
+
+	m_nKeys++;
+
+	return( true );
+}
+
+//---------------------------------------------------------
+bool CSG_Zonal_Statistics::Add_Value(CSG_Grid *pGrid, bool bQuantiles, int nClasses, bool bDirection)
+{
+	if( !pGrid || !pGrid->is_Valid() || m_nKeys < 1 || !pGrid->is_Compatible(m_Keys[0].pGrid) )
+	{
+		return( false );
+	}
+
+	m_Values	= (TValue *)SG_Realloc(m_Values, (m_nValues + 1) * sizeof(TValue));
+
+	m_Values[m_nValues].pGrid		= pGrid;
+	m_Values[m_nValues].bQuantiles	= bQuantiles;
+	m_Values[m_nValues].nClasses	= bQuantiles && nClasses > 0 ? nClasses : 0;
+	m_Values[m_nValues].bDirection	= bDirection;
+
+	m_nValues++;
+
+	return( true );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// Each key gets as many bits as needed for the range of its
+// values. Keys are packed into 64 bit words, a key does not
+// span two words.
+
+bool CSG_Zonal_Statistics::_Set_Key_Layout(void)
+{
+	m_nWords	= 1;
+
+	for(int iKey=0, Free=64; iKey<m_nKeys; iKey++)
+	{
+		TKey	&Key	= m_Keys[iKey];
+
+		double	Min	= floor(Key.pGrid->Get_ZMin()) - 1.0;
+		double	Max	= ceil (Key.pGrid->Get_ZMax()) + 1.0;
+
+		if( Key.bNoData )
+		{
+			Min	= M_GET_MIN(Min, Key.pGrid->Get_NoData_Value());
+			Max	= M_GET_MAX(Max, Key.pGrid->Get_NoData_Value());
+		}
+
+		Min	= M_GET_MAX(Min, (double)-2147483647 - 1.0);
+		Max	= M_GET_MIN(Max, (double) 2147483647);
+
+		if( Min > Max )	// no data
+		{
+			Min	= Max	= 0.0;
+		}
+
+		Key.Offset	= (int)Min;
+
+		for(Key.Bits=0; Key.Bits<33 && ldexp(1.0, Key.Bits) <= Max - Min; Key.Bits++)	{}
+
+		if( Key.Bits > Free || Free <= 0 )
+		{
+			m_nWords++;	Free	= 64;
+		}
+
+		Key.Word	= m_nWords - 1;
+		Key.Shift	= 64 - Free;
+
+		Free	-= Key.Bits;
+	}
+
+	return( true );
+}
+
+//---------------------------------------------------------
+struct SSG_Zonal_Key_Less
+{
+	const std::vector<int>	*Keys;	int	nKeys;
+
+	bool operator () (sLong a, sLong b) const
+	{
+		return( std::lexicographical_compare(
+			Keys->begin() + a * nKeys, Keys->begin() + (a + 1) * nKeys,
+			Keys->begin() + b * nKeys, Keys->begin() + (b + 1) * nKeys
+		));
+	}
+};
+
+//---------------------------------------------------------
+bool CSG_Zonal_Statistics::Execute(void)
+{
+	if( m_nKeys < 1 )
+	{
+		return( false );
+	}
+
+	if( m_pZones )
+	{
+		delete(m_pZones);	m_pZones	= NULL;
+	}
+
+	_Set_Key_Layout();
+
+	//-----------------------------------------------------
+	bool	bParallel	= true;
+
+	for(int iKey=0; iKey<m_nKeys; iKey++)
+	{
+		bParallel	= bParallel && !m_Keys[iKey].pGrid->is_Cached() && !m_Keys[iKey].pGrid->is_Compressed();
+	}
+
+	std::vector<bool>	bHold(m_nValues);	// exact quantiles need all values
+
+	for(int iValue=0; iValue<m_nValues; iValue++)
+	{
+		TValue	&v	= m_Values[iValue];
+
+		bParallel	= bParallel && !v.pGrid->is_Cached() && !v.pGrid->is_Compressed();
+
+		bHold[iValue]	= v.bQuantiles && v.nClasses <= 0;
+
+		v.Min	= v.pGrid->Get_ZMin();	// statistics are updated now, not within the parallel loop
+		v.Max	= v.pGrid->Get_ZMax();
+	}
+
+#ifdef _OPENMP
+	int	nThreads	= bParallel ? SG_Get_Max_Num_Threads_Omp() : 1;
+#else
+	int	nThreads	= 1;
+#endif
+
+	std::vector<CSG_Zonal_Table *>	Tables(nThreads);
+
+	for(int i=0; i<nThreads; i++)
+	{
+		Tables[i]	= new CSG_Zonal_Table(m_nWords, bHold);
+	}
+
+	//-----------------------------------------------------
+	CSG_Grid	*pGrid	= m_Keys[0].pGrid;
+
+	bool	bOkay	= true;
+
+	for(int y=0; y<pGrid->Get_NY() && (bOkay = SG_UI_Process_Set_Progress(y, pGrid->Get_NY())); y++)
+	{
+		#pragma omp parallel for if(bParallel)
+		for(int x=0; x<pGrid->Get_NX(); x++)
+		{
+		#ifdef _OPENMP
+			CSG_Zonal_Table	&Table	= *Tables[bParallel ? omp_get_thread_num() : 0];
+		#else
+			CSG_Zonal_Table	&Table	= *Tables[0];
+		#endif
+
+			uLong	*Key	= Table.Get_Key();	std::fill(Key, Key + m_nWords, (uLong)0);
+
+			bool	bSkip	= false;
+
+			for(int iKey=0; !bSkip && iKey<m_nKeys; iKey++)
+			{
+				const TKey	&k	= m_Keys[iKey];
+
+				bool	bNoData	= k.pGrid->is_NoData(x, y);
+
+				if( (bSkip = bNoData && !k.bNoData) == false )
+				{
+					double	z	= bNoData ? k.pGrid->Get_NoData_Value() : k.pGrid->asInt(x, y);
+
+					z	= M_GET_MIN(M_GET_MAX(z, (double)k.Offset), 2147483647.0);
+
+					Key[k.Word]	|= (uLong)(SG_ROUND_TO_SLONG(z) - k.Offset) << k.Shift;
+				}
+			}
+
+			if( bSkip )
+			{
+				continue;
+			}
+
+			//---------------------------------------------
+			sLong	iZone	= Table.Get_Zone(Key);
+
+			Table.Get_Cells(iZone)++;
+
+			for(int iValue=0; iValue<m_nValues; iValue++)
+			{
+				CSG_Grid	*pValue	= m_Values[iValue].pGrid;
+
+				if( !pValue->is_NoData(x, y) )
+				{
+					double	z	= pValue->asDouble(x, y);
+
+					CSG_Simple_Statistics	&s	= Table.Get_Stats(iZone, iValue);
+
+					if( s.Get_Count() == 0 && m_Values[iValue].nClasses > 0 && s.Get_Histogram_Count() == 0 )
+					{
+						s.Set_Histogram(m_Values[iValue].nClasses, m_Values[iValue].Min, m_Values[iValue].Max);
+					}
+
+					s	+= z;
+
+					if( m_Values[iValue].bDirection )
+					{
+						Table.Get_Sin(iZone, iValue)	+= sin(z);
+						Table.Get_Cos(iZone, iValue)	+= cos(z);
+					}
+				}
+			}
+		}
+	}
+
+	//-----------------------------------------------------
+	for(int i=1; i<nThreads; i++)	// merge into the first table
+	{
+		if( bOkay )
+		{
+			for(sLong iZone=0; iZone<Tables[i]->Get_Count(); iZone++)
+			{
+				Tables[0]->Merge(Tables[0]->Get_Zone(Tables[i]->Get_Key(iZone)), *Tables[i], iZone);
+			}
+		}
+
+		delete(Tables[i]);
+	}
+
+	m_pZones	= Tables[0];
+
+	if( !bOkay )
+	{
+		Destroy();
+
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	std::vector<int>	Keys((size_t)m_pZones->Get_Count() * m_nKeys);
+
+	m_pZones->m_Order.resize((size_t)m_pZones->Get_Count());
+
+	for(sLong iZone=0; iZone<m_pZones->Get_Count(); iZone++)
+	{
+		m_pZones->m_Order[(size_t)iZone]	= iZone;
+
+		for(int iKey=0; iKey<m_nKeys; iKey++)
+		{
+			Keys[(size_t)iZone * m_nKeys + iKey]	= Get_Key(iZone, iKey);	// order not yet set, so index is the zone
+		}
+	}
+
+	SSG_Zonal_Key_Less	Less;	Less.Keys	= &Keys;	Less.nKeys	= m_nKeys;
+
+	std::sort(m_pZones->m_Order.begin(), m_pZones->m_Order.end(), Less);
+
+	return( true );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+#define GET_ZONE(i)	(m_pZones->m_Order.size() == (size_t)m_pZones->Get_Count() ? m_pZones->m_Order[(size_t)(i)] : (i))
+
+//---------------------------------------------------------
+sLong CSG_Zonal_Statistics::Get_Count(void) const
+{
+	return( m_pZones ? m_pZones->Get_Count() : 0 );
+}
+
+//---------------------------------------------------------
+int CSG_Zonal_Statistics::Get_Key(sLong iZone, int iKey) const
+{
+	const TKey	&k	= m_Keys[iKey];
+
+	uLong	Mask	= k.Bits >= 64 ? ~(uLong)0 : (((uLong)1 << k.Bits) - 1);
+
+	return( (int)(k.Offset + (sLong)((m_pZones->Get_Key(GET_ZONE(iZone))[k.Word] >> k.Shift) & Mask)) );
+}
+
+//---------------------------------------------------------
+sLong CSG_Zonal_Statistics::Get_Cells(sLong iZone) const
+{
+	return( m_pZones->Get_Cells(GET_ZONE(iZone)) );
+}
+
+//---------------------------------------------------------
+CSG_Simple_Statistics & CSG_Zonal_Statistics::Get_Statistics(sLong iZone, int iValue)
+{
+	return( m_pZones->Get_Stats(GET_ZONE(iZone), iValue) );
+}
+
+//---------------------------------------------------------
+/** Mean direction (radians, 0 to 2 Pi) of the values of a grid added as direction. */
+double CSG_Zonal_Statistics::Get_Direction(sLong iZone, int iValue) const
+{
+	double	d	= atan2(m_pZones->Get_Sin(GET_ZONE(iZone), iValue), m_pZones->Get_Cos(GET_ZONE(iZone), iValue));
+
+	return( d < 0.0 ? d + M_PI_360 : d );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
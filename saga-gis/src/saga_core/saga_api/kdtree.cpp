@@ -0,0 +1,690 @@
+/**********************************************************
+ * Version $Id$
+ *********************************************************/
+
+///////////////////////////////////////////////////////////
+//                                                       //
+//                         SAGA                          //
+//                                                       //
+//      System for Automated Geoscientific Analyses      //
+//                                                       //
+//           Application Programming Interface           //
+//                                                       //
+//                  Library: SAGA_API                    //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//                      kdtree.cpp                       //
+//                                                       //
+//                 Copyright (C) 2015 by                 //
+//                      Olaf Conrad                      //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+// This file is part of 'SAGA - System for Automated     //
+// Geoscientific Analyses'.                              //
+//                                                       //
+// This library is free software; you can redistribute   //
+// it and/or modify it under the terms of the GNU Lesser //
+// General Public License as published by the Free       //
+// Software Foundation, version 2.1 of the License.      //
+//                                                       //
+// This library is distributed in the hope that it will  //
+// be useful, but WITHOUT ANY WARRANTY; without even the //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A  //
+// PARTICULAR PURPOSE. See the GNU Lesser General Public //
+// License for more details.                             //
+//                                                       //
+// You should have received a copy of the GNU Lesser     //
+// General Public License along with this program; if    //
+// not, write to the Free Software Foundation, Inc.,     //
+// 51 Franklin Street, 5th Floor, Boston, MA 02110-1301, //
+// USA.                                                  //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//    e-mail:     oconrad@saga-gis.org                   //
+//                                                       //
+//    contact:    Olaf Conrad                            //
+//                Institute of Geography                 //
+//                University of Hamburg                  //
+//                Germany                                //
+//                                                       //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+#include "shapes.h"
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// The k-d tree is stored implicitly in a single point array.
+// The median of the range [iFirst, iLast) is the splitting
+// point of a node, its children are the ranges left and right
+// of it. Ranges with no more than KDTREE_BUCKET points are
+// not split any further.
+//---------------------------------------------------------
+#define KDTREE_BUCKET	8
+
+#define KDTREE_MEDIAN(iFirst, iLast)	((iFirst) + ((iLast) - (iFirst)) / 2)
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+CSG_KDTree::CSG_KDTree(void)
+{
+	m_nPoints	= 0;
+	m_Points	= NULL;
+	m_Axis		= NULL;
+}
+
+//---------------------------------------------------------
+CSG_KDTree::CSG_KDTree(CSG_Shapes *pShapes, int Attribute)
+{
+	m_nPoints	= 0;
+	m_Points	= NULL;
+	m_Axis		= NULL;
+
+	Create(pShapes, Attribute);
+}
+
+//---------------------------------------------------------
+CSG_KDTree::~CSG_KDTree(void)
+{
+	Destroy();
+}
+
+//---------------------------------------------------------
+void CSG_KDTree::Destroy(void)
+{
+	SG_FREE_SAFE(m_Points);
+	SG_FREE_SAFE(m_Axis);
+
+	m_nPoints	= 0;
+
+	m_Selection.Destroy();
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+static int SG_KDTree_Compare_Position(const void *a, const void *b)
+{
+	const double	*A	= (const double *)a, *B = (const double *)b;	// x, y, z
+
+	return( A[0] < B[0] ? -1 : A[0] > B[0] ? 1 : A[1] < B[1] ? -1 : A[1] > B[1] ? 1 : 0 );
+}
+
+//---------------------------------------------------------
+/**
+  * Builds the tree from all points of pShapes. The z value of a
+  * point is taken from Attribute or, if Attribute is negative,
+  * is the shape's index. Like with CSG_PRQuadTree, coincident
+  * points are merged into one point with the mean z value.
+*/
+bool CSG_KDTree::Create(CSG_Shapes *pShapes, int Attribute)
+{
+	Destroy();
+
+	if( !pShapes || !pShapes->is_Valid() )
+	{
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	int		iShape, nPoints	= 0;
+
+	for(iShape=0; iShape<pShapes->Get_Count(); iShape++)
+	{
+		CSG_Shape	*pShape	= pShapes->Get_Shape(iShape);
+
+		if( Attribute < 0 || !pShape->is_NoData(Attribute) )
+		{
+			nPoints	+= pShape->Get_Point_Count();
+		}
+	}
+
+	if( nPoints < 1 || (m_Points = (TPoint *)SG_Malloc(nPoints * sizeof(TPoint))) == NULL )
+	{
+		return( false );
+	}
+
+	for(iShape=0; iShape<pShapes->Get_Count(); iShape++)
+	{
+		CSG_Shape	*pShape	= pShapes->Get_Shape(iShape);
+
+		if( Attribute < 0 || !pShape->is_NoData(Attribute) )
+		{
+			double	z	= Attribute < 0 ? iShape : pShape->asDouble(Attribute);
+
+			for(int iPart=0; iPart<pShape->Get_Part_Count(); iPart++)
+			{
+				for(int iPoint=0; iPoint<pShape->Get_Point_Count(iPart); iPoint++, m_nPoints++)
+				{
+					m_Points[m_nPoints].x	= pShape->Get_Point(iPoint, iPart).x;
+					m_Points[m_nPoints].y	= pShape->Get_Point(iPoint, iPart).y;
+					m_Points[m_nPoints].z	= z;
+				}
+			}
+		}
+	}
+
+	//-----------------------------------------------------
+	qsort(m_Points, m_nPoints, sizeof(TPoint), SG_KDTree_Compare_Position);
+
+	int		i, j, n;
+
+	for(i=0, j=0; i<m_nPoints; j++)	// merge coincident points
+	{
+		double	z	= m_Points[i].z;
+
+		for(n=1; i+n<m_nPoints && !SG_KDTree_Compare_Position(m_Points + i, m_Points + i + n); n++)
+		{
+			z	+= m_Points[i + n].z;
+		}
+
+		m_Points[j]		= m_Points[i];
+		m_Points[j].z	= z / n;
+
+		i	+= n;
+	}
+
+	m_nPoints	= j;
+	m_Points	= (TPoint *)SG_Realloc(m_Points, m_nPoints * sizeof(TPoint));
+
+	//-----------------------------------------------------
+	if( (m_Axis = (BYTE *)SG_Calloc(m_nPoints, sizeof(BYTE))) == NULL )
+	{
+		Destroy();
+
+		return( false );
+	}
+
+	m_Extent.xMin	= m_Extent.xMax	= m_Points[0].x;	// sorted by x
+	m_Extent.xMax	= m_Points[m_nPoints - 1].x;
+	m_Extent.yMin	= m_Extent.yMax	= m_Points[0].y;
+
+	for(i=1; i<m_nPoints; i++)
+	{
+		if( m_Extent.yMin > m_Points[i].y )	m_Extent.yMin	= m_Points[i].y;	else
+		if( m_Extent.yMax < m_Points[i].y )	m_Extent.yMax	= m_Points[i].y;
+	}
+
+	_Build(0, m_nPoints, m_Extent);
+
+	return( true );
+}
+
+//---------------------------------------------------------
+void CSG_KDTree::_Build(int iFirst, int iLast, TSG_Rect Extent)
+{
+	if( iLast - iFirst <= KDTREE_BUCKET )
+	{
+		return;
+	}
+
+	//-----------------------------------------------------
+	int		Axis	= Extent.xMax - Extent.xMin >= Extent.yMax - Extent.yMin ? 0 : 1;
+	int		iMedian	= KDTREE_MEDIAN(iFirst, iLast);
+
+	_Select_Median(iFirst, iLast - 1, iMedian, Axis);
+
+	m_Axis[iMedian]	= (BYTE)Axis;
+
+	double	Split	= Axis == 0 ? m_Points[iMedian].x : m_Points[iMedian].y;
+
+	//-----------------------------------------------------
+	TSG_Rect	Left = Extent, Right = Extent;
+
+	if( Axis == 0 )	{	Left.xMax	= Right.xMin	= Split;	}
+	else			{	Left.yMax	= Right.yMin	= Split;	}
+
+	if( iLast - iFirst > 65536 )	// parallel sub-tree construction for large ranges
+	{
+		#pragma omp parallel sections
+		{
+			#pragma omp section
+			_Build(iFirst, iMedian, Left);
+
+			#pragma omp section
+			_Build(iMedian + 1, iLast, Right);
+		}
+	}
+	else
+	{
+		_Build(iFirst     , iMedian, Left );
+		_Build(iMedian + 1, iLast  , Right);
+	}
+}
+
+//---------------------------------------------------------
+// Partial sort (quick select) of [l, r], so that the point at
+// position k has the k-th smallest coordinate on Axis with no
+// larger coordinates left of and no smaller right of it.
+//---------------------------------------------------------
+void CSG_KDTree::_Select_Median(int l, int r, int k, int Axis)
+{
+	#define KDTREE_VALUE(i)	(Axis == 0 ? m_Points[i].x : m_Points[i].y)
+	#define KDTREE_SWAP(a, b)	{	TPoint p = m_Points[a]; m_Points[a] = m_Points[b]; m_Points[b] = p;	}
+
+	while( r > l )
+	{
+		int		m	= l + (r - l) / 2;	// median of three pivot
+
+		if( KDTREE_VALUE(m) < KDTREE_VALUE(l) )	KDTREE_SWAP(m, l);
+		if( KDTREE_VALUE(r) < KDTREE_VALUE(l) )	KDTREE_SWAP(r, l);
+		if( KDTREE_VALUE(r) < KDTREE_VALUE(m) )	KDTREE_SWAP(r, m);
+
+		double	Pivot	= KDTREE_VALUE(m);
+
+		int		i	= l, j = r;
+
+		while( i <= j )
+		{
+			while( KDTREE_VALUE(i) < Pivot )	i++;
+			while( KDTREE_VALUE(j) > Pivot )	j--;
+
+			if( i <= j )
+			{
+				KDTREE_SWAP(i, j);
+
+				i++;	j--;
+			}
+		}
+
+		if( k <= j )
+		{
+			r	= j;
+		}
+		else if( k >= i )
+		{
+			l	= i;
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	#undef KDTREE_VALUE
+	#undef KDTREE_SWAP
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+inline bool CSG_KDTree::_Quadrant_Contains(double x, double y, int iQuadrant, const TPoint &p)	const
+{
+	switch( iQuadrant )
+	{
+	case 0:	return( x <  p.x && y <  p.y );	// lower left
+	case 1:	return( x <  p.x && y >= p.y );	// upper left
+	case 2:	return( x >= p.x && y >= p.y );	// upper right
+	case 3:	return( x >= p.x && y <  p.y );	// lower right
+	}
+
+	return( true );
+}
+
+//---------------------------------------------------------
+inline bool CSG_KDTree::_Quadrant_Intersects(double x, double y, int iQuadrant, const TSG_Rect &Extent)	const
+{
+	switch( iQuadrant )
+	{
+	case 0:	return( x <  Extent.xMax && y <  Extent.yMax );	// lower left
+	case 1:	return( x <  Extent.xMax && y >= Extent.yMin );	// upper left
+	case 2:	return( x >= Extent.xMin && y >= Extent.yMin );	// upper right
+	case 3:	return( x >= Extent.xMin && y <  Extent.yMax );	// lower right
+	}
+
+	return( true );
+}
+
+//---------------------------------------------------------
+/** Returns the distance of (x, y) to the given extent, which is zero if the extent contains the point. */
+inline double CSG_KDTree::_Get_Distance(double x, double y, const TSG_Rect &Extent)	const
+{
+	double	dx	= x < Extent.xMin ? Extent.xMin - x : x > Extent.xMax ? x - Extent.xMax : 0.0;
+	double	dy	= y < Extent.yMin ? Extent.yMin - y : y > Extent.yMax ? y - Extent.yMax : 0.0;
+
+	return( sqrt(dx*dx + dy*dy) );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CSG_KDTree::Get_Nearest_Point(const TSG_Point &p, TSG_Point &Point, double &Value, double &Distance)	const
+{
+	return( Get_Nearest_Point(p.x, p.y, Point, Value, Distance) );
+}
+
+//---------------------------------------------------------
+bool CSG_KDTree::Get_Nearest_Point(double x, double y, TSG_Point &Point, double &Value, double &Distance)	const
+{
+	int		iNearest	= -1;
+
+	if( m_nPoints > 0 )
+	{
+		_Get_Nearest_Point(0, m_nPoints, m_Extent, x, y, iNearest, Distance = -1.0);
+	}
+
+	if( iNearest >= 0 )
+	{
+		Point.x	= m_Points[iNearest].x;
+		Point.y	= m_Points[iNearest].y;
+		Value	= m_Points[iNearest].z;
+
+		return( true );
+	}
+
+	return( false );
+}
+
+//---------------------------------------------------------
+void CSG_KDTree::_Get_Nearest_Point(int iFirst, int iLast, const TSG_Rect &Extent, double x, double y, int &iNearest, double &Distance)	const
+{
+	if( iLast - iFirst <= KDTREE_BUCKET )
+	{
+		for(int i=iFirst; i<iLast; i++)
+		{
+			double	d	= SG_Get_Distance(x, y, m_Points[i].x, m_Points[i].y);
+
+			if( Distance < 0.0 || d < Distance )
+			{
+				Distance	= d;
+				iNearest	= i;
+			}
+		}
+
+		return;
+	}
+
+	//-----------------------------------------------------
+	int		iMedian	= KDTREE_MEDIAN(iFirst, iLast);
+
+	double	d	= SG_Get_Distance(x, y, m_Points[iMedian].x, m_Points[iMedian].y);
+
+	if( Distance < 0.0 || d < Distance )
+	{
+		Distance	= d;
+		iNearest	= iMedian;
+	}
+
+	//-----------------------------------------------------
+	TSG_Rect	Left = Extent, Right = Extent;
+
+	bool	bLeft	= m_Axis[iMedian] == 0
+		? (Left.xMax = Right.xMin = m_Points[iMedian].x) > x
+		: (Left.yMax = Right.yMin = m_Points[iMedian].y) > y;
+
+	for(int i=0; i<2; i++, bLeft=!bLeft)	// nearer child first
+	{
+		if( bLeft )
+		{
+			if( _Get_Distance(x, y, Left ) < Distance )	_Get_Nearest_Point(iFirst     , iMedian, Left , x, y, iNearest, Distance);
+		}
+		else
+		{
+			if( _Get_Distance(x, y, Right) < Distance )	_Get_Nearest_Point(iMedian + 1, iLast  , Right, x, y, iNearest, Distance);
+		}
+	}
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+size_t CSG_KDTree::Select_Nearest_Points(const TSG_Point &p, size_t maxPoints, double Radius, int iQuadrant)
+{
+	return( Select_Nearest_Points(m_Selection, p.x, p.y, maxPoints, Radius, iQuadrant) );
+}
+
+//---------------------------------------------------------
+size_t CSG_KDTree::Select_Nearest_Points(double x, double y, size_t maxPoints, double Radius, int iQuadrant)
+{
+	return( Select_Nearest_Points(m_Selection, x, y, maxPoints, Radius, iQuadrant) );
+}
+
+//---------------------------------------------------------
+size_t CSG_KDTree::Select_Nearest_Points(CSG_Array &Selection, const TSG_Point &p, size_t maxPoints, double Radius, int iQuadrant)	const
+{
+	return( Select_Nearest_Points(Selection, p.x, p.y, maxPoints, Radius, iQuadrant) );
+}
+
+//---------------------------------------------------------
+/**
+  * Selects the maxPoints nearest points (all points, if maxPoints
+  * is zero) within Radius (unlimited, if Radius is zero), like
+  * CSG_PRQuadTree::Select_Nearest_Points() does. With iQuadrant
+  * set to 4 up to maxPoints are selected for each quadrant. This
+  * function does not modify the tree and can safely be called
+  * from multiple threads, each using its own Selection buffer.
+*/
+size_t CSG_KDTree::Select_Nearest_Points(CSG_Array &Selection, double x, double y, size_t maxPoints, double Radius, int iQuadrant)	const
+{
+	if( Selection.Get_Value_Size() != sizeof(TSelected) )
+	{
+		Selection.Create(sizeof(TSelected), 0, SG_ARRAY_GROWTH_3);
+	}
+	else
+	{
+		Selection.Set_Array(0, false);
+	}
+
+	if( m_nPoints > 0 )
+	{
+		double	Distance;
+
+		if( maxPoints < 1 )
+		{
+			maxPoints	= m_nPoints;
+		}
+
+		if( iQuadrant != 4 )
+		{
+			_Select_Nearest_Points(Selection, 0, 0, m_nPoints, m_Extent, x, y, Distance = 0.0, Radius, maxPoints, iQuadrant);
+		}
+		else // if( iQuadrant == 4 )	// quadrant-wise search
+		{
+			for(iQuadrant=0; iQuadrant<4; iQuadrant++)
+			{
+				_Select_Nearest_Points(Selection, Selection.Get_Size(), 0, m_nPoints, m_Extent, x, y, Distance = 0.0, Radius, maxPoints, iQuadrant);
+			}
+		}
+	}
+
+	return( Selection.Get_Size() );
+}
+
+//---------------------------------------------------------
+inline void CSG_KDTree::_Check_Point(CSG_Array &Selection, size_t iSelection, int iPoint, double x, double y, double &Distance, double Radius, size_t maxPoints, int iQuadrant)	const
+{
+	if( !_Quadrant_Contains(x, y, iQuadrant, m_Points[iPoint]) )
+	{
+		return;
+	}
+
+	double	d	= SG_Get_Distance(x, y, m_Points[iPoint].x, m_Points[iPoint].y);
+
+	if( Radius > 0.0 && Radius < d )
+	{
+		return;
+	}
+
+	size_t	i, n	= Selection.Get_Size() - iSelection;
+
+	//-----------------------------------------------------
+	if( n < maxPoints )	// add to max-heap, sift up
+	{
+		if( !Selection.Inc_Array() )
+		{
+			return;
+		}
+
+		TSelected	*pHeap	= (TSelected *)Selection.Get_Entry(iSelection);
+
+		for(i=n; i>0 && pHeap[(i - 1) / 2].Distance < d; i=(i - 1) / 2)
+		{
+			pHeap[i]	= pHeap[(i - 1) / 2];
+		}
+
+		pHeap[i].Index		= iPoint;
+		pHeap[i].Distance	= d;
+	}
+	else if( d < Distance )	// replace the farthest, sift down
+	{
+		TSelected	*pHeap	= (TSelected *)Selection.Get_Entry(iSelection);
+
+		for(i=0; 2 * i + 1<n; )
+		{
+			size_t	j	= 2 * i + 1;
+
+			if( j + 1 < n && pHeap[j].Distance < pHeap[j + 1].Distance )
+			{
+				j++;
+			}
+
+			if( pHeap[j].Distance <= d )
+			{
+				break;
+			}
+
+			pHeap[i]	= pHeap[j];
+			i			= j;
+		}
+
+		pHeap[i].Index		= iPoint;
+		pHeap[i].Distance	= d;
+	}
+	else
+	{
+		return;
+	}
+
+	Distance	= ((TSelected *)Selection.Get_Entry(iSelection))->Distance;	// the farthest selected point
+}
+
+//---------------------------------------------------------
+void CSG_KDTree::_Select_Nearest_Points(CSG_Array &Selection, size_t iSelection, int iFirst, int iLast, const TSG_Rect &Extent, double x, double y, double &Distance, double Radius, size_t maxPoints, int iQuadrant)	const
+{
+	if( iLast - iFirst <= KDTREE_BUCKET )
+	{
+		for(int i=iFirst; i<iLast; i++)
+		{
+			_Check_Point(Selection, iSelection, i, x, y, Distance, Radius, maxPoints, iQuadrant);
+		}
+
+		return;
+	}
+
+	//-----------------------------------------------------
+	int		iMedian	= KDTREE_MEDIAN(iFirst, iLast);
+
+	_Check_Point(Selection, iSelection, iMedian, x, y, Distance, Radius, maxPoints, iQuadrant);
+
+	//-----------------------------------------------------
+	TSG_Rect	Left = Extent, Right = Extent;
+
+	bool	bLeft	= m_Axis[iMedian] == 0
+		? (Left.xMax = Right.xMin = m_Points[iMedian].x) > x
+		: (Left.yMax = Right.yMin = m_Points[iMedian].y) > y;
+
+	for(int i=0; i<2; i++, bLeft=!bLeft)	// nearer child first
+	{
+		const TSG_Rect	&Child	= bLeft ? Left : Right;
+
+		if( _Quadrant_Intersects(x, y, iQuadrant, Child) )
+		{
+			double	d	= _Get_Distance(x, y, Child);
+
+			if( (Radius <= 0.0 || d <= Radius) && (Selection.Get_Size() - iSelection < maxPoints || d < Distance) )
+			{
+				if( bLeft )
+				{
+					_Select_Nearest_Points(Selection, iSelection, iFirst     , iMedian, Left , x, y, Distance, Radius, maxPoints, iQuadrant);
+				}
+				else
+				{
+					_Select_Nearest_Points(Selection, iSelection, iMedian + 1, iLast  , Right, x, y, Distance, Radius, maxPoints, iQuadrant);
+				}
+			}
+		}
+	}
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+size_t CSG_KDTree::Get_Nearest_Points(CSG_Points_Z &Points, const TSG_Point &p, size_t maxPoints, double Radius, int iQuadrant)	const
+{
+	return( Get_Nearest_Points(Points, p.x, p.y, maxPoints, Radius, iQuadrant) );
+}
+
+//---------------------------------------------------------
+size_t CSG_KDTree::Get_Nearest_Points(CSG_Points_Z &Points, double x, double y, size_t maxPoints, double Radius, int iQuadrant)	const
+{
+	CSG_Array	Selection;
+
+	Select_Nearest_Points(Selection, x, y, maxPoints, Radius, iQuadrant);
+
+	Points.Clear();
+
+	for(size_t i=0; i<Selection.Get_Size(); i++)
+	{
+		const TPoint	&p	= m_Points[((TSelected *)Selection.Get_Entry(i))->Index];
+
+		Points.Add(p.x, p.y, p.z);
+	}
+
+	return( Points.Get_Count() );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
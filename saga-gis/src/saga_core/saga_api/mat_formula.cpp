@@ -221,6 +221,9 @@ CSG_Formula::CSG_Formula(void)
 
 	m_bError			= false;
 
+	m_nRegisters		= 0;
+	m_Result.Type		= -1;
+
 	i_ctable			= NULL;
 	i_error				= NULL;
 }
@@ -237,6 +240,12 @@ bool CSG_Formula::Destroy(void)
 	SG_FREE_SAFE(m_Formula.code);
 	SG_FREE_SAFE(m_Formula.ctable);
 
+	m_Program  .Destroy();
+	m_Constants.Destroy();
+
+	m_nRegisters		= 0;
+	m_Result.Type		= -1;
+
 	m_bError			= false;
 
 	return( true );
@@ -353,6 +362,8 @@ bool CSG_Formula::Set_Formula(const CSG_String &Formula)
 
 		if( m_Formula.code != NULL )
 		{
+			_Compile();	// if this fails, Get_Values() falls back to the interpreter
+
 			return( true );
 		}
 	}
@@ -512,13 +523,15 @@ double CSG_Formula::_Get_Value(const double *Parameters, TMAT_Formula func) cons
 
 		case '&':
 			y		= *--bufp;
-			result	= y != 0.0 && *(--bufp) != 0.0 ? 1.0 : 0.0;
+			x		= *--bufp;	// pop before testing, short-circuit evaluation would leave it on the stack
+			result	= x != 0.0 && y != 0.0 ? 1.0 : 0.0;
 			*bufp++	= result;
 			break;
 
 		case '|':
 			y		= *--bufp;
-			result	= y != 0.0 || *(--bufp) != 0.0 ? 1.0 : 0.0;
+			x		= *--bufp;	// pop before testing, short-circuit evaluation would leave it on the stack
+			result	= x != 0.0 || y != 0.0 ? 1.0 : 0.0;
 			*bufp++	= result;
 			break;
 
@@ -570,6 +583,389 @@ finish:
 } 
 
 
+///////////////////////////////////////////////////////////
+//                                                       //
+//                                                       //
+//                                                       //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// The postfix code is compiled once into a small register
+// program. Each instruction then runs as a tight loop over
+// a block of values, which keeps the registers in cache and
+// leaves the simple arithmetic open to auto-vectorization.
+
+//---------------------------------------------------------
+#define FORMULA_BLOCK		256
+
+//---------------------------------------------------------
+enum
+{
+	FORMULA_REGISTER	= 0,
+	FORMULA_CONSTANT,
+	FORMULA_VARIABLE
+};
+
+//---------------------------------------------------------
+enum
+{
+	FORMULA_OP_FNC_0	= 256,	// generic function calls
+	FORMULA_OP_FNC_1,
+	FORMULA_OP_FNC_2,
+	FORMULA_OP_FNC_3,
+	FORMULA_OP_ABS,				// inlined library functions
+	FORMULA_OP_SQRT,
+	FORMULA_OP_SQR,
+	FORMULA_OP_INT,
+	FORMULA_OP_GT,
+	FORMULA_OP_LT,
+	FORMULA_OP_EQ,
+	FORMULA_OP_POW,
+	FORMULA_OP_IFELSE
+};
+
+//---------------------------------------------------------
+static inline bool	SG_Formula_is_Finite	(double x)
+{
+	return( x - x == 0.0 );	// false for NaN and +/-INF
+}
+
+//---------------------------------------------------------
+static void			SG_Formula_Execute		(int Code, TSG_PFNC_Formula_1 f, int n, double *z, const double *a, const double *b, const double *c)
+{
+	int		i;
+
+	switch( Code )
+	{
+	case 'M': for(i=0; i<n; i++)	{	z[i]	= -a[i];						}	break;
+	case '+': for(i=0; i<n; i++)	{	z[i]	= a[i] + b[i];					}	break;
+	case '-': for(i=0; i<n; i++)	{	z[i]	= a[i] - b[i];					}	break;
+	case '*': for(i=0; i<n; i++)	{	z[i]	= a[i] * b[i];					}	break;
+	case '/': for(i=0; i<n; i++)	{	z[i]	= a[i] / b[i];					}	break;
+	case '=': for(i=0; i<n; i++)	{	z[i]	= a[i] == b[i] ? 1.0 : 0.0;		}	break;
+	case '>': for(i=0; i<n; i++)	{	z[i]	= a[i] >  b[i] ? 1.0 : 0.0;		}	break;
+	case '<': for(i=0; i<n; i++)	{	z[i]	= a[i] <  b[i] ? 1.0 : 0.0;		}	break;
+	case '&': for(i=0; i<n; i++)	{	z[i]	= a[i] != 0.0 && b[i] != 0.0 ? 1.0 : 0.0;	}	break;
+	case '|': for(i=0; i<n; i++)	{	z[i]	= a[i] != 0.0 || b[i] != 0.0 ? 1.0 : 0.0;	}	break;
+
+	case '^':
+	case FORMULA_OP_POW   : for(i=0; i<n; i++)	{	z[i]	= pow(a[i], b[i]);				}	break;
+
+	case FORMULA_OP_ABS   : for(i=0; i<n; i++)	{	z[i]	= fabs(a[i]);					}	break;
+	case FORMULA_OP_SQRT  : for(i=0; i<n; i++)	{	z[i]	= sqrt(a[i]);					}	break;
+	case FORMULA_OP_SQR   : for(i=0; i<n; i++)	{	z[i]	= a[i] * a[i];					}	break;
+	case FORMULA_OP_INT   : for(i=0; i<n; i++)	{	z[i]	= (int)(a[i]);					}	break;
+	case FORMULA_OP_GT    : for(i=0; i<n; i++)	{	z[i]	= a[i] > b[i] ? 1.0 : 0.0;		}	break;
+	case FORMULA_OP_LT    : for(i=0; i<n; i++)	{	z[i]	= a[i] < b[i] ? 1.0 : 0.0;		}	break;
+	case FORMULA_OP_EQ    : for(i=0; i<n; i++)	{	z[i]	= fabs(a[i] - b[i]) < EPSILON ? 1.0 : 0.0;	}	break;
+	case FORMULA_OP_IFELSE: for(i=0; i<n; i++)	{	z[i]	= a[i] ? b[i] : c[i];			}	break;
+
+	case FORMULA_OP_FNC_0 : for(i=0; i<n; i++)	{	z[i]	= ((TSG_PFNC_Formula_0)f)();				}	break;
+	case FORMULA_OP_FNC_1 : for(i=0; i<n; i++)	{	z[i]	=                      f (a[i]);			}	break;
+	case FORMULA_OP_FNC_2 : for(i=0; i<n; i++)	{	z[i]	= ((TSG_PFNC_Formula_2)f)(a[i], b[i]);		}	break;
+	case FORMULA_OP_FNC_3 : for(i=0; i<n; i++)	{	z[i]	= ((TSG_PFNC_Formula_3)f)(a[i], b[i], c[i]);	}	break;
+	}
+}
+
+//---------------------------------------------------------
+bool CSG_Formula::_Compile(void)
+{
+	m_Program  .Create(sizeof(TMAT_Operation), 0, SG_ARRAY_GROWTH_1);
+	m_Constants.Create(sizeof(double)        , 0, SG_ARRAY_GROWTH_1);
+
+	m_nRegisters	= 0;
+	m_Result.Type	= -1;
+
+	if( !m_Formula.code )
+	{
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	TMAT_Operand	Stack[GET_VALUE_BUFSIZE];	int	nStack	= 0;
+
+	for(SG_Char *code=m_Formula.code; *code; )
+	{
+		TMAT_Operation	Op;	int	nArgs;	bool	bVarying	= false;
+
+		Op.Function	= NULL;
+
+		switch( *code++ )
+		{
+		//-------------------------------------------------
+		case 'D':
+			if( nStack >= GET_VALUE_BUFSIZE || !m_Constants.Inc_Array() )
+			{
+				return( false );
+			}
+
+			((double *)m_Constants.Get_Array())[m_Constants.Get_Size() - 1]	= m_Formula.ctable[(int)*code++];
+
+			Stack[nStack  ].Type	= FORMULA_CONSTANT;
+			Stack[nStack++].Index	= (int)m_Constants.Get_Size() - 1;
+			continue;
+
+		case 'V':
+			if( nStack >= GET_VALUE_BUFSIZE || *code < 'a' || *code > 'z' )
+			{
+				return( false );
+			}
+
+			Stack[nStack  ].Type	= FORMULA_VARIABLE;
+			Stack[nStack++].Index	= (int)(*code++ - 'a');
+			continue;
+
+		//-------------------------------------------------
+		case 'M':
+			Op.Code	= 'M';	nArgs	= 1;
+			break;
+
+		case '+': case '-': case '*': case '/': case '^':
+		case '=': case '>': case '<': case '&': case '|':
+			Op.Code	= code[-1];	nArgs	= 2;
+			break;
+
+		case 'F':
+			{
+				TSG_Formula_Item	&F	= gSG_Functions[(int)*code++];
+
+				Op.Function	= F.f;	nArgs	= F.n_pars;	bVarying	= F.varying != 0;
+
+				if( nArgs < 0 || nArgs > MAX_PARMS )
+				{
+					return( false );
+				}
+
+				if     ( F.f == (TSG_PFNC_Formula_1)fabs     )	Op.Code	= FORMULA_OP_ABS;
+				else if( F.f == (TSG_PFNC_Formula_1)sqrt     )	Op.Code	= FORMULA_OP_SQRT;
+				else if( F.f == (TSG_PFNC_Formula_1)f_sqr    )	Op.Code	= FORMULA_OP_SQR;
+				else if( F.f == (TSG_PFNC_Formula_1)f_int    )	Op.Code	= FORMULA_OP_INT;
+				else if( F.f == (TSG_PFNC_Formula_1)f_gt     )	Op.Code	= FORMULA_OP_GT;
+				else if( F.f == (TSG_PFNC_Formula_1)f_lt     )	Op.Code	= FORMULA_OP_LT;
+				else if( F.f == (TSG_PFNC_Formula_1)f_eq     )	Op.Code	= FORMULA_OP_EQ;
+				else if( F.f == (TSG_PFNC_Formula_1)f_pow    )	Op.Code	= FORMULA_OP_POW;
+				else if( F.f == (TSG_PFNC_Formula_1)f_ifelse )	Op.Code	= FORMULA_OP_IFELSE;
+				else											Op.Code	= FORMULA_OP_FNC_0 + nArgs;
+			}
+			break;
+
+		default:
+			return( false );
+		}
+
+		//-------------------------------------------------
+		if( nArgs > nStack || (nArgs == 0 && nStack >= GET_VALUE_BUFSIZE) )
+		{
+			return( false );
+		}
+
+		bool	bConstant	= !bVarying;
+
+		nStack	-= nArgs;
+
+		for(int i=0; i<MAX_PARMS; i++)
+		{
+			Op.Args[i]	= Stack[nStack + (i < nArgs ? i : 0)];	// unused arguments just repeat the first one
+
+			if( i < nArgs && Op.Args[i].Type != FORMULA_CONSTANT )
+			{
+				bConstant	= false;
+			}
+		}
+
+		//-------------------------------------------------
+		if( bConstant )	// constant folding
+		{
+			double	x[MAX_PARMS], z;
+
+			for(int i=0; i<nArgs; i++)
+			{
+				x[i]	= ((double *)m_Constants.Get_Array())[Op.Args[i].Index];
+			}
+
+			SG_Formula_Execute(Op.Code, Op.Function, 1, &z, x + 0, x + 1, x + 2);
+
+			if( !m_Constants.Inc_Array() )
+			{
+				return( false );
+			}
+
+			((double *)m_Constants.Get_Array())[m_Constants.Get_Size() - 1]	= z;
+
+			Stack[nStack  ].Type	= FORMULA_CONSTANT;
+			Stack[nStack++].Index	= (int)m_Constants.Get_Size() - 1;
+		}
+
+		//-------------------------------------------------
+		else
+		{
+			Op.Result	= nStack;	// the result goes to the register of its stack slot
+
+			if( m_nRegisters <= nStack )
+			{
+				m_nRegisters	= nStack + 1;
+			}
+
+			if( !m_Program.Inc_Array() )
+			{
+				return( false );
+			}
+
+			((TMAT_Operation *)m_Program.Get_Array())[m_Program.Get_Size() - 1]	= Op;
+
+			Stack[nStack  ].Type	= FORMULA_REGISTER;
+			Stack[nStack++].Index	= Op.Result;
+		}
+	}
+
+	//-----------------------------------------------------
+	if( nStack != 1 )
+	{
+		m_Program  .Set_Array(0);
+		m_Constants.Set_Array(0);
+
+		return( false );
+	}
+
+	m_Result	= Stack[0];
+
+	return( true );
+}
+
+//---------------------------------------------------------
+bool CSG_Formula::Get_Values(const double **Inputs, int nInputs, double *Values, int nValues, bool *bNoData) const
+{
+	if( !m_Formula.code || !Values || nValues < 1 )
+	{
+		return( false );
+	}
+
+	int		i;
+
+	if( !Inputs || nInputs < 0 )
+	{
+		nInputs	= 0;
+	}
+	else if( nInputs > 26 )
+	{
+		nInputs	= 26;
+	}
+
+	//-----------------------------------------------------
+	if( m_Result.Type < 0 )	// not compiled, fall back to the interpreter
+	{
+		for(i=0; i<nValues; i++)
+		{
+			double	Parameters[32];
+
+			memcpy(Parameters, m_Parameters, 32 * sizeof(double));
+
+			for(int j=0; j<nInputs; j++)
+			{
+				if( m_Vars_Used[j] && Inputs[j] )
+				{
+					Parameters[j]	= Inputs[j][i];
+				}
+			}
+
+			Values[i]	= _Get_Value(Parameters, m_Formula);
+
+			if( bNoData && !bNoData[i] && !SG_Formula_is_Finite(Values[i]) )
+			{
+				bNoData[i]	= true;
+			}
+		}
+
+		return( true );
+	}
+
+	//-----------------------------------------------------
+	const TMAT_Operation	*Program	= (const TMAT_Operation *)m_Program.Get_Array();
+
+	int		nProgram	= (int)m_Program.Get_Size(), nConstants = (int)m_Constants.Get_Size();
+
+	double	*Buffer		= (double *)SG_Malloc((m_nRegisters + nConstants + 26) * FORMULA_BLOCK * sizeof(double));
+
+	if( !Buffer )
+	{
+		return( false );
+	}
+
+	double	*Registers	= Buffer, *Constants = Buffer + m_nRegisters * FORMULA_BLOCK, *Parameters = Constants + nConstants * FORMULA_BLOCK;
+
+	for(i=0; i<nConstants; i++)		// constants and unbound variables are broadcast once
+	{
+		double	c	= ((const double *)m_Constants.Get_Array())[i], *p = Constants + i * FORMULA_BLOCK;
+
+		for(int j=0; j<FORMULA_BLOCK; j++)	{	p[j]	= c;	}
+	}
+
+	const double	*Variables[26];	bool	bBound[26];
+
+	for(i=0; i<26; i++)
+	{
+		if( (bBound[i] = i < nInputs && m_Vars_Used[i] && Inputs[i]) == true )
+		{
+			Variables[i]	= Inputs[i];
+		}
+		else
+		{
+			double	c	= m_Parameters[i], *p = Parameters + i * FORMULA_BLOCK;
+
+			for(int j=0; j<FORMULA_BLOCK; j++)	{	p[j]	= c;	}
+
+			Variables[i]	= p;
+		}
+	}
+
+	#define FORMULA_OPERAND(o)	((o).Type == FORMULA_REGISTER ? Registers + (o).Index * FORMULA_BLOCK\
+								:(o).Type == FORMULA_CONSTANT ? Constants + (o).Index * FORMULA_BLOCK\
+								: Variables[(o).Index] + (bBound[(o).Index] ? iBlock : 0))
+
+	//-----------------------------------------------------
+	for(int iBlock=0; iBlock<nValues; iBlock+=FORMULA_BLOCK)
+	{
+		int		n	= M_GET_MIN(FORMULA_BLOCK, nValues - iBlock);
+
+		for(i=0; i<nProgram; i++)
+		{
+			const TMAT_Operation	&Op	= Program[i];
+
+			double	*z	= i == nProgram - 1 ? Values + iBlock : Registers + Op.Result * FORMULA_BLOCK;	// the last operation yields the result
+
+			SG_Formula_Execute(Op.Code, Op.Function, n, z,
+				FORMULA_OPERAND(Op.Args[0]),
+				FORMULA_OPERAND(Op.Args[1]),
+				FORMULA_OPERAND(Op.Args[2])
+			);
+		}
+
+		if( m_Result.Type != FORMULA_REGISTER )	// a single constant or variable
+		{
+			memcpy(Values + iBlock, FORMULA_OPERAND(m_Result), n * sizeof(double));
+		}
+
+		//-------------------------------------------------
+		if( bNoData )
+		{
+			for(int j=iBlock; j<iBlock+n; j++)
+			{
+				if( !bNoData[j] && !SG_Formula_is_Finite(Values[j]) )
+				{
+					bNoData[j]	= true;
+				}
+			}
+		}
+	}
+
+	#undef FORMULA_OPERAND
+
+	SG_Free(Buffer);
+
+	return( true );
+}
+
+
 ///////////////////////////////////////////////////////////
 //                                                       //
 //                                                       //
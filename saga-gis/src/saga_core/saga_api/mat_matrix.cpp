@@ -1623,22 +1623,17 @@ bool CSG_Matrix::Set_Inverse(bool bSilent, int nSubSquare)
 
 		if( SG_Matrix_LU_Decomposition(n, (int *)p.Get_Array(), m.Get_Data(), bSilent) )
 		{
-			CSG_Vector	v(n);
+			int	i, j;
 
-			for(int j=0; j<n && (bSilent || SG_UI_Process_Set_Progress(j, n)); j++)
+			for(i=0; i<n; i++)	// solve for all columns of the identity matrix at once
 			{
-				v.Set_Zero();
-				v[j]	= 1.0;
-
-				SG_Matrix_LU_Solve(n, (int *)p.Get_Array(), m, v.Get_Data(), true);
-
-				for(int i=0; i<n; i++)
+				for(j=0; j<n; j++)
 				{
-					m_z[i][j]	= v[i];
+					m_z[i][j]	= i == j ? 1.0 : 0.0;
 				}
 			}
 
-			return( true );
+			return( SG_Matrix_LU_Solve(n, (int *)p.Get_Array(), m, m_z, n, bSilent) );
 		}
 	}
 
@@ -1752,11 +1747,21 @@ bool		SG_Matrix_Eigen_Reduction(const CSG_Matrix &Matrix, CSG_Matrix &Eigen_Vect
 //														 //
 ///////////////////////////////////////////////////////////
 
+//---------------------------------------------------------
+// LU decomposition with scaled partial pivoting. The matrix is
+// processed in panels of SG_MATRIX_LU_BLOCK columns, the trailing
+// sub-matrix is then updated row by row with contiguous memory
+// access, which vectorizes well and is done in parallel for
+// larger matrices. Pivoting and result are the same as with the
+// unblocked (Crout) algorithm.
+//---------------------------------------------------------
+#define SG_MATRIX_LU_BLOCK	64
+
 //---------------------------------------------------------
 bool		SG_Matrix_LU_Decomposition(int n, int *Permutation, double **Matrix, bool bSilent, int *nRowChanges)
 {
 	int			i, j, k, iMax;
-	double		dMax, d, Sum;
+	double		dMax, d;
 	CSG_Vector	Vector;
 	
 	Vector.Create(n);
@@ -1783,66 +1788,109 @@ bool		SG_Matrix_LU_Decomposition(int n, int *Permutation, double **Matrix, bool
 		Vector[i]	= 1.0 / dMax;
 	}
 
-	for(j=0; j<n && (bSilent || SG_UI_Process_Set_Progress(j, n)); j++)
+	//-----------------------------------------------------
+	for(int jBlock=0; jBlock<n && (bSilent || SG_UI_Process_Set_Progress(jBlock, n)); jBlock+=SG_MATRIX_LU_BLOCK)
 	{
-		for(i=0; i<j; i++)
-		{
-			Sum		= Matrix[i][j];
+		int	jEnd	= jBlock + SG_MATRIX_LU_BLOCK < n ? jBlock + SG_MATRIX_LU_BLOCK : n;
+
+		//-------------------------------------------------
+		// factorize the panel [jBlock, jEnd[ of the remaining rows
 
-			for(k=0; k<i; k++)
+		for(j=jBlock; j<jEnd; j++)
+		{
+			for(i=j, dMax=0.0; i<n; i++)
 			{
-				Sum		-= Matrix[i][k] * Matrix[k][j];
+				if( (d = Vector[i] * fabs(Matrix[i][j])) >= dMax )
+				{
+					dMax	= d;
+					iMax	= i;
+				}
 			}
 
-			Matrix[i][j]	= Sum;
-		}
+			if( j != iMax )
+			{
+				double	*Row	= Matrix[iMax];
 
-		for(i=j, dMax=0.0; i<n; i++)
-		{
-			Sum		= Matrix[i][j];
+				for(k=0; k<n; k++)
+				{
+					d				= Row      [k];
+					Row      [k]	= Matrix[j][k];
+					Matrix[j][k]	= d;
+				}
 
-			for(k=0; k<j; k++)
-			{
-				Sum		-= Matrix[i][k] * Matrix[k][j];
+				Vector[iMax]	= Vector[j];
+
+				if( nRowChanges )	(*nRowChanges)++;
 			}
 
-			Matrix[i][j]	= Sum;
+			Permutation[j]	= iMax;
 
-			if( (d = Vector[i] * fabs(Sum)) >= dMax )
+			if( Matrix[j][j] == 0.0 )
 			{
-				dMax	= d;
-				iMax	= i;
+				Matrix[j][j]	= M_TINY;
 			}
-		}
 
-		if( j != iMax )
-		{
-			for(k=0; k<n; k++)
+			d	= 1.0 / (Matrix[j][j]);
+
+			for(i=j+1; i<n; i++)
 			{
-				d				= Matrix[iMax][k];
-				Matrix[iMax][k]	= Matrix[j   ][k];
-				Matrix[j   ][k]	= d;
-			}
+				double	*Row	= Matrix[i], l = (Row[j] *= d);
 
-			Vector[iMax]	= Vector[j];
+				if( l != 0.0 )
+				{
+					for(k=j+1; k<jEnd; k++)
+					{
+						Row[k]	-= l * Matrix[j][k];
+					}
+				}
+			}
+		}
 
-			if( nRowChanges )	(*nRowChanges)++;
+		if( jEnd >= n )
+		{
+			break;
 		}
 
-		Permutation[j]	= iMax;
+		//-------------------------------------------------
+		// upper block row: U12 = L11^-1 * A12
 
-		if( Matrix[j][j] == 0.0 )
+		for(j=jBlock; j<jEnd; j++)
 		{
-			Matrix[j][j]	= M_TINY;
+			for(i=j+1; i<jEnd; i++)
+			{
+				double	*Row	= Matrix[i], l = Row[j];
+
+				if( l != 0.0 )
+				{
+					for(k=jEnd; k<n; k++)
+					{
+						Row[k]	-= l * Matrix[j][k];
+					}
+				}
+			}
 		}
 
-		if( j != n )
+		//-------------------------------------------------
+		// trailing sub-matrix: A22 = A22 - L21 * U12
+
+		#pragma omp parallel for private(j, k) if(n - jEnd > 2 * SG_MATRIX_LU_BLOCK)
+		for(i=jEnd; i<n; i++)
 		{
-			d	= 1.0 / (Matrix[j][j]);
+			double	*Row	= Matrix[i];
 
-			for(i=j+1; i<n; i++)
+			for(j=jBlock; j<jEnd; j++)
 			{
-				Matrix[i][j]	*= d;
+				double	l	= Row[j];
+
+				if( l != 0.0 )
+				{
+					const double	*U	= Matrix[j];
+
+					for(k=jEnd; k<n; k++)
+					{
+						Row[k]	-= l * U[k];
+					}
+				}
 			}
 		}
 	}
@@ -1896,6 +1944,86 @@ bool		SG_Matrix_LU_Solve(int n, const int *Permutation, const double **Matrix, d
 	return( true );
 }
 
+//---------------------------------------------------------
+/**
+  * Solves the system for nVectors right-hand sides, which are
+  * given as the columns of the n x nVectors matrix Vectors and
+  * replaced by the solution. Rows are processed as a whole, so
+  * that the inner loops run over contiguous memory, column
+  * blocks are solved in parallel.
+*/
+bool		SG_Matrix_LU_Solve(int n, const int *Permutation, const double **Matrix, double **Vectors, int nVectors, bool bSilent)
+{
+	int		i, j, k;
+
+	for(i=0; i<n; i++)
+	{
+		if( Permutation[i] != i )
+		{
+			double	*Row	= Vectors[Permutation[i]];
+
+			for(k=0; k<nVectors; k++)
+			{
+				double	d		= Row[k];
+				Row       [k]	= Vectors[i][k];
+				Vectors[i][k]	= d;
+			}
+		}
+	}
+
+	//-----------------------------------------------------
+	#pragma omp parallel for private(i, j, k) if(n * nVectors > 65536)
+	for(int kBlock=0; kBlock<nVectors; kBlock+=SG_MATRIX_LU_BLOCK)
+	{
+		int	kEnd	= kBlock + SG_MATRIX_LU_BLOCK < nVectors ? kBlock + SG_MATRIX_LU_BLOCK : nVectors;
+
+		for(i=1; i<n; i++)	// forward substitution
+		{
+			double	*Row	= Vectors[i];
+
+			for(j=0; j<i; j++)
+			{
+				double	l	= Matrix[i][j];
+
+				if( l != 0.0 )
+				{
+					for(k=kBlock; k<kEnd; k++)
+					{
+						Row[k]	-= l * Vectors[j][k];
+					}
+				}
+			}
+		}
+
+		for(i=n-1; i>=0; i--)	// back substitution
+		{
+			double	*Row	= Vectors[i];
+
+			for(j=i+1; j<n; j++)
+			{
+				double	u	= Matrix[i][j];
+
+				if( u != 0.0 )
+				{
+					for(k=kBlock; k<kEnd; k++)
+					{
+						Row[k]	-= u * Vectors[j][k];
+					}
+				}
+			}
+
+			double	d	= 1.0 / Matrix[i][i];
+
+			for(k=kBlock; k<kEnd; k++)
+			{
+				Row[k]	*= d;
+			}
+		}
+	}
+
+	return( bSilent || SG_UI_Process_Get_Okay(false) );
+}
+
 
 ///////////////////////////////////////////////////////////
 //														 //
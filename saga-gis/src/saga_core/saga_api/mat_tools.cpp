@@ -321,6 +321,8 @@ bool CSG_Simple_Statistics::Create(bool bHoldValues)
 
 	m_Values.Create(bHoldValues ? sizeof(double) : 0, 0, SG_ARRAY_GROWTH_1);
 
+	m_Histogram.Destroy();	m_Hist_Minimum	= 0.0;	m_Hist_Width	= 1.0;
+
 	return( true );
 }
 
@@ -346,6 +348,10 @@ bool CSG_Simple_Statistics::Create(const CSG_Simple_Statistics &Statistics)
 	m_bSorted		= Statistics.m_bSorted;
 	m_Values		.Create(Statistics.m_Values);
 
+	m_Hist_Minimum	= Statistics.m_Hist_Minimum;
+	m_Hist_Width	= Statistics.m_Hist_Width;
+	m_Histogram		.Create(Statistics.m_Histogram);
+
 	return( true );
 }
 
@@ -368,6 +374,8 @@ bool CSG_Simple_Statistics::Create(double Mean, double StdDev, sLong Count)
 	m_Maximum		= m_Mean + 1.5 * m_StdDev;
 	m_Range			= m_Maximum - m_Minimum;
 
+	m_Histogram.Destroy();	m_Hist_Minimum	= 0.0;	m_Hist_Width	= 1.0;
+
 	return( true );
 }
 
@@ -408,6 +416,39 @@ void CSG_Simple_Statistics::Invalidate(void)
 
 	m_bSorted		= false;
 	m_Values		.Destroy();
+
+	if( m_Histogram.Get_Size() > 0 )	// keep the class layout, reset the counts
+	{
+		memset(m_Histogram.Get_Array(), 0, m_Histogram.Get_Size() * sizeof(sLong));
+	}
+}
+
+//---------------------------------------------------------
+/**
+  * Enables the collection of a histogram with nClasses equal
+  * sized classes ranging from Minimum to Maximum. Values outside
+  * this range are counted in the first or last class respectively.
+  * The histogram allows the approximation of quantiles without
+  * holding the values (see Get_Quantile()). Statistics that
+  * share the same class layout can be merged with Add().
+  * Resets the histogram counts and should therefore be called
+  * before any value has been added.
+*/
+bool CSG_Simple_Statistics::Set_Histogram(int nClasses, double Minimum, double Maximum)
+{
+	if( nClasses < 1 || Minimum > Maximum || !m_Histogram.Create(sizeof(sLong), nClasses) )
+	{
+		m_Histogram.Destroy();
+
+		return( false );
+	}
+
+	memset(m_Histogram.Get_Array(), 0, nClasses * sizeof(sLong));
+
+	m_Hist_Minimum	= Minimum;
+	m_Hist_Width	= Maximum > Minimum ? (Maximum - Minimum) / nClasses : 1.0;
+
+	return( true );
 }
 
 //---------------------------------------------------------
@@ -449,6 +490,19 @@ void CSG_Simple_Statistics::Add(const CSG_Simple_Statistics &Statistics)
 	if( m_Maximum < Statistics.m_Maximum )
 		m_Maximum	= Statistics.m_Maximum;
 
+	if( Get_Histogram_Count() > 0 && Get_Histogram_Count() == Statistics.Get_Histogram_Count()
+	&&  m_Hist_Minimum == Statistics.m_Hist_Minimum && m_Hist_Width == Statistics.m_Hist_Width )
+	{
+		for(int i=0; i<Get_Histogram_Count(); i++)
+		{
+			((sLong *)m_Histogram.Get_Array())[i]	+= Statistics.Get_Histogram_Class(i);
+		}
+	}
+	else
+	{
+		m_Histogram.Destroy();	// incompatible class layouts
+	}
+
 	m_Kurtosis		= 0.0;
 	m_Skewness		= 0.0;
 
@@ -488,6 +542,13 @@ void CSG_Simple_Statistics::Add_Value(double Value, double Weight)
 		((double *)m_Values.Get_Array())[m_nValues]	= Value;
 	}
 
+	if( m_Histogram.Get_Size() > 0 )
+	{
+		double	d	= (Value - m_Hist_Minimum) / m_Hist_Width;
+
+		((sLong *)m_Histogram.Get_Array())[d <= 0.0 ? 0 : d >= Get_Histogram_Count() ? Get_Histogram_Count() - 1 : (int)d]++;
+	}
+
 	m_nValues++;
 }
 
@@ -547,6 +608,9 @@ double CSG_Simple_Statistics::Get_SkewnessPearson(void)
   * A percentage of 50 returns the median. Remark:
   * Quantile calculation is only possible, if statistics
   * has been created with the bHoldValues option set to true.
+  * Otherwise, if a histogram has been collected (see
+  * Set_Histogram()), the quantile is linearly interpolated
+  * within the class it falls into.
 */
 double CSG_Simple_Statistics::Get_Quantile(double Quantile)
 {
@@ -562,6 +626,31 @@ double CSG_Simple_Statistics::Get_Quantile(double Quantile)
 		return( Get_Value((sLong)(0.5 + (m_Values.Get_Size() - 1) * Quantile / 100.0)) );
 	}
 
+	if( Get_Histogram_Count() > 0 && m_nValues > 0 )
+	{
+		double	Rank	= m_nValues * (Quantile < 0.0 ? 0.0 : Quantile > 100.0 ? 1.0 : Quantile / 100.0);
+
+		sLong	nSum	= 0;
+
+		for(int i=0; i<Get_Histogram_Count(); i++)
+		{
+			sLong	n	= Get_Histogram_Class(i);
+
+			if( n > 0 && nSum + n >= Rank )
+			{
+				double	z	= Get_Histogram_Value(i) + m_Hist_Width * (Rank - nSum) / n;
+
+				return( z < m_Minimum ? m_Minimum : z > m_Maximum ? m_Maximum : z );
+			}
+
+			nSum	+= n;
+		}
+
+		return( m_Maximum );
+	}
+
+	if( m_bEvaluated < 1 )	_Evaluate(1);
+
 	return( m_Mean );
 }
 
@@ -417,6 +417,7 @@ SAGA_API_DLL_EXPORT CSG_Matrix	operator *			(double Scalar, const CSG_Matrix &Ma
 //---------------------------------------------------------
 SAGA_API_DLL_EXPORT bool		SG_Matrix_LU_Decomposition	(int n,       int *Permutation,       double **Matrix                , bool bSilent = true, int *nRowChanges = NULL);
 SAGA_API_DLL_EXPORT bool		SG_Matrix_LU_Solve			(int n, const int *Permutation, const double **Matrix, double *Vector, bool bSilent = true);
+SAGA_API_DLL_EXPORT bool		SG_Matrix_LU_Solve			(int n, const int *Permutation, const double **Matrix, double **Vectors, int nVectors, bool bSilent = true);
 
 SAGA_API_DLL_EXPORT bool		SG_Matrix_Solve				(CSG_Matrix &Matrix, CSG_Vector &Vector, bool bSilent = true);
 SAGA_API_DLL_EXPORT bool		SG_Matrix_Eigen_Reduction	(const CSG_Matrix &Matrix, CSG_Matrix &Eigen_Vectors, CSG_Vector &Eigen_Values, bool bSilent = true);
@@ -579,6 +580,11 @@ public:
 	double						Get_Median			(void)		{	return( Get_Quantile(50.0) );	}
 	double						Get_Quantile		(double Quantile);
 
+	bool						Set_Histogram		(int nClasses, double Minimum, double Maximum);
+	int							Get_Histogram_Count	(void)	const	{	return( (int)m_Histogram.Get_Size() );	}
+	sLong						Get_Histogram_Class	(int i)	const	{	return( i >= 0 && i < Get_Histogram_Count() ? ((sLong *)m_Histogram.Get_Array())[i] : 0 );	}
+	double						Get_Histogram_Value	(int i)	const	{	return( m_Hist_Minimum + i * m_Hist_Width );	}
+
 	void						Add					(const CSG_Simple_Statistics &Statistics);
 
 	void						Add_Value			(double Value, double Weight = 1.0);
@@ -602,7 +608,9 @@ protected:
 
 	double						m_Weights, m_Sum, m_Sum2, m_Minimum, m_Maximum, m_Range, m_Mean, m_Variance, m_StdDev, m_Kurtosis, m_Skewness;
 
-	CSG_Array					m_Values;
+	double						m_Hist_Minimum, m_Hist_Width;
+
+	CSG_Array					m_Values, m_Histogram;
 
 
 	void						_Evaluate			(int Level = 1);
@@ -1498,6 +1506,12 @@ public:
 	double						Get_Value			(double *Values, int nValues)	const;
 	double						Get_Value			(SG_Char *Arguments, ...)		const;
 
+	/// Evaluates the formula for nValues sets of variables at once. Inputs[i] points to the nValues values of variable 'a' + i,
+	/// only the first nInputs entries are read. A NULL entry or a variable beyond nInputs takes the value given with Set_Variable().
+	/// If a NoData mask is supplied, it keeps its flags and additionally flags each element with a non-finite result.
+	/// Results must not overlap with any of the inputs.
+	bool						Get_Values			(const double **Inputs, int nInputs, double *Values, int nValues, bool *bNoData = NULL)	const;
+
 	const SG_Char *				Get_Used_Variables	(void);
 
 
@@ -1522,11 +1536,30 @@ private:
 	}
 	TMAT_Formula;
 
+	//-----------------------------------------------------
+	typedef struct
+	{
+		int						Type, Index;		// register, constant or variable
+	}
+	TMAT_Operand;
+
+	typedef struct
+	{
+		int						Code, Result;
+		TSG_PFNC_Formula_1		Function;
+		TMAT_Operand			Args[3];
+	}
+	TMAT_Operation;
+
 
 	//-----------------------------------------------------
 	bool						m_bError, m_Vars_Used[256];
 
-	int							m_Error_Position, m_Length;
+	int							m_Error_Position, m_Length, m_nRegisters;
+
+	TMAT_Operand				m_Result;
+
+	CSG_Array					m_Program, m_Constants;
 
 	TMAT_Formula				m_Formula;
 
@@ -1553,6 +1586,8 @@ private:
 
 	TMAT_Formula				_Translate			(const SG_Char *source, const SG_Char *args, int *length, int *error);
 
+	bool						_Compile			(void);
+
 	int							max_size(const SG_Char *source);
 	SG_Char *					my_strtok(SG_Char *s);
 	SG_Char *					i_trans(SG_Char *function, SG_Char *begin, SG_Char *end);
@@ -232,12 +232,22 @@ CSG_String CSG_Module::Get_MenuPath(bool bSolved)
 //---------------------------------------------------------
 bool CSG_Module::Execute(void)
 {
-	if( m_bExecutes )
+	bool	bExecutes;
+
+	#pragma omp critical (module_executes)	// a running tool might call this tool from another thread
 	{
-		return( false );
+		if( (bExecutes = m_bExecutes) == false )
+		{
+			m_bExecutes	= true;
+		}
 	}
 
-	m_bExecutes	= true;
+	if( bExecutes )	// parameters are owned by the running instance, don't touch them
+	{
+		SG_UI_Msg_Add_Error(CSG_String::Format(SG_T("%s: %s"), Get_Name().c_str(), _TL("tool is busy, it is already being executed")));
+
+		return( false );
+	}
 
 	Destroy();
 
@@ -295,7 +305,10 @@ bool CSG_Module::Execute(void)
 	SG_UI_Process_Set_Ready();
 	SG_UI_Process_Set_Okay();
 
-	m_bExecutes	= false;
+	#pragma omp critical (module_executes)
+	{
+		m_bExecutes	= false;
+	}
 
 	return( bResult );
 }
@@ -569,6 +569,85 @@ protected:
 };
 
 
+///////////////////////////////////////////////////////////
+//														 //
+//					CSG_Module_Schedule					 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+SAGA_API_DLL_EXPORT void		SG_Set_Max_Num_Workers		(int nWorkers);
+SAGA_API_DLL_EXPORT int			SG_Get_Max_Num_Workers		(void);
+
+//---------------------------------------------------------
+/**
+  * CSG_Module_Schedule runs a sequence of tasks (e.g. the tool
+  * calls of a script or a model) as a data flow graph. A task
+  * depends on each preceding task, that writes data it reads
+  * or writes, that reads data it writes, that shares the same
+  * resource (e.g. a tool instance), or that is a barrier.
+  * Tasks that are ready are executed by a bounded number of
+  * workers, the OpenMP threads given by SG_Get_Max_Num_Threads_Omp()
+  * are split among the workers. Task execution is implemented
+  * by overriding On_Run_Task(), which is called without holding
+  * the schedule's lock. Use Lock() and Unlock() to protect code
+  * that must not run concurrently with other tasks.
+*/
+//---------------------------------------------------------
+class SAGA_API_DLL_EXPORT CSG_Module_Schedule
+{
+public:
+	CSG_Module_Schedule(void);
+	virtual ~CSG_Module_Schedule(void);
+
+	void						Destroy					(void);
+
+	int							Add_Task				(const CSG_String &Name, const CSG_Strings &Input, const CSG_Strings &Output, void *pResource = NULL, bool bBarrier = false);
+
+	int							Get_Count				(void)	const	{	return( m_nTasks );	}
+
+	const CSG_String &			Get_Name				(int iTask)	const;
+	double						Get_Time				(int iTask)	const;
+	int							Get_Worker				(int iTask)	const;
+
+	bool						Execute					(int nWorkers = 0);
+
+	int							Get_Workers				(void)	const	{	return( m_nWorkers );	}
+	double						Get_Time				(void)	const	{	return( m_Time     );	}
+
+	CSG_String					Get_Report				(void)	const;
+
+
+protected:
+
+	virtual bool				On_Run_Task				(int iTask)	= 0;
+
+	void						Lock					(void);
+	void						Unlock					(void);
+
+	int							Get_Running				(void)	const	{	return( m_nRunning );	}
+
+
+private:
+
+	int							m_nTasks, m_nWorkers, m_nRunning;
+
+	double						m_Time;
+
+	void						*m_pLock;
+
+	class CSG_Module_Schedule_Task	**m_pTasks;
+
+
+	bool						_Get_Dependencies		(void);
+
+	int							_Get_Ready				(void)	const;
+
+	bool						_Run_Task				(int iTask, int iWorker);
+
+};
+
+
 ///////////////////////////////////////////////////////////
 //														 //
 //			Module Library Interface Definitions		 //
@@ -65,6 +65,8 @@
 
 #include "module_chain.h"
 
+#include <vector>
+
 
 ///////////////////////////////////////////////////////////
 //														 //
@@ -321,7 +323,75 @@ int CSG_Module_Chain::On_Parameters_Enable(CSG_Parameters *pParameters, CSG_Para
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-bool CSG_Module_Chain::On_Execute(void)
+class CSG_Module_Chain_Schedule : public CSG_Module_Schedule
+{
+public:
+	CSG_Module_Chain_Schedule(CSG_Module_Chain *pChain)	: m_pChain(pChain)	{}
+
+	//-----------------------------------------------------
+	bool					Add_Tool		(const CSG_MetaData &Tool)
+	{
+		CSG_Strings	Input, Output;	CSG_Module	*pModule	= NULL;
+
+		if( Tool.Cmp_Name("tool") )	// conditional branches are treated as barriers
+		{
+			for(int i=0; i<Tool.Get_Children_Count(); i++)
+			{
+				if( Tool[i].Cmp_Name("input" ) )	{	Input	+= Tool[i].Get_Content();	}
+				if( Tool[i].Cmp_Name("output") )	{	Output	+= Tool[i].Get_Content();	}
+			}
+
+			if( Tool.Get_Property("library") && Tool.Get_Property("module") )
+			{
+				pModule	= SG_Get_Module_Library_Manager().Get_Module(Tool.Get_Property("library"), Tool.Get_Property("module"));
+			}
+		}
+
+		m_Tools.push_back(&Tool);
+
+		return( Add_Task(pModule ? pModule->Get_Name() : Tool.Get_Name(), Input, Output, pModule, pModule == NULL) >= 0 );
+	}
+
+
+protected:
+
+	//-----------------------------------------------------
+	virtual bool			On_Run_Task		(int iTask)
+	{
+		const CSG_MetaData	&Tool	= *m_Tools[iTask];
+
+		if( !Tool.Cmp_Name("tool") )
+		{
+			Lock();	bool bResult = m_pChain->Tool_Run(Tool);	Unlock();
+
+			return( bResult );
+		}
+
+		Lock();	CSG_Module	*pModule	= m_pChain->Tool_Begin(Tool);	Unlock();
+
+		if( !pModule )
+		{
+			return( false );
+		}
+
+		bool	bResult	= m_pChain->Tool_Execute(pModule);	// the only step that runs concurrently to other tools
+
+		Lock();	m_pChain->Tool_End(Tool, pModule);	Unlock();
+
+		return( bResult );
+	}
+
+
+private:
+
+	CSG_Module_Chain					*m_pChain;
+
+	std::vector<const CSG_MetaData *>	m_Tools;
+
+};
+
+//---------------------------------------------------------
+bool CSG_Module_Chain::On_Execute(void)
 {
 	bool	bResult	= Data_Initialize();
 
@@ -329,10 +399,21 @@ bool CSG_Module_Chain::On_Execute(void)
 	{
 		Error_Set(_TL("no data objects"));
 	}
-
-	for(int i=0; bResult && i<m_Chain["tools"].Get_Children_Count(); i++)
+	else
 	{
-		bResult	= Tool_Run(m_Chain["tools"][i]);
+		CSG_Module_Chain_Schedule	Schedule(this);
+
+		for(int i=0; bResult && i<m_Chain["tools"].Get_Children_Count(); i++)
+		{
+			bResult	= Schedule.Add_Tool(m_Chain["tools"][i]);
+		}
+
+		bResult	= bResult && Schedule.Execute();
+
+		if( Schedule.Get_Workers() > 1 )
+		{
+			Message_Add(CSG_String::Format("\n%s", Schedule.Get_Report().c_str()), false);
+		}
 	}
 
 	Data_Finalize();
@@ -666,12 +747,30 @@ bool CSG_Module_Chain::Tool_Run(const CSG_MetaData &Tool)
 		return( bResult );
 	}
 
+	//-----------------------------------------------------
+	CSG_Module	*pModule	= Tool_Begin(Tool);
+
+	if( !pModule )
+	{
+		return( false );
+	}
+
+	bool	bResult	= Tool_Execute(pModule);
+
+	Tool_End(Tool, pModule);
+
+	return( bResult );
+}
+
+//---------------------------------------------------------
+CSG_Module * CSG_Module_Chain::Tool_Begin(const CSG_MetaData &Tool)
+{
 	//-----------------------------------------------------
 	if( !Tool.Cmp_Name("tool") || !Tool.Get_Property("library") || !Tool.Get_Property("module") )
 	{
 		Error_Set(_TL("invalid tool definition"));
 
-		return( false );
+		return( NULL );
 	}
 
 	//-----------------------------------------------------
@@ -683,7 +782,7 @@ bool CSG_Module_Chain::Tool_Run(const CSG_MetaData &Tool)
 	{
 		Error_Fmt("%s [%s].[%s]", _TL("could not find tool"),  Tool.Get_Property("library"), Module.c_str());
 
-		return( false );
+		return( NULL );
 	}
 
 	//-----------------------------------------------------
@@ -698,20 +797,40 @@ bool CSG_Module_Chain::Tool_Run(const CSG_MetaData &Tool)
 	{
 		Error_Fmt("%s [%s].[%s]", _TL("before tool execution check failed"), pModule->Get_Library().c_str(), pModule->Get_Name().c_str());
 	}
-	else if( !Tool_Initialize(Tool, pModule) )
+	else if( !(bResult = Tool_Initialize(Tool, pModule)) )
 	{
 		Error_Fmt("%s [%s].[%s]", _TL("tool initialization failed"        ), pModule->Get_Library().c_str(), pModule->Get_Name().c_str());
 	}
-	else if( !(bResult = pModule->Execute()) )
+
+	if( !bResult )
+	{
+		Tool_End(Tool, pModule);
+
+		return( NULL );
+	}
+
+	return( pModule );
+}
+
+//---------------------------------------------------------
+bool CSG_Module_Chain::Tool_Execute(CSG_Module *pModule)
+{
+	if( !pModule->Execute() )
 	{
 		Error_Fmt("%s [%s].[%s]", _TL("tool execution failed"             ), pModule->Get_Library().c_str(), pModule->Get_Name().c_str());
+
+		return( false );
 	}
 
+	return( true );
+}
+
+//---------------------------------------------------------
+void CSG_Module_Chain::Tool_End(const CSG_MetaData &Tool, CSG_Module *pModule)
+{
 	Tool_Finalize(Tool, pModule);
 
 	pModule->Settings_Pop();
-
-	return( bResult );
 }
 
 
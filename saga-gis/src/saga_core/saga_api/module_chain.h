@@ -88,6 +88,8 @@
 //---------------------------------------------------------
 class SAGA_API_DLL_EXPORT CSG_Module_Chain : public CSG_Module
 {
+	friend class CSG_Module_Chain_Schedule;
+
 public:
 	CSG_Module_Chain(void);
 	virtual ~CSG_Module_Chain(void);
@@ -132,6 +134,9 @@ private:
 	bool						Check_Condition			(const CSG_MetaData &Condition, CSG_Parameters *pData);
 
 	bool						Tool_Run				(const CSG_MetaData &Tool);
+	CSG_Module *				Tool_Begin				(const CSG_MetaData &Tool);
+	bool						Tool_Execute			(CSG_Module *pModule);
+	void						Tool_End				(const CSG_MetaData &Tool, CSG_Module *pModule);
 	bool						Tool_Check_Condition	(const CSG_MetaData &Tool);
 	bool						Tool_Get_Parameter		(const CSG_MetaData &Parameter, CSG_Module *pModule, CSG_Parameter **ppParameter, CSG_Parameter **ppParameters);
 	bool						Tool_Initialize			(const CSG_MetaData &Tool, CSG_Module *pModule);
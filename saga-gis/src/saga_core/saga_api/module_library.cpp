@@ -65,6 +65,7 @@
 //---------------------------------------------------------
 #include <wx/dynlib.h>
 #include <wx/dir.h>
+#include <wx/filefn.h>
 #include <wx/filename.h>
 #include <wx/utils.h>
 
@@ -326,9 +327,108 @@ CSG_String CSG_Module_Library::Get_Menu(int i) const
 //														 //
 ///////////////////////////////////////////////////////////
 
+//---------------------------------------------------------
+#ifdef _OPENMP
+#include <omp.h>
+
+//---------------------------------------------------------
+// Libraries might be looked up and loaded on demand by tools,
+// that are executed in parallel and call other tools. The
+// lock is recursive, because loading a tool chain looks up
+// the tools it uses. It is defined before the global library
+// manager to be destroyed after it.
+
+class CSG_Module_Library_Manager_Lock
+{
+public:
+	CSG_Module_Library_Manager_Lock(void)	{	omp_init_nest_lock   (&m_Lock);	}
+	~CSG_Module_Library_Manager_Lock(void)	{	omp_destroy_nest_lock(&m_Lock);	}
+
+	omp_nest_lock_t		m_Lock;
+};
+
+static CSG_Module_Library_Manager_Lock	g_Module_Library_Manager_Lock;
+
+//---------------------------------------------------------
+class CSG_Module_Library_Manager_Guard
+{
+public:
+	CSG_Module_Library_Manager_Guard(void)	{	omp_set_nest_lock  (&g_Module_Library_Manager_Lock.m_Lock);	}
+	~CSG_Module_Library_Manager_Guard(void)	{	omp_unset_nest_lock(&g_Module_Library_Manager_Lock.m_Lock);	}
+};
+
+#define LIBRARY_MANAGER_LOCK	CSG_Module_Library_Manager_Guard	Guard
+
+#else
+#define LIBRARY_MANAGER_LOCK
+#endif
+
 //---------------------------------------------------------
 CSG_Module_Library_Manager		g_Module_Library_Manager;
 
+//---------------------------------------------------------
+// The manifest lists each library file found by deferred
+// directory scans together with its time stamp, library
+// name and tool identifiers. Files that did not change
+// since the manifest was written are only registered and
+// get loaded not before a library or tool is requested.
+//---------------------------------------------------------
+class CSG_Module_Library_Manifest
+{
+public:
+	CSG_Module_Library_Manifest(void)
+	{
+		m_bModified	= false;
+
+		m_Entries.Set_Name("SAGA_MANIFEST");
+		m_Entries.Add_Property("VERSION", SAGA_VERSION);
+	}
+
+	//-----------------------------------------------------
+	static CSG_String	Get_Stamp	(const CSG_String &File)
+	{
+		wxFileName	fn(File.c_str());
+
+		return( CSG_String::Format(SG_T("%.0f:%.0f"), (double)fn.GetModificationTime().GetTicks(), fn.GetSize().ToDouble()) );
+	}
+
+	//-----------------------------------------------------
+	static CSG_MetaData *	Find	(const CSG_MetaData &List, const CSG_String &File)
+	{
+		for(int i=0; i<List.Get_Children_Count(); i++)
+		{
+			if( List[i].Cmp_Property("FILE", File) )
+			{
+				return( List.Get_Child(i) );
+			}
+		}
+
+		return( NULL );
+	}
+
+	//-----------------------------------------------------
+	static bool			has_Module	(const CSG_MetaData &Entry, const CSG_String &Module)
+	{
+		for(int i=0; i<Entry.Get_Children_Count(); i++)
+		{
+			if( Entry[i].Cmp_Property("ID", Module) || !Entry[i].Get_Content().Cmp(Module) )
+			{
+				return( true );
+			}
+		}
+
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	bool				m_bModified;
+
+	CSG_String			m_File;
+
+	CSG_MetaData		m_Cache, m_Entries, m_Deferred;
+
+};
+
 //---------------------------------------------------------
 CSG_Module_Library_Manager &	SG_Get_Module_Library_Manager	(void)
 {
@@ -346,6 +446,8 @@ CSG_Module_Library_Manager::CSG_Module_Library_Manager(void)
 	m_pLibraries	= NULL;
 	m_nLibraries	= 0;
 
+	m_pManifest		= NULL;
+
 	if( this == &g_Module_Library_Manager )
 	{
 		CSG_Random::Initialize();	// initialize with current time on startup
@@ -366,6 +468,8 @@ CSG_Module_Library_Manager::~CSG_Module_Library_Manager(void)
 //---------------------------------------------------------
 CSG_Module_Library * CSG_Module_Library_Manager::Add_Library(const SG_Char *File_Name)
 {
+	LIBRARY_MANAGER_LOCK;
+
 	//-----------------------------------------------------
 	if( !SG_File_Cmp_Extension(File_Name, SG_T("mlb"  ))
 	&&	!SG_File_Cmp_Extension(File_Name, SG_T("dll"  ))
@@ -411,8 +515,13 @@ CSG_Module_Library * CSG_Module_Library_Manager::Add_Library(const SG_Char *File
 }
 
 //---------------------------------------------------------
-int CSG_Module_Library_Manager::Add_Directory(const SG_Char *Directory, bool bOnlySubDirectories)
+int CSG_Module_Library_Manager::Add_Directory(const SG_Char *Directory, bool bOnlySubDirectories, bool bDeferred)
 {
+	if( bDeferred && !m_pManifest )
+	{
+		m_pManifest	= new CSG_Module_Library_Manifest;
+	}
+
 	int		nOpened	= 0;
 	wxDir	Dir;
 
@@ -424,7 +533,9 @@ int CSG_Module_Library_Manager::Add_Directory(const SG_Char *Directory, bool bOn
 		{
 			do
 			{	if( File_Name.Find("saga_") < 0 && File_Name.Find("wx") < 0 )
-				if( Add_Library(SG_File_Make_Path(Dir.GetName(), File_Name, NULL)) )
+				if( bDeferred
+				?	_Add_Deferred(SG_File_Make_Path(Dir.GetName(), File_Name, NULL))
+				:	 Add_Library (SG_File_Make_Path(Dir.GetName(), File_Name, NULL)) != NULL )
 				{
 					nOpened++;
 				}
@@ -438,7 +549,7 @@ int CSG_Module_Library_Manager::Add_Directory(const SG_Char *Directory, bool bOn
 			{
 				if( File_Name.CmpNoCase("dll") )
 				{
-					nOpened	+= Add_Directory(SG_File_Make_Path(Dir.GetName(), File_Name, NULL), false);
+					nOpened	+= Add_Directory(SG_File_Make_Path(Dir.GetName(), File_Name, NULL), false, bDeferred);
 				}
 			}
 			while( Dir.GetNext(&File_Name) );
@@ -449,6 +560,185 @@ int CSG_Module_Library_Manager::Add_Directory(const SG_Char *Directory, bool bOn
 }
 
 
+///////////////////////////////////////////////////////////
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CSG_Module_Library_Manager::Open_Manifest(const CSG_String &File)
+{
+	if( !m_pManifest )
+	{
+		m_pManifest	= new CSG_Module_Library_Manifest;
+	}
+
+	m_pManifest->m_File	= File;
+
+	if( !m_pManifest->m_Cache.Load(File) || !m_pManifest->m_Cache.Cmp_Property("VERSION", SAGA_VERSION) )
+	{
+		m_pManifest->m_Cache.Destroy();	// no or outdated manifest, all libraries will be probed
+	}
+
+	return( true );
+}
+
+//---------------------------------------------------------
+bool CSG_Module_Library_Manager::Save_Manifest(void)
+{
+	if( !m_pManifest || m_pManifest->m_File.is_Empty() )
+	{
+		return( false );
+	}
+
+	if( !m_pManifest->m_bModified && m_pManifest->m_Entries.Get_Children_Count() == m_pManifest->m_Cache.Get_Children_Count() )
+	{
+		return( true );	// nothing changed
+	}
+
+	//-----------------------------------------------------
+	// several processes might start at the same time, so
+	// write to a process specific file and rename it then
+
+	CSG_String	File	= CSG_String::Format(SG_T("%s.%lu"), m_pManifest->m_File.c_str(), (unsigned long)wxGetProcessId());
+
+	if( m_pManifest->m_Entries.Save(File) && wxRenameFile(File.c_str(), m_pManifest->m_File.c_str(), true) )
+	{
+		m_pManifest->m_Cache		= m_pManifest->m_Entries;
+		m_pManifest->m_bModified	= false;
+
+		return( true );
+	}
+
+	SG_File_Delete(File);
+
+	return( false );
+}
+
+//---------------------------------------------------------
+int CSG_Module_Library_Manager::Get_Deferred_Count(void) const
+{
+	return( m_pManifest ? m_pManifest->m_Deferred.Get_Children_Count() : 0 );
+}
+
+//---------------------------------------------------------
+int CSG_Module_Library_Manager::Load_Deferred(void)
+{
+	LIBRARY_MANAGER_LOCK;
+
+	int		nLoaded	= 0;
+
+	while( Get_Deferred_Count() > 0 )
+	{
+		CSG_String	File(m_pManifest->m_Deferred[0].Get_Property("FILE"));
+
+		m_pManifest->m_Deferred.Del_Child(0);
+
+		if( Add_Library(File) )
+		{
+			nLoaded++;
+		}
+	}
+
+	return( nLoaded );
+}
+
+//---------------------------------------------------------
+bool CSG_Module_Library_Manager::_Add_Deferred(const CSG_String &File_Name)
+{
+	if( !SG_File_Cmp_Extension(File_Name, SG_T("mlb"  ))
+	&&	!SG_File_Cmp_Extension(File_Name, SG_T("dll"  ))
+	&&	!SG_File_Cmp_Extension(File_Name, SG_T("so"   ))
+	&&	!SG_File_Cmp_Extension(File_Name, SG_T("dylib"))
+	&&	!SG_File_Cmp_Extension(File_Name, SG_T("xml"  )) )
+	{
+		return( false );
+	}
+
+	CSG_String	File(SG_File_Get_Path_Absolute(File_Name)), Stamp(CSG_Module_Library_Manifest::Get_Stamp(File));
+
+	if( CSG_Module_Library_Manifest::Find(m_pManifest->m_Entries, File) )
+	{
+		return( false );	// has already been registered
+	}
+
+	//-----------------------------------------------------
+	CSG_MetaData	*pEntry	= CSG_Module_Library_Manifest::Find(m_pManifest->m_Cache, File);
+
+	if( pEntry && pEntry->Cmp_Property("STAMP", Stamp) )
+	{
+		m_pManifest->m_Entries.Add_Child(*pEntry);
+
+		if( !pEntry->Cmp_Property("LIBRARY", "") )
+		{
+			m_pManifest->m_Deferred.Add_Child(*pEntry);
+
+			return( true );
+		}
+
+		return( false );	// not a tool library
+	}
+
+	//-----------------------------------------------------
+	// new or modified file, load it now and describe it
+
+	m_pManifest->m_bModified	= true;
+
+	pEntry	= m_pManifest->m_Entries.Add_Child("LIBRARY");
+
+	pEntry->Add_Property("FILE" , File );
+	pEntry->Add_Property("STAMP", Stamp);
+
+	CSG_Module_Library	*pLibrary	= Add_Library(File);
+
+	pEntry->Add_Property("LIBRARY", pLibrary ? pLibrary->Get_Library_Name() : CSG_String(""));
+	pEntry->Add_Property("NAME"   , pLibrary ? pLibrary->Get_Name        () : CSG_String(""));
+
+	if( pLibrary )
+	{
+		wxFileName	fn(File.c_str());
+
+		for(int i=0; i<pLibrary->Get_Count(); i++)
+		{
+			CSG_Module	*pModule	= pLibrary->Get_Module(i);
+
+			if( pModule && (pLibrary->Get_Type() != MODULE_CHAINS	// chain libraries collect the tools of several files
+			||  fn == ((CSG_Module_Chain *)pModule)->Get_File_Name().c_str()) )
+			{
+				pEntry->Add_Child("TOOL", pModule->Get_Name())->Add_Property("ID", pModule->Get_ID());
+			}
+		}
+	}
+
+	return( pLibrary != NULL );
+}
+
+//---------------------------------------------------------
+int CSG_Module_Library_Manager::_Load_Deferred(const CSG_String &Name, bool bLibrary, const CSG_String &Module)
+{
+	int		nLoaded	= 0;
+
+	for(int i=Get_Deferred_Count()-1; i>=0; i--)
+	{
+		CSG_MetaData	&Entry	= *m_pManifest->m_Deferred.Get_Child(i);
+
+		if( Entry.Cmp_Property(bLibrary ? "LIBRARY" : "NAME", Name)
+		&&  (Module.is_Empty() || CSG_Module_Library_Manifest::has_Module(Entry, Module)) )
+		{
+			CSG_String	File(Entry.Get_Property("FILE"));
+
+			m_pManifest->m_Deferred.Del_Child(i);
+
+			if( Add_Library(File) )
+			{
+				nLoaded++;
+			}
+		}
+	}
+
+	return( nLoaded );
+}
+
+
 ///////////////////////////////////////////////////////////
 //														 //
 ///////////////////////////////////////////////////////////
@@ -586,6 +876,13 @@ bool CSG_Module_Library_Manager::Destroy(void)
 		m_nLibraries	= 0;
 	}
 
+	if( m_pManifest )
+	{
+		delete(m_pManifest);
+
+		m_pManifest		= NULL;
+	}
+
 	return( true );
 }
 
@@ -611,6 +908,8 @@ bool CSG_Module_Library_Manager::Del_Library(CSG_Module_Library *pLibrary)
 //---------------------------------------------------------
 bool CSG_Module_Library_Manager::Del_Library(int i)
 {
+	LIBRARY_MANAGER_LOCK;
+
 	if( i >= 0 && i < Get_Count() )
 	{
 		delete(m_pLibraries[i]);
@@ -635,6 +934,19 @@ bool CSG_Module_Library_Manager::Del_Library(int i)
 
 //---------------------------------------------------------
 CSG_Module_Library * CSG_Module_Library_Manager::Get_Library(const SG_Char *Name, bool bLibrary) const
+{
+	LIBRARY_MANAGER_LOCK;
+
+	if( Get_Deferred_Count() > 0 )
+	{
+		((CSG_Module_Library_Manager *)this)->_Load_Deferred(Name, bLibrary);
+	}
+
+	return( _Get_Library(Name, bLibrary) );
+}
+
+//---------------------------------------------------------
+CSG_Module_Library * CSG_Module_Library_Manager::_Get_Library(const CSG_String &Name, bool bLibrary) const
 {
 	for(int i=0; i<Get_Count(); i++)
 	{
@@ -671,17 +983,28 @@ bool CSG_Module_Library_Manager::is_Loaded(CSG_Module_Library *pLibrary) const
 //---------------------------------------------------------
 CSG_Module * CSG_Module_Library_Manager::Get_Module(const CSG_String &Library, int ID)	const
 {
-	CSG_Module_Library	*pLibrary	= Get_Library(Library, true);
-
-	return( pLibrary ? pLibrary->Get_Module(CSG_String::Format("%d", ID)) : NULL );
+	return( Get_Module(Library, CSG_String::Format("%d", ID)) );
 }
 
 //---------------------------------------------------------
 CSG_Module * CSG_Module_Library_Manager::Get_Module(const CSG_String &Library, const CSG_String &Module)	const
 {
-	CSG_Module_Library	*pLibrary	= Get_Library(Library, true);
+	LIBRARY_MANAGER_LOCK;
+
+	if( Get_Deferred_Count() > 0 )	// load only the file providing the tool, if known
+	{
+		((CSG_Module_Library_Manager *)this)->_Load_Deferred(Library, true, Module);
+	}
+
+	CSG_Module_Library	*pLibrary	= _Get_Library(Library, true);
+	CSG_Module			*pModule	= pLibrary ? pLibrary->Get_Module(Module) : NULL;
+
+	if( !pModule && (pLibrary = Get_Library(Library, true)) != NULL )
+	{
+		pModule	= pLibrary->Get_Module(Module);
+	}
 
-	return( pLibrary ? pLibrary->Get_Module(Module) : NULL );
+	return( pModule );
 }
 
 
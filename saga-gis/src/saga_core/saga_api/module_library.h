@@ -188,7 +188,12 @@ public:
 	int								Get_Count			(void)	const	{	return( m_nLibraries );	}
 
 	CSG_Module_Library *			Add_Library			(const SG_Char *File_Name);
-	int								Add_Directory		(const SG_Char *Directory, bool bOnlySubDirectories);
+	int								Add_Directory		(const SG_Char *Directory, bool bOnlySubDirectories, bool bDeferred = false);
+
+	bool							Open_Manifest		(const CSG_String &File);
+	bool							Save_Manifest		(void);
+	int								Get_Deferred_Count	(void)	const;
+	int								Load_Deferred		(void);
 
 	bool							Del_Library			(int i);
 	bool							Del_Library			(CSG_Module_Library *pLibrary);
@@ -211,9 +216,16 @@ private:
 
 	CSG_Module_Library				**m_pLibraries;
 
+	class CSG_Module_Library_Manifest	*m_pManifest;
+
 
 	CSG_Module_Library *			_Add_Module_Chain	(const SG_Char *File_Name);
 
+	bool							_Add_Deferred		(const CSG_String &File_Name);
+	int								_Load_Deferred		(const CSG_String &Name, bool bLibrary, const CSG_String &Module = "");
+
+	CSG_Module_Library *			_Get_Library		(const CSG_String &Name, bool bLibrary)	const;
+
 };
 
 //---------------------------------------------------------
@@ -0,0 +1,583 @@
+/**********************************************************
+ * Version $Id$
+ *********************************************************/
+
+///////////////////////////////////////////////////////////
+//                                                       //
+//                         SAGA                          //
+//                                                       //
+//      System for Automated Geoscientific Analyses      //
+//                                                       //
+//           Application Programming Interface           //
+//                                                       //
+//                  Library: SAGA_API                    //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//                  module_schedule.cpp                  //
+//                                                       //
+//                 Copyright (C) 2015 by                 //
+//                      Olaf Conrad                      //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+// This file is part of 'SAGA - System for Automated     //
+// Geoscientific Analyses'.                              //
+//                                                       //
+// This library is free software; you can redistribute   //
+// it and/or modify it under the terms of the GNU Lesser //
+// General Public License as published by the Free       //
+// Software Foundation, version 2.1 of the License.      //
+//                                                       //
+// This library is distributed in the hope that it will  //
+// be useful, but WITHOUT ANY WARRANTY; without even the //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A  //
+// PARTICULAR PURPOSE. See the GNU Lesser General Public //
+// License for more details.                             //
+//                                                       //
+// You should have received a copy of the GNU Lesser     //
+// General Public License along with this program; if    //
+// not, write to the Free Software Foundation, Inc.,     //
+// 51 Franklin Street, 5th Floor, Boston, MA 02110-1301, //
+// USA.                                                  //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//    e-mail:     oconrad@saga-gis.org                   //
+//                                                       //
+//    contact:    Olaf Conrad                            //
+//                Institute of Geography                 //
+//                University of Hamburg                  //
+//                Germany                                //
+//                                                       //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+#include "module.h"
+#include "datetime.h"
+
+#include <wx/utils.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+int		g_SG_Max_Num_Workers	= 1;
+
+//---------------------------------------------------------
+void	SG_Set_Max_Num_Workers		(int nWorkers)
+{
+	g_SG_Max_Num_Workers	= nWorkers > 1 ? nWorkers : 1;
+}
+
+//---------------------------------------------------------
+int		SG_Get_Max_Num_Workers		(void)
+{
+	return( g_SG_Max_Num_Workers );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+enum
+{
+	TASK_WAITING	= 0,
+	TASK_RUNNING,
+	TASK_FINISHED,
+	TASK_FAILED
+};
+
+//---------------------------------------------------------
+class CSG_Module_Schedule_Task
+{
+public:
+
+	CSG_Module_Schedule_Task(void)	: m_pResource(NULL), m_bBarrier(false), m_State(TASK_WAITING), m_Worker(-1), m_Time(0.)	{}
+
+	CSG_String					m_Name;
+
+	CSG_Strings					m_Input, m_Output;
+
+	void						*m_pResource;
+
+	bool						m_bBarrier;
+
+	int							m_State, m_Worker;
+
+	double						m_Time;
+
+	CSG_Array					m_Depends;
+
+
+	int							Get_Depends_Count		(void)	const	{	return( (int)m_Depends.Get_Size() );	}
+	int							Get_Depends				(int i)	const	{	return( ((int *)m_Depends.Get_Array())[i] );	}
+
+	//-----------------------------------------------------
+	static bool					Intersects				(const CSG_Strings &A, const CSG_Strings &B)
+	{
+		for(int i=0; i<A.Get_Count(); i++)
+		{
+			for(int j=0; j<B.Get_Count(); j++)
+			{
+				if( !A[i].Cmp(B[j]) )
+				{
+					return( true );
+				}
+			}
+		}
+
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	bool						Depends_On				(const CSG_Module_Schedule_Task &Task)	const
+	{
+		return( m_bBarrier || Task.m_bBarrier
+			||  (m_pResource && m_pResource == Task.m_pResource)
+			||  Intersects(m_Input , Task.m_Output)	// read after write
+			||  Intersects(m_Output, Task.m_Input )	// write after read
+			||  Intersects(m_Output, Task.m_Output)	// write after write
+		);
+	}
+};
+
+//---------------------------------------------------------
+static double	SG_Schedule_Get_Time	(void)	// wall clock time in seconds
+{
+#ifdef _OPENMP
+	return( omp_get_wtime() );
+#else
+	return( CSG_DateTime::Now().Get_Value() / 1000. );
+#endif
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+CSG_Module_Schedule::CSG_Module_Schedule(void)
+{
+	m_nTasks	= 0;
+	m_pTasks	= NULL;
+
+	m_nWorkers	= 0;
+	m_nRunning	= 0;
+	m_Time		= 0.;
+
+#ifdef _OPENMP
+	m_pLock		= new omp_nest_lock_t;
+
+	omp_init_nest_lock((omp_nest_lock_t *)m_pLock);
+#else
+	m_pLock		= NULL;
+#endif
+}
+
+//---------------------------------------------------------
+CSG_Module_Schedule::~CSG_Module_Schedule(void)
+{
+	Destroy();
+
+#ifdef _OPENMP
+	omp_destroy_nest_lock((omp_nest_lock_t *)m_pLock);
+
+	delete((omp_nest_lock_t *)m_pLock);
+#endif
+}
+
+//---------------------------------------------------------
+void CSG_Module_Schedule::Destroy(void)
+{
+	for(int i=0; i<m_nTasks; i++)
+	{
+		delete(m_pTasks[i]);
+	}
+
+	SG_FREE_SAFE(m_pTasks);
+
+	m_nTasks	= 0;
+	m_nWorkers	= 0;
+	m_nRunning	= 0;
+	m_Time		= 0.;
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+int CSG_Module_Schedule::Add_Task(const CSG_String &Name, const CSG_Strings &Input, const CSG_Strings &Output, void *pResource, bool bBarrier)
+{
+	CSG_Module_Schedule_Task	**pTasks	= (CSG_Module_Schedule_Task **)SG_Realloc(m_pTasks, (m_nTasks + 1) * sizeof(CSG_Module_Schedule_Task *));
+
+	if( !pTasks )
+	{
+		return( -1 );
+	}
+
+	m_pTasks	= pTasks;
+
+	CSG_Module_Schedule_Task	*pTask	= m_pTasks[m_nTasks]	= new CSG_Module_Schedule_Task;
+
+	pTask->m_Name		= Name;
+	pTask->m_Input		= Input;
+	pTask->m_Output		= Output;
+	pTask->m_pResource	= pResource;
+	pTask->m_bBarrier	= bBarrier;
+
+	pTask->m_Depends.Create(sizeof(int));
+
+	return( m_nTasks++ );
+}
+
+//---------------------------------------------------------
+const CSG_String & CSG_Module_Schedule::Get_Name(int iTask) const
+{
+	static CSG_String	None;
+
+	return( iTask >= 0 && iTask < m_nTasks ? m_pTasks[iTask]->m_Name : None );
+}
+
+//---------------------------------------------------------
+double CSG_Module_Schedule::Get_Time(int iTask) const
+{
+	return( iTask >= 0 && iTask < m_nTasks ? m_pTasks[iTask]->m_Time : 0. );
+}
+
+//---------------------------------------------------------
+int CSG_Module_Schedule::Get_Worker(int iTask) const
+{
+	return( iTask >= 0 && iTask < m_nTasks ? m_pTasks[iTask]->m_Worker : -1 );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+void CSG_Module_Schedule::Lock(void)
+{
+#ifdef _OPENMP
+	omp_set_nest_lock((omp_nest_lock_t *)m_pLock);
+#endif
+}
+
+//---------------------------------------------------------
+void CSG_Module_Schedule::Unlock(void)
+{
+#ifdef _OPENMP
+	omp_unset_nest_lock((omp_nest_lock_t *)m_pLock);
+#endif
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CSG_Module_Schedule::_Get_Dependencies(void)
+{
+	for(int i=0; i<m_nTasks; i++)
+	{
+		CSG_Module_Schedule_Task	*pTask	= m_pTasks[i];
+
+		pTask->m_State	= TASK_WAITING;
+		pTask->m_Worker	= -1;
+		pTask->m_Time	= 0.;
+
+		pTask->m_Depends.Set_Array(0);
+
+		for(int j=0; j<i; j++)	// dependencies only refer to preceding tasks, so the graph is acyclic by construction
+		{
+			if( pTask->Depends_On(*m_pTasks[j]) )
+			{
+				if( pTask->m_Depends.Inc_Array() )
+				{
+					((int *)pTask->m_Depends.Get_Array())[pTask->Get_Depends_Count() - 1]	= j;
+				}
+			}
+		}
+	}
+
+	return( true );
+}
+
+//---------------------------------------------------------
+/**
+  * Returns the first waiting task, whose dependencies all have
+  * been finished, or -1 if there is none. Keeping the original
+  * order as far as possible reproduces sequential behaviour
+  * with a single worker.
+*/
+int CSG_Module_Schedule::_Get_Ready(void) const
+{
+	for(int i=0; i<m_nTasks; i++)
+	{
+		const CSG_Module_Schedule_Task	*pTask	= m_pTasks[i];
+
+		if( pTask->m_State == TASK_WAITING )
+		{
+			bool	bReady	= true;
+
+			for(int j=0; bReady && j<pTask->Get_Depends_Count(); j++)
+			{
+				bReady	= m_pTasks[pTask->Get_Depends(j)]->m_State == TASK_FINISHED;
+			}
+
+			if( bReady )
+			{
+				return( i );
+			}
+		}
+	}
+
+	return( -1 );
+}
+
+//---------------------------------------------------------
+bool CSG_Module_Schedule::_Run_Task(int iTask, int iWorker)
+{
+	CSG_Module_Schedule_Task	*pTask	= m_pTasks[iTask];
+
+	pTask->m_Worker	= iWorker;
+
+	double	Time	= SG_Schedule_Get_Time();
+
+	bool	bResult	= On_Run_Task(iTask);
+
+	pTask->m_Time	= SG_Schedule_Get_Time() - Time;
+
+	return( bResult );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+/**
+  * Executes all tasks. The number of workers defaults to
+  * SG_Get_Max_Num_Workers() and is limited by the number of
+  * tasks and by the OpenMP thread budget, which is divided
+  * among the workers for the tools' own parallelization.
+  * Once a task fails no further tasks are started. Because
+  * the user interface callbacks of the graphical front end
+  * are not thread safe, tasks always run one by one there,
+  * as well as for schedules started from within a worker.
+*/
+bool CSG_Module_Schedule::Execute(int nWorkers)
+{
+	if( m_nTasks < 1 || !_Get_Dependencies() )
+	{
+		return( false );
+	}
+
+	//-----------------------------------------------------
+	if( nWorkers < 1 )
+	{
+		nWorkers	= SG_Get_Max_Num_Workers();
+	}
+
+	if( nWorkers > m_nTasks )
+	{
+		nWorkers	= m_nTasks;
+	}
+
+#ifdef _OPENMP
+	int	nThreads	= SG_Get_Max_Num_Threads_Omp();
+
+	if( nWorkers > nThreads )
+	{
+		nWorkers	= nThreads;
+	}
+
+	if( omp_in_parallel() )	// e.g. a model running as task of another schedule
+	{
+		nWorkers	= 1;
+	}
+#endif
+
+	if( SG_UI_Get_Window_Main() )
+	{
+		nWorkers	= 1;
+	}
+
+	m_nWorkers	= nWorkers > 1 ? nWorkers : 1;
+	m_nRunning	= 0;
+
+	double	Time	= SG_Schedule_Get_Time();
+
+	bool	bResult	= true;
+
+	//-----------------------------------------------------
+	if( m_nWorkers == 1 )
+	{
+		for(int iTask=_Get_Ready(); bResult && iTask>=0; iTask=_Get_Ready())
+		{
+			m_pTasks[iTask]->m_State	= TASK_RUNNING;	m_nRunning	= 1;
+
+			bResult	= _Run_Task(iTask, 0);
+
+			m_pTasks[iTask]->m_State	= bResult ? TASK_FINISHED : TASK_FAILED;	m_nRunning	= 0;
+		}
+	}
+
+	//-----------------------------------------------------
+#ifdef _OPENMP
+	else
+	{
+		int	bNested	= omp_get_nested();
+
+		omp_set_nested(1);
+
+		#pragma omp parallel num_threads(m_nWorkers)
+		{
+			omp_set_num_threads(nThreads / m_nWorkers > 1 ? nThreads / m_nWorkers : 1);	// threads per worker for the tools' own parallel regions
+
+			int		iWorker	= omp_get_thread_num();
+
+			for(bool bDone=false; !bDone; )
+			{
+				int		iTask	= -1;
+
+				Lock();
+
+				if( !bResult || (iTask = _Get_Ready()) < 0 )
+				{
+					bDone	= m_nRunning == 0 || !bResult;	// nothing more to do, or wait for running tasks to release their successors
+				}
+				else
+				{
+					m_pTasks[iTask]->m_State	= TASK_RUNNING;	m_nRunning++;
+				}
+
+				Unlock();
+
+				if( iTask >= 0 )
+				{
+					bool	bTask	= _Run_Task(iTask, iWorker);
+
+					Lock();
+
+					m_pTasks[iTask]->m_State	= bTask ? TASK_FINISHED : TASK_FAILED;	m_nRunning--;
+
+					if( !bTask )
+					{
+						bResult	= false;
+					}
+
+					Unlock();
+				}
+				else if( !bDone )
+				{
+					wxMilliSleep(1);
+				}
+			}
+		}
+
+		omp_set_nested(bNested);
+		omp_set_num_threads(nThreads);
+	}
+#endif
+
+	//-----------------------------------------------------
+	m_Time	= SG_Schedule_Get_Time() - Time;
+
+	for(int i=0; bResult && i<m_nTasks; i++)
+	{
+		bResult	= m_pTasks[i]->m_State == TASK_FINISHED;
+	}
+
+	return( bResult );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+CSG_String CSG_Module_Schedule::Get_Report(void) const
+{
+	CSG_String	Report;
+
+	double	Total	= 0.;
+
+	Report	+= CSG_String::Format("%s\n", _TL("Execution Times"));
+
+	for(int i=0; i<m_nTasks; i++)
+	{
+		const CSG_Module_Schedule_Task	*pTask	= m_pTasks[i];
+
+		if( pTask->m_State == TASK_FINISHED || pTask->m_State == TASK_FAILED )
+		{
+			Report	+= CSG_String::Format("%4d [%d] %10.3fs %s%s\n", i + 1, pTask->m_Worker + 1, pTask->m_Time,
+				pTask->m_Name.c_str(), pTask->m_State == TASK_FAILED ? CSG_String::Format(" (%s)", _TL("failed")).c_str() : SG_T("")
+			);
+
+			Total	+= pTask->m_Time;
+		}
+		else
+		{
+			Report	+= CSG_String::Format("%4d [-] %10s  %s (%s)\n", i + 1, "", pTask->m_Name.c_str(), _TL("not executed"));
+		}
+	}
+
+	Report	+= CSG_String::Format("%s: %.3fs, %s: %.3fs, %s: %d", _TL("total"), Total, _TL("elapsed"), m_Time, _TL("workers"), m_nWorkers);
+
+	if( m_Time > 0. )
+	{
+		Report	+= CSG_String::Format(", %s: %.2f", _TL("speedup"), Total / m_Time);
+	}
+
+	return( Report );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
@@ -609,41 +609,57 @@ CSG_PRQuadTree_Leaf	* CSG_PRQuadTree::_Get_Nearest_Point(CSG_PRQuadTree_Item *pI
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-inline CSG_PRQuadTree::TLeaf * CSG_PRQuadTree::_Get_Selected(const CSG_Array &Selection, size_t i)	const
-{
-	return( (TLeaf *)Selection.Get_Entry(i) );
-}
-
+// The selection of the current search, starting at iFirst,
+// is organized as binary max-heap on distance, so that the
+// farthest of the selected points can be replaced in
+// logarithmic time.
 //---------------------------------------------------------
-inline bool CSG_PRQuadTree::_Add_Selected(CSG_Array &Selection, CSG_PRQuadTree_Leaf *pLeaf, double Distance)	const
+void CSG_PRQuadTree::_Add_Selected(CSG_Array &Selection, size_t iFirst, size_t maxPoints, CSG_PRQuadTree_Leaf *pLeaf, double Distance)	const
 {
-	if( Selection.Inc_Array() )
+	size_t	i, n	= Selection.Get_Size() - iFirst;
+
+	if( n < maxPoints )	// sift up
 	{
-		TLeaf	*pL		= (TLeaf *)Selection.Get_Entry(Selection.Get_Size() - 1);
+		if( !Selection.Inc_Array() )
+		{
+			return;
+		}
 
-		pL->pLeaf		= pLeaf;
-		pL->Distance	= Distance;
+		TLeaf	*pHeap	= _Get_Selected(Selection, iFirst);
 
-		return( true );
+		for(i=n; i>0 && pHeap[(i - 1) / 2].Distance < Distance; i=(i - 1) / 2)
+		{
+			pHeap[i]	= pHeap[(i - 1) / 2];
+		}
+
+		pHeap[i].pLeaf		= pLeaf;
+		pHeap[i].Distance	= Distance;
 	}
+	else				// replace the farthest point and sift down
+	{
+		TLeaf	*pHeap	= _Get_Selected(Selection, iFirst);
 
-	return( false );
-}
+		for(i=0; 2 * i + 1<n; )
+		{
+			size_t	j	= 2 * i + 1;
 
-//---------------------------------------------------------
-inline bool CSG_PRQuadTree::_Set_Selected(CSG_Array &Selection, size_t i, CSG_PRQuadTree_Leaf *pLeaf, double Distance)	const
-{
-	TLeaf	*pL		= (TLeaf *)Selection.Get_Entry(i);
+			if( j + 1 < n && pHeap[j].Distance < pHeap[j + 1].Distance )
+			{
+				j++;
+			}
 
-	if( pL )
-	{
-		pL->pLeaf		= pLeaf;
-		pL->Distance	= Distance;
+			if( pHeap[j].Distance <= Distance )
+			{
+				break;
+			}
 
-		return( true );
-	}
+			pHeap[i]	= pHeap[j];
+			i			= j;
+		}
 
-	return( false );
+		pHeap[i].pLeaf		= pLeaf;
+		pHeap[i].Distance	= Distance;
+	}
 }
 
 
@@ -654,17 +670,33 @@ inline bool CSG_PRQuadTree::_Set_Selected(CSG_Array &Selection, size_t i, CSG_PR
 //---------------------------------------------------------
 size_t CSG_PRQuadTree::Select_Nearest_Points(const TSG_Point &p, size_t maxPoints, double Radius, int iQuadrant)
 {
-	return( Select_Nearest_Points(p.x, p.y, maxPoints, Radius, iQuadrant) );
+	return( Select_Nearest_Points(m_Selection, p.x, p.y, maxPoints, Radius, iQuadrant) );
 }
 
 //---------------------------------------------------------
 size_t CSG_PRQuadTree::Select_Nearest_Points(double x, double y, size_t maxPoints, double Radius, int iQuadrant)
 {
-	return( _Select_Nearest_Points(m_Selection, x, y, maxPoints, Radius, iQuadrant) );
+	return( Select_Nearest_Points(m_Selection, x, y, maxPoints, Radius, iQuadrant) );
 }
 
 //---------------------------------------------------------
-size_t CSG_PRQuadTree::_Select_Nearest_Points(CSG_Array &Selection, double x, double y, size_t maxPoints, double Radius, int iQuadrant)	const
+size_t CSG_PRQuadTree::Select_Nearest_Points(CSG_Array &Selection, const TSG_Point &p, size_t maxPoints, double Radius, int iQuadrant)	const
+{
+	return( Select_Nearest_Points(Selection, p.x, p.y, maxPoints, Radius, iQuadrant) );
+}
+
+//---------------------------------------------------------
+/**
+  * Selects the maxPoints nearest points (all points, if maxPoints
+  * is zero) within Radius (unlimited, if Radius is zero). With
+  * iQuadrant set to 4 the search is performed for each quadrant,
+  * selecting up to maxPoints per quadrant. The result is stored in
+  * the supplied Selection buffer and can be queried with the
+  * Get_Selected_...() functions taking this buffer as argument.
+  * This function does not modify the search tree and can safely
+  * be called from multiple threads, each using its own buffer.
+*/
+size_t CSG_PRQuadTree::Select_Nearest_Points(CSG_Array &Selection, double x, double y, size_t maxPoints, double Radius, int iQuadrant)	const
 {
 	if( Selection.Get_Value_Size() != sizeof(TLeaf) )
 	{
@@ -686,13 +718,13 @@ size_t CSG_PRQuadTree::_Select_Nearest_Points(CSG_Array &Selection, double x, do
 
 		if( iQuadrant != 4 )
 		{
-			_Select_Nearest_Points(Selection, m_pRoot, x, y, Distance = 0.0, Radius, maxPoints, iQuadrant);
+			_Select_Nearest_Points(Selection, 0, m_pRoot, x, y, Distance = 0.0, Radius, maxPoints, iQuadrant);
 		}
 		else // if( iQuadrant == 4 )	// quadrant-wise search
 		{
 			for(iQuadrant=0; iQuadrant<4; iQuadrant++)
 			{
-				_Select_Nearest_Points(Selection, m_pRoot, x, y, Distance = 0.0, Radius, maxPoints, iQuadrant);
+				_Select_Nearest_Points(Selection, Selection.Get_Size(), m_pRoot, x, y, Distance = 0.0, Radius, maxPoints, iQuadrant);
 			}
 		}
 	}
@@ -701,7 +733,7 @@ size_t CSG_PRQuadTree::_Select_Nearest_Points(CSG_Array &Selection, double x, do
 }
 
 //---------------------------------------------------------
-void CSG_PRQuadTree::_Select_Nearest_Points(CSG_Array &Selection, CSG_PRQuadTree_Item *pItem, double x, double y, double &Distance, double Radius, size_t maxPoints, int iQuadrant)	const
+void CSG_PRQuadTree::_Select_Nearest_Points(CSG_Array &Selection, size_t iFirst, CSG_PRQuadTree_Item *pItem, double x, double y, double &Distance, double Radius, size_t maxPoints, int iQuadrant)	const
 {
 	//-----------------------------------------------------
 	if( pItem->is_Leaf() )
@@ -721,36 +753,11 @@ void CSG_PRQuadTree::_Select_Nearest_Points(CSG_Array &Selection, CSG_PRQuadTree
 		}
 
 		//-------------------------------------------------
-		if( Selection.Get_Size() < maxPoints )
-		{
-			if( Distance < d )
-			{
-				Distance	= d;
-			}
-
-			_Add_Selected(Selection, pLeaf, d);
-		}
-		else if( d < Distance )
+		if( Selection.Get_Size() - iFirst < maxPoints || d < Distance )
 		{
-			size_t	i;
+			_Add_Selected(Selection, iFirst, maxPoints, pLeaf, d);
 
-			for(i=0; i<Selection.Get_Size(); i++)
-			{
-				if( Distance <= _Get_Selected(Selection, i)->Distance )
-				{
-					_Set_Selected(Selection, i, pLeaf, d);
-
-					break;
-				}
-			}
-
-			for(i=0, Distance=d; i<maxPoints; i++)
-			{
-				if( Distance < _Get_Selected(Selection, i)->Distance )
-				{
-					Distance	= _Get_Selected(Selection, i)->Distance;
-				}
-			}
+			Distance	= _Get_Selected(Selection, iFirst)->Distance;	// the farthest selected point
 		}
 	}
 
@@ -765,7 +772,7 @@ void CSG_PRQuadTree::_Select_Nearest_Points(CSG_Array &Selection, CSG_PRQuadTree
 		{
 			if( (pChild = ((CSG_PRQuadTree_Node *)pItem)->Get_Child(i)) != NULL && pChild->Contains(x, y) == true )
 			{
-				_Select_Nearest_Points(Selection, pChild, x, y, Distance, Radius, maxPoints, iQuadrant);
+				_Select_Nearest_Points(Selection, iFirst, pChild, x, y, Distance, Radius, maxPoints, iQuadrant);
 			}
 		}
 
@@ -775,11 +782,11 @@ void CSG_PRQuadTree::_Select_Nearest_Points(CSG_Array &Selection, CSG_PRQuadTree
 			{
 				if( _Radius_Intersects(x, y, Radius, iQuadrant, pChild) )
 				{
-					if( Get_Selected_Count() < maxPoints
+					if( Selection.Get_Size() - iFirst < maxPoints
 					||	(	Distance > (x < pChild->Get_xCenter() ? pChild->Get_xMin() - x : x - pChild->Get_xMax())
 						&&	Distance > (y < pChild->Get_yCenter() ? pChild->Get_yMin() - y : y - pChild->Get_yMax())	) )
 					{
-						_Select_Nearest_Points(Selection, pChild, x, y, Distance, Radius, maxPoints, iQuadrant);
+						_Select_Nearest_Points(Selection, iFirst, pChild, x, y, Distance, Radius, maxPoints, iQuadrant);
 					}
 				}
 			}
@@ -805,7 +812,7 @@ size_t CSG_PRQuadTree::Get_Nearest_Points(CSG_Points_Z &Points, double x, double
 {
 	CSG_Array	Selection;
 
-	_Select_Nearest_Points(Selection, x, y, maxPoints, Radius, iQuadrant);
+	Select_Nearest_Points(Selection, x, y, maxPoints, Radius, iQuadrant);
 
 	Points.Clear();
 
@@ -903,6 +910,15 @@ bool CSG_Parameters_Search_Points::Create(CSG_Parameters *pParameters, CSG_Param
 		)
 	);
 
+	m_pParameters->Add_Choice(
+		pNode	, "SEARCH_ENGINE"		, _TL("Search Engine"),
+		_TL("spatial index used to find the nearest points; the k-d tree is built faster and queried faster, the quadtree needs less memory for very large point sets"),
+		CSG_String::Format(SG_T("%s|%s|"),
+			_TL("k-d tree"),
+			_TL("quadtree")
+		), 0
+	);
+
 	return( true );
 }
 
@@ -989,7 +1005,14 @@ bool CSG_Parameters_Search_Points::Initialize(CSG_Shapes *pPoints, int zField)
 		return( true );
 	}
 
-	return( m_Search.Create(pPoints, zField) );
+	if( m_pParameters->Get_Parameter("SEARCH_ENGINE") && m_pParameters->Get_Parameter("SEARCH_ENGINE")->asInt() == 1 )
+	{
+		return( m_Search.Create(pPoints, zField) );
+	}
+
+	m_bKDTree	= true;
+
+	return( m_KDTree.Create(pPoints, zField) );
 }
 
 //---------------------------------------------------------
@@ -1002,7 +1025,10 @@ bool CSG_Parameters_Search_Points::Finalize(void)
 	m_nPoints	= m_nPoints_Min	= m_nPoints_Max = 0;
 	m_Quadrant	= -1;
 
+	m_bKDTree	= false;
+
 	m_Search.Destroy();
+	m_KDTree.Destroy();
 
 	return( true );
 }
@@ -1017,7 +1043,9 @@ int CSG_Parameters_Search_Points::Set_Location(double x, double y)
 {
 	if( m_nPoints_Max > 0 || m_Radius > 0.0 )	// using search engine
 	{
-		m_nPoints	= m_Search.Select_Nearest_Points(x, y, m_nPoints_Max, m_Radius, m_Quadrant);
+		m_nPoints	= m_bKDTree
+			? m_KDTree.Select_Nearest_Points(x, y, m_nPoints_Max, m_Radius, m_Quadrant)
+			: m_Search.Select_Nearest_Points(x, y, m_nPoints_Max, m_Radius, m_Quadrant);
 	}
 	else										// without search engine
 	{
@@ -1032,6 +1060,30 @@ int CSG_Parameters_Search_Points::Set_Location(const TSG_Point &p)
 	return( Set_Location(p.x, p.y) );
 }
 
+//---------------------------------------------------------
+/**
+  * Thread-safe version of Set_Location(), storing the selected
+  * points in the supplied buffer, which has to be passed to
+  * Get_Point() to request the points.
+*/
+int CSG_Parameters_Search_Points::Set_Location(double x, double y, CSG_Array &Selection)	const
+{
+	if( m_nPoints_Max > 0 || m_Radius > 0.0 )	// using search engine
+	{
+		return( (int)(m_bKDTree
+			? m_KDTree.Select_Nearest_Points(Selection, x, y, m_nPoints_Max, m_Radius, m_Quadrant)
+			: m_Search.Select_Nearest_Points(Selection, x, y, m_nPoints_Max, m_Radius, m_Quadrant)
+		));
+	}
+
+	return( m_pPoints ? m_pPoints->Get_Count() : 0 );
+}
+
+int CSG_Parameters_Search_Points::Set_Location(const TSG_Point &p, CSG_Array &Selection)	const
+{
+	return( Set_Location(p.x, p.y, Selection) );
+}
+
 
 ///////////////////////////////////////////////////////////
 //														 //
@@ -1055,7 +1107,7 @@ bool CSG_Parameters_Search_Points::Get_Point(int Index, double &x, double &y, do
 	}
 	else			// using search engine
 	{
-		if( !m_Search.Get_Selected_Point(Index, x, y, z) )
+		if( !(m_bKDTree ? m_KDTree.Get_Selected_Point(Index, x, y, z) : m_Search.Get_Selected_Point(Index, x, y, z)) )
 		{
 			return( false );
 		}
@@ -1064,6 +1116,31 @@ bool CSG_Parameters_Search_Points::Get_Point(int Index, double &x, double &y, do
 	return( true );
 }
 
+//---------------------------------------------------------
+bool CSG_Parameters_Search_Points::Get_Point(const CSG_Array &Selection, int Index, double &x, double &y, double &z)	const
+{
+	if( m_pPoints )	// without search engine
+	{
+		CSG_Shape	*pPoint	= m_pPoints->Get_Shape(Index);
+
+		if( !pPoint || pPoint->is_NoData(m_zField) )
+		{
+			return( false );
+		}
+
+		x	= pPoint->Get_Point(0).x;
+		y	= pPoint->Get_Point(0).y;
+		z	= m_zField < 0 ? Index : pPoint->asDouble(m_zField);
+
+		return( true );
+	}
+
+	return( m_bKDTree	// using search engine
+		? m_KDTree.Get_Selected_Point(Selection, Index, x, y, z)
+		: m_Search.Get_Selected_Point(Selection, Index, x, y, z)
+	);
+}
+
 
 ///////////////////////////////////////////////////////////
 //														 //
@@ -1080,7 +1157,10 @@ bool CSG_Parameters_Search_Points::Get_Points(double x, double y, CSG_Points_Z &
 //---------------------------------------------------------
 bool CSG_Parameters_Search_Points::Get_Points(const TSG_Point &p, CSG_Points_Z &Points)
 {
-	return( m_Search.Get_Nearest_Points(Points, p, m_nPoints_Max, m_Radius, m_Quadrant) >= (size_t)m_nPoints_Min );
+	return( (m_bKDTree
+		? m_KDTree.Get_Nearest_Points(Points, p, m_nPoints_Max, m_Radius, m_Quadrant)
+		: m_Search.Get_Nearest_Points(Points, p, m_nPoints_Max, m_Radius, m_Quadrant)
+	) >= (size_t)m_nPoints_Min );
 }
 
 
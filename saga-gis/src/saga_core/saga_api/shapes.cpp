@@ -482,6 +482,30 @@ CSG_Shape * CSG_Shapes::Add_Shape(CSG_Table_Record *pCopy, TSG_ADD_Shape_Copy_Mo
 	return( pShape );
 }
 
+//---------------------------------------------------------
+CSG_Table_Record * CSG_Shapes::Ins_Record(int iRecord, CSG_Table_Record *pCopy)
+{
+	m_Spatial_Index.Invalidate();	// shape indices are shifted
+
+	return( CSG_Table::Ins_Record(iRecord, pCopy) );
+}
+
+//---------------------------------------------------------
+bool CSG_Shapes::Del_Record(int iRecord)
+{
+	m_Spatial_Index.Invalidate();
+
+	return( CSG_Table::Del_Record(iRecord) );
+}
+
+//---------------------------------------------------------
+bool CSG_Shapes::Del_Records(void)
+{
+	m_Spatial_Index.Destroy();
+
+	return( CSG_Table::Del_Records() );
+}
+
 //---------------------------------------------------------
 bool CSG_Shapes::Del_Shape(CSG_Shape *pShape)
 {
@@ -549,10 +573,40 @@ bool CSG_Shapes::On_Update(void)
 //														 //
 ///////////////////////////////////////////////////////////
 
+//---------------------------------------------------------
+const CSG_Shapes_RTree * CSG_Shapes::Get_Spatial_Index(void)
+{
+	if( Get_ObjectType() != DATAOBJECT_TYPE_Shapes )	// point clouds
+	{
+		return( NULL );
+	}
+
+	if( !m_Spatial_Index.is_Valid() )
+	{
+		#pragma omp critical (shapes_spatial_index)
+		{
+			if( !m_Spatial_Index.is_Valid() )
+			{
+				m_Spatial_Index.Create(this);
+			}
+		}
+	}
+
+	return( m_Spatial_Index.Get_Count() > 0 ? &m_Spatial_Index : NULL );
+}
+
+//---------------------------------------------------------
+CSG_Shape * CSG_Shapes::Get_Nearest_Shape(const TSG_Point &Point, double *Distance, double maxDistance)
+{
+	const CSG_Shapes_RTree	*pIndex	= Get_Spatial_Index();
+
+	return( pIndex ? pIndex->Get_Nearest(Point, Distance, maxDistance) : NULL );
+}
+
 //---------------------------------------------------------
 CSG_Shape * CSG_Shapes::Get_Shape(TSG_Point Point, double Epsilon)
 {
-	int			iShape;
+	int			iShape, nShapes;
 	double		d, dNearest;
 	CSG_Rect	r(Point.x - Epsilon, Point.y - Epsilon, Point.x + Epsilon, Point.y + Epsilon);
 	CSG_Shape	*pShape, *pNearest;
@@ -561,9 +615,15 @@ CSG_Shape * CSG_Shapes::Get_Shape(TSG_Point Point, double Epsilon)
 
 	if( r.Intersects(Get_Extent()) != INTERSECTION_None )
 	{
-		for(iShape=0, dNearest=-1.0; iShape<Get_Count(); iShape++)
+		CSG_Array	Candidates;
+
+		const CSG_Shapes_RTree	*pIndex	= Get_Count() > 64 ? Get_Spatial_Index() : NULL;
+
+		nShapes	= pIndex ? pIndex->Get_Intersection(r.m_rect, Candidates) : Get_Count();
+
+		for(iShape=0, dNearest=-1.0; iShape<nShapes; iShape++)
 		{
-			pShape	= Get_Shape(iShape);
+			pShape	= Get_Shape(pIndex ? CSG_Shapes_RTree::Get_Index(Candidates, iShape) : iShape);
 
 			if( pShape->Intersects(r) )
 			{
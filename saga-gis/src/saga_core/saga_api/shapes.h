@@ -607,6 +607,82 @@ protected:
 };
 
 
+///////////////////////////////////////////////////////////
+//														 //
+//					Spatial Index						 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+/**
+  * CSG_Shapes_RTree is a static, packed R-tree of the shapes'
+  * bounding boxes, bulk-loaded with the sort-tile-recursive
+  * (STR) algorithm. Queries return candidate shape indices
+  * whose extents intersect a rectangle or contain a point and
+  * find the nearest shape using exact shape distances. All
+  * queries are const and can be run concurrently. The index
+  * is usually obtained from CSG_Shapes::Get_Spatial_Index(),
+  * which builds it on demand and drops it on geometry changes.
+*/
+//---------------------------------------------------------
+class SAGA_API_DLL_EXPORT CSG_Shapes_RTree
+{
+private:
+
+	typedef struct SNode
+	{
+		TSG_Rect				Extent;
+
+		int						First, Count;
+	}
+	TNode;
+
+
+public:
+	CSG_Shapes_RTree(void);
+	virtual ~CSG_Shapes_RTree(void);
+
+								CSG_Shapes_RTree		(class CSG_Shapes *pShapes);
+	bool						Create					(class CSG_Shapes *pShapes);
+
+	void						Destroy					(void);
+
+	bool						is_Valid				(void)	const	{	return( m_bValid );		}
+	void						Invalidate				(void)			{	m_bValid	= false;	}
+
+	int							Get_Count				(void)	const	{	return( m_nItems );		}
+
+	/// Collects the indices of all shapes whose extent intersects 'Extent' in ascending order. Returns the number of shapes found.
+	int							Get_Intersection		(const TSG_Rect  &Extent, CSG_Array &Indices)	const;
+
+	/// Collects the indices of all shapes whose extent contains 'Point', e.g. the candidates for a point in polygon test.
+	int							Get_Candidates			(const TSG_Point &Point , CSG_Array &Indices)	const;
+
+	/// Returns the shape with the smallest distance to 'Point' or NULL if there is none within 'maxDistance' (ignored if negative).
+	class CSG_Shape *			Get_Nearest				(const TSG_Point &Point, double *Distance = NULL, double maxDistance = -1.0)	const;
+
+	static int					Get_Index				(const CSG_Array &Indices, size_t i)	{	return( ((int *)Indices.Get_Array())[i] );	}
+
+
+private:
+
+	bool						m_bValid;
+
+	int							m_nItems, m_nNodes, m_nLeaves, *m_Items;
+
+	TSG_Rect					*m_Extents;
+
+	TNode						*m_Nodes;
+
+	class CSG_Shapes			*m_pShapes;
+
+
+	void						_Sort					(TNode *Nodes, int nNodes)	const;
+	int							_Group					(TNode *Nodes, int nNodes, int First)	const;
+
+};
+
+
 ///////////////////////////////////////////////////////////
 //														 //
 //						Shapes							 //
@@ -670,6 +746,10 @@ public:
 	virtual bool					Del_Shape				(CSG_Shape *pShape);
 	virtual bool					Del_Shapes				(void)					{	return( Del_Records() );	}
 
+	virtual CSG_Table_Record *		Ins_Record				(int iRecord, CSG_Table_Record *pCopy = NULL);
+	virtual bool					Del_Record				(int iRecord);
+	virtual bool					Del_Records				(void);
+
 	virtual CSG_Shape *				Get_Shape				(TSG_Point Point, double Epsilon = 0.0);
 	virtual CSG_Shape *				Get_Shape				(int iShape)	const	{	return( (CSG_Shape *)Get_Record(iShape) );	}
 	virtual CSG_Shape *				Get_Shape_byIndex		(int Index)		const	{	return( (CSG_Shape *)Get_Record_byIndex(Index) );	}
@@ -686,6 +766,13 @@ public:
 	virtual bool					Select					(TSG_Rect Extent			, bool bInvert = false);
 	virtual bool					Select					(TSG_Point Point			, bool bInvert = false);
 
+	//-----------------------------------------------------
+	/// Returns the shapes' R-tree, which is built on first request and invalidated by any change of geometries or shape order. Returns NULL, if there is nothing to index.
+	const CSG_Shapes_RTree *		Get_Spatial_Index		(void);
+	void							Del_Spatial_Index		(void)					{	m_Spatial_Index.Destroy();	}
+
+	CSG_Shape *						Get_Nearest_Shape		(const TSG_Point &Point, double *Distance = NULL, double maxDistance = -1.0);
+
 
 protected:
 
@@ -697,6 +784,8 @@ protected:
 
 	CSG_Rect						m_Extent, m_Extent_Selected;
 
+	CSG_Shapes_RTree				m_Spatial_Index;
+
 
 	virtual bool					On_Update				(void);
 
@@ -928,6 +1017,17 @@ protected:
 //---------------------------------------------------------
 class SAGA_API_DLL_EXPORT CSG_PRQuadTree
 {
+private:
+
+	typedef struct SLeaf
+	{
+		CSG_PRQuadTree_Leaf		*pLeaf;
+
+		double					Distance;
+	}
+	TLeaf;
+
+
 public:
 	CSG_PRQuadTree(void);
 	virtual ~CSG_PRQuadTree(void);
@@ -964,13 +1064,26 @@ public:
 	size_t						Select_Nearest_Points	(const TSG_Point &p, size_t maxPoints, double Radius = 0.0, int iQuadrant = -1);
 	size_t						Select_Nearest_Points	(double x, double y, size_t maxPoints, double Radius = 0.0, int iQuadrant = -1);
 
-	size_t						Get_Selected_Count		(void)     const	{	return( m_Selection.Get_Size() );	}
-	CSG_PRQuadTree_Leaf *		Get_Selected_Leaf		(size_t i) const	{	return( i >= m_Selection.Get_Size() ? NULL : (((TLeaf *)m_Selection.Get_Array()) + i)->pLeaf          );	}
-	double						Get_Selected_Z			(size_t i) const	{	return( i >= m_Selection.Get_Size() ?  0.0 : (((TLeaf *)m_Selection.Get_Array()) + i)->pLeaf->Get_Z() );	}
-	double						Get_Selected_Distance	(size_t i) const	{	return( i >= m_Selection.Get_Size() ? -1.0 : (((TLeaf *)m_Selection.Get_Array()) + i)->Distance       );	}
-	bool						Get_Selected_Point		(size_t i, double &x, double &y, double &z) const
+	size_t						Get_Selected_Count		(void)     const	{	return( Get_Selected_Count   (m_Selection   ) );	}
+	CSG_PRQuadTree_Leaf *		Get_Selected_Leaf		(size_t i) const	{	return( Get_Selected_Leaf    (m_Selection, i) );	}
+	double						Get_Selected_Z			(size_t i) const	{	return( Get_Selected_Z       (m_Selection, i) );	}
+	double						Get_Selected_Distance	(size_t i) const	{	return( Get_Selected_Distance(m_Selection, i) );	}
+	bool						Get_Selected_Point		(size_t i, double &x, double &y, double &z) const	{	return( Get_Selected_Point(m_Selection, i, x, y, z) );	}
+
+	//-----------------------------------------------------
+	// Thread-safe selection using a caller owned buffer, which
+	// is reused by subsequent queries without re-allocation...
+
+	size_t						Select_Nearest_Points	(CSG_Array &Selection, const TSG_Point &p, size_t maxPoints, double Radius = 0.0, int iQuadrant = -1)	const;
+	size_t						Select_Nearest_Points	(CSG_Array &Selection, double x, double y, size_t maxPoints, double Radius = 0.0, int iQuadrant = -1)	const;
+
+	size_t						Get_Selected_Count		(const CSG_Array &Selection)           const	{	return( Selection.Get_Value_Size() == sizeof(TLeaf) ? Selection.Get_Size() : 0 );	}
+	CSG_PRQuadTree_Leaf *		Get_Selected_Leaf		(const CSG_Array &Selection, size_t i) const	{	return( i >= Get_Selected_Count(Selection) ? NULL : _Get_Selected(Selection, i)->pLeaf          );	}
+	double						Get_Selected_Z			(const CSG_Array &Selection, size_t i) const	{	return( i >= Get_Selected_Count(Selection) ?  0.0 : _Get_Selected(Selection, i)->pLeaf->Get_Z() );	}
+	double						Get_Selected_Distance	(const CSG_Array &Selection, size_t i) const	{	return( i >= Get_Selected_Count(Selection) ? -1.0 : _Get_Selected(Selection, i)->Distance       );	}
+	bool						Get_Selected_Point		(const CSG_Array &Selection, size_t i, double &x, double &y, double &z) const
 	{
-		CSG_PRQuadTree_Leaf	*pLeaf	= Get_Selected_Leaf(i);
+		CSG_PRQuadTree_Leaf	*pLeaf	= Get_Selected_Leaf(Selection, i);
 
 		if( pLeaf )
 		{
@@ -985,17 +1098,6 @@ public:
 	}
 
 
-private:
-
-	typedef struct SLeaf
-	{
-		CSG_PRQuadTree_Leaf		*pLeaf;
-
-		double					Distance;
-	}
-	TLeaf;
-
-
 private:
 
 	bool						m_bPolar;
@@ -1017,11 +1119,127 @@ private:
 
 	CSG_PRQuadTree_Leaf	*		_Get_Nearest_Point		(CSG_PRQuadTree_Item *pItem, double x, double y, double &Distance)			const;
 
-	TLeaf *						_Get_Selected			(const CSG_Array &Selection, size_t i)										const;
-	bool						_Add_Selected			(      CSG_Array &Selection          , CSG_PRQuadTree_Leaf *pLeaf, double Distance)	const;
-	bool						_Set_Selected			(      CSG_Array &Selection, size_t i, CSG_PRQuadTree_Leaf *pLeaf, double Distance)	const;
-	void						_Select_Nearest_Points	(      CSG_Array &Selection, CSG_PRQuadTree_Item *pItem, double x, double y, double &Distance, double Radius, size_t maxPoints, int iQuadrant)	const;
-	size_t						_Select_Nearest_Points	(      CSG_Array &Selection, double x, double y, size_t maxPoints, double Radius, int iQuadrant)	const;
+	TLeaf *						_Get_Selected			(const CSG_Array &Selection, size_t i)	const	{	return( (TLeaf *)Selection.Get_Entry(i) );	}
+	void						_Add_Selected			(      CSG_Array &Selection, size_t iFirst, size_t maxPoints, CSG_PRQuadTree_Leaf *pLeaf, double Distance)	const;
+	void						_Select_Nearest_Points	(      CSG_Array &Selection, size_t iFirst, CSG_PRQuadTree_Item *pItem, double x, double y, double &Distance, double Radius, size_t maxPoints, int iQuadrant)	const;
+
+};
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//						k-d Tree						 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+/**
+  * CSG_KDTree is a static, bulk-loaded two-dimensional k-d tree
+  * for nearest neighbour and radius queries on point data. It
+  * offers the selection interface of CSG_PRQuadTree, but keeps
+  * all points in one contiguous array, which makes construction
+  * and queries considerably faster for large point sets. Points
+  * cannot be added after construction. Distances are planar.
+*/
+//---------------------------------------------------------
+class SAGA_API_DLL_EXPORT CSG_KDTree
+{
+private:
+
+	typedef struct SPoint
+	{
+		double					x, y, z;
+	}
+	TPoint;
+
+	typedef struct SSelected
+	{
+		int						Index;
+
+		double					Distance;
+	}
+	TSelected;
+
+
+public:
+	CSG_KDTree(void);
+	virtual ~CSG_KDTree(void);
+
+								CSG_KDTree				(CSG_Shapes *pShapes, int Attribute);
+	bool						Create					(CSG_Shapes *pShapes, int Attribute);
+
+	void						Destroy					(void);
+
+	int							Get_Point_Count			(void)	const	{	return( m_nPoints );		}
+
+	bool						is_Okay					(void)	const	{	return( m_nPoints > 0 );	}
+
+	const TSG_Rect &			Get_Extent				(void)	const	{	return( m_Extent );			}
+
+	bool						Get_Nearest_Point		(const TSG_Point &p, TSG_Point &Point, double &Value, double &Distance)	const;
+	bool						Get_Nearest_Point		(double x, double y, TSG_Point &Point, double &Value, double &Distance)	const;
+
+	size_t						Get_Nearest_Points		(CSG_Points_Z &Points, const TSG_Point &p, size_t maxPoints, double Radius = 0.0, int iQuadrant = -1)	const;
+	size_t						Get_Nearest_Points		(CSG_Points_Z &Points, double x, double y, size_t maxPoints, double Radius = 0.0, int iQuadrant = -1)	const;
+
+	size_t						Select_Nearest_Points	(const TSG_Point &p, size_t maxPoints, double Radius = 0.0, int iQuadrant = -1);
+	size_t						Select_Nearest_Points	(double x, double y, size_t maxPoints, double Radius = 0.0, int iQuadrant = -1);
+
+	size_t						Get_Selected_Count		(void)     const	{	return( Get_Selected_Count   (m_Selection   ) );	}
+	double						Get_Selected_Z			(size_t i) const	{	return( Get_Selected_Z       (m_Selection, i) );	}
+	double						Get_Selected_Distance	(size_t i) const	{	return( Get_Selected_Distance(m_Selection, i) );	}
+	bool						Get_Selected_Point		(size_t i, double &x, double &y, double &z) const	{	return( Get_Selected_Point(m_Selection, i, x, y, z) );	}
+
+	//-----------------------------------------------------
+	// Thread-safe selection using a caller owned buffer...
+
+	size_t						Select_Nearest_Points	(CSG_Array &Selection, const TSG_Point &p, size_t maxPoints, double Radius = 0.0, int iQuadrant = -1)	const;
+	size_t						Select_Nearest_Points	(CSG_Array &Selection, double x, double y, size_t maxPoints, double Radius = 0.0, int iQuadrant = -1)	const;
+
+	size_t						Get_Selected_Count		(const CSG_Array &Selection)           const	{	return( Selection.Get_Value_Size() == sizeof(TSelected) ? Selection.Get_Size() : 0 );	}
+	double						Get_Selected_Z			(const CSG_Array &Selection, size_t i) const	{	return( i >= Get_Selected_Count(Selection) ?  0.0 : m_Points[_Get_Selected(Selection, i)->Index].z );	}
+	double						Get_Selected_Distance	(const CSG_Array &Selection, size_t i) const	{	return( i >= Get_Selected_Count(Selection) ? -1.0 : _Get_Selected(Selection, i)->Distance          );	}
+	bool						Get_Selected_Point		(const CSG_Array &Selection, size_t i, double &x, double &y, double &z) const
+	{
+		if( i < Get_Selected_Count(Selection) )
+		{
+			const TPoint	&p	= m_Points[_Get_Selected(Selection, i)->Index];
+
+			x	= p.x;
+			y	= p.y;
+			z	= p.z;
+
+			return( true );
+		}
+
+		return( false );
+	}
+
+
+private:
+
+	int							m_nPoints;
+
+	BYTE						*m_Axis;
+
+	TPoint						*m_Points;
+
+	TSG_Rect					m_Extent;
+
+	CSG_Array					m_Selection;
+
+	void						_Build					(int iFirst, int iLast, TSG_Rect Extent);
+	void						_Select_Median			(int l, int r, int k, int Axis);
+
+	bool						_Quadrant_Contains		(double x, double y, int iQuadrant, const TPoint &p)			const;
+	bool						_Quadrant_Intersects	(double x, double y, int iQuadrant, const TSG_Rect &Extent)		const;
+	double						_Get_Distance			(double x, double y, const TSG_Rect &Extent)					const;
+
+	void						_Get_Nearest_Point		(int iFirst, int iLast, const TSG_Rect &Extent, double x, double y, int &iNearest, double &Distance)	const;
+
+	TSelected *					_Get_Selected			(const CSG_Array &Selection, size_t i)	const	{	return( (TSelected *)Selection.Get_Entry(i) );	}
+	void						_Check_Point			(      CSG_Array &Selection, size_t iSelection, int iPoint, double x, double y, double &Distance, double Radius, size_t maxPoints, int iQuadrant)	const;
+	void						_Select_Nearest_Points	(      CSG_Array &Selection, size_t iSelection, int iFirst, int iLast, const TSG_Rect &Extent, double x, double y, double &Distance, double Radius, size_t maxPoints, int iQuadrant)	const;
 
 };
 
@@ -1052,6 +1270,11 @@ public:
 	int							Get_Count				(void)	const	{	return( m_nPoints );	}
 	bool						Get_Point				(int Index, double &x, double &y, double &z);
 
+	int							Set_Location			(double x, double y, CSG_Array &Selection)	const;
+	int							Set_Location			(const TSG_Point &p, CSG_Array &Selection)	const;
+
+	bool						Get_Point				(const CSG_Array &Selection, int Index, double &x, double &y, double &z)	const;
+
 	bool						Get_Points				(double x, double y, CSG_Points_Z &Points);
 	bool						Get_Points				(const TSG_Point &p, CSG_Points_Z &Points);
 
@@ -1060,6 +1283,8 @@ public:
 
 private:
 
+	bool						m_bKDTree;
+
 	int							m_zField, m_nPoints, m_nPoints_Min, m_nPoints_Max, m_Quadrant;
 
 	double						m_Radius;
@@ -1070,6 +1295,8 @@ private:
 
 	CSG_PRQuadTree				m_Search;
 
+	CSG_KDTree					m_KDTree;
+
 };
 
 
@@ -0,0 +1,525 @@
+/**********************************************************
+ * Version $Id$
+ *********************************************************/
+
+///////////////////////////////////////////////////////////
+//                                                       //
+//                         SAGA                          //
+//                                                       //
+//      System for Automated Geoscientific Analyses      //
+//                                                       //
+//           Application Programming Interface           //
+//                                                       //
+//                  Library: SAGA_API                    //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//                   shapes_rtree.cpp                    //
+//                                                       //
+//                 Copyright (C) 2015 by                 //
+//                      Olaf Conrad                      //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+// This file is part of 'SAGA - System for Automated     //
+// Geoscientific Analyses'.                              //
+//                                                       //
+// This library is free software; you can redistribute   //
+// it and/or modify it under the terms of the GNU Lesser //
+// General Public License as published by the Free       //
+// Software Foundation, version 2.1 of the License.      //
+//                                                       //
+// This library is distributed in the hope that it will  //
+// be useful, but WITHOUT ANY WARRANTY; without even the //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A  //
+// PARTICULAR PURPOSE. See the GNU Lesser General Public //
+// License for more details.                             //
+//                                                       //
+// You should have received a copy of the GNU Lesser     //
+// General Public License along with this program; if    //
+// not, write to the Free Software Foundation, Inc.,     //
+// 51 Franklin Street, 5th Floor, Boston, MA 02110-1301, //
+// USA.                                                  //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//    e-mail:     oconrad@saga-gis.org                   //
+//                                                       //
+//    contact:    Olaf Conrad                            //
+//                Institute of Geography                 //
+//                University of Hamburg                  //
+//                Germany                                //
+//                                                       //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+#include "shapes.h"
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// All nodes are kept in one array, level by level, starting
+// with the leaves. The children of a node are the range
+// [First, First + Count) of the next lower level, for leaves
+// it is the range of the item arrays (shape indices and their
+// extents). The root is the last node.
+//---------------------------------------------------------
+#define RTREE_NODE_SIZE		16
+#define RTREE_STACK_SIZE	1024
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+CSG_Shapes_RTree::CSG_Shapes_RTree(void)
+{
+	m_bValid	= false;
+
+	m_nItems	= 0;
+	m_nNodes	= 0;
+	m_nLeaves	= 0;
+
+	m_Items		= NULL;
+	m_Extents	= NULL;
+	m_Nodes		= NULL;
+
+	m_pShapes	= NULL;
+}
+
+//---------------------------------------------------------
+CSG_Shapes_RTree::CSG_Shapes_RTree(CSG_Shapes *pShapes)
+{
+	m_bValid	= false;
+
+	m_nItems	= 0;
+	m_nNodes	= 0;
+	m_nLeaves	= 0;
+
+	m_Items		= NULL;
+	m_Extents	= NULL;
+	m_Nodes		= NULL;
+
+	m_pShapes	= NULL;
+
+	Create(pShapes);
+}
+
+//---------------------------------------------------------
+CSG_Shapes_RTree::~CSG_Shapes_RTree(void)
+{
+	Destroy();
+}
+
+//---------------------------------------------------------
+void CSG_Shapes_RTree::Destroy(void)
+{
+	SG_FREE_SAFE(m_Items);
+	SG_FREE_SAFE(m_Extents);
+	SG_FREE_SAFE(m_Nodes);
+
+	m_nItems	= 0;
+	m_nNodes	= 0;
+	m_nLeaves	= 0;
+
+	m_pShapes	= NULL;
+
+	m_bValid	= false;
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//						Construction					 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CSG_Shapes_RTree::Create(CSG_Shapes *pShapes)
+{
+	Destroy();
+
+	if( !pShapes || pShapes->Get_ObjectType() != DATAOBJECT_TYPE_Shapes )
+	{
+		return( false );
+	}
+
+	m_pShapes	= pShapes;
+
+	//-----------------------------------------------------
+	TNode	*Level	= (TNode *)SG_Malloc((pShapes->Get_Count() + 1) * sizeof(TNode));
+
+	int		i, n	= 0;
+
+	for(i=0; i<pShapes->Get_Count(); i++)
+	{
+		CSG_Shape	*pShape	= pShapes->Get_Shape(i);
+
+		if( pShape->Get_Point_Count() > 0 )
+		{
+			Level[n].Extent	= pShape->Get_Extent().m_rect;
+			Level[n].First	= i;
+			Level[n].Count	= 0;
+
+			n++;
+		}
+	}
+
+	if( n < 1 )	// nothing to index, but valid
+	{
+		SG_Free(Level);
+
+		m_bValid	= true;
+
+		return( true );
+	}
+
+	//-----------------------------------------------------
+	m_nItems	= n;
+	m_Items		= (int      *)SG_Malloc(n * sizeof(int     ));
+	m_Extents	= (TSG_Rect *)SG_Malloc(n * sizeof(TSG_Rect));
+	m_Nodes		= (TNode    *)SG_Malloc((n + 2) * sizeof(TNode));	// more than enough for a node size > 2
+
+	_Sort(Level, n);
+
+	for(i=0; i<n; i++)
+	{
+		m_Items  [i]	= Level[i].First;
+		m_Extents[i]	= Level[i].Extent;
+	}
+
+	n	= m_nLeaves	= _Group(Level, n, 0);
+
+	//-----------------------------------------------------
+	while( n > 1 )
+	{
+		_Sort(Level, n);
+
+		memcpy(m_Nodes + m_nNodes, Level, n * sizeof(TNode));	// the leaves are the first level
+
+		int	First	= m_nNodes;
+
+		m_nNodes	+= n;
+
+		n	= _Group(Level, n, First);
+	}
+
+	m_Nodes[m_nNodes++]	= Level[0];	// root
+
+	SG_Free(Level);
+
+	m_bValid	= true;
+
+	return( true );
+}
+
+//---------------------------------------------------------
+static int	SG_RTree_Compare_X(const void *a, const void *b)
+{
+	const TSG_Rect	&A	= *(const TSG_Rect *)a, &B	= *(const TSG_Rect *)b;
+
+	double	d	= (A.xMin + A.xMax) - (B.xMin + B.xMax);
+
+	return( d < 0.0 ? -1 : d > 0.0 ? 1 : 0 );
+}
+
+static int	SG_RTree_Compare_Y(const void *a, const void *b)
+{
+	const TSG_Rect	&A	= *(const TSG_Rect *)a, &B	= *(const TSG_Rect *)b;
+
+	double	d	= (A.yMin + A.yMax) - (B.yMin + B.yMax);
+
+	return( d < 0.0 ? -1 : d > 0.0 ? 1 : 0 );
+}
+
+//---------------------------------------------------------
+// Sort-tile-recursive: sort by x, cut into vertical slices
+// of sqrt(nNodes / RTREE_NODE_SIZE) node groups each and sort
+// every slice by y.
+//---------------------------------------------------------
+void CSG_Shapes_RTree::_Sort(TNode *Nodes, int nNodes)	const
+{
+	int	nGroups	= (nNodes + RTREE_NODE_SIZE - 1) / RTREE_NODE_SIZE;
+	int	nSlice	= (int)ceil(sqrt((double)nGroups)) * RTREE_NODE_SIZE;
+
+	qsort(Nodes, nNodes, sizeof(TNode), SG_RTree_Compare_X);
+
+	for(int i=0; i<nNodes; i+=nSlice)
+	{
+		qsort(Nodes + i, M_GET_MIN(nSlice, nNodes - i), sizeof(TNode), SG_RTree_Compare_Y);
+	}
+}
+
+//---------------------------------------------------------
+// Replaces the first entries of 'Nodes' with the parents of
+// consecutive runs of RTREE_NODE_SIZE nodes. 'First' is the
+// position of Nodes[0] in the array the children are stored
+// in. Returns the number of parents.
+//---------------------------------------------------------
+int CSG_Shapes_RTree::_Group(TNode *Nodes, int nNodes, int First)	const
+{
+	int	nParents	= 0;
+
+	for(int i=0; i<nNodes; i+=RTREE_NODE_SIZE, nParents++)
+	{
+		TNode	Parent;
+
+		Parent.First	= First + i;
+		Parent.Count	= M_GET_MIN(RTREE_NODE_SIZE, nNodes - i);
+		Parent.Extent	= Nodes[i].Extent;
+
+		for(int j=i+1; j<i+Parent.Count; j++)
+		{
+			const TSG_Rect	&r	= Nodes[j].Extent;
+
+			if( Parent.Extent.xMin > r.xMin )	Parent.Extent.xMin	= r.xMin;
+			if( Parent.Extent.yMin > r.yMin )	Parent.Extent.yMin	= r.yMin;
+			if( Parent.Extent.xMax < r.xMax )	Parent.Extent.xMax	= r.xMax;
+			if( Parent.Extent.yMax < r.yMax )	Parent.Extent.yMax	= r.yMax;
+		}
+
+		Nodes[nParents]	= Parent;
+	}
+
+	return( nParents );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//						Queries							 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+inline bool SG_RTree_Intersects(const TSG_Rect &A, const TSG_Rect &B)
+{
+	return( A.xMin <= B.xMax && B.xMin <= A.xMax && A.yMin <= B.yMax && B.yMin <= A.yMax );
+}
+
+//---------------------------------------------------------
+inline double SG_RTree_Distance(const TSG_Rect &r, const TSG_Point &p)
+{
+	double	dx	= p.x < r.xMin ? r.xMin - p.x : p.x > r.xMax ? p.x - r.xMax : 0.0;
+	double	dy	= p.y < r.yMin ? r.yMin - p.y : p.y > r.yMax ? p.y - r.yMax : 0.0;
+
+	return( sqrt(dx*dx + dy*dy) );
+}
+
+//---------------------------------------------------------
+static int	SG_RTree_Compare_Index(const void *a, const void *b)
+{
+	return( *(const int *)a - *(const int *)b );
+}
+
+//---------------------------------------------------------
+int CSG_Shapes_RTree::Get_Intersection(const TSG_Rect &Extent, CSG_Array &Indices)	const
+{
+	if( Indices.Get_Value_Size() != sizeof(int) )
+	{
+		Indices.Create(sizeof(int), 0, SG_ARRAY_GROWTH_2);
+	}
+
+	Indices.Set_Array(0, false);
+
+	if( m_nNodes < 1 )
+	{
+		return( 0 );
+	}
+
+	//-----------------------------------------------------
+	int	Stack[RTREE_STACK_SIZE], nStack	= 0;
+
+	Stack[nStack++]	= m_nNodes - 1;
+
+	while( nStack > 0 )
+	{
+		int			 iNode	= Stack[--nStack];
+
+		const TNode	&Node	= m_Nodes[iNode];
+
+		if( SG_RTree_Intersects(Node.Extent, Extent) )
+		{
+			if( iNode < m_nLeaves )
+			{
+				for(int i=Node.First; i<Node.First+Node.Count; i++)
+				{
+					if( SG_RTree_Intersects(m_Extents[i], Extent) && Indices.Inc_Array() )
+					{
+						((int *)Indices.Get_Array())[Indices.Get_Size() - 1]	= m_Items[i];
+					}
+				}
+			}
+			else for(int i=Node.First; i<Node.First+Node.Count && nStack<RTREE_STACK_SIZE; i++)
+			{
+				Stack[nStack++]	= i;
+			}
+		}
+	}
+
+	qsort(Indices.Get_Array(), Indices.Get_Size(), sizeof(int), SG_RTree_Compare_Index);	// same order as a sequential search
+
+	return( (int)Indices.Get_Size() );
+}
+
+//---------------------------------------------------------
+int CSG_Shapes_RTree::Get_Candidates(const TSG_Point &Point, CSG_Array &Indices)	const
+{
+	TSG_Rect	Extent;
+
+	Extent.xMin	= Extent.xMax	= Point.x;
+	Extent.yMin	= Extent.yMax	= Point.y;
+
+	return( Get_Intersection(Extent, Indices) );
+}
+
+//---------------------------------------------------------
+// Best-first search. The queue holds nodes with the distance
+// to their extent and shapes with their exact distance, which
+// is never less than the distance to the shape's extent. So
+// the first shape taken from the queue is the nearest one.
+//---------------------------------------------------------
+typedef struct SSG_RTree_Entry
+{
+	double	Distance;
+
+	int		Index;
+
+	bool	bShape;
+}
+TSG_RTree_Entry;
+
+//---------------------------------------------------------
+static void	SG_RTree_Push(CSG_Array &Queue, double Distance, int Index, bool bShape)
+{
+	if( !Queue.Inc_Array() )
+	{
+		return;
+	}
+
+	TSG_RTree_Entry	*q	= (TSG_RTree_Entry *)Queue.Get_Array();
+
+	size_t	i	= Queue.Get_Size() - 1;
+
+	for(size_t j; i>0 && q[j = (i - 1) / 2].Distance > Distance; i=j)
+	{
+		q[i]	= q[j];
+	}
+
+	q[i].Distance	= Distance;
+	q[i].Index		= Index;
+	q[i].bShape		= bShape;
+}
+
+//---------------------------------------------------------
+static TSG_RTree_Entry	SG_RTree_Pop(CSG_Array &Queue)
+{
+	TSG_RTree_Entry	*q	= (TSG_RTree_Entry *)Queue.Get_Array(), Top	= q[0], Last	= q[Queue.Get_Size() - 1];
+
+	size_t	n	= Queue.Get_Size() - 1, i	= 0;
+
+	for(size_t j; (j = 2 * i + 1) < n; i=j)
+	{
+		if( j + 1 < n && q[j + 1].Distance < q[j].Distance )
+		{
+			j++;
+		}
+
+		if( Last.Distance <= q[j].Distance )
+		{
+			break;
+		}
+
+		q[i]	= q[j];
+	}
+
+	q[i]	= Last;
+
+	Queue.Set_Array(n, false);
+
+	return( Top );
+}
+
+//---------------------------------------------------------
+CSG_Shape * CSG_Shapes_RTree::Get_Nearest(const TSG_Point &Point, double *Distance, double maxDistance)	const
+{
+	if( m_nNodes < 1 )
+	{
+		return( NULL );
+	}
+
+	CSG_Array	Queue(sizeof(TSG_RTree_Entry), 0, SG_ARRAY_GROWTH_2);
+
+	SG_RTree_Push(Queue, SG_RTree_Distance(m_Nodes[m_nNodes - 1].Extent, Point), m_nNodes - 1, false);
+
+	//-----------------------------------------------------
+	while( Queue.Get_Size() > 0 )
+	{
+		TSG_RTree_Entry	Entry	= SG_RTree_Pop(Queue);
+
+		if( maxDistance >= 0.0 && Entry.Distance > maxDistance )
+		{
+			break;	// all remaining entries are even further away
+		}
+
+		if( Entry.bShape )
+		{
+			if( Distance )
+			{
+				*Distance	= Entry.Distance;
+			}
+
+			return( m_pShapes->Get_Shape(Entry.Index) );
+		}
+
+		const TNode	&Node	= m_Nodes[Entry.Index];
+
+		for(int i=Node.First; i<Node.First+Node.Count; i++)
+		{
+			if( Entry.Index < m_nLeaves )
+			{
+				if( maxDistance < 0.0 || SG_RTree_Distance(m_Extents[i], Point) <= maxDistance )
+				{
+					double	d	= m_pShapes->Get_Shape(m_Items[i])->Get_Distance(Point);
+
+					if( d >= 0.0 )
+					{
+						SG_RTree_Push(Queue, d, m_Items[i], true);
+					}
+				}
+			}
+			else
+			{
+				SG_RTree_Push(Queue, SG_RTree_Distance(m_Nodes[i].Extent, Point), i, false);
+			}
+		}
+	}
+
+	return( NULL );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
@@ -92,8 +92,16 @@ bool CSG_Shapes::Select(TSG_Rect Extent, bool bInvert)
 		CSG_Table::Select();
 	}
 
-	for(int i=0; i<Get_Count(); i++)
+	CSG_Array	Candidates;
+
+	const CSG_Shapes_RTree	*pIndex	= Get_Count() > 64 ? Get_Spatial_Index() : NULL;
+
+	int	n	= pIndex ? pIndex->Get_Intersection(Extent, Candidates) : Get_Count();
+
+	for(int j=0; j<n; j++)
 	{
+		int	i	= pIndex ? CSG_Shapes_RTree::Get_Index(Candidates, j) : j;
+
 		if( Get_Shape(i)->Intersects(Extent) )
 		{
 			CSG_Table::Select(i, true);
@@ -116,8 +124,16 @@ bool CSG_Shapes::Select(TSG_Point Point, bool bInvert)
 		CSG_Table::Select();
 	}
 
-	for(int i=0; i<Get_Count(); i++)
+	CSG_Array	Candidates;
+
+	const CSG_Shapes_RTree	*pIndex	= Get_Count() > 64 ? Get_Spatial_Index() : NULL;
+
+	int	n	= pIndex ? pIndex->Get_Candidates(Point, Candidates) : Get_Count();
+
+	for(int j=0; j<n; j++)
 	{
+		int	i	= pIndex ? CSG_Shapes_RTree::Get_Index(Candidates, j) : j;
+
 		if( ((CSG_Shape_Polygon *)Get_Shape(i))->Contains(Point) )
 		{
 			CSG_Table::Select(i, true);
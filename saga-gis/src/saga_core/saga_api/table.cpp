@@ -318,6 +318,9 @@ void CSG_Table::_On_Construction(void)
 
 	m_Index			= NULL;
 
+	m_bColumnar		= false;
+	m_Columns		= NULL;
+
 	Set_Update_Flag();
 }
 
@@ -347,6 +350,11 @@ bool CSG_Table::Destroy(void)
 		{
 			delete(m_Field_Name [i]);
 			delete(m_Field_Stats[i]);
+
+			if( m_Columns )
+			{
+				delete(m_Columns[i]);
+			}
 		}
 
 		m_nFields		= 0;
@@ -355,6 +363,8 @@ bool CSG_Table::Destroy(void)
 		SG_Free(m_Field_Type);
 		SG_Free(m_Field_Stats);
 
+		SG_FREE_SAFE(m_Columns);
+
 		m_Field_Name	= NULL;
 		m_Field_Type	= NULL;
 		m_Field_Stats	= NULL;
@@ -512,7 +522,19 @@ bool CSG_Table::Add_Field(const CSG_String &Name, TSG_Data_Type Type, int add_Fi
 	m_Field_Stats[add_Field]	= new CSG_Simple_Statistics();
 
 	//-----------------------------------------------------
-	for(iRecord=0; iRecord<m_nRecords; iRecord++)
+	if( m_bColumnar )
+	{
+		m_Columns	= (CSG_Table_Column **)SG_Realloc(m_Columns, m_nFields * sizeof(CSG_Table_Column *));
+
+		for(iField=m_nFields-1; iField>add_Field; iField--)
+		{
+			m_Columns[iField]	= m_Columns[iField - 1];
+		}
+
+		m_Columns[add_Field]	= new CSG_Table_Column(Type);
+		m_Columns[add_Field]->Set_Count(m_nRecords);
+	}
+	else for(iRecord=0; iRecord<m_nRecords; iRecord++)
 	{
 		m_Records[iRecord]->_Add_Field(add_Field);
 	}
@@ -549,7 +571,18 @@ bool CSG_Table::Del_Field(int del_Field)
 		m_Field_Stats	= (CSG_Simple_Statistics **)SG_Realloc(m_Field_Stats, m_nFields * sizeof(CSG_Simple_Statistics *));
 
 		//-------------------------------------------------
-		for(iRecord=0; iRecord<m_nRecords; iRecord++)
+		if( m_bColumnar )
+		{
+			delete(m_Columns[del_Field]);
+
+			for(iField=del_Field; iField<m_nFields; iField++)
+			{
+				m_Columns[iField]	= m_Columns[iField + 1];
+			}
+
+			m_Columns	= (CSG_Table_Column **)SG_Realloc(m_Columns, m_nFields * sizeof(CSG_Table_Column *));
+		}
+		else for(iRecord=0; iRecord<m_nRecords; iRecord++)
 		{
 			m_Records[iRecord]->_Del_Field(del_Field);
 		}
@@ -586,7 +619,46 @@ bool CSG_Table::Set_Field_Type(int iField, TSG_Data_Type Type)
 		{
 			m_Field_Type[iField]	= Type;
 
-			for(int i=0; i<m_nRecords; i++)
+			if( m_bColumnar )
+			{
+				CSG_Table_Column	*pOld	= m_Columns[iField];
+				CSG_Table_Column	*pNew	= new CSG_Table_Column(Type);
+
+				pNew->Set_Count(m_nRecords);
+
+				for(int i=0; i<m_nRecords; i++)
+				{
+					switch( Type )
+					{
+					default:
+					case SG_DATATYPE_String:
+					case SG_DATATYPE_Date:		pNew->Set_Value(i, pOld->asString(i));	break;
+
+					case SG_DATATYPE_Color:
+					case SG_DATATYPE_Byte:
+					case SG_DATATYPE_Char:
+					case SG_DATATYPE_Word:
+					case SG_DATATYPE_Short:
+					case SG_DATATYPE_DWord:
+					case SG_DATATYPE_Int:
+					case SG_DATATYPE_ULong:
+					case SG_DATATYPE_Long:		pNew->Set_Value(i, pOld->asInt   (i));	break;
+
+					case SG_DATATYPE_Float:
+					case SG_DATATYPE_Double:	pNew->Set_Value(i, pOld->asDouble(i));	break;
+
+					case SG_DATATYPE_Binary:	pNew->Set_Value(i, pOld->asBinary(i));	break;
+					}
+
+					m_Records[i]->Set_Modified();
+				}
+
+				m_Columns[iField]	= pNew;
+
+				delete(pOld);
+			}
+
+			else for(int i=0; i<m_nRecords; i++)
 			{
 				CSG_Table_Value	*pOld	= m_Records[i]->m_Values[iField];
 				CSG_Table_Value	*pNew	= CSG_Table_Record::_Create_Value(Type);
@@ -748,6 +820,36 @@ bool CSG_Table::_Dec_Array(void)
 	return( true );
 }
 
+//---------------------------------------------------------
+bool CSG_Table::_Columns_Ins_Row(int iRecord)
+{
+	for(int iField=0; m_bColumnar && iField<m_nFields; iField++)
+	{
+		if( !m_Columns[iField]->Ins_Row(iRecord) )
+		{
+			while( --iField >= 0 )
+			{
+				m_Columns[iField]->Del_Row(iRecord);
+			}
+
+			return( false );
+		}
+	}
+
+	return( true );
+}
+
+//---------------------------------------------------------
+bool CSG_Table::_Columns_Del_Row(int iRecord)
+{
+	for(int iField=0; m_bColumnar && iField<m_nFields; iField++)
+	{
+		m_Columns[iField]->Del_Row(iRecord);
+	}
+
+	return( true );
+}
+
 //---------------------------------------------------------
 CSG_Table_Record * CSG_Table::_Get_New_Record(int Index)
 {
@@ -759,7 +861,12 @@ CSG_Table_Record * CSG_Table::Add_Record(CSG_Table_Record *pCopy)
 {
 	CSG_Table_Record	*pRecord;
 
-	if( _Inc_Array() && (pRecord = _Get_New_Record(m_nRecords)) != NULL )
+	if( !_Inc_Array() || !_Columns_Ins_Row(m_nRecords) )
+	{
+		return( NULL );
+	}
+
+	if( (pRecord = _Get_New_Record(m_nRecords)) != NULL )
 	{
 		if( pCopy )
 		{
@@ -790,6 +897,8 @@ CSG_Table_Record * CSG_Table::Add_Record(CSG_Table_Record *pCopy)
 		return( pRecord );
 	}
 
+	_Columns_Del_Row(m_nRecords);
+
 	return( NULL );
 }
 
@@ -808,14 +917,14 @@ CSG_Table_Record * CSG_Table::Ins_Record(int iRecord, CSG_Table_Record *pCopy)
 	//-----------------------------------------------------
 	CSG_Table_Record	*pRecord;
 
-	if( _Inc_Array() && (pRecord = _Get_New_Record(m_nRecords)) != NULL )
+	if( !_Inc_Array() || !_Columns_Ins_Row(iRecord) )
 	{
-		if( pCopy )
-		{
-			pRecord->Assign(pCopy);
-		}
+		return( NULL );
+	}
 
-		for(int i=m_nRecords; i>iRecord; i--)
+	if( (pRecord = _Get_New_Record(iRecord)) != NULL )
+	{
+		for(int i=m_nRecords; i>iRecord; i--)	// shift first, so that the row of a columnar pCopy from this table is up to date
 		{
 			if( is_Indexed() )
 			{
@@ -826,6 +935,11 @@ CSG_Table_Record * CSG_Table::Ins_Record(int iRecord, CSG_Table_Record *pCopy)
 			m_Records[i]->m_Index	= i;
 		}
 
+		if( pCopy )
+		{
+			pRecord->Assign(pCopy);
+		}
+
 		if( is_Indexed() )
 		{
 			m_Index[iRecord]	= iRecord;
@@ -843,6 +957,8 @@ CSG_Table_Record * CSG_Table::Ins_Record(int iRecord, CSG_Table_Record *pCopy)
 		return( pRecord );
 	}
 
+	_Columns_Del_Row(iRecord);
+
 	return( NULL );
 }
 
@@ -855,6 +971,8 @@ bool CSG_Table::Del_Record(int iRecord)
 
 		delete(m_Records[iRecord]);
 
+		_Columns_Del_Row(iRecord);
+
 		m_nRecords--;
 
 		for(i=iRecord; i<m_nRecords; i++)
@@ -916,6 +1034,11 @@ bool CSG_Table::Del_Records(void)
 		m_nRecords	= 0;
 		m_nBuffer	= 0;
 
+		for(int iField=0; m_bColumnar && iField<m_nFields; iField++)
+		{
+			m_Columns[iField]->Set_Count(0);
+		}
+
 		return( true );
 	}
 
@@ -938,6 +1061,83 @@ bool CSG_Table::Set_Record_Count(int nRecords)
 }
 
 
+///////////////////////////////////////////////////////////
+//														 //
+//						Storage							 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+static bool	gSG_Table_bColumnar	= false;
+
+void		SG_Table_Set_Columnar(bool bOn)
+{
+	gSG_Table_bColumnar	= bOn;
+}
+
+bool		SG_Table_Get_Columnar(void)
+{
+	return( gSG_Table_bColumnar );
+}
+
+//---------------------------------------------------------
+bool CSG_Table::Set_Columnar(bool bOn)
+{
+	if( bOn == m_bColumnar )
+	{
+		return( true );
+	}
+
+	if( bOn && Get_ObjectType() == DATAOBJECT_TYPE_PointCloud )	// point clouds come with their own storage
+	{
+		return( false );
+	}
+
+	int		iField, iRecord;
+
+	//-----------------------------------------------------
+	if( bOn )
+	{
+		if( m_nFields > 0 )
+		{
+			m_Columns	= (CSG_Table_Column **)SG_Malloc(m_nFields * sizeof(CSG_Table_Column *));
+
+			for(iField=0; iField<m_nFields; iField++)
+			{
+				m_Columns[iField]	= new CSG_Table_Column(m_Field_Type[iField]);
+				m_Columns[iField]->Set_Count(m_nRecords);
+			}
+		}
+
+		for(iRecord=0; iRecord<m_nRecords; iRecord++)
+		{
+			m_Records[iRecord]->_Del_Values();
+		}
+	}
+
+	//-----------------------------------------------------
+	else
+	{
+		for(iRecord=0; iRecord<m_nRecords; iRecord++)
+		{
+			m_Records[iRecord]->_Set_Values();
+		}
+
+		for(iField=0; iField<m_nFields; iField++)
+		{
+			delete(m_Columns[iField]);
+		}
+
+		SG_FREE_SAFE(m_Columns);
+	}
+
+	//-----------------------------------------------------
+	m_bColumnar	= bOn;
+
+	return( true );
+}
+
+
 ///////////////////////////////////////////////////////////
 //														 //
 //						Value Access					 //
@@ -1056,13 +1256,65 @@ bool CSG_Table::_Stats_Update(int iField) const
 	{
 		if( !m_Field_Stats[iField]->is_Evaluated() )
 		{
-			CSG_Table_Record	**ppRecord	= m_Records;
+			if( m_bColumnar && m_Columns[iField]->Get_Data() )	// numeric columns, read the typed array directly
+			{
+				CSG_Table_Column	*pColumn	= m_Columns[iField];
 
-			for(int iRecord=0; iRecord<m_nRecords; iRecord++, ppRecord++)
+				switch( pColumn->Get_Type() )
+				{
+				default:
+					{
+						const int	*Values	= (const int *)pColumn->Get_Data();
+
+						for(int iRecord=0; iRecord<m_nRecords; iRecord++)
+						{
+							if( !pColumn->is_NoData(iRecord) && !is_NoData_Value(Values[iRecord]) )
+							{
+								m_Field_Stats[iField]->Add_Value(Values[iRecord]);
+							}
+						}
+					}
+					break;
+
+				case SG_TABLE_VALUE_TYPE_Long:
+					{
+						const sLong	*Values	= (const sLong *)pColumn->Get_Data();
+
+						for(int iRecord=0; iRecord<m_nRecords; iRecord++)
+						{
+							if( !pColumn->is_NoData(iRecord) && !is_NoData_Value((double)Values[iRecord]) )
+							{
+								m_Field_Stats[iField]->Add_Value((double)Values[iRecord]);
+							}
+						}
+					}
+					break;
+
+				case SG_TABLE_VALUE_TYPE_Double:
+					{
+						const double	*Values	= (const double *)pColumn->Get_Data();
+
+						for(int iRecord=0; iRecord<m_nRecords; iRecord++)
+						{
+							if( !pColumn->is_NoData(iRecord) && !is_NoData_Value(Values[iRecord]) )
+							{
+								m_Field_Stats[iField]->Add_Value(Values[iRecord]);
+							}
+						}
+					}
+					break;
+				}
+			}
+			else
 			{
-				if( !(*ppRecord)->is_NoData(iField) )
+				CSG_Table_Record	**ppRecord	= m_Records;
+
+				for(int iRecord=0; iRecord<m_nRecords; iRecord++, ppRecord++)
 				{
-					m_Field_Stats[iField]->Add_Value((*ppRecord)->asDouble(iField));
+					if( !(*ppRecord)->is_NoData(iField) )
+					{
+						m_Field_Stats[iField]->Add_Value((*ppRecord)->asDouble(iField));
+					}
 				}
 			}
 		}
@@ -1297,7 +1549,35 @@ inline int CSG_Table::_Index_Compare(int a, int b, int Field)
 {
 	double	Result;
 
-	switch( m_Field_Type[m_Index_Field[Field]] )
+	if( m_bColumnar )	// compare directly on the column arrays
+	{
+		CSG_Table_Column	*pColumn	= m_Columns[m_Index_Field[Field]];
+
+		switch( pColumn->Get_Type() )
+		{
+		case SG_TABLE_VALUE_TYPE_String:
+			Result	= SG_STR_CMP(pColumn->asString(a), pColumn->asString(b));
+			break;
+
+		case SG_TABLE_VALUE_TYPE_Date:	// date numbers sort like their iso strings
+		case SG_TABLE_VALUE_TYPE_Int:
+			Result	= (double)((const int    *)pColumn->Get_Data())[a] - ((const int    *)pColumn->Get_Data())[b];
+			break;
+
+		case SG_TABLE_VALUE_TYPE_Long:
+			Result	= (double)((const sLong  *)pColumn->Get_Data())[a] - ((const sLong  *)pColumn->Get_Data())[b];
+			break;
+
+		case SG_TABLE_VALUE_TYPE_Double:
+			Result	=         ((const double *)pColumn->Get_Data())[a] - ((const double *)pColumn->Get_Data())[b];
+			break;
+
+		default:
+			Result	= 0.0;
+			break;
+		}
+	}
+	else switch( m_Field_Type[m_Index_Field[Field]] )
 	{
 	case SG_DATATYPE_String:
 	case SG_DATATYPE_Date:
@@ -163,8 +163,8 @@ public:
 	double						asDouble		(int              iField)	const;
 	double						asDouble		(const CSG_String &Field)	const;
 
-	CSG_Table_Value *			Get_Value		(int              iField)			{	return(  m_Values[iField] );	}
-	CSG_Table_Value &			operator []		(int              iField)	const	{	return( *m_Values[iField] );	}
+	CSG_Table_Value *			Get_Value		(int              iField);
+	CSG_Table_Value &			operator []		(int              iField)	const;
 
 	virtual bool				Assign			(CSG_Table_Record *pRecord);
 
@@ -198,6 +198,9 @@ protected:
 
 	int							_Get_Field	 	(const CSG_String &Field)	const;
 
+	bool						_Set_Values		(void);
+	bool						_Del_Values		(void);
+
 };
 
 
@@ -329,6 +332,14 @@ public:
 	int								Get_Index_Field		(int i)	const		{	return( i >= 0 && i < 3 ? m_Index_Field[i] : -1 );	}
 	TSG_Table_Index_Order			Get_Index_Order		(int i)	const		{	return( i >= 0 && i < 3 ? m_Index_Order[i] : TABLE_INDEX_None );	}
 
+	//-----------------------------------------------------
+	/// Switches between record (default) and columnar storage. In columnar mode the values of each field are kept in a CSG_Table_Column, records just refer to their row.
+	bool							Set_Columnar		(bool bOn = true);
+	bool							is_Columnar			(void)	const		{	return( m_bColumnar );	}
+
+	/// Returns the value store of the given field if the table is in columnar mode, NULL otherwise.
+	CSG_Table_Column *				Get_Column			(int iField)	const	{	return( m_bColumnar && iField >= 0 && iField < m_nFields ? m_Columns[iField] : NULL );	}
+
 
 protected:
 
@@ -354,16 +365,23 @@ private:
 
 	int								*m_Index, m_Index_Field[3], *m_Selected;
 
+	bool							m_bColumnar;
+
 	TSG_Table_Index_Order			m_Index_Order[3];
 
 	CSG_Table_Record				**m_Records;
 
+	CSG_Table_Column				**m_Columns;
+
 
 	bool							_Destroy_Selection	(void);
 
 	bool							_Inc_Array			(void);
 	bool							_Dec_Array			(void);
 
+	bool							_Columns_Ins_Row	(int iRecord);
+	bool							_Columns_Del_Row	(int iRecord);
+
 	bool							_Load				(const CSG_String &File_Name, TSG_Table_File_Type Format, const SG_Char *Separator);
 	bool							_Load_Text			(const CSG_String &File_Name, bool bHeadline, const SG_Char *Separator);
 	bool							_Save_Text			(const CSG_String &File_Name, bool bHeadline, const SG_Char *Separator);
@@ -397,6 +415,11 @@ SAGA_API_DLL_EXPORT CSG_Table *	SG_Create_Table	(const CSG_String &File_Name);
 /** Safe table construction */
 SAGA_API_DLL_EXPORT CSG_Table *	SG_Create_Table	(CSG_Table *pTemplate);
 
+//---------------------------------------------------------
+/** Load dBase tables and shapefile attributes with columnar storage */
+SAGA_API_DLL_EXPORT void		SG_Table_Set_Columnar	(bool bOn);
+SAGA_API_DLL_EXPORT bool		SG_Table_Get_Columnar	(void);
+
 
 ///////////////////////////////////////////////////////////
 //														 //
@@ -0,0 +1,738 @@
+/**********************************************************
+ * Version $Id$
+ *********************************************************/
+
+///////////////////////////////////////////////////////////
+//                                                       //
+//                         SAGA                          //
+//                                                       //
+//      System for Automated Geoscientific Analyses      //
+//                                                       //
+//           Application Programming Interface           //
+//                                                       //
+//                  Library: SAGA_API                    //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//                   table_column.cpp                    //
+//                                                       //
+//          Copyright (C) 2015 by Olaf Conrad            //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+// This file is part of 'SAGA - System for Automated     //
+// Geoscientific Analyses'.                              //
+//                                                       //
+// This library is free software; you can redistribute   //
+// it and/or modify it under the terms of the GNU Lesser //
+// General Public License as published by the Free       //
+// Software Foundation, version 2.1 of the License.      //
+//                                                       //
+// This library is distributed in the hope that it will  //
+// be useful, but WITHOUT ANY WARRANTY; without even the //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A  //
+// PARTICULAR PURPOSE. See the GNU Lesser General Public //
+// License for more details.                             //
+//                                                       //
+// You should have received a copy of the GNU Lesser     //
+// General Public License along with this program; if    //
+// not, write to the Free Software Foundation, Inc.,     //
+// 51 Franklin Street, 5th Floor, Boston, MA 02110-1301, //
+// USA.                                                  //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//    contact:    Olaf Conrad                            //
+//                Institute of Geography                 //
+//                University of Goettingen               //
+//                Goldschmidtstr. 5                      //
+//                37077 Goettingen                       //
+//                Germany                                //
+//                                                       //
+//    e-mail:     oconrad@saga-gis.org                   //
+//                                                       //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+
+
+//---------------------------------------------------------
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "table_value.h"
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+#define ARENA_COMPACT_MIN	65536	// arenas are not compacted before this many bytes became unused
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+TSG_Table_Value_Type CSG_Table_Value_Column::Get_Type(void) const
+{
+	return( m_pColumn->Get_Type() );
+}
+
+//---------------------------------------------------------
+bool CSG_Table_Value_Column::Set_Value(const CSG_Bytes &Value)	{	return( m_pColumn->Set_Value(m_iRow, Value) );	}
+bool CSG_Table_Value_Column::Set_Value(const SG_Char   *Value)	{	return( m_pColumn->Set_Value(m_iRow, Value) );	}
+bool CSG_Table_Value_Column::Set_Value(int              Value)	{	return( m_pColumn->Set_Value(m_iRow, Value) );	}
+bool CSG_Table_Value_Column::Set_Value(sLong            Value)	{	return( m_pColumn->Set_Value(m_iRow, Value) );	}
+bool CSG_Table_Value_Column::Set_Value(double           Value)	{	return( m_pColumn->Set_Value(m_iRow, Value) );	}
+
+//---------------------------------------------------------
+CSG_Bytes       CSG_Table_Value_Column::asBinary(void)         const	{	return( m_pColumn->asBinary(m_iRow          ) );	}
+const SG_Char * CSG_Table_Value_Column::asString(int Decimals) const	{	return( m_pColumn->asString(m_iRow, Decimals) );	}
+int             CSG_Table_Value_Column::asInt   (void)         const	{	return( m_pColumn->asInt   (m_iRow          ) );	}
+sLong           CSG_Table_Value_Column::asLong  (void)         const	{	return( m_pColumn->asLong  (m_iRow          ) );	}
+double          CSG_Table_Value_Column::asDouble(void)         const	{	return( m_pColumn->asDouble(m_iRow          ) );	}
+
+//---------------------------------------------------------
+CSG_Table_Value & CSG_Table_Value_Column::operator = (const CSG_Table_Value &Value)
+{
+	switch( Get_Type() )
+	{
+	case SG_TABLE_VALUE_TYPE_Binary:	Set_Value(Value.asBinary());	break;
+	case SG_TABLE_VALUE_TYPE_String:
+	case SG_TABLE_VALUE_TYPE_Date  :	Set_Value(Value.asString());	break;
+	case SG_TABLE_VALUE_TYPE_Int   :	Set_Value(Value.asInt   ());	break;
+	case SG_TABLE_VALUE_TYPE_Long  :	Set_Value(Value.asLong  ());	break;
+	case SG_TABLE_VALUE_TYPE_Double:	Set_Value(Value.asDouble());	break;
+	}
+
+	return( *this );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+CSG_Table_Column::CSG_Table_Column(TSG_Data_Type Type)
+{
+	m_Data_Type	= Type;
+
+	switch( Type )
+	{
+	default:
+	case SG_DATATYPE_String:	m_Type	= SG_TABLE_VALUE_TYPE_String;	break;
+
+	case SG_DATATYPE_Date  :	m_Type	= SG_TABLE_VALUE_TYPE_Date  ;	break;
+
+	case SG_DATATYPE_Color :
+	case SG_DATATYPE_Byte  :
+	case SG_DATATYPE_Char  :
+	case SG_DATATYPE_Word  :
+	case SG_DATATYPE_Short :
+	case SG_DATATYPE_DWord :
+	case SG_DATATYPE_Int   :	m_Type	= SG_TABLE_VALUE_TYPE_Int   ;	break;
+
+	case SG_DATATYPE_ULong :
+	case SG_DATATYPE_Long  :	m_Type	= SG_TABLE_VALUE_TYPE_Long  ;	break;
+
+	case SG_DATATYPE_Float :
+	case SG_DATATYPE_Double:	m_Type	= SG_TABLE_VALUE_TYPE_Double;	break;
+
+	case SG_DATATYPE_Binary:	m_Type	= SG_TABLE_VALUE_TYPE_Binary;	break;
+	}
+
+	switch( m_Type )
+	{
+	case SG_TABLE_VALUE_TYPE_Binary:
+	case SG_TABLE_VALUE_TYPE_String:	m_Values.Create(sizeof(TText ), 0, SG_ARRAY_GROWTH_3);	break;
+	case SG_TABLE_VALUE_TYPE_Date  :
+	case SG_TABLE_VALUE_TYPE_Int   :	m_Values.Create(sizeof(int   ), 0, SG_ARRAY_GROWTH_3);	break;
+	case SG_TABLE_VALUE_TYPE_Long  :	m_Values.Create(sizeof(sLong ), 0, SG_ARRAY_GROWTH_3);	break;
+	case SG_TABLE_VALUE_TYPE_Double:	m_Values.Create(sizeof(double), 0, SG_ARRAY_GROWTH_3);	break;
+	}
+
+	m_NoData.Create(sizeof(BYTE), 0, SG_ARRAY_GROWTH_3);
+
+	m_Arena		= NULL;
+	m_nArena	= 0;
+	m_nBuffer	= 0;
+	m_nGarbage	= 0;
+}
+
+//---------------------------------------------------------
+CSG_Table_Column::~CSG_Table_Column(void)
+{
+	SG_FREE_SAFE(m_Arena);
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//						Rows							 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CSG_Table_Column::Set_Count(int nRows)
+{
+	int		i, nOld	= Get_Count();
+
+	if( nRows < 0 || nRows == nOld )
+	{
+		return( nRows == nOld );
+	}
+
+	//-----------------------------------------------------
+	if( nRows < nOld )
+	{
+		for(i=nRows; i<nOld; i++)
+		{
+			Set_NoData(i, false);
+
+			if( m_Type == SG_TABLE_VALUE_TYPE_String || m_Type == SG_TABLE_VALUE_TYPE_Binary )
+			{
+				m_nGarbage	+= _Get_Text(i).Size;
+			}
+		}
+
+		if( nRows == 0 )
+		{
+			SG_FREE_SAFE(m_Arena);
+
+			m_nArena	= 0;
+			m_nBuffer	= 0;
+			m_nGarbage	= 0;
+		}
+	}
+
+	//-----------------------------------------------------
+	if( !m_Values.Set_Array(nRows) || !m_NoData.Set_Array((nRows + 7) / 8) )
+	{
+		return( false );
+	}
+
+	if( nRows > nOld )
+	{
+		memset((BYTE *)m_Values.Get_Array() + nOld * m_Values.Get_Value_Size(), 0, (nRows - nOld) * m_Values.Get_Value_Size());
+
+		memset((BYTE *)m_NoData.Get_Array() + (nOld + 7) / 8, 0, m_NoData.Get_Size() - (nOld + 7) / 8);
+	}
+
+	return( true );
+}
+
+//---------------------------------------------------------
+bool CSG_Table_Column::Ins_Row(int iRow)
+{
+	int		n	= Get_Count();
+
+	if( iRow < 0 || iRow > n || !Set_Count(n + 1) )
+	{
+		return( false );
+	}
+
+	BYTE	*pValue	= (BYTE *)m_Values.Get_Entry(iRow);
+	size_t	 Size	= m_Values.Get_Value_Size();
+
+	memmove(pValue + Size, pValue, (n - iRow) * Size);
+	memset (pValue, 0, Size);
+
+	for(int i=n; i>iRow; i--)
+	{
+		Set_NoData(i, is_NoData(i - 1));
+	}
+
+	Set_NoData(iRow, false);
+
+	return( true );
+}
+
+//---------------------------------------------------------
+bool CSG_Table_Column::Del_Row(int iRow)
+{
+	int		n	= Get_Count() - 1;
+
+	if( iRow < 0 || iRow > n )
+	{
+		return( false );
+	}
+
+	if( m_Type == SG_TABLE_VALUE_TYPE_String || m_Type == SG_TABLE_VALUE_TYPE_Binary )
+	{
+		m_nGarbage	+= _Get_Text(iRow).Size;
+	}
+
+	BYTE	*pValue	= (BYTE *)m_Values.Get_Entry(iRow);
+	size_t	 Size	= m_Values.Get_Value_Size();
+
+	memmove(pValue, pValue + Size, (n - iRow) * Size);
+
+	for(int i=iRow; i<n; i++)
+	{
+		Set_NoData(i, is_NoData(i + 1));
+	}
+
+	if( m_Type == SG_TABLE_VALUE_TYPE_String || m_Type == SG_TABLE_VALUE_TYPE_Binary )
+	{
+		_Get_Text(n).Size	= 0;	// has been moved, don't count it as garbage in Set_Count()
+	}
+
+	return( Set_Count(n) );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//						Text Arena						 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CSG_Table_Column::_Set_Text(int iRow, const BYTE *Bytes, int Size)
+{
+	TText	&Text	= _Get_Text(iRow);
+
+	if( !Bytes || Size < 0 )
+	{
+		Size	= 0;
+	}
+
+	//-----------------------------------------------------
+	if( Size <= Text.Size )	// overwrite in place
+	{
+		if( Size > 0 )
+		{
+			memmove(m_Arena + Text.Offset, Bytes, Size);
+		}
+
+		m_nGarbage	+= Text.Size - Size;
+		Text.Size	 = Size;
+
+		return( true );
+	}
+
+	//-----------------------------------------------------
+	CSG_Bytes	Copy;	// source might be part of the arena, which is going to be moved
+
+	if( m_Arena && Bytes >= m_Arena && Bytes < m_Arena + m_nArena )
+	{
+		Copy.Create(Bytes, Size);
+
+		Bytes	= Copy.Get_Bytes();
+	}
+
+	m_nGarbage	+= Text.Size;
+	Text.Size	 = 0;
+
+	if( m_nGarbage > ARENA_COMPACT_MIN && m_nGarbage > m_nArena / 2 )
+	{
+		_Compact();
+	}
+
+	if( m_nArena + Size > m_nBuffer )
+	{
+		sLong	nBuffer	= m_nBuffer < 4096 ? 4096 : m_nBuffer;
+
+		while( nBuffer < m_nArena + Size )
+		{
+			nBuffer	*= 2;
+		}
+
+		BYTE	*pArena	= (BYTE *)SG_Realloc(m_Arena, nBuffer);
+
+		if( !pArena )
+		{
+			return( false );
+		}
+
+		m_Arena		= pArena;
+		m_nBuffer	= nBuffer;
+	}
+
+	memcpy(m_Arena + m_nArena, Bytes, Size);
+
+	Text.Offset	 = m_nArena;
+	Text.Size	 = Size;
+	m_nArena	+= Size;
+
+	return( true );
+}
+
+//---------------------------------------------------------
+bool CSG_Table_Column::_Compact(void)
+{
+	sLong	nBuffer	= m_nArena - m_nGarbage > 0 ? m_nArena - m_nGarbage : 1;
+
+	BYTE	*pArena	= (BYTE *)SG_Malloc(nBuffer);
+
+	if( !pArena )
+	{
+		return( false );
+	}
+
+	sLong	nArena	= 0;
+
+	for(int i=0; i<Get_Count(); i++)
+	{
+		TText	&Text	= _Get_Text(i);
+
+		if( Text.Size > 0 )
+		{
+			memcpy(pArena + nArena, m_Arena + Text.Offset, Text.Size);
+
+			Text.Offset	 = nArena;
+			nArena		+= Text.Size;
+		}
+	}
+
+	SG_Free(m_Arena);
+
+	m_Arena		= pArena;
+	m_nArena	= nArena;
+	m_nBuffer	= nBuffer;
+	m_nGarbage	= 0;
+
+	return( true );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//						Set Values						 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CSG_Table_Column::Set_Value(int iRow, const CSG_Bytes &Value)
+{
+	switch( m_Type )
+	{
+	case SG_TABLE_VALUE_TYPE_Binary:
+		Set_NoData(iRow, false);
+
+		return( _Set_Text(iRow, Value.Get_Bytes(), Value.Get_Count()) );
+
+	default:
+		return( Set_Value(iRow, (const SG_Char *)Value.Get_Bytes()) );
+	}
+}
+
+//---------------------------------------------------------
+bool CSG_Table_Column::Set_Value(int iRow, const SG_Char *Value)
+{
+	switch( m_Type )
+	{
+	case SG_TABLE_VALUE_TYPE_Binary:
+		return( Set_Value(iRow, CSG_Bytes((const BYTE *)Value, (int)(Value && *Value ? SG_STR_LEN(Value) : 0))) );
+
+	case SG_TABLE_VALUE_TYPE_String:
+		if( Value )
+		{
+			int		Size	= *Value ? (int)((SG_STR_LEN(Value) + 1) * sizeof(SG_Char)) : 0;
+
+			if( Size != _Get_Text(iRow).Size || (Size > 0 && memcmp(m_Arena + _Get_Text(iRow).Offset, Value, Size)) )
+			{
+				Set_NoData(iRow, false);
+
+				return( _Set_Text(iRow, (const BYTE *)Value, Size) );
+			}
+		}
+
+		return( false );
+
+	case SG_TABLE_VALUE_TYPE_Date:
+		return( Set_Value(iRow, SG_Date_To_Number(Value)) );
+
+	case SG_TABLE_VALUE_TYPE_Int:
+	case SG_TABLE_VALUE_TYPE_Long:
+		{
+			int			i;
+			CSG_String	s(Value);
+
+			return( s.asInt(i) ? Set_Value(iRow, i) : false );
+		}
+
+	case SG_TABLE_VALUE_TYPE_Double:
+		{
+			double		d;
+			CSG_String	s(Value);
+
+			return( s.asDouble(d) ? Set_Value(iRow, d) : false );
+		}
+	}
+
+	return( false );
+}
+
+//---------------------------------------------------------
+bool CSG_Table_Column::Set_Value(int iRow, int Value)
+{
+	switch( m_Type )
+	{
+	case SG_TABLE_VALUE_TYPE_Binary:
+		return( Set_Value(iRow, CSG_Bytes((const BYTE *)&Value, sizeof(Value))) );
+
+	case SG_TABLE_VALUE_TYPE_String:
+		return( Set_Value(iRow, CSG_String::Format(SG_T("%d"), Value).c_str()) );
+
+	case SG_TABLE_VALUE_TYPE_Date:
+	case SG_TABLE_VALUE_TYPE_Int:
+		Set_NoData(iRow, false);
+
+		if( ((int *)m_Values.Get_Array())[iRow] != Value )
+		{
+			((int *)m_Values.Get_Array())[iRow]	= Value;
+
+			return( true );
+		}
+
+		return( false );
+
+	case SG_TABLE_VALUE_TYPE_Long:
+		return( Set_Value(iRow, (sLong)Value) );
+
+	case SG_TABLE_VALUE_TYPE_Double:
+		return( Set_Value(iRow, (double)Value) );
+	}
+
+	return( false );
+}
+
+//---------------------------------------------------------
+bool CSG_Table_Column::Set_Value(int iRow, sLong Value)
+{
+	switch( m_Type )
+	{
+	case SG_TABLE_VALUE_TYPE_Binary:
+		return( Set_Value(iRow, CSG_Bytes((const BYTE *)&Value, sizeof(Value))) );
+
+	case SG_TABLE_VALUE_TYPE_String:
+		return( Set_Value(iRow, CSG_String::Format(SG_T("%ld"), Value).c_str()) );
+
+	case SG_TABLE_VALUE_TYPE_Date:
+	case SG_TABLE_VALUE_TYPE_Int:
+		return( Set_Value(iRow, (int)Value) );
+
+	case SG_TABLE_VALUE_TYPE_Long:
+		Set_NoData(iRow, false);
+
+		if( ((sLong *)m_Values.Get_Array())[iRow] != Value )
+		{
+			((sLong *)m_Values.Get_Array())[iRow]	= Value;
+
+			return( true );
+		}
+
+		return( false );
+
+	case SG_TABLE_VALUE_TYPE_Double:
+		return( Set_Value(iRow, (double)Value) );
+	}
+
+	return( false );
+}
+
+//---------------------------------------------------------
+bool CSG_Table_Column::Set_Value(int iRow, double Value)
+{
+	switch( m_Type )
+	{
+	case SG_TABLE_VALUE_TYPE_Binary:
+		return( Set_Value(iRow, CSG_Bytes((const BYTE *)&Value, sizeof(Value))) );
+
+	case SG_TABLE_VALUE_TYPE_String:
+		return( Set_Value(iRow, CSG_String::Format(SG_T("%f"), Value).c_str()) );
+
+	case SG_TABLE_VALUE_TYPE_Date:
+	case SG_TABLE_VALUE_TYPE_Int:
+		return( Set_Value(iRow, (int)Value) );
+
+	case SG_TABLE_VALUE_TYPE_Long:
+		return( Set_Value(iRow, (sLong)Value) );
+
+	case SG_TABLE_VALUE_TYPE_Double:
+		Set_NoData(iRow, false);
+
+		if( ((double *)m_Values.Get_Array())[iRow] != Value )
+		{
+			((double *)m_Values.Get_Array())[iRow]	= Value;
+
+			return( true );
+		}
+
+		return( false );
+	}
+
+	return( false );
+}
+
+//---------------------------------------------------------
+bool CSG_Table_Column::Set_NoData(int iRow, bool bOn)
+{
+	BYTE	&Flags	= ((BYTE *)m_NoData.Get_Array())[iRow >> 3];
+
+	if( bOn )
+	{
+		Flags	|=  (1 << (iRow & 7));
+	}
+	else
+	{
+		Flags	&= ~(1 << (iRow & 7));
+	}
+
+	return( true );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//						Get Values						 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+CSG_Bytes CSG_Table_Column::asBinary(int iRow) const
+{
+	if( m_Type == SG_TABLE_VALUE_TYPE_Binary )
+	{
+		TText	&Text	= _Get_Text(iRow);
+
+		return( CSG_Bytes(Text.Size > 0 ? m_Arena + Text.Offset : NULL, Text.Size) );
+	}
+
+	const SG_Char	*s	= asString(iRow);
+
+	return( CSG_Bytes((BYTE *)s, (int)(s && *s ? SG_STR_LEN(s) : 0) * sizeof(SG_Char)) );
+}
+
+//---------------------------------------------------------
+const SG_Char * CSG_Table_Column::asString(int iRow, int Decimals) const
+{
+	static CSG_String	s;
+
+	switch( m_Type )
+	{
+	case SG_TABLE_VALUE_TYPE_Binary:
+		return( _Get_Text(iRow).Size > 0 ? (const SG_Char *)(m_Arena + _Get_Text(iRow).Offset) : NULL );
+
+	case SG_TABLE_VALUE_TYPE_String:
+		return( _Get_Text(iRow).Size > 0 ? (const SG_Char *)(m_Arena + _Get_Text(iRow).Offset) : SG_T("") );
+
+	case SG_TABLE_VALUE_TYPE_Date:
+		s	= SG_Number_To_Date(((int *)m_Values.Get_Array())[iRow]);
+		break;
+
+	case SG_TABLE_VALUE_TYPE_Int:
+		s.Printf(SG_T("%d"), ((int *)m_Values.Get_Array())[iRow]);
+		break;
+
+	case SG_TABLE_VALUE_TYPE_Long:
+		s.Printf(SG_T("%ld"), ((sLong *)m_Values.Get_Array())[iRow]);
+		break;
+
+	case SG_TABLE_VALUE_TYPE_Double:
+		s	= SG_Get_String(((double *)m_Values.Get_Array())[iRow], Decimals, false);
+		break;
+	}
+
+	return( s.c_str() );
+}
+
+//---------------------------------------------------------
+int CSG_Table_Column::asInt(int iRow) const
+{
+	switch( m_Type )
+	{
+	case SG_TABLE_VALUE_TYPE_Binary:	return( _Get_Text(iRow).Size );
+	case SG_TABLE_VALUE_TYPE_String:	return( CSG_String(asString(iRow)).asInt() );
+	case SG_TABLE_VALUE_TYPE_Date  :
+	case SG_TABLE_VALUE_TYPE_Int   :	return(        ((int    *)m_Values.Get_Array())[iRow] );
+	case SG_TABLE_VALUE_TYPE_Long  :	return( (int  )((sLong  *)m_Values.Get_Array())[iRow] );
+	case SG_TABLE_VALUE_TYPE_Double:	return( (int  )((double *)m_Values.Get_Array())[iRow] );
+	}
+
+	return( 0 );
+}
+
+//---------------------------------------------------------
+sLong CSG_Table_Column::asLong(int iRow) const
+{
+	switch( m_Type )
+	{
+	case SG_TABLE_VALUE_TYPE_Binary:	return( _Get_Text(iRow).Size );
+	case SG_TABLE_VALUE_TYPE_String:	return( CSG_String(asString(iRow)).asInt() );
+	case SG_TABLE_VALUE_TYPE_Date  :
+	case SG_TABLE_VALUE_TYPE_Int   :	return(        ((int    *)m_Values.Get_Array())[iRow] );
+	case SG_TABLE_VALUE_TYPE_Long  :	return(        ((sLong  *)m_Values.Get_Array())[iRow] );
+	case SG_TABLE_VALUE_TYPE_Double:	return( (sLong)((double *)m_Values.Get_Array())[iRow] );
+	}
+
+	return( 0 );
+}
+
+//---------------------------------------------------------
+double CSG_Table_Column::asDouble(int iRow) const
+{
+	switch( m_Type )
+	{
+	case SG_TABLE_VALUE_TYPE_Binary:	return( 0.0 );
+	case SG_TABLE_VALUE_TYPE_String:	return( CSG_String(asString(iRow)).asDouble() );
+	case SG_TABLE_VALUE_TYPE_Date  :
+	case SG_TABLE_VALUE_TYPE_Int   :	return( ((int    *)m_Values.Get_Array())[iRow] );
+	case SG_TABLE_VALUE_TYPE_Long  :	return( (double)((sLong *)m_Values.Get_Array())[iRow] );
+	case SG_TABLE_VALUE_TYPE_Double:	return( ((double *)m_Values.Get_Array())[iRow] );
+	}
+
+	return( 0.0 );
+}
+
+//---------------------------------------------------------
+// Each thread takes its row proxies from its own ring, so that
+// records of a columnar table can be read in parallel loops.
+// A ring is created with the first request of a thread and is
+// kept for the thread's life time.
+
+static CSG_Table_Value_Column	*gSG_Column_Proxies	= NULL;
+static int						 gSG_Column_iProxy	= 0;
+
+#ifdef _OPENMP
+#pragma omp threadprivate(gSG_Column_Proxies, gSG_Column_iProxy)
+#endif
+
+//---------------------------------------------------------
+CSG_Table_Value * CSG_Table_Column::Get_Value(int iRow)
+{
+	if( gSG_Column_Proxies == NULL )
+	{
+		gSG_Column_Proxies	= new CSG_Table_Value_Column[SG_TABLE_COLUMN_PROXIES];
+	}
+
+	CSG_Table_Value_Column	*pValue	= gSG_Column_Proxies + gSG_Column_iProxy;
+
+	gSG_Column_iProxy	= (gSG_Column_iProxy + 1) % SG_TABLE_COLUMN_PROXIES;
+
+	pValue->m_pColumn	= this;
+	pValue->m_iRow		= iRow;
+
+	return( pValue );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
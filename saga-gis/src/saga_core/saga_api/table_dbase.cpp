@@ -186,6 +186,8 @@ bool CSG_Table_DBase::Open_Read(const SG_Char *FileName, CSG_Table *pTable, bool
 			}
 		}
 
+		pTable->Set_Columnar(SG_Table_Get_Columnar());
+
 		//-------------------------------------------------
 		if( bRecords_Load && Get_Record_Count() > 0 && Move_First() )
 		{
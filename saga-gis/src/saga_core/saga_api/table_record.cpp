@@ -80,7 +80,7 @@ CSG_Table_Record::CSG_Table_Record(CSG_Table *pTable, int Index)
 	m_Index		= Index;
 	m_Flags		= 0;
 
-	if( m_pTable && m_pTable->Get_Field_Count() > 0 )
+	if( m_pTable && m_pTable->Get_Field_Count() > 0 && !m_pTable->is_Columnar() )
 	{
 		m_Values	= (CSG_Table_Value **)SG_Malloc(m_pTable->Get_Field_Count() * sizeof(CSG_Table_Value *));
 
@@ -103,7 +103,7 @@ CSG_Table_Record::~CSG_Table_Record(void)
 		m_pTable->Select(m_Index, true);
 	}
 
-	if( m_pTable->Get_Field_Count() > 0 )
+	if( m_Values )
 	{
 		for(int iField=0; iField<m_pTable->Get_Field_Count(); iField++)
 		{
@@ -213,6 +213,75 @@ int CSG_Table_Record::_Get_Field(const CSG_String &Field) const
 }
 
 
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// Creates the value objects from the table's columns,
+// used when switching back to record storage.
+//---------------------------------------------------------
+bool CSG_Table_Record::_Set_Values(void)
+{
+	if( m_Values || m_pTable->Get_Field_Count() <= 0 )
+	{
+		return( false );
+	}
+
+	m_Values	= (CSG_Table_Value **)SG_Malloc(m_pTable->Get_Field_Count() * sizeof(CSG_Table_Value *));
+
+	for(int iField=0; iField<m_pTable->Get_Field_Count(); iField++)
+	{
+		CSG_Table_Value_Column	Value(m_pTable->m_Columns[iField], m_Index);
+
+		m_Values[iField]	= _Create_Value(m_pTable->Get_Field_Type(iField));
+
+		*m_Values[iField]	= Value;
+	}
+
+	return( true );
+}
+
+//---------------------------------------------------------
+// Moves the values to the table's columns and releases
+// the value objects, used when switching to columnar storage.
+//---------------------------------------------------------
+bool CSG_Table_Record::_Del_Values(void)
+{
+	if( !m_Values )
+	{
+		return( false );
+	}
+
+	for(int iField=0; iField<m_pTable->Get_Field_Count(); iField++)
+	{
+		CSG_Table_Value_Column	Value(m_pTable->m_Columns[iField], m_Index);
+
+		Value	= *m_Values[iField];
+
+		delete(m_Values[iField]);
+	}
+
+	SG_FREE_SAFE(m_Values);
+
+	return( true );
+}
+
+//---------------------------------------------------------
+CSG_Table_Value * CSG_Table_Record::Get_Value(int iField)
+{
+	return( m_Values ? m_Values[iField] : m_pTable->m_Columns[iField]->Get_Value(m_Index) );
+}
+
+//---------------------------------------------------------
+CSG_Table_Value & CSG_Table_Record::operator [] (int iField) const
+{
+	return( *(m_Values ? m_Values[iField] : m_pTable->m_Columns[iField]->Get_Value(m_Index)) );
+}
+
+
 ///////////////////////////////////////////////////////////
 //														 //
 //														 //
@@ -268,7 +337,7 @@ bool CSG_Table_Record::Set_Value		(int           iField, const CSG_Bytes &Value)
 {
 	if( iField >= 0 && iField < m_pTable->Get_Field_Count() )
 	{
-		if( m_Values[iField]->Set_Value(Value) )
+		if( m_Values ? m_Values[iField]->Set_Value(Value) : m_pTable->m_Columns[iField]->Set_Value(m_Index, Value) )
 		{
 			Set_Modified(true);
 
@@ -292,7 +361,7 @@ bool CSG_Table_Record::Set_Value(int iField, const CSG_String &Value)
 {
 	if( iField >= 0 && iField < m_pTable->Get_Field_Count() )
 	{
-		if( m_Values[iField]->Set_Value(Value) )
+		if( m_Values ? m_Values[iField]->Set_Value(Value) : m_pTable->m_Columns[iField]->Set_Value(m_Index, Value.c_str()) )
 		{
 			Set_Modified(true);
 
@@ -316,7 +385,7 @@ bool CSG_Table_Record::Set_Value(int iField, double Value)
 {
 	if( iField >= 0 && iField < m_pTable->Get_Field_Count() )
 	{
-		if( m_Values[iField]->Set_Value(Value) )
+		if( m_Values ? m_Values[iField]->Set_Value(Value) : m_pTable->m_Columns[iField]->Set_Value(m_Index, Value) )
 		{
 			Set_Modified(true);
 
@@ -379,12 +448,17 @@ bool CSG_Table_Record::Set_NoData(int iField)
 {
 	if( iField >= 0 && iField < m_pTable->Get_Field_Count() )
 	{
+		CSG_Table_Value_Column	Column(m_Values ? NULL : m_pTable->m_Columns[iField], m_Index);
+
+		CSG_Table_Value	*pValue	= m_Values ? m_Values[iField] : &Column;
+
+		bool	bChanged	= true;
+
 		switch( m_pTable->Get_Field_Type(iField) )
 		{
 		default:
 		case SG_DATATYPE_String:
-			if( !m_Values[iField]->Set_Value(SG_T("")) )
-				return( false );
+			bChanged	= pValue->Set_Value(SG_T(""));
 			break;
 
 		case SG_DATATYPE_Date:
@@ -399,15 +473,31 @@ bool CSG_Table_Record::Set_NoData(int iField)
 		case SG_DATATYPE_Long:
 		case SG_DATATYPE_Float:
 		case SG_DATATYPE_Double:
-			if( !m_Values[iField]->Set_Value(m_pTable->Get_NoData_Value()) )
-				return( false );
+			bChanged	= pValue->Set_Value(m_pTable->Get_NoData_Value());
 			break;
 
 		case SG_DATATYPE_Binary:
-			m_Values[iField]->asBinary().Destroy();
+			if( m_Values )
+			{
+				m_Values[iField]->asBinary().Destroy();
+			}
+			else
+			{
+				pValue->Set_Value(CSG_Bytes());
+			}
 			break;
 		}
 
+		if( !m_Values )
+		{
+			m_pTable->m_Columns[iField]->Set_NoData(m_Index);
+		}
+
+		if( !bChanged )
+		{
+			return( false );
+		}
+
 		Set_Modified(true);
 
 		m_pTable->Set_Update_Flag();
@@ -429,6 +519,28 @@ bool CSG_Table_Record::is_NoData(int iField) const
 {
 	if( iField >= 0 && iField < m_pTable->Get_Field_Count() )
 	{
+		if( !m_Values )	// columnar storage, no-data bitmap first
+		{
+			CSG_Table_Column	*pColumn	= m_pTable->m_Columns[iField];
+
+			switch( pColumn->Get_Type() )
+			{
+			case SG_TABLE_VALUE_TYPE_String:
+				return( false );
+
+			case SG_TABLE_VALUE_TYPE_Binary:
+				return( pColumn->is_NoData(m_Index) || pColumn->asInt(m_Index) == 0 );
+
+			case SG_TABLE_VALUE_TYPE_Date:
+			case SG_TABLE_VALUE_TYPE_Int:
+			case SG_TABLE_VALUE_TYPE_Long:
+				return( pColumn->is_NoData(m_Index) || m_pTable->is_NoData_Value(pColumn->asInt   (m_Index)) );
+
+			case SG_TABLE_VALUE_TYPE_Double:
+				return( pColumn->is_NoData(m_Index) || m_pTable->is_NoData_Value(pColumn->asDouble(m_Index)) );
+			}
+		}
+
 		switch( m_pTable->Get_Field_Type(iField) )
 		{
 		default:
@@ -474,7 +586,7 @@ bool CSG_Table_Record::is_NoData(const CSG_String &Field) const
 //---------------------------------------------------------
 const SG_Char * CSG_Table_Record::asString(int iField, int Decimals) const
 {
-	return( iField >= 0 && iField < m_pTable->Get_Field_Count() ? m_Values[iField]->asString(Decimals) : NULL );
+	return( iField >= 0 && iField < m_pTable->Get_Field_Count() ? (m_Values ? m_Values[iField]->asString(Decimals) : m_pTable->m_Columns[iField]->asString(m_Index, Decimals)) : NULL );
 }
 
 const SG_Char * CSG_Table_Record::asString(const CSG_String &Field, int Decimals) const
@@ -485,7 +597,7 @@ const SG_Char * CSG_Table_Record::asString(const CSG_String &Field, int Decimals
 //---------------------------------------------------------
 int CSG_Table_Record::asInt(int iField) const
 {
-	return( iField >= 0 && iField < m_pTable->Get_Field_Count() ? m_Values[iField]->asInt() : 0 );
+	return( iField >= 0 && iField < m_pTable->Get_Field_Count() ? (m_Values ? m_Values[iField]->asInt() : m_pTable->m_Columns[iField]->asInt(m_Index)) : 0 );
 }
 
 int CSG_Table_Record::asInt(const CSG_String &Field) const
@@ -496,7 +608,7 @@ int CSG_Table_Record::asInt(const CSG_String &Field) const
 //---------------------------------------------------------
 sLong CSG_Table_Record::asLong(int iField) const
 {
-	return( iField >= 0 && iField < m_pTable->Get_Field_Count() ? m_Values[iField]->asLong() : 0 );
+	return( iField >= 0 && iField < m_pTable->Get_Field_Count() ? (m_Values ? m_Values[iField]->asLong() : m_pTable->m_Columns[iField]->asLong(m_Index)) : 0 );
 }
 
 sLong CSG_Table_Record::asLong(const CSG_String &Field) const
@@ -507,7 +619,7 @@ sLong CSG_Table_Record::asLong(const CSG_String &Field) const
 //---------------------------------------------------------
 double CSG_Table_Record::asDouble(int iField) const
 {
-	return( iField >= 0 && iField < m_pTable->Get_Field_Count() ? m_Values[iField]->asDouble() : 0.0 );
+	return( iField >= 0 && iField < m_pTable->Get_Field_Count() ? (m_Values ? m_Values[iField]->asDouble() : m_pTable->m_Columns[iField]->asDouble(m_Index)) : 0.0 );
 }
 
 double CSG_Table_Record::asDouble(const CSG_String &Field) const
@@ -532,7 +644,26 @@ bool CSG_Table_Record::Assign(CSG_Table_Record *pRecord)
 
 		for(int iField=0; iField<nFields; iField++)
 		{
-			*(m_Values[iField])	= *(pRecord->m_Values[iField]);
+			if( m_Values && pRecord->m_Values )
+			{
+				*(m_Values[iField])	= *(pRecord->m_Values[iField]);
+			}
+			else	// at least one of both is stored in columns
+			{
+				CSG_Table_Value_Column	Source(pRecord->m_Values ? NULL : pRecord->m_pTable->m_Columns[iField], pRecord->m_Index);
+				CSG_Table_Value_Column	Target(         m_Values ? NULL :          m_pTable->m_Columns[iField],          m_Index);
+
+				const CSG_Table_Value	&Value	= pRecord->m_Values ? *(pRecord->m_Values[iField]) : Source;
+
+				if( m_Values )
+				{
+					*(m_Values[iField])	= Value;
+				}
+				else
+				{
+					Target	= Value;
+				}
+			}
 		}
 
 		Set_Modified();
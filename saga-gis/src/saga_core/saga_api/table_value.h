@@ -553,6 +553,135 @@ private:
 };
 
 
+///////////////////////////////////////////////////////////
+//														 //
+//					Columnar Storage					 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+class CSG_Table_Value_Column : public CSG_Table_Value
+{
+	friend class CSG_Table_Column;
+
+public:
+	CSG_Table_Value_Column(void)												{	m_pColumn	= NULL;		m_iRow	= 0;		}
+	CSG_Table_Value_Column(class CSG_Table_Column *pColumn, int iRow)			{	m_pColumn	= pColumn;	m_iRow	= iRow;		}
+	virtual ~CSG_Table_Value_Column(void) {}
+
+	virtual TSG_Table_Value_Type	Get_Type		(void)				const;
+
+	//-----------------------------------------------------
+	virtual bool					Set_Value		(const CSG_Bytes &Value);
+	virtual bool					Set_Value		(const SG_Char   *Value);
+	virtual bool					Set_Value		(int              Value);
+	virtual bool					Set_Value		(sLong            Value);
+	virtual bool					Set_Value		(double           Value);
+
+	//-----------------------------------------------------
+	virtual CSG_Bytes				asBinary		(void)				const;
+	virtual const SG_Char *			asString		(int Decimals = -1)	const;
+	virtual int						asInt			(void)				const;
+	virtual sLong					asLong			(void)				const;
+	virtual double					asDouble		(void)				const;
+
+	//-----------------------------------------------------
+	virtual CSG_Table_Value &		operator = (const CSG_Table_Value        &Value);
+	CSG_Table_Value_Column &		operator = (const CSG_Table_Value_Column &Value)	{	*this = (const CSG_Table_Value &)Value;	return( *this );	}
+
+
+private:
+
+	int								m_iRow;
+
+	class CSG_Table_Column			*m_pColumn;
+
+};
+
+//---------------------------------------------------------
+#define SG_TABLE_COLUMN_PROXIES		64
+
+//---------------------------------------------------------
+/**
+  * CSG_Table_Column stores all values of one table field in
+  * a contiguous array of its storage type (int, sLong, double).
+  * Strings, dates' text and binaries are kept in a single byte
+  * arena, referenced per row by offset and size. A bitmap flags
+  * rows that have explicitly been set to no-data. Used by
+  * CSG_Table when switched to columnar storage mode.
+  * Writing text values is not thread-safe, because the arena
+  * might be reallocated. Pointers returned by asString() for
+  * string columns stay valid until the column is modified.
+*/
+//---------------------------------------------------------
+class SAGA_API_DLL_EXPORT CSG_Table_Column
+{
+public:
+	CSG_Table_Column(TSG_Data_Type Type);
+	virtual ~CSG_Table_Column(void);
+
+	TSG_Data_Type					Get_Data_Type	(void)	const	{	return( m_Data_Type );	}
+	TSG_Table_Value_Type			Get_Type		(void)	const	{	return( m_Type      );	}
+
+	int								Get_Count		(void)	const	{	return( (int)m_Values.Get_Size() );	}
+	bool							Set_Count		(int nRows);
+
+	bool							Ins_Row			(int iRow);
+	bool							Del_Row			(int iRow);
+
+	/// Direct access to the contiguous value array. Type is int for SG_TABLE_VALUE_TYPE_Int and _Date, sLong for _Long and double for _Double. Returns NULL for string and binary columns.
+	const void *					Get_Data		(void)	const	{	return( m_Type == SG_TABLE_VALUE_TYPE_String || m_Type == SG_TABLE_VALUE_TYPE_Binary ? NULL : m_Values.Get_Array() );	}
+
+	//-----------------------------------------------------
+	bool							Set_Value		(int iRow, const CSG_Bytes &Value);
+	bool							Set_Value		(int iRow, const SG_Char   *Value);
+	bool							Set_Value		(int iRow, int              Value);
+	bool							Set_Value		(int iRow, sLong            Value);
+	bool							Set_Value		(int iRow, double           Value);
+
+	bool							Set_NoData		(int iRow, bool bOn = true);
+	bool							is_NoData		(int iRow)	const	{	return( (((const BYTE *)m_NoData.Get_Array())[iRow >> 3] & (1 << (iRow & 7))) != 0 );	}
+
+	//-----------------------------------------------------
+	CSG_Bytes						asBinary		(int iRow)						const;
+	const SG_Char *					asString		(int iRow, int Decimals = -1)	const;
+	int								asInt			(int iRow)						const;
+	sLong							asLong			(int iRow)						const;
+	double							asDouble		(int iRow)						const;
+
+	/// Returns a value object referencing the given row. The object is taken from a small ring buffer owned by the calling thread and is only valid until this thread has made SG_TABLE_COLUMN_PROXIES further requests on any column.
+	CSG_Table_Value *				Get_Value		(int iRow);
+
+
+private:
+
+	typedef struct SText
+	{
+		sLong						Offset;
+
+		int							Size;
+	}
+	TText;
+
+
+	TSG_Data_Type					m_Data_Type;
+
+	TSG_Table_Value_Type			m_Type;
+
+	sLong							m_nArena, m_nBuffer, m_nGarbage;
+
+	BYTE							*m_Arena;
+
+	CSG_Array						m_Values, m_NoData;
+
+
+	TText &							_Get_Text		(int iRow)	const	{	return( ((TText *)m_Values.Get_Array())[iRow] );	}
+	bool							_Set_Text		(int iRow, const BYTE *Bytes, int Size);
+	bool							_Compact		(void);
+
+};
+
+
 ///////////////////////////////////////////////////////////
 //														 //
 //														 //
@@ -257,21 +257,6 @@ public:
 	CSG_TIN_Triangle *				Get_Triangle			(int Index)	const	{	return( Index >= 0 && Index < m_nTriangles ? m_Triangles[Index] : NULL );	}
 
 
-protected:
-
-	typedef struct
-	{
-		int							p1, p2;
-	}
-	TTIN_Edge;
-
-	typedef struct
-	{
-		int							p1, p2, p3;
-	}
-	TTIN_Triangle;
-
-
 protected:
 
 	int								m_nEdges, m_nTriangles;
@@ -297,8 +282,6 @@ protected:
 	bool							_Add_Triangle			(CSG_TIN_Node *a, CSG_TIN_Node *b, CSG_TIN_Node *c);
 
 	bool							_Triangulate			(void);
-	bool							_Triangulate			(CSG_TIN_Node **Nodes, int nNodes, TTIN_Triangle *Triangles, int &nTriangles);
-	int								_CircumCircle			(double xp, double yp, double x1, double y1, double x2, double y2, double x3, double y3, double *xc, double *yc, double *r);
 
 };
 
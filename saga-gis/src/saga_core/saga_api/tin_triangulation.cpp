@@ -56,6 +56,7 @@
 //---------------------------------------------------------
 
 
+
 ///////////////////////////////////////////////////////////
 //														 //
 //														 //
@@ -63,10 +64,20 @@
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-// The Delaunay Triangulation algorithm used here is based
-// on Paul Bourke's C source codes, which can be found at:
+// The Delaunay triangulation is constructed incrementally
+// (Bowyer-Watson). Points are inserted in a biased randomized
+// order (BRIO) with each round sorted along a Hilbert curve,
+// so that a visibility walk from the last created triangle
+// locates the next point in a few steps. The hull is closed
+// by 'ghost' triangles sharing one vertex at infinity, which
+// makes a bounding super triangle unnecessary.
+//
+// Orientation and in-circle tests use a floating point
+// filter backed by exact expansion arithmetic, following:
 //
-//     http://astronomy.swin.edu.au/~pbourke/
+//     Shewchuk, J.R. (1997): Adaptive Precision Floating-
+//     Point Arithmetic and Fast Robust Geometric Predicates.
+//     Discrete & Computational Geometry 18:305-363.
 //
 //---------------------------------------------------------
 
@@ -78,353 +89,830 @@
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
+#include <string.h>
+
 #include "tin.h"
 
 
 ///////////////////////////////////////////////////////////
 //														 //
-//														 //
+//					Robust Predicates					 //
 //														 //
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-int SG_TIN_Compare(const void *pp1, const void *pp2)
+#define SG_PREDICATE_EPSILON	1.1102230246251565e-16	// 2^-53
+#define SG_PREDICATE_SPLITTER	134217729.0				// 2^27 + 1
+
+#define SG_ORIENT_ERRBOUND		((3.0 + 16.0 * SG_PREDICATE_EPSILON) * SG_PREDICATE_EPSILON)
+#define SG_INCIRCLE_ERRBOUND	((10.0 + 96.0 * SG_PREDICATE_EPSILON) * SG_PREDICATE_EPSILON)
+
+//---------------------------------------------------------
+static inline void	SG_Two_Sum			(double a, double b, double &x, double &y)
 {
-	CSG_TIN_Node	*p1	= *((CSG_TIN_Node **)pp1),
-					*p2	= *((CSG_TIN_Node **)pp2);
+	x	= a + b;	double	bv	= x - a, av	= x - bv;	y	= (a - av) + (b - bv);
+}
 
-	if( p1->Get_X() < p2->Get_X() )
+//---------------------------------------------------------
+static inline void	SG_Fast_Two_Sum		(double a, double b, double &x, double &y)
+{
+	x	= a + b;	y	= b - (x - a);
+}
+
+//---------------------------------------------------------
+static inline void	SG_Two_Diff			(double a, double b, double &x, double &y)
+{
+	x	= a - b;	double	bv	= a - x, av	= x + bv;	y	= (a - av) + (bv - b);
+}
+
+//---------------------------------------------------------
+static inline void	SG_Split			(double a, double &hi, double &lo)
+{
+	double	c	= SG_PREDICATE_SPLITTER * a;	hi	= c - (c - a);	lo	= a - hi;
+}
+
+//---------------------------------------------------------
+static inline void	SG_Two_Product		(double a, double b, double &x, double &y)
+{
+	double	ahi, alo, bhi, blo;
+
+	x	= a * b;
+
+	SG_Split(a, ahi, alo);
+	SG_Split(b, bhi, blo);
+
+	y	= alo * blo - (((x - ahi * bhi) - alo * bhi) - ahi * blo);
+}
+
+//---------------------------------------------------------
+/**
+  * Exact difference of two doubles as expansion of up to two
+  * non-overlapping components in increasing magnitude.
+*/
+static int			SG_Expansion_Diff	(double a, double b, double *h)
+{
+	double	x, y;	int	n	= 0;
+
+	SG_Two_Diff(a, b, x, y);
+
+	if( y != 0.0 )	{	h[n++]	= y;	}
+	if( x != 0.0 || n == 0 )	{	h[n++]	= x;	}
+
+	return( n );
+}
+
+//---------------------------------------------------------
+/** Sum of two expansions with zero elimination. */
+static int			SG_Expansion_Sum	(int elen, const double *e, int flen, const double *f, double *h)
+{
+	int		ei	= 0, fi	= 0, hn	= 0;
+	double	Q, Qnew, hh, enow	= e[0], fnow	= f[0];
+
+	if( (fnow > enow) == (fnow > -enow) )
 	{
-		return( -1 );
+		Q	= enow;	enow	= ++ei < elen ? e[ei] : 0.0;
+	}
+	else
+	{
+		Q	= fnow;	fnow	= ++fi < flen ? f[fi] : 0.0;
 	}
 
-	if( p1->Get_X() > p2->Get_X() )
+	if( ei < elen && fi < flen )
 	{
-		return(  1 );
+		if( (fnow > enow) == (fnow > -enow) )
+		{
+			SG_Fast_Two_Sum(enow, Q, Qnew, hh);	enow	= ++ei < elen ? e[ei] : 0.0;
+		}
+		else
+		{
+			SG_Fast_Two_Sum(fnow, Q, Qnew, hh);	fnow	= ++fi < flen ? f[fi] : 0.0;
+		}
+
+		Q	= Qnew;	if( hh != 0.0 )	{	h[hn++]	= hh;	}
+
+		while( ei < elen && fi < flen )
+		{
+			if( (fnow > enow) == (fnow > -enow) )
+			{
+				SG_Two_Sum(Q, enow, Qnew, hh);	enow	= ++ei < elen ? e[ei] : 0.0;
+			}
+			else
+			{
+				SG_Two_Sum(Q, fnow, Qnew, hh);	fnow	= ++fi < flen ? f[fi] : 0.0;
+			}
+
+			Q	= Qnew;	if( hh != 0.0 )	{	h[hn++]	= hh;	}
+		}
 	}
 
-	if( p1->Get_Y() < p2->Get_Y() )
+	while( ei < elen )
 	{
-		return( -1 );
+		SG_Two_Sum(Q, enow, Qnew, hh);	enow	= ++ei < elen ? e[ei] : 0.0;
+
+		Q	= Qnew;	if( hh != 0.0 )	{	h[hn++]	= hh;	}
 	}
 
-	if( p1->Get_Y() > p2->Get_Y() )
+	while( fi < flen )
 	{
-		return(  1 );
+		SG_Two_Sum(Q, fnow, Qnew, hh);	fnow	= ++fi < flen ? f[fi] : 0.0;
+
+		Q	= Qnew;	if( hh != 0.0 )	{	h[hn++]	= hh;	}
 	}
 
-	return( 0 );
+	if( Q != 0.0 || hn == 0 )
+	{
+		h[hn++]	= Q;
+	}
+
+	return( hn );
 }
 
+//---------------------------------------------------------
+/** Product of an expansion with a double, with zero elimination. */
+static int			SG_Expansion_Scale	(int elen, const double *e, double b, double *h)
+{
+	int		hn	= 0;
+	double	Q, hh, p1, p0, Sum;
 
-///////////////////////////////////////////////////////////
-//														 //
-//														 //
-//														 //
-///////////////////////////////////////////////////////////
+	SG_Two_Product(e[0], b, Q, hh);
+
+	if( hh != 0.0 )	{	h[hn++]	= hh;	}
+
+	for(int i=1; i<elen; i++)
+	{
+		SG_Two_Product (e[i], b, p1, p0);
+		SG_Two_Sum     (Q, p0 , Sum, hh);	if( hh != 0.0 )	{	h[hn++]	= hh;	}
+		SG_Fast_Two_Sum(p1, Sum, Q  , hh);	if( hh != 0.0 )	{	h[hn++]	= hh;	}
+	}
+
+	if( Q != 0.0 || hn == 0 )
+	{
+		h[hn++]	= Q;
+	}
+
+	return( hn );
+}
 
 //---------------------------------------------------------
-bool CSG_TIN::_Triangulate(void)
+/**
+  * Product of two expansions. 'h' needs room for 2 * elen * flen
+  * and 't' for 2 * elen * (flen + 1) values.
+*/
+static int			SG_Expansion_Product	(int elen, const double *e, int flen, const double *f, double *h, double *t)
 {
-	bool			bResult;
-	int				i, j, n, nTriangles;
-	CSG_TIN_Node	**Nodes;
-	TTIN_Triangle	*Triangles;
+	int		hn	= 1;	double	*s	= t, *u	= t + 2 * elen;
+
+	h[0]	= 0.0;
+
+	for(int i=0; i<flen; i++)
+	{
+		int	sn	= SG_Expansion_Scale(elen, e, f[i], s);
+
+		hn	= SG_Expansion_Sum(hn, h, sn, s, u);
+
+		memcpy(h, u, hn * sizeof(double));
+	}
+
+	return( hn );
+}
+
+//---------------------------------------------------------
+static inline void	SG_Expansion_Negate	(int elen, double *e)
+{
+	for(int i=0; i<elen; i++)
+	{
+		e[i]	= -e[i];
+	}
+}
+
+//---------------------------------------------------------
+/** Exact (a x b - c x d) for expansions of up to two components each. */
+static int			SG_Expansion_Cross	(int an, const double *a, int bn, const double *b, int cn, const double *c, int dn, const double *d, double *h)
+{
+	double	ab[8], cd[8], t[24];
+
+	int	abn	= SG_Expansion_Product(an, a, bn, b, ab, t);
+	int	cdn	= SG_Expansion_Product(cn, c, dn, d, cd, t);
+
+	SG_Expansion_Negate(cdn, cd);
+
+	return( SG_Expansion_Sum(abn, ab, cdn, cd, h) );
+}
+
+//---------------------------------------------------------
+static double		SG_Orientation_Exact	(const TSG_Point &a, const TSG_Point &b, const TSG_Point &c)
+{
+	double	acx[2], acy[2], bcx[2], bcy[2], det[16];
+
+	int	acxn	= SG_Expansion_Diff(a.x, c.x, acx);
+	int	acyn	= SG_Expansion_Diff(a.y, c.y, acy);
+	int	bcxn	= SG_Expansion_Diff(b.x, c.x, bcx);
+	int	bcyn	= SG_Expansion_Diff(b.y, c.y, bcy);
+
+	int	n		= SG_Expansion_Cross(acxn, acx, bcyn, bcy, acyn, acy, bcxn, bcx, det);
+
+	return( det[n - 1] );
+}
+
+//---------------------------------------------------------
+/** Returns a positive value if a, b, c are arranged counterclockwise, negative if clockwise and zero if they are collinear. */
+static inline double	SG_Orientation		(const TSG_Point &a, const TSG_Point &b, const TSG_Point &c)
+{
+	double	dl	= (a.x - c.x) * (b.y - c.y);
+	double	dr	= (a.y - c.y) * (b.x - c.x);
+	double	d	= dl - dr;
+
+	if( (dl > 0.0 && dr <= 0.0) || (dl < 0.0 && dr >= 0.0) )
+	{
+		return( d );
+	}
+
+	double	Bound	= SG_ORIENT_ERRBOUND * (fabs(dl) + fabs(dr));
+
+	if( d >= Bound || -d >= Bound )
+	{
+		return( d );
+	}
+
+	return( SG_Orientation_Exact(a, b, c) );
+}
+
+//---------------------------------------------------------
+static double		SG_InCircle_Exact	(const TSG_Point &a, const TSG_Point &b, const TSG_Point &c, const TSG_Point &d)
+{
+	double	adx[2], ady[2], bdx[2], bdy[2], cdx[2], cdy[2];
+
+	int	adxn	= SG_Expansion_Diff(a.x, d.x, adx);
+	int	adyn	= SG_Expansion_Diff(a.y, d.y, ady);
+	int	bdxn	= SG_Expansion_Diff(b.x, d.x, bdx);
+	int	bdyn	= SG_Expansion_Diff(b.y, d.y, bdy);
+	int	cdxn	= SG_Expansion_Diff(c.x, d.x, cdx);
+	int	cdyn	= SG_Expansion_Diff(c.y, d.y, cdy);
 
 	//-----------------------------------------------------
-	_Destroy_Edges();
-	_Destroy_Triangles();
+	double	Lift[16], Cross[16], Term[3][512], t[544], ab[1024], det[1536], sq[2][8];
+
+	int	n[3], sqn[2], Liftn, Crossn;
+
+	#define SG_INCIRCLE_TERM(i, px, pxn, py, pyn, qx, qxn, qy, qyn, rx, rxn, ry, ryn)\
+		sqn[0]	= SG_Expansion_Product(pxn, px, pxn, px, sq[0], t);\
+		sqn[1]	= SG_Expansion_Product(pyn, py, pyn, py, sq[1], t);\
+		Liftn	= SG_Expansion_Sum(sqn[0], sq[0], sqn[1], sq[1], Lift);\
+		Crossn	= SG_Expansion_Cross(qxn, qx, ryn, ry, rxn, rx, qyn, qy, Cross);\
+		n[i]	= SG_Expansion_Product(Liftn, Lift, Crossn, Cross, Term[i], t);
+
+	SG_INCIRCLE_TERM(0, adx, adxn, ady, adyn, bdx, bdxn, bdy, bdyn, cdx, cdxn, cdy, cdyn);
+	SG_INCIRCLE_TERM(1, bdx, bdxn, bdy, bdyn, cdx, cdxn, cdy, cdyn, adx, adxn, ady, adyn);
+	SG_INCIRCLE_TERM(2, cdx, cdxn, cdy, cdyn, adx, adxn, ady, adyn, bdx, bdxn, bdy, bdyn);
+
+	#undef SG_INCIRCLE_TERM
 
 	//-----------------------------------------------------
-	Nodes	= (CSG_TIN_Node **)SG_Malloc((Get_Node_Count() + 3) * sizeof(CSG_TIN_Node *));
+	int	abn	= SG_Expansion_Sum(n[0], Term[0], n[1], Term[1], ab);
+	int	detn	= SG_Expansion_Sum(abn, ab, n[2], Term[2], det);
 
-	for(i=0; i<Get_Node_Count(); i++)
+	return( det[detn - 1] );
+}
+
+//---------------------------------------------------------
+/** Returns a positive value if d lies inside the circle passing through the counterclockwise arranged points a, b, c, negative if outside and zero if on the circle. */
+static inline double	SG_InCircle			(const TSG_Point &a, const TSG_Point &b, const TSG_Point &c, const TSG_Point &d)
+{
+	double	adx	= a.x - d.x, ady	= a.y - d.y;
+	double	bdx	= b.x - d.x, bdy	= b.y - d.y;
+	double	cdx	= c.x - d.x, cdy	= c.y - d.y;
+
+	double	bdxcdy	= bdx * cdy, cdxbdy	= cdx * bdy, aLift	= adx * adx + ady * ady;
+	double	cdxady	= cdx * ady, adxcdy	= adx * cdy, bLift	= bdx * bdx + bdy * bdy;
+	double	adxbdy	= adx * bdy, bdxady	= bdx * ady, cLift	= cdx * cdx + cdy * cdy;
+
+	double	det	= aLift * (bdxcdy - cdxbdy)
+				+ bLift * (cdxady - adxcdy)
+				+ cLift * (adxbdy - bdxady);
+
+	double	Bound	= SG_INCIRCLE_ERRBOUND * (
+					  (fabs(bdxcdy) + fabs(cdxbdy)) * aLift
+					+ (fabs(cdxady) + fabs(adxcdy)) * bLift
+					+ (fabs(adxbdy) + fabs(bdxady)) * cLift
+				);
+
+	if( det > Bound || -det > Bound )
 	{
-		Nodes[i]	= Get_Node(i);
-		Nodes[i]	->_Del_Relations();
+		return( det );
 	}
 
-	//-----------------------------------------------------
-	qsort(Nodes, Get_Node_Count(), sizeof(CSG_TIN_Node *), SG_TIN_Compare);
+	return( SG_InCircle_Exact(a, b, c, d) );
+}
 
-	for(i=0, j=0, n=Get_Node_Count(); j<n; i++)	// remove duplicates
+
+///////////////////////////////////////////////////////////
+//														 //
+//					Spatial Sort						 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+typedef struct
+{
+	unsigned int	Key;
+
+	int				Index;
+}
+TSG_TIN_Order;
+
+//---------------------------------------------------------
+static int			SG_TIN_Compare_Order	(const void *a, const void *b)
+{
+	unsigned int	ka	= ((const TSG_TIN_Order *)a)->Key;
+	unsigned int	kb	= ((const TSG_TIN_Order *)b)->Key;
+
+	return( ka < kb ? -1 : ka > kb ? 1 : 0 );
+}
+
+//---------------------------------------------------------
+/** Position of the cell (x, y) along a Hilbert curve covering a 2^16 x 2^16 grid. */
+static unsigned int	SG_TIN_Hilbert_Key	(unsigned int x, unsigned int y)
+{
+	unsigned int	Key	= 0;
+
+	for(unsigned int s=1u<<15; s>0; s>>=1)
 	{
-		Nodes[i]	= Nodes[j++];
+		unsigned int	rx	= (x & s) ? 1 : 0;
+		unsigned int	ry	= (y & s) ? 1 : 0;
 
-		while(	j < n
-			&&	Nodes[i]->Get_X() == Nodes[j]->Get_X()
-			&&	Nodes[i]->Get_Y() == Nodes[j]->Get_Y() )
+		Key	+= s * s * ((3 * rx) ^ ry);
+
+		if( ry == 0 )
 		{
-			Del_Node(Nodes[j++]->Get_Index(), false);
+			if( rx == 1 )
+			{
+				x	= 65535 - x;
+				y	= 65535 - y;
+			}
+
+			unsigned int	t	= x;	x	= y;	y	= t;
 		}
 	}
 
-	//-----------------------------------------------------
-	for(i=Get_Node_Count(); i<Get_Node_Count()+3; i++)
+	return( Key );
+}
+
+//---------------------------------------------------------
+/**
+  * Biased randomized insertion order: the shuffled points are
+  * split into rounds of doubling size, each of which is sorted
+  * along a Hilbert curve. The shuffle is seeded to keep the
+  * resulting triangulation reproducible.
+*/
+static TSG_TIN_Order *	SG_TIN_Get_Order	(const TSG_Point *Points, int nPoints)
+{
+	TSG_TIN_Order	*Order	= (TSG_TIN_Order *)SG_Malloc(nPoints * sizeof(TSG_TIN_Order));
+
+	if( Order == NULL )
 	{
-		Nodes[i]	= new CSG_TIN_Node(this, 0);
+		return( NULL );
 	}
 
 	//-----------------------------------------------------
-	Triangles	= (TTIN_Triangle *)SG_Malloc(3 * Get_Node_Count() * sizeof(TTIN_Triangle));
+	int		i;
+	double	xMin, yMin, xMax, yMax;
 
-	if( (bResult = _Triangulate(Nodes, Get_Node_Count(), Triangles, nTriangles)) == true )
+	xMin	= xMax	= Points[0].x;
+	yMin	= yMax	= Points[0].y;
+
+	for(i=1; i<nPoints; i++)
 	{
-		for(i=0; i<nTriangles && SG_UI_Process_Set_Progress(i, nTriangles); i++)
-		{
-			_Add_Triangle(Nodes[Triangles[i].p1], Nodes[Triangles[i].p2], Nodes[Triangles[i].p3]);
-		}
+		if( xMin > Points[i].x )	xMin	= Points[i].x;	else if( xMax < Points[i].x )	xMax	= Points[i].x;
+		if( yMin > Points[i].y )	yMin	= Points[i].y;	else if( yMax < Points[i].y )	yMax	= Points[i].y;
 	}
 
-	SG_Free(Triangles);
+	double	Scale	= M_GET_MAX(xMax - xMin, yMax - yMin);
+
+	Scale	= Scale > 0.0 ? 65535.0 / Scale : 0.0;
 
 	//-----------------------------------------------------
-	for(i=Get_Node_Count(); i<Get_Node_Count()+3; i++)
+	unsigned int	Random	= 20151208;
+
+	for(i=0; i<nPoints; i++)
 	{
-		delete(Nodes[i]);
+		Order[i].Index	= i;
 	}
 
-	SG_Free(Nodes);
+	for(i=nPoints-1; i>0; i--)
+	{
+		Random	= 1664525u * Random + 1013904223u;
 
-	SG_UI_Process_Set_Ready();
+		int	j	= (int)((Random >> 8) % (unsigned int)(i + 1));
 
-	return( bResult );
+		TSG_TIN_Order	t	= Order[i];	Order[i]	= Order[j];	Order[j]	= t;
+	}
+
+	for(i=0; i<nPoints; i++)
+	{
+		const TSG_Point	&p	= Points[Order[i].Index];
+
+		Order[i].Key	= SG_TIN_Hilbert_Key(
+			(unsigned int)(Scale * (p.x - xMin)),
+			(unsigned int)(Scale * (p.y - yMin))
+		);
+	}
+
+	//-----------------------------------------------------
+	for(int End=nPoints, Start; End>0; End=Start)
+	{
+		Start	= End > 1024 ? End / 2 : 0;
+
+		qsort(Order + Start, End - Start, sizeof(TSG_TIN_Order), SG_TIN_Compare_Order);
+	}
+
+	return( Order );
 }
 
 
 ///////////////////////////////////////////////////////////
 //														 //
-//														 //
+//					Triangulator						 //
 //														 //
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-bool CSG_TIN::_Triangulate(CSG_TIN_Node **Points, int nPoints, TTIN_Triangle *Triangles, int &nTriangles)
+/**
+  * Compact, index based incremental Delaunay triangulator.
+  * Each triangle stores its three vertices counterclockwise
+  * and, for each vertex, the neighbour across the opposite
+  * edge. Hull edges are adjacent to ghost triangles, whose
+  * third vertex is the virtual point at infinity (m_nPoints).
+*/
+class CSG_TIN_Delaunay
 {
-	int			i, j, k, inside, trimax,
-				nedge		= 0,
-				emax		= 200,
-				status		= 0,
-				*complete	= NULL;
+public:
+	CSG_TIN_Delaunay(void);
+	~CSG_TIN_Delaunay(void);
 
-	double		dmax, xp, yp, x1, y1, x2, y2, x3, y3, xc, yc, r;
+	void					Destroy				(void);
 
-	TTIN_Edge	*edges		= NULL;
+	/// Triangulates the given points, which must not contain duplicates.
+	bool					Create				(const TSG_Point *Points, int nPoints);
 
-	//-----------------------------------------------------
-	// Update extent...
-	if( nPoints >= 3 )
-	{
-		TSG_Rect	r;
+	/// Number of triangle slots including ghost triangles.
+	int						Get_Count			(void)			const	{	return( m_nTriangles );	}
 
-		m_Extent.Assign(
-			Points[0]->Get_X(), Points[0]->Get_Y(),
-			Points[0]->Get_X(), Points[0]->Get_Y()
-		);
+	bool					is_Triangle			(int t)			const	{	return( m_V[3 * t] != m_nPoints && m_V[3 * t + 1] != m_nPoints && m_V[3 * t + 2] != m_nPoints );	}
 
-		for(i=1; i<nPoints; i++)
-		{
-			r.xMin	= r.xMax	= Points[i]->Get_X();
-			r.yMin	= r.yMax	= Points[i]->Get_Y();
+	int						Get_Vertex			(int t, int i)	const	{	return( m_V[3 * t + i] );	}
+	int						Get_Neighbor		(int t, int i)	const	{	return( m_N[3 * t + i] );	}
 
-			m_Extent.Union(r);
-		}
+
+private:
+
+	typedef struct
+	{
+		int					Triangle, Neighbor, Edge, u, w;
 	}
-	else
+	TBoundary;
+
+
+	int						m_nPoints, m_nTriangles, m_nBuffer, m_Last, m_Stamp;
+
+	int						*m_V, *m_N, *m_Mark, *m_Start;
+
+	const TSG_Point			*m_Points;
+
+	CSG_Array				m_Stack, m_Cavity, m_Boundary;
+
+
+	bool					_Initialize			(TSG_TIN_Order *Order);
+
+	int						_Locate				(int p);
+	bool					_is_Conflict		(int t, int p);
+	bool					_Insert				(int p);
+
+};
+
+//---------------------------------------------------------
+CSG_TIN_Delaunay::CSG_TIN_Delaunay(void)
+{
+	m_V			= NULL;
+	m_N			= NULL;
+	m_Mark		= NULL;
+	m_Start		= NULL;
+
+	m_nPoints	= 0;
+	m_nTriangles	= 0;
+
+	m_Stack   .Create(sizeof(int      ), 0, SG_ARRAY_GROWTH_1);
+	m_Cavity  .Create(sizeof(int      ), 0, SG_ARRAY_GROWTH_1);
+	m_Boundary.Create(sizeof(TBoundary), 0, SG_ARRAY_GROWTH_1);
+}
+
+//---------------------------------------------------------
+CSG_TIN_Delaunay::~CSG_TIN_Delaunay(void)
+{
+	Destroy();
+}
+
+//---------------------------------------------------------
+void CSG_TIN_Delaunay::Destroy(void)
+{
+	SG_FREE_SAFE(m_V);
+	SG_FREE_SAFE(m_N);
+	SG_FREE_SAFE(m_Mark);
+	SG_FREE_SAFE(m_Start);
+
+	m_nPoints		= 0;
+	m_nTriangles	= 0;
+}
+
+//---------------------------------------------------------
+bool CSG_TIN_Delaunay::Create(const TSG_Point *Points, int nPoints)
+{
+	Destroy();
+
+	if( nPoints < 3 )
 	{
 		return( false );
 	}
 
-	//-----------------------------------------------------
-	// Allocate memory for the completeness list, flag for each triangle
-	trimax	= 4 * nPoints;
-	if( (complete	= (int       *)SG_Malloc(trimax * sizeof(int))) == NULL )
+	m_Points	= Points;
+	m_nPoints	= nPoints;
+	m_nBuffer	= 2 * nPoints + 8;	// triangles including ghosts never exceed 2n - 2
+
+	m_V		= (int *)SG_Malloc(3 * m_nBuffer * sizeof(int));
+	m_N		= (int *)SG_Malloc(3 * m_nBuffer * sizeof(int));
+	m_Mark	= (int *)SG_Malloc(    m_nBuffer * sizeof(int));
+	m_Start	= (int *)SG_Malloc((nPoints + 1) * sizeof(int));
+
+	TSG_TIN_Order	*Order	= SG_TIN_Get_Order(Points, nPoints);
+
+	if( !m_V || !m_N || !m_Mark || !m_Start || !Order || !_Initialize(Order) )
 	{
-		status	= 1;
-		goto skip;
+		SG_FREE_SAFE(Order);
+
+		Destroy();
+
+		return( false );
 	}
 
 	//-----------------------------------------------------
-	// Allocate memory for the edge list
-	if( (edges		= (TTIN_Edge *)SG_Malloc(emax   * sizeof(TTIN_Edge))) == NULL )
+	bool	bResult	= true;
+
+	for(int i=3; bResult && i<nPoints; i++)
 	{
-		status	= 2;
-		goto skip;
+		if( (i % 4096) == 0 && !SG_UI_Process_Set_Progress(i, nPoints) )
+		{
+			bResult	= false;
+		}
+		else
+		{
+			bResult	= _Insert(Order[i].Index);
+		}
 	}
 
-	//-----------------------------------------------------
-	//	Find the maximum and minimum vertex bounds.
-	//	This is to allow calculation of the bounding triangle
-	//	Set up the supertriangle
-	//	This is a triangle which encompasses all the sample points.
-	//	The supertriangle coordinates are added to the end of the
-	//	vertex list. The supertriangle is the first triangle in
-	//	the triangle list.
+	SG_Free(Order);
 
-	dmax	= m_Extent.Get_XRange() > m_Extent.Get_YRange() ? m_Extent.Get_XRange() : m_Extent.Get_YRange();
+	if( !bResult )
+	{
+		Destroy();
+	}
 
-	Points[nPoints + 0]->m_Point.x	= m_Extent.Get_XCenter() - 20 * dmax;
-	Points[nPoints + 1]->m_Point.x	= m_Extent.Get_XCenter();
-	Points[nPoints + 2]->m_Point.x	= m_Extent.Get_XCenter() + 20 * dmax;
+	return( bResult );
+}
 
-	Points[nPoints + 0]->m_Point.y	= m_Extent.Get_YCenter() -      dmax;
-	Points[nPoints + 1]->m_Point.y	= m_Extent.Get_YCenter() + 20 * dmax;
-	Points[nPoints + 2]->m_Point.y	= m_Extent.Get_YCenter() -      dmax;
+//---------------------------------------------------------
+/**
+  * Starts with the first non-degenerate triangle found along
+  * the insertion order and its three ghost triangles.
+*/
+bool CSG_TIN_Delaunay::_Initialize(TSG_TIN_Order *Order)
+{
+	int		i, j, k;
 
-	Triangles[0].p1	= nPoints;
-	Triangles[0].p2	= nPoints + 1;
-	Triangles[0].p3	= nPoints + 2;
+	for(k=2; k<m_nPoints && SG_Orientation(m_Points[Order[0].Index], m_Points[Order[1].Index], m_Points[Order[k].Index]) == 0.0; k++)
+	{}
 
-	complete [0]	= false;
+	if( k >= m_nPoints )	// all points are collinear
+	{
+		return( false );
+	}
 
-	nTriangles		= 1;
+	TSG_TIN_Order	t	= Order[2];	Order[2]	= Order[k];	Order[k]	= t;
 
 	//-----------------------------------------------------
-	//	Include each point one at a time into the existing mesh
-	for(i=0; i<nPoints && SG_UI_Process_Set_Progress(i, nPoints); i++)
+	int	a	= Order[0].Index, b	= Order[1].Index, c	= Order[2].Index, g	= m_nPoints;
+
+	if( SG_Orientation(m_Points[a], m_Points[b], m_Points[c]) < 0.0 )
 	{
-		xp		= Points[i]->Get_X();
-		yp		= Points[i]->Get_Y();
-		nedge	= 0;
+		k	= a;	a	= b;	b	= k;
+	}
 
-		//-------------------------------------------------
-		//	Set up the edge buffer.
-		//	If the point (xp,yp) lies inside the circumcircle then the
-		//	three edges of that triangle are added to the edge buffer
-		//	and that triangle is removed.
-		for(j=0; j<nTriangles; j++)
+	int	V[12]	= {	a, b, c,	c, b, g,	a, c, g,	b, a, g	};
+
+	memcpy(m_V, V, sizeof(V));
+
+	m_nTriangles	= 4;
+
+	for(i=0; i<4; i++)	// link the shared edges
+	{
+		for(j=0; j<3; j++)
 		{
-			if( complete[j] )
+			int	u	= m_V[3 * i + (j + 1) % 3], w	= m_V[3 * i + (j + 2) % 3];
+
+			for(int s=0; s<4; s++)	for(k=0; k<3; k++)
 			{
-				continue;
+				if( s != i && m_V[3 * s + (k + 1) % 3] == w && m_V[3 * s + (k + 2) % 3] == u )
+				{
+					m_N[3 * i + j]	= s;
+				}
 			}
+		}
+	}
 
-			x1		= Points[Triangles[j].p1]->Get_X();
-			y1		= Points[Triangles[j].p1]->Get_Y();
-			x2		= Points[Triangles[j].p2]->Get_X();
-			y2		= Points[Triangles[j].p2]->Get_Y();
-			x3		= Points[Triangles[j].p3]->Get_X();
-			y3		= Points[Triangles[j].p3]->Get_Y();
+	for(i=0; i<m_nBuffer; i++)
+	{
+		m_Mark[i]	= 0;
+	}
 
-			inside	= _CircumCircle(xp, yp, x1, y1, x2, y2, x3, y3, &xc, &yc, &r);
+	m_Stamp	= 0;
+	m_Last	= 0;
 
-			if( xc + r < xp )
-			{
-				complete[j]	= true;
-			}
+	return( true );
+}
 
-			if( inside )
-			{
-				// Check that we haven't exceeded the edge list size
-				if( nedge + 3 >= emax )
-				{
-					emax	+= 100;
+//---------------------------------------------------------
+/** A ghost triangle conflicts with points beyond its hull edge or on the open edge segment itself. */
+bool CSG_TIN_Delaunay::_is_Conflict(int t, int p)
+{
+	const int	*V	= m_V + 3 * t;
 
-					if( (edges = (TTIN_Edge *)SG_Realloc(edges, emax * sizeof(TTIN_Edge))) == NULL )
-					{
-						status	= 3;
-						goto skip;
-					}
-				}
+	int	g	= V[0] == m_nPoints ? 0 : V[1] == m_nPoints ? 1 : V[2] == m_nPoints ? 2 : -1;
 
-				edges[nedge + 0].p1	= Triangles[j].p1;
-				edges[nedge + 0].p2	= Triangles[j].p2;
-				edges[nedge + 1].p1	= Triangles[j].p2;
-				edges[nedge + 1].p2	= Triangles[j].p3;
-				edges[nedge + 2].p1	= Triangles[j].p3;
-				edges[nedge + 2].p2	= Triangles[j].p1;
+	if( g < 0 )
+	{
+		return( SG_InCircle(m_Points[V[0]], m_Points[V[1]], m_Points[V[2]], m_Points[p]) > 0.0 );
+	}
+
+	const TSG_Point	&u	= m_Points[V[(g + 1) % 3]], &w	= m_Points[V[(g + 2) % 3]], &q	= m_Points[p];
 
-				nedge	+= 3;
+	double	o	= SG_Orientation(u, w, q);
 
-				Triangles[j]	= Triangles[nTriangles - 1];
-				complete [j]	= complete [nTriangles - 1];
+	if( o != 0.0 )
+	{
+		return( o > 0.0 );
+	}
 
-				nTriangles--;
-				j--;
+	return( u.x != w.x
+		? (u.x < q.x && q.x < w.x) || (w.x < q.x && q.x < u.x)
+		: (u.y < q.y && q.y < w.y) || (w.y < q.y && q.y < u.y)
+	);
+}
+
+//---------------------------------------------------------
+/** Visibility walk from the most recently created triangle to one being in conflict with point p. */
+int CSG_TIN_Delaunay::_Locate(int p)
+{
+	int	t	= m_Last, Prev	= -1, Rotate	= 0;
+
+	for(int i=0; i<3; i++)
+	{
+		if( m_V[3 * t + i] == m_nPoints )	// ghost
+		{
+			if( _is_Conflict(t, p) )
+			{
+				return( t );
 			}
+
+			Prev	= t;	t	= m_N[3 * t + i];
+
+			break;
 		}
+	}
 
-		//-------------------------------------------------
-		//	Tag multiple edges
-		//	Note: if all triangles are specified anticlockwise then all
-		//	      interior edges are opposite pointing in direction.
-		for(j=0; j<nedge-1; j++)
+	//-----------------------------------------------------
+	for(bool bMoved=true; bMoved; )
+	{
+		bMoved	= false;	Rotate	= (Rotate + 1) % 3;
+
+		for(int k=0; k<3 && !bMoved; k++)
 		{
-			for(k=j+1; k<nedge; k++)
+			int	i	= (k + Rotate) % 3, n	= m_N[3 * t + i];
+
+			if( n != Prev && SG_Orientation(m_Points[m_V[3 * t + (i + 1) % 3]], m_Points[m_V[3 * t + (i + 2) % 3]], m_Points[p]) < 0.0 )
 			{
-				if( (edges[j].p1 == edges[k].p2) && (edges[j].p2 == edges[k].p1) )
-				{
-					edges[j].p1 = -1;
-					edges[j].p2 = -1;
-					edges[k].p1 = -1;
-					edges[k].p2 = -1;
-				}
+				Prev	= t;	t	= n;	bMoved	= true;
 
-				// Shouldn't need the following, see note above
-				if( (edges[j].p1 == edges[k].p1) && (edges[j].p2 == edges[k].p2) )
+				if( !is_Triangle(t) )	// p lies beyond this hull edge
 				{
-					edges[j].p1 = -1;
-					edges[j].p2 = -1;
-					edges[k].p1 = -1;
-					edges[k].p2 = -1;
+					return( t );
 				}
 			}
 		}
+	}
 
-		//-------------------------------------------------
-		//	Form new triangles for the current point
-		//	Skipping over any tagged edges.
-		//	All edges are arranged in clockwise order.
-		for(j=0; j<nedge; j++)
+	return( t );
+}
+
+//---------------------------------------------------------
+/**
+  * Bowyer-Watson insertion: removes all triangles in conflict
+  * with point p and connects p to the boundary of the cavity.
+*/
+bool CSG_TIN_Delaunay::_Insert(int p)
+{
+	int	t	= _Locate(p);
+
+	int	Inside	= (m_Stamp += 2), Outside	= Inside + 1;
+
+	m_Stack   .Set_Array(0, false);
+	m_Cavity  .Set_Array(0, false);
+	m_Boundary.Set_Array(0, false);
+
+	m_Mark[t]	= Inside;
+
+	m_Stack .Inc_Array();	((int *)m_Stack .Get_Array())[0]	= t;
+	m_Cavity.Inc_Array();	((int *)m_Cavity.Get_Array())[0]	= t;
+
+	//-----------------------------------------------------
+	while( m_Stack.Get_Size() > 0 )
+	{
+		int	c	= ((int *)m_Stack.Get_Array())[m_Stack.Get_Size() - 1];	m_Stack.Dec_Array(false);
+
+		for(int i=0; i<3; i++)
 		{
-			if( edges[j].p1 < 0 || edges[j].p2 < 0 )
+			int	n	= m_N[3 * c + i];
+
+			if( m_Mark[n] == Inside )
 			{
 				continue;
 			}
 
-			if( nTriangles >= trimax )
+			if( m_Mark[n] != Outside )
 			{
-				status	= 4;
-				goto skip;
+				if( _is_Conflict(n, p) )
+				{
+					m_Mark[n]	= Inside;
+
+					m_Stack .Inc_Array();	((int *)m_Stack .Get_Array())[m_Stack .Get_Size() - 1]	= n;
+					m_Cavity.Inc_Array();	((int *)m_Cavity.Get_Array())[m_Cavity.Get_Size() - 1]	= n;
+
+					continue;
+				}
+
+				m_Mark[n]	= Outside;
 			}
 
-			Triangles[nTriangles].p1	= edges[j].p1;
-			Triangles[nTriangles].p2	= edges[j].p2;
-			Triangles[nTriangles].p3	= i;
-			complete [nTriangles]		= false;
-			nTriangles++;
+			//---------------------------------------------
+			m_Boundary.Inc_Array();
+
+			TBoundary	&b	= ((TBoundary *)m_Boundary.Get_Array())[m_Boundary.Get_Size() - 1];
+
+			b.Neighbor	= n;
+			b.u			= m_V[3 * c + (i + 1) % 3];
+			b.w			= m_V[3 * c + (i + 2) % 3];
+			b.Edge		= m_N[3 * n] == c ? 0 : m_N[3 * n + 1] == c ? 1 : 2;
 		}
 	}
 
 	//-----------------------------------------------------
-	//	Remove triangles with supertriangle vertices
-	//	These are triangles which have a vertex number greater than nPoints
-	for(i=0; i<nTriangles; i++)
+	int	nCavity	= (int)m_Cavity.Get_Size(), nBoundary	= (int)m_Boundary.Get_Size();
+
+	if( m_nTriangles - nCavity + nBoundary > m_nBuffer )
 	{
-		if(	Triangles[i].p1 >= nPoints
-		||	Triangles[i].p2 >= nPoints
-		||	Triangles[i].p3 >= nPoints )
-		{
-			Triangles[i] = Triangles[nTriangles - 1];
-			nTriangles--;
-			i--;
-		}
+		return( false );
 	}
 
-	//-----------------------------------------------------
-	skip:
+	TBoundary	*Boundary	= (TBoundary *)m_Boundary.Get_Array();
+	int			*Cavity		= (int       *)m_Cavity  .Get_Array();
 
-	if( edges )
+	for(int i=0; i<nBoundary; i++)
 	{
-		SG_Free(edges);
+		TBoundary	&b	= Boundary[i];
+
+		b.Triangle	= i < nCavity ? Cavity[i] : m_nTriangles++;
+
+		int	*V	= m_V + 3 * b.Triangle, *N	= m_N + 3 * b.Triangle;
+
+		V[0]	= b.u;	V[1]	= b.w;	V[2]	= p;
+
+		N[2]	= b.Neighbor;	m_N[3 * b.Neighbor + b.Edge]	= b.Triangle;
+
+		m_Start[b.u]	= b.Triangle;
+		m_Mark [b.Triangle]	= 0;
 	}
 
-	if( complete )
+	for(int i=0; i<nBoundary; i++)
 	{
-		SG_Free(complete);
+		int	s	= m_Start[Boundary[i].w];
+
+		m_N[3 * Boundary[i].Triangle]	= s;
+		m_N[3 * s + 1]					= Boundary[i].Triangle;
+
+		if( is_Triangle(Boundary[i].Triangle) )
+		{
+			m_Last	= Boundary[i].Triangle;
+		}
 	}
 
-	return( status == 0 );
+	return( true );
 }
 
 
@@ -435,71 +923,167 @@ bool CSG_TIN::_Triangulate(CSG_TIN_Node **Points, int nPoints, TTIN_Triangle *Tr
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-//	Return true if a point (xp,yp) is inside the circumcircle made up
-//	of the points (x1,y1), (x2,y2), (x3,y3)
-//	The circumcircle centre is returned in (xc,yc) and the radius r
-//	NOTE: A point on the edge is inside the circumcircle
-//
+int SG_TIN_Compare(const void *pp1, const void *pp2)
+{
+	CSG_TIN_Node	*p1	= *((CSG_TIN_Node **)pp1),
+					*p2	= *((CSG_TIN_Node **)pp2);
 
-//---------------------------------------------------------
-#define IS_IDENTICAL(a, b)	(a == b)
-//#define IS_IDENTICAL(a, b)	(fabs(a - b) < 0.0001)
+	if( p1->Get_X() < p2->Get_X() )
+	{
+		return( -1 );
+	}
+
+	if( p1->Get_X() > p2->Get_X() )
+	{
+		return(  1 );
+	}
+
+	if( p1->Get_Y() < p2->Get_Y() )
+	{
+		return( -1 );
+	}
+
+	if( p1->Get_Y() > p2->Get_Y() )
+	{
+		return(  1 );
+	}
+
+	return( 0 );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-int CSG_TIN::_CircumCircle(double xp, double yp, double x1, double y1, double x2, double y2, double x3, double y3, double *xc, double *yc, double *r)
+bool CSG_TIN::_Triangulate(void)
 {
-	double	m1, m2, mx1, mx2, my1, my2,
-			dx, dy, rsqr, drsqr;
+	int				i, j, n;
+	CSG_TIN_Node	**Nodes;
+
+	//-----------------------------------------------------
+	_Destroy_Edges();
+	_Destroy_Triangles();
 
-	// Check for coincident points
-	if( IS_IDENTICAL(y1, y2) && IS_IDENTICAL(y2, y3) )
+	//-----------------------------------------------------
+	Nodes	= (CSG_TIN_Node **)SG_Malloc(Get_Node_Count() * sizeof(CSG_TIN_Node *));
+
+	for(i=0; i<Get_Node_Count(); i++)
 	{
-		return( false );
+		Nodes[i]	= Get_Node(i);
+		Nodes[i]	->_Del_Relations();
 	}
 
 	//-----------------------------------------------------
-	if( IS_IDENTICAL(y2, y1) )
+	qsort(Nodes, Get_Node_Count(), sizeof(CSG_TIN_Node *), SG_TIN_Compare);
+
+	for(i=0, j=0, n=Get_Node_Count(); j<n; i++)	// remove duplicates
 	{
-		m2	= -(x3 - x2) / (y3 - y2);
-		mx2	=  (x2 + x3) / 2.0;
-		my2	=  (y2 + y3) / 2.0;
-		*xc	=  (x2 + x1) / 2.0;
+		Nodes[i]	= Nodes[j++];
 
-		*yc	= m2 * (*xc - mx2) + my2;
+		while(	j < n
+			&&	Nodes[i]->Get_X() == Nodes[j]->Get_X()
+			&&	Nodes[i]->Get_Y() == Nodes[j]->Get_Y() )
+		{
+			Del_Node(Nodes[j++]->Get_Index(), false);
+		}
 	}
-	else if( IS_IDENTICAL(y3, y2) )
+
+	//-----------------------------------------------------
+	if( (n = Get_Node_Count()) < 3 )
 	{
-		m1	= -(x2 - x1) / (y2 - y1);
-		mx1	=  (x1 + x2) / 2.0;
-		my1	=  (y1 + y2) / 2.0;
-		*xc	=  (x3 + x2) / 2.0;
+		SG_Free(Nodes);
 
-		*yc	= m1 * (*xc - mx1) + my1;
+		return( false );
 	}
-	else
+
+	TSG_Point	*Points	= (TSG_Point *)SG_Malloc(n * sizeof(TSG_Point));
+
+	m_Extent.Assign(Nodes[0]->Get_X(), Nodes[0]->Get_Y(), Nodes[0]->Get_X(), Nodes[0]->Get_Y());
+
+	for(i=0; i<n; i++)
 	{
-		m1	= -(x2 - x1) / (y2 - y1);
-		m2	= -(x3 - x2) / (y3 - y2);
-		mx1	=  (x1 + x2) / 2.0;
-		mx2	=  (x2 + x3) / 2.0;
-		my1	=  (y1 + y2) / 2.0;
-		my2	=  (y2 + y3) / 2.0;
+		Points[i]	= Nodes[i]->Get_Point();
 
-		*xc	= (m1 * mx1 - m2 * mx2 + my2 - my1) / (m1 - m2);
-		*yc	= m1 * (*xc - mx1) + my1;
+		m_Extent.Union(Points[i]);
 	}
 
 	//-----------------------------------------------------
-	dx		= x2 - *xc;
-	dy		= y2 - *yc;
-	rsqr	= dx*dx + dy*dy;
-	*r		= sqrt(rsqr);
+	CSG_TIN_Delaunay	Delaunay;
+
+	bool	bResult	= Delaunay.Create(Points, n);
+
+	SG_Free(Points);
+
+	if( bResult )
+	{
+		int	nTriangles	= 0, nEdges	= 0;
+
+		for(i=0; i<Delaunay.Get_Count(); i++)
+		{
+			if( Delaunay.is_Triangle(i) )
+			{
+				nTriangles++;
 
-	dx		= xp - *xc;
-	dy		= yp - *yc;
-	drsqr	= dx*dx + dy*dy;
+				for(j=0; j<3; j++)
+				{
+					int	k	= Delaunay.Get_Neighbor(i, j);
 
-	return( drsqr <= rsqr ? 1 : 0 );
+					if( k > i || !Delaunay.is_Triangle(k) )
+					{
+						nEdges++;
+					}
+				}
+			}
+		}
+
+		m_Triangles	= (CSG_TIN_Triangle **)SG_Malloc(nTriangles * sizeof(CSG_TIN_Triangle *));
+		m_Edges		= (CSG_TIN_Edge     **)SG_Malloc(nEdges     * sizeof(CSG_TIN_Edge     *));
+
+		//-------------------------------------------------
+		for(i=0; i<Delaunay.Get_Count() && SG_UI_Process_Set_Progress(i, Delaunay.Get_Count()); i++)
+		{
+			if( Delaunay.is_Triangle(i) )
+			{
+				CSG_TIN_Node	*pNodes[3];
+
+				for(j=0; j<3; j++)
+				{
+					pNodes[j]	= Nodes[Delaunay.Get_Vertex(i, j)];
+				}
+
+				CSG_TIN_Triangle	*pTriangle	= new CSG_TIN_Triangle(pNodes[0], pNodes[1], pNodes[2]);
+
+				m_Triangles[m_nTriangles++]	= pTriangle;
+
+				for(j=0; j<3; j++)
+				{
+					pNodes[j]->_Add_Triangle(pTriangle);
+
+					int	k	= Delaunay.Get_Neighbor(i, j);
+
+					if( k > i || !Delaunay.is_Triangle(k) )
+					{
+						CSG_TIN_Node	*a	= pNodes[(j + 1) % 3], *b	= pNodes[(j + 2) % 3];
+
+						a->_Add_Neighbor(b);
+						b->_Add_Neighbor(a);
+
+						m_Edges[m_nEdges++]	= new CSG_TIN_Edge(a, b);
+					}
+				}
+			}
+		}
+	}
+
+	SG_Free(Nodes);
+
+	SG_UI_Process_Set_Ready();
+
+	return( bResult );
 }
 
 
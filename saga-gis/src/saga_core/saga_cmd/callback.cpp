@@ -81,6 +81,10 @@
 //---------------------------------------------------------
 static CCMD_Module	*g_pCMD_Module	= NULL;
 
+#ifdef _OPENMP
+#pragma omp threadprivate(g_pCMD_Module)	// script commands might be executed in parallel
+#endif
+
 //---------------------------------------------------------
 void			CMD_Set_Module		(CCMD_Module *pCMD_Module)
 {
@@ -0,0 +1,320 @@
+/**********************************************************
+ * Version $Id$
+ *********************************************************/
+
+///////////////////////////////////////////////////////////
+//                                                       //
+//                         SAGA                          //
+//                                                       //
+//      System for Automated Geoscientific Analyses      //
+//                                                       //
+//                Command Line Interface                 //
+//                                                       //
+//                   Program: SAGA_CMD                   //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//                     data_store.cpp                    //
+//                                                       //
+//                 Copyright (C) 2015 by                 //
+//                      Olaf Conrad                      //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+// This file is part of 'SAGA - System for Automated     //
+// Geoscientific Analyses'. SAGA is free software; you   //
+// can redistribute it and/or modify it under the terms  //
+// of the GNU General Public License as published by the //
+// Free Software Foundation; version 2 of the License.   //
+//                                                       //
+// SAGA is distributed in the hope that it will be       //
+// useful, but WITHOUT ANY WARRANTY; without even the    //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A  //
+// PARTICULAR PURPOSE. See the GNU General Public        //
+// License for more details.                             //
+//                                                       //
+// You should have received a copy of the GNU General    //
+// Public License along with this program; if not,       //
+// write to the Free Software Foundation, Inc.,          //
+// 51 Franklin Street, 5th Floor, Boston, MA 02110-1301, //
+// USA.                                                  //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//    contact:    Olaf Conrad                            //
+//                Institute of Geography                 //
+//                University of Goettingen               //
+//                Goldschmidtstr. 5                      //
+//                37077 Goettingen                       //
+//                Germany                                //
+//                                                       //
+//    e-mail:     oconrad@saga-gis.org                   //
+//                                                       //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+#include "data_store.h"
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+CCMD_Data_Store	g_Data_Store;
+
+//---------------------------------------------------------
+CCMD_Data_Store &	CMD_Get_Data_Store	(void)
+{
+	return( g_Data_Store );
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+CCMD_Data_Store::CCMD_Data_Store(void)
+{
+	m_Access	= 0;
+	m_Budget	= 0;
+}
+
+//---------------------------------------------------------
+CCMD_Data_Store::~CCMD_Data_Store(void)
+{
+	Detach();
+}
+
+//---------------------------------------------------------
+void CCMD_Data_Store::Set_Memory_Budget(double MB)
+{
+	m_Budget	= MB > 0.0 ? (sLong)(MB * N_MEGABYTE_BYTES) : 0;
+
+	Evict();
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+int CCMD_Data_Store::_Find(const CSG_String &Name) const
+{
+	for(size_t i=0; i<m_Data.size(); i++)
+	{
+		if( !m_Data[i].Name.Cmp(Name) )
+		{
+			return( (int)i );
+		}
+	}
+
+	return( -1 );
+}
+
+//---------------------------------------------------------
+CSG_Data_Object * CCMD_Data_Store::Get(const CSG_String &Name)
+{
+	int	i	= _Find(Name);
+
+	if( i < 0 )
+	{
+		return( NULL );
+	}
+
+	m_Data[i].Access	= ++m_Access;
+
+	if( !SG_Get_Data_Manager().Exists(m_Data[i].pObject) )	// tools only accept input of the global data manager
+	{
+		SG_Get_Data_Manager().Add(m_Data[i].pObject);
+	}
+
+	return( m_Data[i].pObject );
+}
+
+//---------------------------------------------------------
+bool CCMD_Data_Store::Set(const CSG_String &Name, CSG_Data_Object *pObject)
+{
+	if( !is_Name(Name) || !pObject )
+	{
+		return( false );
+	}
+
+	int	i	= _Find(Name);
+
+	if( i < 0 )
+	{
+		TCMD_Data	Data;
+
+		Data.Name		= Name;
+		Data.pObject	= NULL;
+
+		m_Data.push_back(Data);
+
+		i	= (int)m_Data.size() - 1;
+	}
+
+	if( m_Data[i].pObject != pObject )
+	{
+		CSG_Data_Object	*pPrevious	= m_Data[i].pObject;
+
+		m_Data[i].pObject	= pObject;
+
+		if( pPrevious )
+		{
+			_Release(pPrevious);
+		}
+
+		if( !m_Manager.Exists(pObject) )
+		{
+			SG_Get_Data_Manager().Delete(pObject, true);	// take ownership
+
+			m_Manager.Add(pObject);
+		}
+	}
+
+	m_Data[i].Access	= ++m_Access;
+
+	return( true );
+}
+
+//---------------------------------------------------------
+bool CCMD_Data_Store::Save(const CSG_String &Name, const CSG_String &File)
+{
+	int	i	= _Find(Name);
+
+	if( i < 0 || File.is_Empty() )
+	{
+		return( false );
+	}
+
+	m_Data[i].Access	= ++m_Access;
+
+	return( m_Data[i].pObject->Save(File) );
+}
+
+//---------------------------------------------------------
+bool CCMD_Data_Store::Delete(const CSG_String &Name)
+{
+	int	i	= _Find(Name);
+
+	if( i < 0 )
+	{
+		return( false );
+	}
+
+	CSG_Data_Object	*pObject	= m_Data[i].pObject;
+
+	m_Data.erase(m_Data.begin() + i);
+
+	_Release(pObject);
+
+	return( true );
+}
+
+//---------------------------------------------------------
+// Deletes an object, which is no more referenced by any
+// name. Make sure the global data manager doesn't keep a
+// dangling pointer to it.
+//---------------------------------------------------------
+void CCMD_Data_Store::_Release(CSG_Data_Object *pObject)
+{
+	for(size_t i=0; i<m_Data.size(); i++)
+	{
+		if( m_Data[i].pObject == pObject )
+		{
+			return;
+		}
+	}
+
+	SG_Get_Data_Manager().Delete(pObject, true);
+
+	m_Manager.Delete(pObject);
+}
+
+//---------------------------------------------------------
+// To be called before the global data manager removes its
+// unsaved data objects.
+//---------------------------------------------------------
+void CCMD_Data_Store::Detach(void)
+{
+	for(size_t i=0; i<m_Data.size(); i++)
+	{
+		SG_Get_Data_Manager().Delete(m_Data[i].pObject, true);
+	}
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// Must not be called while tools are running, that might
+// read one of the grids.
+//---------------------------------------------------------
+void CCMD_Data_Store::Evict(void)
+{
+	if( m_Budget <= 0 )
+	{
+		return;
+	}
+
+	sLong	Size	= 0;
+
+	for(size_t i=0; i<m_Data.size(); i++)
+	{
+		CSG_Grid	*pGrid	= m_Data[i].pObject->asGrid();
+
+		if( pGrid && !pGrid->is_Cached() )
+		{
+			Size	+= pGrid->Get_Memory_Size();
+		}
+	}
+
+	while( Size > m_Budget )
+	{
+		CSG_Grid	*pGrid	= NULL;	sLong	Access	= 0;
+
+		for(size_t i=0; i<m_Data.size(); i++)	// find the least recently used grid
+		{
+			CSG_Grid	*p	= m_Data[i].pObject->asGrid();
+
+			if( p && !p->is_Cached() && (!pGrid || Access > m_Data[i].Access) )
+			{
+				pGrid	= p;	Access	= m_Data[i].Access;
+			}
+		}
+
+		if( !pGrid || !pGrid->Set_Cache(true) )
+		{
+			return;
+		}
+
+		Size	-= pGrid->Get_Memory_Size();
+	}
+}
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
@@ -0,0 +1,152 @@
+/**********************************************************
+ * Version $Id$
+ *********************************************************/
+
+///////////////////////////////////////////////////////////
+//                                                       //
+//                         SAGA                          //
+//                                                       //
+//      System for Automated Geoscientific Analyses      //
+//                                                       //
+//                Command Line Interface                 //
+//                                                       //
+//                   Program: SAGA_CMD                   //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//                      data_store.h                     //
+//                                                       //
+//                 Copyright (C) 2015 by                 //
+//                      Olaf Conrad                      //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+// This file is part of 'SAGA - System for Automated     //
+// Geoscientific Analyses'. SAGA is free software; you   //
+// can redistribute it and/or modify it under the terms  //
+// of the GNU General Public License as published by the //
+// Free Software Foundation; version 2 of the License.   //
+//                                                       //
+// SAGA is distributed in the hope that it will be       //
+// useful, but WITHOUT ANY WARRANTY; without even the    //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A  //
+// PARTICULAR PURPOSE. See the GNU General Public        //
+// License for more details.                             //
+//                                                       //
+// You should have received a copy of the GNU General    //
+// Public License along with this program; if not,       //
+// write to the Free Software Foundation, Inc.,          //
+// 51 Franklin Street, 5th Floor, Boston, MA 02110-1301, //
+// USA.                                                  //
+//                                                       //
+//-------------------------------------------------------//
+//                                                       //
+//    contact:    Olaf Conrad                            //
+//                Institute of Geography                 //
+//                University of Goettingen               //
+//                Goldschmidtstr. 5                      //
+//                37077 Goettingen                       //
+//                Germany                                //
+//                                                       //
+//    e-mail:     oconrad@saga-gis.org                   //
+//                                                       //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+#ifndef _HEADER_INCLUDED__SAGA_CMD__Data_Store_H
+#define _HEADER_INCLUDED__SAGA_CMD__Data_Store_H
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+#include <vector>
+
+#include <saga_api/saga_api.h>
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+// Keeps data objects in memory across the tool calls of a
+// script. Objects are addressed by symbolic names starting
+// with '@', e.g. '-SLOPE=@slope', and are only written to
+// a file, if this is explicitly requested. If a memory
+// budget is set, the least recently used grids are moved
+// to the grid cache by Evict(), when the budget is exceeded.
+//---------------------------------------------------------
+class CCMD_Data_Store
+{
+public:
+	CCMD_Data_Store(void);
+	virtual ~CCMD_Data_Store(void);
+
+	static bool					is_Name				(const CSG_String &Name)	{	return( Name.Length() > 1 && Name[0] == '@' );	}
+
+	void						Set_Memory_Budget	(double MB);
+
+	CSG_Data_Object *			Get					(const CSG_String &Name);
+	bool						Set					(const CSG_String &Name, CSG_Data_Object *pObject);
+	bool						Save				(const CSG_String &Name, const CSG_String &File);
+	bool						Delete				(const CSG_String &Name);
+
+	void						Detach				(void);
+
+	void						Evict				(void);
+
+
+private:
+
+	typedef struct SCMD_Data
+	{
+		CSG_String				Name;
+
+		CSG_Data_Object			*pObject;
+
+		sLong					Access;
+	}
+	TCMD_Data;
+
+
+	sLong						m_Access, m_Budget;
+
+	std::vector<TCMD_Data>		m_Data;
+
+	CSG_Data_Manager			m_Manager;
+
+
+	int							_Find				(const CSG_String &Name)		const;
+
+	void						_Release			(CSG_Data_Object *pObject);
+
+};
+
+//---------------------------------------------------------
+CCMD_Data_Store &				CMD_Get_Data_Store	(void);
+
+
+///////////////////////////////////////////////////////////
+//														 //
+//														 //
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+#endif // #ifndef _HEADER_INCLUDED__SAGA_CMD__Data_Store_H
@@ -61,8 +61,12 @@
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
+#include <wx/log.h>
+
 #include "callback.h"
 
+#include "data_store.h"
+
 #include "module_library.h"
 
 
@@ -153,6 +157,21 @@ void CCMD_Module::Usage(void)
 
 //---------------------------------------------------------
 bool CCMD_Module::Execute(int argc, char *argv[])
+{
+	if( !Initialize(argc, argv) )
+	{
+		return( false );
+	}
+
+	return( Finalize(Run()) );
+}
+
+//---------------------------------------------------------
+/**
+  * Parses the command line and sets the tool's parameters,
+  * which includes loading of input data.
+*/
+bool CCMD_Module::Initialize(int argc, char *argv[])
 {
 	//-----------------------------------------------------
 	if( !m_pLibrary || !m_pModule )
@@ -167,24 +186,7 @@ bool CCMD_Module::Execute(int argc, char *argv[])
 		return( false );
 	}
 
-	//-----------------------------------------------------
-	// m_CMD.SetCmdLine(argc, argv);
-	//
-	// We can't do it this way (passing argv as char**) because then we use an
-	// overload of the method which (re-)sets the locale from the current
-	// enviromment; in order to prevent this, we use wxString overload
-	{
-		wxString	sCmdLine;
-
-		for(int i=1; i<argc; i++)
-		{
-			sCmdLine	+= wxString(i == 1 ? "\"" : " \"") + argv[i] + "\"";
-		}
-
-		m_CMD.SetCmdLine(sCmdLine);
-	}
-
-	if( m_CMD.Parse(false) != 0 )
+	if( !_Set_Command_Line(argc, argv) )
 	{
 		Usage();
 
@@ -192,11 +194,9 @@ bool CCMD_Module::Execute(int argc, char *argv[])
 	}
 
 	//-----------------------------------------------------
-	int		i;
-
 	bool	bResult	= _Get_Parameters(m_pModule->Get_Parameters(), true);
 
-	for(i=0; bResult && i<m_pModule->Get_Parameters_Count(); i++)
+	for(int i=0; bResult && i<m_pModule->Get_Parameters_Count(); i++)
 	{
 		bResult	= _Get_Parameters(m_pModule->Get_Parameters(i), true);
 	}
@@ -208,7 +208,19 @@ bool CCMD_Module::Execute(int argc, char *argv[])
 		return( false );
 	}
 
-	//-----------------------------------------------------
+	return( true );
+}
+
+//---------------------------------------------------------
+/**
+  * Executes the tool. This is the only step, that might run
+  * concurrently to other tools, when script commands are
+  * executed in parallel.
+*/
+bool CCMD_Module::Run(void)
+{
+	bool	bResult	= false;
+
 	CMD_Set_Module(this);
 
 	if( m_pModule->On_Before_Execution() )
@@ -220,26 +232,194 @@ bool CCMD_Module::Execute(int argc, char *argv[])
 
 	CMD_Set_Module(NULL);
 
+	return( bResult );
+}
+
+//---------------------------------------------------------
+/**
+  * Stores the output and, if bCleanUp is true, removes all
+  * temporary data and applies the memory budget of resident
+  * data objects. Clean up has to be skipped as long as other
+  * tools are running, that might still use them.
+*/
+bool CCMD_Module::Finalize(bool bResult, bool bCleanUp)
+{
 	//-----------------------------------------------------
 	if( bResult )
 	{
 		_Save_Output(m_pModule->Get_Parameters());
 
-		for(i=0; i<m_pModule->Get_Parameters_Count(); i++)
+		for(int i=0; i<m_pModule->Get_Parameters_Count(); i++)
 		{
 			_Save_Output(m_pModule->Get_Parameters(i));
 		}
-
-		SG_Get_Data_Manager().Delete_Unsaved();	// remove temporary data to save memory resources
 	}
 	else
 	{
 		CMD_Print_Error(_TL("executing tool"), m_pModule->Get_Name());
 	}
 
+	if( bCleanUp )
+	{
+		CMD_Get_Data_Store().Evict();	// grids of running tools must not be moved to the cache
+
+		CMD_Get_Data_Store().Detach();	// keep named data objects resident for subsequent script commands
+
+		if( bResult )
+		{
+			SG_Get_Data_Manager().Delete_Unsaved();	// remove temporary data to save memory resources
+		}
+	}
+
+	return( bResult );
+}
+
+
+///////////////////////////////////////////////////////////
+//                                                       //
+//                                                       //
+//                                                       //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+bool CCMD_Module::_Set_Command_Line(int argc, char *argv[])
+{
+	//-----------------------------------------------------
+	// m_CMD.SetCmdLine(argc, argv);
+	//
+	// We can't do it this way (passing argv as char**) because then we use an
+	// overload of the method which (re-)sets the locale from the current
+	// enviromment; in order to prevent this, we use wxString overload
+	{
+		wxString	sCmdLine;
+
+		for(int i=1; i<argc; i++)
+		{
+			sCmdLine	+= wxString(i == 1 ? "\"" : " \"") + argv[i] + "\"";
+		}
+
+		m_CMD.SetCmdLine(sCmdLine);
+	}
+
+	return( m_CMD.Parse(false) == 0 );
+}
+
+
+///////////////////////////////////////////////////////////
+//                                                       //
+//                                                       //
+//                                                       //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+/**
+  * Collects the files (or names of resident data objects),
+  * that are read or written, when the tool is executed with
+  * the given arguments. Returns false, if these cannot be
+  * determined in advance, e.g. for output lists whose file
+  * names depend on the number of created data objects.
+*/
+bool CCMD_Module::Get_Data_Files(int argc, char *argv[], CSG_Strings &Input, CSG_Strings &Output)
+{
+	if( !m_pLibrary || !m_pModule || argc <= 1 )
+	{
+		return( false );
+	}
+
+	{
+		wxLogNull	NoLog;	// errors will be reported on execution
+
+		if( !_Set_Command_Line(argc, argv) )
+		{
+			return( false );
+		}
+	}
+
+	bool	bResult	= _Get_Data_Files(m_pModule->Get_Parameters(), Input, Output);
+
+	for(int i=0; i<m_pModule->Get_Parameters_Count(); i++)
+	{
+		if( !_Get_Data_Files(m_pModule->Get_Parameters(i), Input, Output) )
+		{
+			bResult	= false;
+		}
+	}
+
 	return( bResult );
 }
 
+//---------------------------------------------------------
+bool CCMD_Module::_Get_Data_Files(CSG_Parameters *pParameters, CSG_Strings &Input, CSG_Strings &Output)
+{
+	bool	bResult	= true;
+
+	for(int i=0; pParameters && i<pParameters->Get_Count(); i++)
+	{
+		wxString		FileNames;
+
+		CSG_Parameter	*pParameter	= pParameters->Get_Parameter(i);
+
+		if( pParameter->Get_Type() == PARAMETER_TYPE_Parameters )
+		{
+			if( !_Get_Data_Files(pParameter->asParameters(), Input, Output) )
+			{
+				bResult	= false;
+			}
+		}
+
+		else if( pParameter->is_Input() )
+		{
+			if( m_CMD.Found(_Get_ID(pParameter), &FileNames) )
+			{
+				_Add_Data_Files(FileNames, Input);
+			}
+		}
+
+		else if( pParameter->is_Output() )
+		{
+			if( m_CMD.Found(_Get_ID(pParameter), &FileNames) )
+			{
+				if( pParameter->is_DataObject_List() )
+				{
+					bResult	= false;
+				}
+
+				_Add_Data_Files(FileNames, Output);
+			}
+		}
+
+		else if( pParameter->Get_Type() == PARAMETER_TYPE_FilePath )
+		{
+			if( m_CMD.Found(_Get_ID(pParameter), &FileNames) )
+			{
+				_Add_Data_Files(FileNames, pParameter->asFilePath()->is_Save() ? Output : Input);
+			}
+		}
+	}
+
+	return( bResult );
+}
+
+//---------------------------------------------------------
+void CCMD_Module::_Add_Data_Files(const wxString &FileNames, CSG_Strings &Files)
+{
+	wxString	s(FileNames);
+
+	while( s.Length() > 0 )
+	{
+		wxString	File(s.BeforeFirst(';'));	File.Trim(true);	File.Trim(false);
+
+		if( !File.IsEmpty() )
+		{
+			CSG_String	Name(&File);
+
+			Files	+= Get_Data_Key(Name);
+		}
+
+		s	= s.AfterFirst(';');
+	}
+}
+
 
 ///////////////////////////////////////////////////////////
 //                                                       //
@@ -247,6 +427,31 @@ bool CCMD_Module::Execute(int argc, char *argv[])
 //                                                       //
 ///////////////////////////////////////////////////////////
 
+//---------------------------------------------------------
+// Data files are saved with their default extension being
+// added or replaced (e.g. '-SLOPE=slope' writes 'slope.sgrd'),
+// so files are identified by their absolute path without
+// extension. Different data types sharing a base name are
+// thereby scheduled sequentially, which is safe.
+//---------------------------------------------------------
+CSG_String CCMD_Module::Get_Data_Key(const CSG_String &File)
+{
+	if( CCMD_Data_Store::is_Name(File) )
+	{
+		return( File );
+	}
+
+	CSG_String	Path	= SG_File_Get_Path_Absolute(File.c_str());
+
+	CSG_String	Key		= SG_File_Make_Path(SG_File_Get_Path(Path).c_str(), SG_File_Get_Name(Path.c_str(), false).c_str());
+
+#ifdef _SAGA_MSW
+	Key.Make_Lower();	// case insensitive file system
+#endif
+
+	return( Key );
+}
+
 //---------------------------------------------------------
 wxString CCMD_Module::_Get_ID(CSG_Parameter *pParameter, const wxString &Modifier)
 {
@@ -639,14 +844,16 @@ bool CCMD_Module::_Load_Input(CSG_Parameter *pParameter)
 
 	if( pParameter->is_DataObject() )
 	{
-		if( !SG_Get_Data_Manager().Find(&FileName) && !SG_Get_Data_Manager().Add(&FileName) && !pParameter->is_Optional() )
+		CSG_Data_Object	*pObject	= _Get_Input(FileName);
+
+		if( !pObject && !pParameter->is_Optional() )
 		{
 			CMD_Print_Error(_TL("input file"), &FileName);
 
 			return( false );
 		}
 
-		return( pParameter->Set_Value(SG_Get_Data_Manager().Find(&FileName, false)) );
+		return( pParameter->Set_Value(pObject) );
 	}
 
 	else if( pParameter->is_DataObject_List() )
@@ -660,12 +867,7 @@ bool CCMD_Module::_Load_Input(CSG_Parameter *pParameter)
 			FileName	= FileNames.BeforeFirst(';').Trim(false);
 			FileNames	= FileNames.AfterFirst (';');
 
-			if( !SG_Get_Data_Manager().Find(&FileName) )
-			{
-				SG_Get_Data_Manager().Add(&FileName);
-			}
-
-			pParameter->asList()->Add_Item(SG_Get_Data_Manager().Find(&FileName, false));
+			pParameter->asList()->Add_Item(_Get_Input(FileName));
 		}
 		while( FileNames.Length() > 0 );
 	}
@@ -673,6 +875,22 @@ bool CCMD_Module::_Load_Input(CSG_Parameter *pParameter)
 	return( true );
 }
 
+//---------------------------------------------------------
+CSG_Data_Object * CCMD_Module::_Get_Input(const wxString &FileName)
+{
+	if( CCMD_Data_Store::is_Name(&FileName) )	// resident data object
+	{
+		return( CMD_Get_Data_Store().Get(&FileName) );
+	}
+
+	if( !SG_Get_Data_Manager().Find(&FileName) )
+	{
+		SG_Get_Data_Manager().Add(&FileName);
+	}
+
+	return( SG_Get_Data_Manager().Find(&FileName, false) );
+}
+
 
 ///////////////////////////////////////////////////////////
 //                                                       //
@@ -723,7 +941,7 @@ bool CCMD_Module::_Save_Output(CSG_Parameters *pParameters)
 			{
 				if( pParameter->asDataObject() )
 				{
-					pParameter->asDataObject()->Save(&FileName);
+					_Set_Output(pParameter->asDataObject(), &FileName);
 				}
 			}
 
@@ -751,11 +969,11 @@ bool CCMD_Module::_Save_Output(CSG_Parameters *pParameters)
 					{
 						if( i < nFileNames )
 						{
-							pParameter->asList()->asDataObject(i)->Save(FileNames[i]);
+							_Set_Output(pParameter->asList()->asDataObject(i), FileNames[i]);
 						}
 						else
 						{
-							pParameter->asList()->asDataObject(i)->Save(CSG_String::Format(SG_T("%s_%0*d"),
+							_Set_Output(pParameter->asList()->asDataObject(i), CSG_String::Format(SG_T("%s_%0*d"),
 								FileNames[nFileNames].c_str(),
 								SG_Get_Digit_Count(pParameter->asList()->Get_Count()),
 								1 + i - nFileNames
@@ -770,6 +988,17 @@ bool CCMD_Module::_Save_Output(CSG_Parameters *pParameters)
 	return( true );
 }
 
+//---------------------------------------------------------
+bool CCMD_Module::_Set_Output(CSG_Data_Object *pObject, const CSG_String &FileName)
+{
+	if( CCMD_Data_Store::is_Name(FileName) )	// keep resident, don't write a file
+	{
+		return( CMD_Get_Data_Store().Set(FileName, pObject) );
+	}
+
+	return( pObject->Save(FileName) );
+}
+
 
 ///////////////////////////////////////////////////////////
 //                                                       //
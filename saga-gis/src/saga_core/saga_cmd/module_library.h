@@ -98,6 +98,13 @@ public:
 
 	bool						Execute					(int argc, char *argv[]);
 
+	bool						Initialize				(int argc, char *argv[]);
+	bool						Run						(void);
+	bool						Finalize				(bool bResult, bool bCleanUp = true);
+
+	bool						Get_Data_Files			(int argc, char *argv[], CSG_Strings &Input, CSG_Strings &Output);
+	static CSG_String			Get_Data_Key			(const CSG_String &File);
+
 	bool						Get_Parameters			(CSG_Parameters *pParameters)	{	return( _Get_Parameters(pParameters, false) );	}
 
 
@@ -112,11 +119,19 @@ private:
 
 	wxString					_Get_ID					(CSG_Parameter  *pParameter, const wxString &Modifier = "");
 
+	bool						_Set_Command_Line		(int argc, char *argv[]);
+
 	bool						_Set_Parameters			(CSG_Parameters *pParameters);
 	bool						_Get_Parameters			(CSG_Parameters *pParameters, bool bInitialize);
 
 	bool						_Load_Input				(CSG_Parameter  *pParameter);
+	CSG_Data_Object *			_Get_Input				(const wxString &FileName);
+
 	bool						_Save_Output			(CSG_Parameters *pParameters);
+	bool						_Set_Output				(CSG_Data_Object *pObject, const CSG_String &FileName);
+
+	bool						_Get_Data_Files			(CSG_Parameters *pParameters, CSG_Strings &Input, CSG_Strings &Output);
+	void						_Add_Data_Files			(const wxString &FileNames, CSG_Strings &Files);
 
 };
 
@@ -65,9 +65,13 @@
 
 #include <wx/app.h>
 #include <wx/utils.h>
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
 
 #include "callback.h"
 
+#include "data_store.h"
+
 #include "module_library.h"
 
 
@@ -80,10 +84,14 @@
 //---------------------------------------------------------
 bool		Run				(int argc, char *argv[]);
 
+CSG_Module *	Get_Module		(int argc, char *argv[], CSG_Module_Library **ppLibrary);
+
 bool		Execute			(int argc, char *argv[]);
+bool		Execute			(CSG_String Command);
 bool		Execute_Script	(const CSG_String &Script);
 
 bool		Load_Libraries	(void);
+void		Load_Deferred	(void);
 
 bool		Check_First		(const CSG_String &Argument);
 bool		Check_Flags		(const CSG_String &Argument);
@@ -219,22 +227,50 @@ bool		Run(int argc, char *argv[])
 ///////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-bool		Execute(int argc, char *argv[])
+CSG_Module *	Get_Module(int argc, char *argv[], CSG_Module_Library **ppLibrary)
 {
-	CSG_Module_Library	*pLibrary;
+	CSG_Module_Library	*pLibrary	= NULL;
 	CSG_Module			*pModule;
 
-	if( argc == 1 || (pLibrary = SG_Get_Module_Library_Manager().Get_Library(CSG_String(argv[1]), true)) == NULL )
+	if( argc > 1 )	// loads the requested library, if its loading has been deferred
+	{
+		bool	bShow	= CMD_Get_Show_Messages();
+
+		CMD_Set_Show_Messages(false);
+		pLibrary	= SG_Get_Module_Library_Manager().Get_Library(CSG_String(argv[1]), true);
+		CMD_Set_Show_Messages(bShow);
+	}
+
+	if( pLibrary == NULL )
 	{
 		Print_Libraries();
 
-		return( false );
+		return( NULL );
 	}
 
 	if( argc == 2 || (pModule = pLibrary->Get_Module(argv[2])) == NULL )
 	{
 		Print_Modules(pLibrary);
 
+		return( NULL );
+	}
+
+	if( ppLibrary )
+	{
+		*ppLibrary	= pLibrary;
+	}
+
+	return( pModule );
+}
+
+//---------------------------------------------------------
+bool		Execute(int argc, char *argv[])
+{
+	CSG_Module_Library	*pLibrary;
+	CSG_Module			*pModule	= Get_Module(argc, argv, &pLibrary);
+
+	if( pModule == NULL )
+	{
 		return( false );
 	}
 
@@ -286,31 +322,50 @@ bool		Set_Environment(CSG_String &Command)
 }
 
 //---------------------------------------------------------
-bool		Execute(CSG_String Command)
+enum
 {
-	Command.Trim();
+	COMMAND_NONE	= 0,
+	COMMAND_ECHO,
+	COMMAND_SAVE,
+	COMMAND_DELETE,
+	COMMAND_TOOL
+};
 
-	if( Command.is_Empty() )
+//---------------------------------------------------------
+int			Get_Command_Type(const CSG_String &Command)
+{
+	if( Command.is_Empty() || !Command.Left(3).CmpNoCase("REM") || Command[0] == '#' )
 	{
-		return( true );
+		return( COMMAND_NONE );
 	}
 
-	if( !Command.Left(3).CmpNoCase("REM") || Command[0] == '#' )
-	{
-		return( true );
-	}
+	if( !Command.Left(4).CmpNoCase("ECHO"   ) )	{	return( COMMAND_ECHO   );	}
+	if( !Command.Left(5).CmpNoCase("SAVE "  ) )	{	return( COMMAND_SAVE   );	}	// SAVE @name file: writes a resident data object to file
+	if( !Command.Left(7).CmpNoCase("DELETE ") )	{	return( COMMAND_DELETE );	}	// DELETE @name: frees a resident data object
 
-	if( !Command.Left(4).CmpNoCase("ECHO") )
-	{
-		CMD_Print(Command.AfterFirst(' '));
+	return( COMMAND_TOOL );
+}
 
-		return( true );
+//---------------------------------------------------------
+void		Get_Save_Arguments(const CSG_String &Command, CSG_String &Name, CSG_String &File)
+{
+	Name	= Command.AfterFirst(' ');
+
+	Name.Trim();	File	= Name.AfterFirst(' ');	Name	= Name.BeforeFirst(' ');	File.Trim();
+
+	if( File.Length() > 0 && File[0] == '\"' )
+	{
+		File	= File.AfterFirst('\"').BeforeFirst('\"');
 	}
+}
 
-	//-----------------------------------------------------
-	int		argc	= 1;
+//---------------------------------------------------------
+char **		Get_Arguments(CSG_String Command, int &argc)
+{
 	char	**argv	= NULL;
 
+	argc	= 1;
+
 	while( Command.Length() > 0 )
 	{
 		CSG_String	s	= Command[0] == '\"' ? Command.AfterFirst('\"').BeforeFirst('\"') : Command.BeforeFirst(' ');
@@ -323,19 +378,209 @@ bool		Execute(CSG_String Command)
 		Command	= Command.AfterFirst(' ');	Command.Trim();
 	}
 
-	//-----------------------------------------------------
-	bool	bResult	= Execute(argc, argv);
+	return( argv );
+}
 
+//---------------------------------------------------------
+void		Del_Arguments(int argc, char **argv)
+{
 	for(int i=1; i<argc; i++)
 	{
 		SG_FREE_SAFE(argv[i]);
 	}
 
 	SG_FREE_SAFE(argv);
+}
+
+//---------------------------------------------------------
+bool		Execute(CSG_String Command)
+{
+	Command.Trim();
+
+	switch( Get_Command_Type(Command) )
+	{
+	case COMMAND_NONE:
+		return( true );
+
+	case COMMAND_ECHO:
+		CMD_Print(Command.AfterFirst(' '));
+
+		return( true );
+
+	case COMMAND_SAVE: {
+		CSG_String	Name, File;	Get_Save_Arguments(Command, Name, File);
+
+		return( CMD_Get_Data_Store().Save(Name, File) ); }
+
+	case COMMAND_DELETE: {
+		CSG_String	Name(Command.AfterFirst(' '));	Name.Trim();
+
+		return( CMD_Get_Data_Store().Delete(Name) ); }
+	}
+
+	//-----------------------------------------------------
+	int		argc;
+	char	**argv	= Get_Arguments(Command, argc);
+
+	bool	bResult	= Execute(argc, argv);
+
+	Del_Arguments(argc, argv);
 
 	return( bResult );
 }
 
+
+///////////////////////////////////////////////////////////
+//														 //
+///////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+/**
+  * The commands of a script are executed as a data flow graph.
+  * A command waits for preceding commands that write files or
+  * resident data objects it reads or writes, and for those
+  * reading what it writes. Runs of the same tool are serialized,
+  * because each tool exists as single instance. ECHO commands
+  * and tool calls with output lists are barriers. With a single
+  * worker (the default) commands run in their original order.
+*/
+class CCMD_Script : public CSG_Module_Schedule
+{
+public:
+
+	//-----------------------------------------------------
+	bool					Add_Command		(CSG_String Command)
+	{
+		Command.Trim();
+
+		CSG_Strings	Input, Output;	CSG_String	Name, File;
+
+		switch( Get_Command_Type(Command) )
+		{
+		case COMMAND_NONE:
+			return( true );
+
+		case COMMAND_ECHO:
+			return( Add_Task(Command, Input, Output, NULL, true) >= 0 );
+
+		case COMMAND_SAVE:
+			Get_Save_Arguments(Command, Name, File);	Input	+= Name;	Output	+= CCMD_Module::Get_Data_Key(File);
+
+			return( Add_Task(Command, Input, Output) >= 0 );
+
+		case COMMAND_DELETE:
+			Name	= Command.AfterFirst(' ');	Name.Trim();	Output	+= Name;
+
+			return( Add_Task(Command, Input, Output) >= 0 );
+		}
+
+		//-------------------------------------------------
+		int		argc;
+		char	**argv	= Get_Arguments(Command, argc);
+
+		CSG_Module_Library	*pLibrary	= NULL;
+		CSG_Module			*pModule	= NULL;
+
+		bool	bBarrier	= true;
+
+		if( argc > 2 )
+		{
+			bool	bShow	= CMD_Get_Show_Messages();
+
+			CMD_Set_Show_Messages(false);
+			pLibrary	= SG_Get_Module_Library_Manager().Get_Library(CSG_String(argv[1]), true);
+			CMD_Set_Show_Messages(bShow);
+
+			if( pLibrary && (pModule = pLibrary->Get_Module(argv[2])) != NULL && !pModule->needs_GUI() )
+			{
+				CCMD_Module	CMD_Module(pLibrary, pModule);
+
+				bBarrier	= !CMD_Module.Get_Data_Files(argc - 2, argv + 2, Input, Output);
+			}
+		}
+
+		Del_Arguments(argc, argv);
+
+		return( Add_Task(Command, Input, Output, pModule, bBarrier) >= 0 );
+	}
+
+
+protected:
+
+	//-----------------------------------------------------
+	virtual bool			On_Run_Task		(int iTask)
+	{
+		bool	bResult;
+
+		if( Get_Command_Type(Get_Name(iTask)) != COMMAND_TOOL )
+		{
+			Lock();	bResult	= ::Execute(Get_Name(iTask));	Unlock();
+		}
+		else
+		{
+			int		argc;
+			char	**argv	= Get_Arguments(Get_Name(iTask), argc);
+
+			bResult	= _Execute_Tool(argc, argv);
+
+			Del_Arguments(argc, argv);
+		}
+
+		if( !bResult )
+		{
+			Lock();	CMD_Print_Error(_TL("invalid command"), Get_Name(iTask));	Unlock();
+		}
+
+		return( bResult );
+	}
+
+
+private:
+
+	//-----------------------------------------------------
+	bool					_Execute_Tool	(int argc, char *argv[])
+	{
+		CCMD_Module			CMD_Module;
+		CSG_Module_Library	*pLibrary;
+		CSG_Module			*pModule;
+
+		Lock();
+
+		if( (pModule = Get_Module(argc, argv, &pLibrary)) == NULL || argc <= 3 || pModule->needs_GUI() )
+		{
+			bool	bResult	= pModule != NULL && ::Execute(argc, argv);	// usage information, synopsis or error message
+
+			Unlock();
+
+			return( bResult );
+		}
+
+		Print_Execution(pLibrary, pModule);
+
+		CMD_Module.Create(pLibrary, pModule);
+
+		bool	bResult	= CMD_Module.Initialize(argc - 2, argv + 2);
+
+		Unlock();
+
+		//-------------------------------------------------
+		if( bResult )
+		{
+			bResult	= CMD_Module.Run();
+		}
+
+		//-------------------------------------------------
+		Lock();
+
+		bResult	= CMD_Module.Finalize(bResult, Get_Running() == 1);	// no clean up as long as other commands are running
+
+		Unlock();
+
+		return( bResult );
+	}
+
+};
+
 //---------------------------------------------------------
 bool		Execute_Script(const CSG_String &Script)
 {
@@ -355,11 +600,13 @@ bool		Execute_Script(const CSG_String &Script)
 
 	CSG_String	Command;
 
+	CCMD_Script	Commands;
+
 	while( Stream.Read_Line(Command) )
 	{
 		Set_Environment(Command);
 
-		if( !Execute(Command) )
+		if( !Commands.Add_Command(Command) )
 		{
 			CMD_Print_Error(_TL("invalid command"), Command);
 
@@ -367,7 +614,27 @@ bool		Execute_Script(const CSG_String &Script)
 		}
 	}
 
-	return( true );
+	if( Commands.Get_Count() < 1 )
+	{
+		return( true );
+	}
+
+	bool	bResult	= Commands.Execute();
+
+	CMD_Get_Data_Store().Detach();	// final clean up, might have been skipped while commands were running in parallel
+
+	if( bResult )
+	{
+		SG_Get_Data_Manager().Delete_Unsaved();
+	}
+
+	if( CMD_Get_Show_Messages() && Commands.Get_Workers() > 1 )
+	{
+		CMD_Print("");
+		CMD_Print(Commands.Get_Report());
+	}
+
+	return( bResult );
 }
 
 
@@ -383,17 +650,41 @@ bool		Load_Libraries(const CSG_String &Directory)
 	bool	bShow	= CMD_Get_Show_Messages();
 
 	CMD_Set_Show_Messages(false);
-	int	n	= SG_Get_Module_Library_Manager().Add_Directory(Directory, false);
+	int	n	= SG_Get_Module_Library_Manager().Add_Directory(Directory, false, true);
 	CMD_Set_Show_Messages(bShow);
 
 	return( n > 0 );
 }
 
+//---------------------------------------------------------
+CSG_String	Get_Manifest_File(void)
+{
+	wxString	File;
+
+	if( !wxGetEnv(wxT("SAGA_MANIFEST"), &File) || File.IsEmpty() )
+	{
+	#if defined(_SAGA_LINUX)
+		File	= wxFileName(wxStandardPaths::Get().GetUserConfigDir(), wxT(".saga_cmd"), wxT("manifest")).GetFullPath();
+	#else
+		File	= wxFileName(wxStandardPaths::Get().GetUserConfigDir(), wxT( "saga_cmd"), wxT("manifest")).GetFullPath();
+	#endif
+	}
+
+	return( CSG_String(&File) );
+}
+
+//---------------------------------------------------------
+// Libraries are not loaded at once, but only registered
+// together with the library and tool identifiers stored
+// in the manifest, which is updated for new or modified
+// library files. A library is loaded on first request.
 //---------------------------------------------------------
 bool		Load_Libraries(void)
 {
 	wxString	Path, CMD_Path	= SG_File_Get_Path(SG_UI_Get_Application_Path()).c_str();
 
+	SG_Get_Module_Library_Manager().Open_Manifest(Get_Manifest_File());
+
     #if defined(_SAGA_LINUX)
 		Load_Libraries(wxT(MODULE_LIBRARY_PATH));
 	#else
@@ -423,7 +714,9 @@ bool		Load_Libraries(void)
 		}
 	}
 
-	if( SG_Get_Module_Library_Manager().Get_Count() <= 0 )
+	SG_Get_Module_Library_Manager().Save_Manifest();
+
+	if( SG_Get_Module_Library_Manager().Get_Count() + SG_Get_Module_Library_Manager().Get_Deferred_Count() <= 0 )
 	{
 		CMD_Print_Error(SG_T("could not load any tool library"));
 
@@ -433,6 +726,16 @@ bool		Load_Libraries(void)
 	return( true );
 }
 
+//---------------------------------------------------------
+void		Load_Deferred(void)
+{
+	bool	bShow	= CMD_Get_Show_Messages();
+
+	CMD_Set_Show_Messages(false);
+	SG_Get_Module_Library_Manager().Load_Deferred();
+	CMD_Set_Show_Messages(bShow);
+}
+
 
 ///////////////////////////////////////////////////////////
 //														 //
@@ -530,6 +833,32 @@ bool		Check_Flags		(const CSG_String &Argument)
 		return( true );
 	}
 
+	else if( !s.CmpNoCase("-w") || !s.CmpNoCase("--workers") )
+	{
+		#ifdef _OPENMP
+		int	nWorkers	= 1;
+
+		if( CSG_String(Argument).AfterFirst('=').asInt(nWorkers) )
+		{
+			SG_Set_Max_Num_Workers(nWorkers);
+		}
+		#endif // _OPENMP
+
+		return( true );
+	}
+
+	else if( !s.CmpNoCase("-m") || !s.CmpNoCase("--memory") )
+	{
+		double	MB;
+
+		if( CSG_String(Argument).AfterFirst('=').asDouble(MB) )
+		{
+			CMD_Get_Data_Store().Set_Memory_Budget(MB);
+		}
+
+		return( true );
+	}
+
 	else if( !s.CmpNoCase("-s") || !s.CmpNoCase("--story") )
 	{
 		int	Depth;
@@ -559,6 +888,8 @@ void		Print_Libraries	(void)
 
 	if( CMD_Get_Show_Messages() )
 	{
+		Load_Deferred();
+
 		if( CMD_Get_XML() )
 		{
 			SG_PRINTF(SG_Get_Module_Library_Manager().Get_Summary(SG_SUMMARY_FMT_XML_NO_INTERACTIVE).c_str());
@@ -687,14 +1018,14 @@ void		Print_Help		(void)
 		"saga_cmd [-b, --batch]\n"
 		"saga_cmd [-d, --docs]\n"
 #ifdef _OPENMP
-		"saga_cmd [-f, --flags][=qrsilpxo][-s, --story][=#][-c, --cores][=#]\n"
+		"saga_cmd [-f, --flags][=qrsilpxo][-s, --story][=#][-c, --cores][=#][-w, --workers][=#]\n"
 		"  <LIBRARY> <MODULE> <OPTIONS>\n"
-		"saga_cmd [-f, --flags][=qrsilpxo][-s, --story][=#][-c, --cores][=#]\n"
-		"  <SCRIPT>\n"
+		"saga_cmd [-f, --flags][=qrsilpxo][-s, --story][=#][-c, --cores][=#][-w, --workers][=#]\n"
+		"  [-m, --memory][=#] <SCRIPT>\n"
 #else
 		"saga_cmd [-f, --flags][=qrsilpxo][-s, --story][=#]\n"
 		"  <LIBRARY> <MODULE> <OPTIONS>\n"
-		"saga_cmd [-f, --flags][=qrsilpxo][-s, --story][=#]\n"
+		"saga_cmd [-f, --flags][=qrsilpxo][-s, --story][=#][-m, --memory][=#]\n"
 		"  <SCRIPT>\n"
 #endif
 		"\n"
@@ -703,8 +1034,10 @@ void		Print_Help		(void)
 		"[-b], [--batch]  : create a batch file example\n"
 		"[-d], [--docs]   : create tool documentation in current working directory\n"
 		"[-s], [--story]  : maximum data history depth (default is unlimited)\n"
+		"[-m], [--memory] : memory budget (MB) for resident grids of a script\n"
 #ifdef _OPENMP
 		"[-c], [--cores]  : number of physical processors to use for computation\n"
+		"[-w], [--workers]: number of script commands or model tools running in parallel\n"
 #endif
 		"[-f], [--flags]  : various flags for general usage [qrsilpxo]\n"
 		"  q              : no progress report\n"
@@ -733,12 +1066,28 @@ void		Print_Help		(void)
 		"by adding the environment variable \'SAGA_MLB\' and let it point to one\n"
 		"or more directories, just the way it is done with the DOS \'PATH\' variable.\n"
 		"\n"
+		"Library and tool names are kept in a manifest file, so that only the library\n"
+		"providing the requested tool needs to be loaded. The manifest is updated\n"
+		"whenever a library file has been added or modified. Its location can be\n"
+		"set with the environment variable \'SAGA_MANIFEST\'.\n"
+		"\n"
 		"The SAGA command line interpreter is particularly useful for the processing\n"
 		"of complex work flows by defining a series of subsequent tool calls in a\n"
 		"script file. Calling saga_cmd with the option \'-b\' or \'--batch\' will\n"
 		"create an example of a DOS batch script file, which might be a good starting\n"
 		"point for the implementation of your own specific work flows.\n"
 		"\n"
+		"Within a script, data objects can be kept in memory instead of being written\n"
+		"to and read from files, by using a name starting with \'@\' instead of a file\n"
+		"name (e.g. -SLOPE=@slope). Such objects are written to a file with the\n"
+		"command \'SAVE @name file\' and freed with \'DELETE @name\'. If a memory\n"
+		"budget is given, the least recently used grids are moved to the grid cache.\n"
+		"\n"
+		"Script commands and the tools of a model are executed in the order of their\n"
+		"data dependencies. With more than one worker, commands that do not depend on\n"
+		"each other run in parallel and the processors given by \'-c\' are shared\n"
+		"among them. A timing report for each command is printed at the end.\n"
+		"\n"
 		"_____________________________________________________________________________\n"
 		"\n"
 		"Please provide the following reference in your work if you are using SAGA:\n"
@@ -874,6 +1223,8 @@ void		Create_Docs		(void)
 
 		CMD_Set_Show_Messages(false);
 
+		Load_Deferred();
+
 		SG_Get_Module_Library_Manager().Get_Summary(SG_Dir_Get_Current());
 
 		CMD_Print(_TL("okay"));
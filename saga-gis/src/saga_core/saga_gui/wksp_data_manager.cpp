@@ -252,6 +252,12 @@ CWKSP_Data_Manager::CWKSP_Data_Manager(void)
 		PARAMETER_TYPE_Double, SG_Grid_Cache_Get_Threshold_MB(), 0.0, true
 	);
 
+	m_Parameters.Add_Value(
+		pNode_1	, "GRID_CACHE_MAP"		, _TL("Memory Mapping"),
+		_TL("Use memory mapped files instead of the file cache. Native grid files are mapped directly, if their data can be used as is."),
+		PARAMETER_TYPE_Bool, SG_Grid_Cache_Get_Mapping()
+	);
+
 	m_Parameters.Add_Choice(
 		pNode_1	, "GRID_CACHE_CONFIRM"	, _TL("Confirm file caching"),
 		_TL(""),
@@ -268,14 +274,26 @@ CWKSP_Data_Manager::CWKSP_Data_Manager(void)
 		NULL, SG_Grid_Cache_Get_Directory(), true, true
 	);
 
+	//-----------------------------------------------------
+	pNode	= m_Parameters.Add_Node(NULL, "NODE_TABLE", _TL("Tables"), _TL(""));
+
+	m_Parameters.Add_Value(
+		pNode	, "TABLE_COLUMNAR"		, _TL("Columnar Storage"),
+		_TL("Load dBase tables and shapefile attributes with columnar storage, which needs less memory and speeds up statistics and sorting of large tables."),
+		PARAMETER_TYPE_Bool, SG_Table_Get_Columnar()
+	);
+
 	//-----------------------------------------------------
 	CONFIG_Read("/DATA", &m_Parameters);
 
 	SG_Grid_Cache_Set_Directory   (m_Parameters("GRID_CACHE_TMPDIR" )->asString());
 	SG_Grid_Cache_Set_Automatic   (m_Parameters("GRID_CACHE_AUTO"   )->asBool  ());
 	SG_Grid_Cache_Set_Threshold_MB(m_Parameters("GRID_CACHE_THRSHLD")->asDouble());
+	SG_Grid_Cache_Set_Mapping     (m_Parameters("GRID_CACHE_MAP"    )->asBool  ());
 	SG_Grid_Cache_Set_Confirm     (m_Parameters("GRID_CACHE_CONFIRM")->asInt   ());
 
+	SG_Table_Set_Columnar(m_Parameters("TABLE_COLUMNAR")->asBool());
+
 	SG_Set_History_Depth(m_Parameters("HISTORY_DEPTH")->asInt());
 
 	m_Numbering	= m_Parameters("NUMBERING")->asInt();
@@ -601,8 +619,11 @@ void CWKSP_Data_Manager::Parameters_Changed(void)
 	SG_Grid_Cache_Set_Directory   (m_Parameters("GRID_CACHE_TMPDIR" )->asString());
 	SG_Grid_Cache_Set_Automatic   (m_Parameters("GRID_CACHE_AUTO"   )->asBool  ());
 	SG_Grid_Cache_Set_Threshold_MB(m_Parameters("GRID_CACHE_THRSHLD")->asDouble());
+	SG_Grid_Cache_Set_Mapping     (m_Parameters("GRID_CACHE_MAP"    )->asBool  ());
 	SG_Grid_Cache_Set_Confirm     (m_Parameters("GRID_CACHE_CONFIRM")->asInt   ());
 
+	SG_Table_Set_Columnar(m_Parameters("TABLE_COLUMNAR")->asBool());
+
 	SG_Set_History_Depth(m_Parameters("HISTORY_DEPTH")->asInt());
 
 	m_Numbering	= m_Parameters("NUMBERING")->asInt();